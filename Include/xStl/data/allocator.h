@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_ALLOCATOR_H
+#define __TBA_STL_ALLOCATOR_H
+
+/*
+ * allocator.h
+ *
+ * Declare the memory allocator interface of the containers.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+
+/*
+ * cAllocator
+ *
+ * An interface for the memory of the containers (cArray, cList, cString and
+ * cHash). A container without an allocator (NULL) uses the cOS small-memory
+ * functions. See cArena for an allocator which frees all its memory at once.
+ *
+ * The allocator of a container is set while the container is empty, and it
+ * must live longer than the container. The allocator is not copied: copies of
+ * a container use the default allocator and operator = keeps the allocator of
+ * the destination (a move assignment between different allocators copies the
+ * elements). Move-constructing or swapping containers moves their memory
+ * together with their allocators.
+ */
+class cAllocator
+{
+public:
+    // Virtual destructor. You can inherit from me
+    virtual ~cAllocator() {}
+
+    /*
+     * Return a new memory block of 'size' bytes, aligned for any object, or
+     * NULL if there is no memory.
+     */
+    virtual void* allocate(uint size) = 0;
+
+    /*
+     * Change the size of the block 'block' of 'oldSize' bytes into 'newSize'
+     * bytes. The content of the block is preserved. Return the new block, or
+     * NULL if there is no memory (and the old block is still valid).
+     */
+    virtual void* reallocate(void* block, uint oldSize, uint newSize) = 0;
+
+    /*
+     * Free the block 'block' of 'size' bytes.
+     */
+    virtual void free(void* block, uint size) = 0;
+
+    // The default allocator dispatch. 'allocator' can be NULL.
+
+    static void* allocateMemory(cAllocator* allocator, uint size)
+    {
+        if (allocator == NULL)
+            return cOS::smallMemoryAllocation(size);
+        return allocator->allocate(size);
+    }
+
+    static void* reallocateMemory(cAllocator* allocator, void* block,
+                                  uint oldSize, uint newSize)
+    {
+        if (allocator == NULL)
+            return cOS::smallMemoryRealloc(block, newSize);
+        return allocator->reallocate(block, oldSize, newSize);
+    }
+
+    static void freeMemory(cAllocator* allocator, void* block, uint size)
+    {
+        if (allocator == NULL)
+            cOS::smallMemoryFree(block);
+        else
+            allocator->free(block, size);
+    }
+};
+
+#endif // __TBA_STL_ALLOCATOR_H
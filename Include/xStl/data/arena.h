@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_ARENA_H
+#define __TBA_STL_ARENA_H
+
+/*
+ * arena.h
+ *
+ * A region allocator: Memory blocks are carved out of large chunks and all the
+ * chunks are freed together.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/allocator.h"
+#include "xStl/except/exception.h"
+
+/*
+ * cArena
+ *
+ * A bump-pointer allocator. Every allocation advances a pointer inside the
+ * current chunk, and a new chunk is allocated (with cOS::smallMemoryAllocation)
+ * when the current one is full. Freeing a block returns the memory only if it
+ * is the last allocation, so the memory of a whole working set is released by
+ * freeAll(), which frees the chunks and doesn't touch the blocks.
+ *
+ * When the free-lists are enabled, freed small blocks are kept in a list per
+ * size and are recycled by the next allocations of the same size. Use it when
+ * the working set also frees and re-allocates many blocks (for example
+ * growing arrays).
+ *
+ * The arena is an allocator for the containers (See cAllocator), and objects
+ * can be constructed inside it:
+ *     cArena arena;
+ *     cNode* node = new (arena) cNode();
+ *     node->m_children.setAllocator(&arena);
+ *     ...
+ *     // Release all the nodes and their children arrays. The destructors of
+ *     // the nodes are not called.
+ *     arena.freeAll();
+ *
+ * NOTE: This class is not thread-safe
+ */
+class cArena : public cAllocator
+{
+public:
+    enum {
+        // The alignment of all the blocks
+        Alignment = 16,
+        // The default number of bytes of a chunk
+        DefaultChunkSize = 64 * 1024,
+        // The largest block which is kept in the free-lists
+        MaxFreeListSize = 256,
+        // The number of free-lists, one for each aligned size
+        FreeListsCount = MaxFreeListSize / Alignment
+    };
+
+    /*
+     * Constructor. Creates an empty arena. No memory is allocated until the
+     * first allocation.
+     *
+     * chunkSize    - The number of bytes of each chunk. Blocks larger than a
+     *                quarter of a chunk get a chunk of their own.
+     * useFreeLists - Set to true in order to recycle the freed small blocks.
+     */
+    explicit cArena(uint chunkSize = DefaultChunkSize,
+                    bool useFreeLists = false);
+
+    /*
+     * Destructor. Frees all the chunks.
+     */
+    virtual ~cArena();
+
+    // cAllocator
+
+    /*
+     * Return a new block of 'size' bytes, or NULL if there is no memory.
+     */
+    virtual void* allocate(uint size);
+
+    /*
+     * Grow the block in place if it's the last allocation, otherwise copy it
+     * into a new block.
+     */
+    virtual void* reallocate(void* block, uint oldSize, uint newSize);
+
+    /*
+     * Recycle the block, if it's the last allocation or if the free-lists
+     * are enabled. Otherwise the memory is released by freeAll().
+     */
+    virtual void free(void* block, uint size);
+
+    /*
+     * Free all the chunks. All the blocks of the arena become invalid.
+     */
+    void freeAll();
+
+    /*
+     * Return the number of bytes allocated by the arena chunks
+     */
+    uint getAllocatedBytes() const;
+
+private:
+    // Deny copy-constructor and operator =
+    cArena(const cArena& other);
+    cArena& operator = (const cArena& other);
+
+    /*
+     * Round 'size' to the alignment of the blocks.
+     */
+    static uint alignSize(uint size);
+
+    /*
+     * Allocate a chunk with at least 'size' bytes for blocks and link it.
+     * Return the first byte of the chunk blocks, or NULL if there is no
+     * memory.
+     *
+     * makeCurrent - Set to true in order to allocate the next blocks from the
+     *               new chunk.
+     */
+    uint8* allocateChunk(uint size, bool makeCurrent);
+
+    // A free block, linked into a free-list
+    struct FreeBlock
+    {
+        FreeBlock* m_next;
+    };
+
+    // The header in the beginning of each chunk
+    struct Chunk
+    {
+        // The next (older) chunk
+        Chunk* m_next;
+        // The number of bytes of the chunk, including the header
+        uint m_size;
+    };
+
+    // The size of the chunk header, which keeps the blocks aligned
+    enum { ChunkHeaderSize = ((sizeof(Chunk) + Alignment - 1) /
+                              Alignment) * Alignment };
+
+    // The number of bytes of a chunk
+    uint m_chunkSize;
+    // Set if freed blocks are recycled
+    bool m_useFreeLists;
+    // The free blocks, by their size
+    FreeBlock* m_freeLists[FreeListsCount];
+    // All the chunks, the newest first
+    Chunk* m_chunks;
+    // The next block of the current chunk, and the end of the current chunk
+    uint8* m_position;
+    uint8* m_end;
+    // The number of bytes of all the chunks
+    uint m_allocatedBytes;
+};
+
+/*
+ * Construct an object inside an arena:
+ *     cNode* node = new (arena) cNode();
+ *
+ * The object memory is released by cArena::freeAll(), and the object should
+ * not be deleted.
+ *
+ * Throws out of memory exception.
+ */
+inline void* operator new(size_t size, cArena& arena)
+{
+    void* ret = arena.allocate((uint)size);
+    if (ret == NULL)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    return ret;
+}
+
+/*
+ * Called only if the constructor of an object which is constructed inside an
+ * arena throws an exception. The memory is released by cArena::freeAll().
+ */
+inline void operator delete(void*, cArena&)
+{
+}
+
+#endif // __TBA_STL_ARENA_H
@@ -43,7 +43,9 @@
 #include "xStl/types.h"
 #include "xStl/operators.h"
 #include "xStl/utils/algorithm.h"
+#include "xStl/utils/typeTraits.h"
 #include "xStl/except/assert.h"
+#include "xStl/data/allocator.h"
 
 #ifdef XSTL_WINDOWS
 // Template classes might not use all the local functions the interface has
@@ -52,6 +54,85 @@
 #pragma warning(disable:4505)
 #endif
 
+/*
+ * class cArrayStorage
+ *
+ * Allocate, reallocate, free and copy the storage of a cArray. The general
+ * implementation uses operator new[] and operator =. The specialization for
+ * plain-old-data types (see cTypeTraits) uses the cOS small-memory functions
+ * and memcpy, so the storage is not initialized and can be grown in place.
+ *
+ * When an allocator is given (See cAllocator) the memory is allocated by it.
+ * The elements of non plain-old-data types are constructed inside the memory
+ * and are destroyed by free(), which must get the number of elements.
+ *
+ * All the functions throws 'EXCEPTION_OUT_OF_MEM' exception.
+ */
+template <class T, bool isPod>
+class cArrayStorage
+{
+public:
+    /*
+     * Allocate storage for 'count' elements. 'count' must not be zero.
+     */
+    static T* allocate(uint count, cAllocator* allocator = NULL);
+
+    /*
+     * Change the storage 'array' of 'oldCount' elements into 'newCount'
+     * elements. The first 'copyCount' elements are preserved. 'array' may be
+     * NULL.
+     */
+    static T* reallocate(T* array, uint oldCount, uint newCount,
+                         uint copyCount, cAllocator* allocator = NULL);
+
+    /*
+     * Free a storage of 'count' elements returned by allocate() or
+     * reallocate(). 'array' may be NULL.
+     */
+    static void free(T* array, uint count = 0, cAllocator* allocator = NULL);
+
+    /*
+     * Copy 'count' elements from 'source' into 'destination'.
+     */
+    static void copy(T* destination, const T* source, uint count);
+};
+
+template <class T>
+class cArrayStorage<T, true>
+{
+public:
+    static T* allocate(uint count, cAllocator* allocator = NULL);
+    static T* reallocate(T* array, uint oldCount, uint newCount,
+                         uint copyCount, cAllocator* allocator = NULL);
+    static void free(T* array, uint count = 0, cAllocator* allocator = NULL);
+    static void copy(T* destination, const T* source, uint count);
+};
+
+/*
+ * class cArrayElement
+ *
+ * Constructs an element of a non plain-old-data array inside memory of an
+ * allocator.
+ */
+template <class T>
+class cArrayElement
+{
+public:
+    cArrayElement() : m_element() {}
+
+    static void* operator new(size_t, void* position)
+    {
+        return position;
+    }
+
+    static void operator delete(void*, void*)
+    {
+    }
+
+    // The constructed element
+    T m_element;
+};
+
 /*
  * cArray template class.
  *
@@ -63,8 +144,17 @@
  * memory for the array but when the size of the array is changed within the
  * page size, no memory allocation operation is called.
  *
- * PS cArray can be used for many call to changeSize()
- *    only if you configure the page_size variable right.
+ * When the array must grow beyond its allocated capacity, the new capacity is
+ * multiplied by the growth factor (see setGrowthFactor()), so a sequence of
+ * append() calls costs amortized constant time. Shrinking the array keeps the
+ * allocation until the size drops below a quarter of the capacity. Use
+ * reserve() and shrinkToFit() in order to control the capacity explicitly.
+ *
+ * Arrays of plain-old-data types (see cTypeTraits) are stored in raw memory
+ * which is copied using memcpy and grown using realloc. The elements of these
+ * arrays are not initialized.
+ *
+ * The memory of the array can be allocated from a cArena (See setAllocator()).
  *
  * T must have:
  *    default constructor.
@@ -80,6 +170,14 @@ public:
     // Forward deceleration for class iterator.
     class iterator;
 
+    // The growth factor constants, in percents of the current capacity
+    enum {
+        // No geometric growth, the array is paged by the page-size only
+        NoGrowth = 100,
+        // The default growth factor (x1.5)
+        DefaultGrowthFactor = 150
+    };
+
     /*
      * Explicit constructor.
      *
@@ -109,6 +207,13 @@ public:
      */
     cArray(const cArray<T>& other);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Move constructor. Take the storage of 'other', which becomes empty.
+     */
+    cArray(cArray<T>&& other);
+    #endif
+
     /*
      * Virtual destructor. Used for cBuffer implementation.
      */
@@ -139,13 +244,28 @@ public:
     uint getSize() const;
 
     /*
-     * Replace the array pointers of the current array and 'other'
+     * Replace the array pointers (and allocators) of the current array and
+     * 'other'
      *
-     * NOTE: This function doesn't replace the pageSize values.
+     * NOTE: This function doesn't replace the pageSize and the growth factor
+     *       values.
      * NOTE: This class is not thread-safe
      */
     void swap(cArray<T>& other);
 
+    /*
+     * Allocate the memory of the array from 'allocator' (NULL for the default
+     * allocator). See cAllocator.
+     *
+     * Throws exception if the array isn't empty.
+     */
+    void setAllocator(cAllocator* allocator);
+
+    /*
+     * Return the allocator of the array, or NULL for the default allocator
+     */
+    cAllocator* getAllocator() const;
+
     /*
      * Increase or decrease the count of elements in the array. Destroy the
      * previous memory if the preserverMemory is false. Otherwise, if the
@@ -162,6 +282,41 @@ public:
      */
     void setPageSize(uint newPageSize);
 
+    /*
+     * Return the number of elements the array can hold without reallocation.
+     */
+    uint getCapacity() const;
+
+    /*
+     * Make sure that the array can hold at least 'capacity' elements without
+     * reallocation. The size of the array is not changed.
+     *
+     * throws 'EXCEPTION_OUT_OF_MEM' exception.
+     */
+    void reserve(uint capacity);
+
+    /*
+     * Release the unused capacity of the array. The capacity is reduced to the
+     * size of the array (rounded to the page size).
+     *
+     * throws 'EXCEPTION_OUT_OF_MEM' exception.
+     */
+    void shrinkToFit();
+
+    /*
+     * Return the growth factor of the array in percents.
+     */
+    uint getGrowthFactor() const;
+
+    /*
+     * Change the growth factor of the array. When the array is expanded beyond
+     * its capacity the new capacity is at least 'percent'% of the old one.
+     * NoGrowth disables the geometric growth.
+     *
+     * Throws exception if 'percent' is lower than NoGrowth.
+     */
+    void setGrowthFactor(uint percent);
+
     /*
      * Like the python's operator [:], but mush less improve. Copy from the
      * array 'count' elements starting from 'startLocation' into 'other' array.
@@ -187,6 +342,33 @@ public:
      */
     virtual void append(const T& object);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Insert single object to the end of the array. The object is moved into
+     * the new element.
+     *
+     * object - The object to append
+     *
+     * throws 'EXCEPTION_OUT_OF_MEM' exception.
+     */
+    void append(T&& object);
+
+    /*
+     * Construct a new element at the end of the array from 'args' and return
+     * it. Since the elements of the array are default constructed, the new
+     * element is move-assigned from an object constructed by 'args'.
+     *
+     * throws 'EXCEPTION_OUT_OF_MEM' exception.
+     */
+    template <class... Args>
+    T& emplace(Args&&... args)
+    {
+        changeSize(m_size + 1);
+        m_array[m_size - 1] = T(t_forward<Args>(args)...);
+        return m_array[m_size - 1];
+    }
+    #endif
+
     /*
      * Insert new array to the end of the array. The array is expand by one
      * element and the 'object' is copyied to the end of the array.
@@ -269,6 +451,13 @@ public:
      */
     cArray<T>& operator = (const cArray<T>& other);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Move operator. Take the storage of 'other', which becomes empty.
+     */
+    cArray<T>& operator = (cArray<T>&& other);
+    #endif
+
     /*
      * Operators which appends data to the array. Anoter array
      * or another element.
@@ -439,6 +628,17 @@ public:
                 return iterator(m_tcArray, m_index - count);
             }
 
+            /*
+             * Return the number of elements between 'other' and this
+             * iterator. 'other' must not be after this iterator.
+             */
+            uint operator- (const iterator& other) const
+            {
+                ASSERT((m_tcArray == other.m_tcArray) &&
+                       (other.m_index <= m_index));
+                return m_index - other.m_index;
+            }
+
         private:
             /*
              * Only the cArray<T> class should access the internal data of the
@@ -483,6 +683,9 @@ protected:
     /* Private methods */
     friend class cTestArray;
 
+    // The storage handler of the array elements
+    typedef cArrayStorage<T, (cTypeTraits<T>::isPod != 0)> Storage;
+
     /*
      * Free the array. free all memory allocated and create empty array.
      */
@@ -510,6 +713,21 @@ protected:
      */
     uint pageRound(uint bytes) const;
 
+    /*
+     * Return the capacity which should be allocated in order to expand the
+     * array into 'newSize' elements, using the growth factor of the array.
+     */
+    uint growCapacity(uint newSize) const;
+
+    /*
+     * Allocate a new storage of 'newCapacity' elements, copy the first
+     * 'count' elements into it and free the old storage. The size of the array
+     * is not changed.
+     *
+     * throws 'EXCEPTION_OUT_OF_MEM' exception.
+     */
+    virtual void reallocArray(uint newCapacity, uint count);
+
     /*
      * Private members
      */
@@ -521,6 +739,10 @@ protected:
     uint m_alocatedArray;
     // The page size for the allocation.
     uint m_pageSize;
+    // The growth factor of the allocation, in percents
+    uint m_growthFactor;
+    // The allocator of the array memory, NULL for the default allocator
+    cAllocator* m_allocator;
 };
 
 
@@ -37,6 +37,174 @@
  * Author: Elad Raz <e@eladraz.com>
  */
 #include "xStl/except/exception.h"
+#include "xStl/os/os.h"
+
+template <class T, bool isPod>
+T* cArrayStorage<T, isPod>::allocate(uint count,
+                                     cAllocator* allocator /* = NULL */)
+{
+    if (allocator == NULL)
+    {
+        T* ret = new T[count];
+        if (ret == NULL)
+        {
+            XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+        }
+        return ret;
+    }
+
+    if (count > (MAX_UINT / sizeof(T)))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+
+    T* ret = (T*)allocator->allocate(count * sizeof(T));
+    if (ret == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+    for (uint i = 0; i < count; i++)
+    {
+        new ((void*)(ret + i)) cArrayElement<T>();
+    }
+    return ret;
+}
+
+template <class T, bool isPod>
+T* cArrayStorage<T, isPod>::reallocate(T* array,
+                                       uint oldCount,
+                                       uint newCount,
+                                       uint copyCount,
+                                       cAllocator* allocator /* = NULL */)
+{
+    ASSERT(copyCount <= newCount);
+
+    T* ret = allocate(newCount, allocator);
+    if (array != NULL)
+    {
+        #ifdef XSTL_CPP11
+        // The old elements are destroyed, move them
+        for (uint i = 0; i < copyCount; i++)
+        {
+            ret[i] = t_move(array[i]);
+        }
+        #else
+        copy(ret, array, copyCount);
+        #endif
+        free(array, oldCount, allocator);
+    }
+    return ret;
+}
+
+template <class T, bool isPod>
+void cArrayStorage<T, isPod>::free(T* array,
+                                   uint count /* = 0 */,
+                                   cAllocator* allocator /* = NULL */)
+{
+    if (allocator == NULL)
+    {
+        delete [] array;
+        return;
+    }
+
+    if (array != NULL)
+    {
+        for (uint i = 0; i < count; i++)
+        {
+            array[i].~T();
+        }
+        allocator->free(array, count * sizeof(T));
+    }
+}
+
+template <class T, bool isPod>
+void cArrayStorage<T, isPod>::copy(T* destination,
+                                   const T* source,
+                                   uint count)
+{
+    for (uint i = 0; i < count; i++)
+    {
+        destination[i] = source[i];
+    }
+}
+
+template <class T>
+T* cArrayStorage<T, true>::allocate(uint count,
+                                    cAllocator* allocator /* = NULL */)
+{
+    if (count > (MAX_UINT / sizeof(T)))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+
+    T* ret = (T*)cAllocator::allocateMemory(allocator, count * sizeof(T));
+    if (ret == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+    return ret;
+}
+
+template <class T>
+T* cArrayStorage<T, true>::reallocate(T* array,
+                                      uint oldCount,
+                                      uint newCount,
+                                      uint copyCount,
+                                      cAllocator* allocator /* = NULL */)
+{
+    ASSERT(copyCount <= newCount);
+
+    if (array == NULL)
+    {
+        return allocate(newCount, allocator);
+    }
+
+    if (newCount > (MAX_UINT / sizeof(T)))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+
+    #ifdef XSTL_NTDDK
+        // The kernel pool cannot be reallocated
+        T* ret = allocate(newCount, allocator);
+        copy(ret, array, t_min(copyCount, oldCount));
+        free(array, oldCount, allocator);
+    #else
+        // realloc() keeps the whole old block, copyCount is only an upper
+        // bound for the kernel copy above
+        UNUSED_PARAM(copyCount);
+        T* ret = (T*)cAllocator::reallocateMemory(allocator, array,
+                                                  oldCount * sizeof(T),
+                                                  newCount * sizeof(T));
+        if (ret == NULL)
+        {
+            XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+        }
+    #endif
+    return ret;
+}
+
+template <class T>
+void cArrayStorage<T, true>::free(T* array,
+                                  uint count /* = 0 */,
+                                  cAllocator* allocator /* = NULL */)
+{
+    if (array != NULL)
+    {
+        cAllocator::freeMemory(allocator, array, count * sizeof(T));
+    }
+}
+
+template <class T>
+void cArrayStorage<T, true>::copy(T* destination,
+                                  const T* source,
+                                  uint count)
+{
+    if (count != 0)
+    {
+        cOS::memcpy(destination, source, count * sizeof(T));
+    }
+}
 
 template <class T>
 cArray<T>::cArray(uint numberOfElements /* = 0*/,
@@ -50,11 +218,7 @@ cArray<T>::cArray(uint numberOfElements /* = 0*/,
 	{
 		m_size          = numberOfElements;
 		m_alocatedArray = pageRound(m_size);
-		m_array         = new T[m_alocatedArray];
-        if (m_array == NULL)
-        {
-            XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
-        }
+		m_array         = Storage::allocate(m_alocatedArray, m_allocator);
 	}
 }
 
@@ -73,18 +237,11 @@ cArray<T>::cArray(const T* staticArray,
 	{
 		m_size          = length;
 		m_alocatedArray = pageRound(m_size);
-		m_array         = new T[m_alocatedArray];
-        if (m_array == NULL)
-        {
-                XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
-        }
+		m_array         = Storage::allocate(m_alocatedArray, m_allocator);
 
 		// Copy the static array into the created array
-        // Notice that operator = is in used...
-		for (uint i = 0; i < length; i++)
-		{
-			m_array[i] = staticArray[i];
-		}
+        // Notice that operator = is in used for non-POD types...
+		Storage::copy(m_array, staticArray, length);
 	}
 }
 
@@ -98,6 +255,43 @@ cArray<T>::cArray(const cArray<T>& other)
 	copyFrom(other);
 }
 
+#ifdef XSTL_CPP11
+template <class T>
+cArray<T>::cArray(cArray<T>&& other)
+{
+    initArray(other.m_pageSize);
+    m_growthFactor = other.m_growthFactor;
+    swap(other);
+}
+
+template <class T>
+cArray<T>& cArray<T>::operator = (cArray<T>&& other)
+{
+    if (m_allocator != other.m_allocator)
+    {
+        // Keep the allocator of this array
+        return *this = static_cast<const cArray<T>&>(other);
+    }
+
+    if (this != &other)
+    {
+        freeArray();
+        swap(other);
+    }
+    return *this;
+}
+
+template <class T>
+void cArray<T>::append(T&& object)
+{
+    // First we will increase the array by one.
+    changeSize(m_size + 1);
+
+    // Now we will move the element to end of the array
+    m_array[m_size - 1] = t_move(object);
+}
+#endif // XSTL_CPP11
+
 template <class T>
 uint cArray<T>::pageRound(uint bytes) const
 {
@@ -122,7 +316,38 @@ void cArray<T>::initArray(uint pageSize)
 
 	m_alocatedArray = 0;
 	m_pageSize      = pageSize;
+	m_growthFactor  = DefaultGrowthFactor;
+	m_allocator     = NULL;
+}
+
+template <class T>
+uint cArray<T>::growCapacity(uint newSize) const
+{
+    uint newCapacity = pageRound(newSize);
+
+    // The first allocation is exact, the following are geometric.
+    if ((m_alocatedArray == 0) || (m_growthFactor <= NoGrowth))
+    {
+        return newCapacity;
+    }
 
+    uint grown = m_alocatedArray;
+    if (m_alocatedArray <= (MAX_UINT / m_growthFactor))
+    {
+        grown = pageRound((m_alocatedArray * m_growthFactor) / NoGrowth);
+    }
+
+    return t_max(grown, newCapacity);
+}
+
+template <class T>
+void cArray<T>::reallocArray(uint newCapacity, uint count)
+{
+    ASSERT(count <= newCapacity);
+
+    m_array = Storage::reallocate(m_array, m_alocatedArray, newCapacity,
+                                  count, m_allocator);
+    m_alocatedArray = newCapacity;
 }
 
 template <class T>
@@ -133,10 +358,7 @@ void cArray<T>::copyFrom(const cArray<T> &other)
 	// Create a new empty array at a default size and set the data
 	changeSize(other.m_size);
 
-	for (uint index = 0; index < other.m_size; index++)
-	{
-		m_array[index] = other.m_array[index];
-	}
+	Storage::copy(m_array, other.m_array, other.m_size);
 }
 
 template <class T>
@@ -159,13 +381,17 @@ template <class T>
 cArray<T> cArray<T>::operator + (const cArray<T>& other)
 {
 	// Create new object, append the data and return it.
-	return (cArray<T>(*this) += other);
+	cArray<T> ret(*this);
+	ret.append(other);
+	return ret;
 }
 template <class T>
 cArray<T> cArray<T>::operator + (const T & object)
 {
 	// Create new object, append the data and return it.
-	return (cArray<T>(*this) += object);
+	cArray<T> ret(*this);
+	ret.append(object);
+	return ret;
 }
 
 
@@ -195,7 +421,7 @@ void cArray<T>::freeArray()
 	if (m_array != NULL)
 	{
 		/* Need to deallocate the memory */
-		delete [] m_array;
+		Storage::free(m_array, m_alocatedArray, m_allocator);
 		m_array = NULL;
 	}
 	m_size = 0;
@@ -220,12 +446,79 @@ void cArray<T>::setPageSize(uint newPageSize)
     m_pageSize = newPageSize;
 }
 
+template <class T>
+uint cArray<T>::getCapacity() const
+{
+    return m_alocatedArray;
+}
+
+template <class T>
+void cArray<T>::reserve(uint capacity)
+{
+    if (capacity > m_alocatedArray)
+    {
+        reallocArray(capacity, m_size);
+    }
+}
+
+template <class T>
+void cArray<T>::shrinkToFit()
+{
+    if (m_size == 0)
+    {
+        freeArray();
+        return;
+    }
+
+    uint newCapacity = pageRound(m_size);
+    if (newCapacity < m_alocatedArray)
+    {
+        reallocArray(newCapacity, m_size);
+    }
+}
+
+template <class T>
+uint cArray<T>::getGrowthFactor() const
+{
+    return m_growthFactor;
+}
+
+template <class T>
+void cArray<T>::setGrowthFactor(uint percent)
+{
+    if (percent < NoGrowth)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    m_growthFactor = percent;
+}
+
 template <class T>
 void cArray<T>::swap(cArray<T>& other)
 {
     t_swap(m_array, other.m_array);
     t_swap(m_size, other.m_size);
     t_swap(m_alocatedArray, other.m_alocatedArray);
+    t_swap(m_allocator, other.m_allocator);
+}
+
+template <class T>
+void cArray<T>::setAllocator(cAllocator* allocator)
+{
+    if (m_size != 0)
+    {
+        XSTL_THROW(cException, EXCEPTION_FAILED);
+    }
+
+    // Release the unused memory of the previous allocator
+    freeArray();
+    m_allocator = allocator;
+}
+
+template <class T>
+cAllocator* cArray<T>::getAllocator() const
+{
+    return m_allocator;
 }
 
 template <class T>
@@ -269,52 +562,29 @@ void cArray<T>::changeSize(uint newSize,
 	{
 		if (preserveMemory)
 		{
-			uint index     = 0;
-			uint new_alloc = pageRound(newSize);
-			T *buffer;
-
-			/* Create a new buffer and copy the data to it, if needed */
-			if ((uint)t_abs((int)new_alloc - (int)m_alocatedArray) >= m_pageSize)
+			if (newSize > m_alocatedArray)
 			{
-				/* Need to realloc the buffer */
-				buffer = new T[new_alloc];
-                if (buffer == NULL)
-                {
-                        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
-                }
-
-				if (m_array != NULL)
+				/* Expand the buffer geometrically */
+				reallocArray(growCapacity(newSize), m_size);
+			} else if (newSize < m_size)
+			{
+				/* Release the buffer only if most of it is unused */
+				uint new_alloc = pageRound(newSize);
+				if ((new_alloc <= (m_alocatedArray / 4)) &&
+				    ((m_alocatedArray - new_alloc) >= m_pageSize))
 				{
-					for (index = 0; index < t_min(newSize, m_size); index++)
-					{
-						buffer[index] = m_array[index];
-					}
-					delete [] m_array;
+					reallocArray(new_alloc, newSize);
 				}
-
-				/* Assign the new array */
-				m_array = buffer;
-				m_size  = newSize;
-				m_alocatedArray = new_alloc;
-			} else
-			{
-				/* Just increase the space needed */
-				m_size = newSize;
 			}
+			m_size = newSize;
 		} else
 		{
 			/* Free the list and create a new one */
-			if (m_array != NULL)
-			{
-				delete [] m_array;
-			}
-			m_alocatedArray = pageRound(newSize);
-			m_array = new T[m_alocatedArray];
+			freeArray();
+			uint new_alloc = pageRound(newSize);
+			m_array = Storage::allocate(new_alloc, m_allocator);
+			m_alocatedArray = new_alloc;
 			m_size  = newSize;
-            if (m_array == NULL)
-            {
-                    XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
-            }
 		}
 	}
 }
@@ -346,10 +616,7 @@ void cArray<T>::append(const cArray<T>& array)
 	changeSize(m_size + array.m_size);
 
 	// Copy the rest of the data
-	for (uint i = 0; i < add_size; i++)
-	{
-		m_array[i + org_size] = array.m_array[i];
-	}
+	Storage::copy(m_array + org_size, array.m_array, add_size);
 }
 
 template <class T>
@@ -361,10 +628,7 @@ void cArray<T>::copyRange(const cArray<T>& other,
 	changeSize(count, false);
 
 	/* Copy the data */
-	for (uint i = 0; i < count; i++)
-	{
-		m_array[i] = other.m_array[i + startLocation];
-	}
+	Storage::copy(m_array, other.m_array + startLocation, count);
 }
 
 /*
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_CASEINSENSITIVESTRING_H
+#define __TBA_STL_CASEINSENSITIVESTRING_H
+
+/*
+ * caseInsensitiveString.h
+ *
+ * A string key which ignores the case of its letters.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+#include "xStl/types.h"
+#include "xStl/operators.h"
+#include "xStl/data/string.h"
+#include "xStl/data/hashFunction.h"
+
+/*
+ * cCaseInsensitiveString
+ *
+ * Wraps a cString for the hash tables and the sorted containers. The
+ * comparison and the hash-value of the key ignore the case of the ASCII
+ * letters (See cStringCase), without making a lower-case copy of the string.
+ * The original string is kept as is.
+ *
+ * Usage:
+ *    cHash<cCaseInsensitiveString, int> headers;
+ *    headers.append(cString(XSTL_STRING("Content-Length")), 10);
+ *    headers[cString(XSTL_STRING("content-length"))];    // Returns 10
+ */
+class cCaseInsensitiveString
+{
+public:
+    /*
+     * Constructor. Copies 'string' (See cString copy-constructor).
+     */
+    cCaseInsensitiveString(const cString& string = cString());
+
+    /*
+     * Return the original string.
+     */
+    const cString& getString() const;
+
+    /*
+     * Case insensitive comparison of the strings.
+     */
+    bool operator == (const cCaseInsensitiveString& other) const;
+    bool operator <  (const cCaseInsensitiveString& other) const;
+    MAKE_SIMPLE_OPERATORS(cCaseInsensitiveString);
+
+private:
+    // The original string
+    cString m_string;
+};
+
+/*
+ * The hash functions of the key. See hash.h and hashFunction.h
+ */
+uint cHashFunction(const cCaseInsensitiveString& index, uint range);
+hashValue cHashCode(const cCaseInsensitiveString& index, hashValue seed);
+
+#endif // __TBA_STL_CASEINSENSITIVESTRING_H
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_CONCURRENTHASH_H
+#define __TBA_STL_CONCURRENTHASH_H
+
+/*
+ * concurrentHash.h
+ *
+ * Interface of the template "concurrent-hash" class. A hash table which can be
+ * shared between threads without an external lock.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+#include "xStl/types.h"
+#include "xStl/data/list.h"
+#include "xStl/data/hash.h"
+#include "xStl/os/mutex.h"
+#include "xStl/os/interlocked.h"
+
+#ifdef XSTL_WINDOWS
+// Template classes might not use all the local functions the interface has
+// to ofer. Warning C4505 should be over-written for template functions
+#pragma warning(push)
+#pragma warning(disable:4505)
+#endif
+
+/*
+ * class cConcurrentHash
+ *
+ * A thread-safe hash table with the cHash vocabulary.
+ *
+ * Readers (hasKey, tryGet, operator [], keys) never lock. They walk the
+ * link-lists of the table while writers are changing it, so the elements are
+ * never changed in place:
+ *   - A new element is fully constructed and then published by a single
+ *     pointer write at the head of it's link-list.
+ *   - Assigning a new data to an existing index replaces the whole element.
+ *   - Resizing the table copies all the elements into a new table which is
+ *     published by a single pointer write.
+ *
+ * Writers lock one of StripesCount mutexes, selected by the cell of the
+ * index, so writers of different cells run in parallel. Resizing the table
+ * locks all the stripes.
+ *
+ * Removed elements and old tables are not freed immediately, since readers
+ * might still use them. They are freed once all the readers which were
+ * running during their removal are done. The readers are counted by two
+ * counter generations, and every thread uses it's own counter slot in order
+ * to reduce the cache-line sharing between readers.
+ *
+ * NOTES:
+ *   IndexType must have a complete implementation of operator ==
+ *   IndexType must have an hash function (See cHash)
+ *   The data is returned by value, since a reference to an element might be
+ *   released by another thread.
+ *   The hash cannot be copied.
+ */
+template <class IndexType, class FiledType,
+          class HashFunction = cHashFunctor<IndexType> >
+class cConcurrentHash
+{
+public:
+    enum {
+        // The default number of cells in a new table. Must be power of two
+        DefaultCapacity = 256,
+        // The number of writers locks. Must be power of two
+        StripesCount = 64,
+        // The number of readers counters in each generation
+        ReaderSlots = 16,
+        // The number of removed elements which triggers their release
+        RetiredThreshold = 256
+    };
+
+    /*
+     * Constructor. Creates an empty hash table.
+     *
+     * capacity     - The initialize number of cells. Rounded up to the next
+     *                power of two.
+     * hashFunction - The function which translates keys into cells
+     */
+    explicit cConcurrentHash(uint capacity = DefaultCapacity,
+                             const HashFunction& hashFunction = HashFunction());
+
+    /*
+     * Destructor. Free all the elements. The hash must not be used by other
+     * threads anymore.
+     */
+    ~cConcurrentHash();
+
+    /* Hash functions */
+
+    /*
+     * Add an element to the hash. The element is copied.
+     *
+     * index - The new index for the object. Must be unique
+     * data  - The data to put in the cell
+     *
+     * Throws exception if the index exist
+     */
+    void append(const IndexType& index, const FiledType& data);
+
+    /*
+     * Add an element to the hash, or replace the data of an existing element.
+     *
+     * index - The index for the object
+     * data  - The data to put in the cell
+     */
+    void insertOrAssign(const IndexType& index, const FiledType& data);
+
+    /*
+     * Remove a item from the hash
+     *
+     * index - The element to remove
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' exception incase the index is invalid
+     */
+    void remove(const IndexType& index);
+
+    /*
+     * Remove all the elements from the hash. The capacity of the table is
+     * reset to the original capacity.
+     */
+    void removeAll();
+
+    /*
+     * Return a list of keys value. Elements which are added or removed during
+     * the call might not be listed.
+     *
+     * ret - Will be filled with the keys
+     */
+    void keys(cList<IndexType>& ret) const;
+
+    /*
+     * Returns a list of keys value in the function return coed
+     */
+    cList<IndexType> keys() const;
+
+    /*
+     * Return true if there is a key in the hash
+     *
+     * index - The index to be query
+     */
+    bool hasKey(const IndexType& index) const;
+
+    /*
+     * Search for an element without throwing exception.
+     *
+     * index - The index for the hash table
+     * data  - Will be filled with a copy of the data incase the index exist
+     *
+     * Return true if the index was found
+     */
+    bool tryGet(const IndexType& index, FiledType& data) const;
+
+    /*
+     * Return the number of elements stored in the hash
+     */
+    uint length() const;
+
+    /*
+     * Return the number of cells of the table
+     */
+    uint getCapacity() const;
+
+    // Operators
+
+    /*
+     * The map operator. Retrieve index-type and return a copy of the object.
+     *
+     * index - The index for the hash table
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' exception when the index is invalid
+     */
+    FiledType operator [] (const IndexType& index) const;
+
+private:
+    // Deny copy-constructor and operator =
+    cConcurrentHash(const cConcurrentHash<IndexType, FiledType, HashFunction>& other);
+    cConcurrentHash<IndexType, FiledType, HashFunction>& operator =
+        (const cConcurrentHash<IndexType, FiledType, HashFunction>& other);
+
+    enum {
+        // The number of counters in a single cache-line. Every reader slot
+        // uses it's own cache-line
+        CounterPadding = 64 / sizeof(counter_t)
+    };
+
+    /*
+     * A single element. The element is never changed after it was published
+     * except for the 'm_next' pointer.
+     */
+    class Node
+    {
+    public:
+        // Constructor
+        Node(const IndexType& index, const FiledType& data, Node* next) :
+            m_index(index), m_data(data), m_next(next), m_retiredNext(NULL) {}
+
+        // The key of the element
+        IndexType m_index;
+        // The stored data
+        FiledType m_data;
+        // The next element in the link-list
+        Node* volatile m_next;
+        // The next element in the retired elements list
+        Node* m_retiredNext;
+    };
+
+    /*
+     * The table of the link-lists
+     */
+    class Table
+    {
+    public:
+        // Constructor. Creates 'size' empty link-lists.
+        Table(uint size);
+        // Destructor. Free the cells array (but not the elements)
+        ~Table();
+        // Free all the elements of the table
+        void freeNodes();
+
+        // The number of cells
+        uint m_size;
+        // The head of each link-list
+        Node* volatile* m_buckets;
+        // The next table in the retired tables list
+        Table* m_retiredNext;
+    };
+
+    /*
+     * Register a running reader for the life-time of the object.
+     */
+    class ReadGuard
+    {
+    public:
+        // Constructor. Register the reader
+        ReadGuard(const cConcurrentHash<IndexType, FiledType, HashFunction>& owner);
+        // Destructor. Unregister the reader
+        ~ReadGuard();
+    private:
+        // The counter of the reader
+        volatile counter_t* m_counter;
+    };
+    friend class ReadGuard;
+
+    /*
+     * Load a pointer which was published by another thread
+     */
+    static Node* loadNode(Node* const volatile* pointer);
+
+    /*
+     * Publish a pointer to other threads
+     */
+    static void storeNode(Node* volatile* pointer, Node* node);
+
+    /*
+     * Return the current table. Valid for readers, or for writers which holds
+     * at least one of the stripes.
+     */
+    Table* getTable() const;
+
+    /*
+     * Return the smallest power of two which is greater or equal to 'count'
+     */
+    static uint roundCapacity(uint count);
+
+    /*
+     * Return the element of 'index', or NULL if the index doesn't exist.
+     * Must be called by a reader.
+     */
+    const Node* find(const IndexType& index) const;
+
+    /*
+     * Return the stripe which protects the cell of 'index' in a table with
+     * 'capacity' cells.
+     */
+    uint getStripe(const IndexType& index, uint capacity) const;
+
+    /*
+     * Return the pointer which points to the element of 'index'. If the index
+     * doesn't exist, returns the pointer to the end of the link-list.
+     * Must be called by a writer which holds the stripe of 'index'.
+     */
+    Node* volatile* findLink(const IndexType& index);
+
+    /*
+     * Lock all the stripes (in order) and release them.
+     */
+    void lockAllStripes();
+    void unlockAllStripes();
+
+    /*
+     * Grow the table if the number of elements exceeds the number of cells.
+     */
+    void growIfNeeded();
+
+    /*
+     * Move all the elements into a table with 'newSize' cells.
+     */
+    void resize(uint newSize);
+
+    /*
+     * Queue a removed element to be freed once all the current readers are
+     * done.
+     */
+    void retireNode(Node* node);
+
+    /*
+     * Queue a replaced table and all it's elements to be freed once all the
+     * current readers are done.
+     */
+    void retireTable(Table* table);
+
+    /*
+     * Free all the retired elements and tables which are not in use by any
+     * reader. Blocks until the current readers are done.
+     */
+    void reclaim();
+
+    // The function which translates keys into cells
+    HashFunction m_hashFunction;
+    // The capacity the table was constructed with. Used by removeAll()
+    uint m_initCapacity;
+    // The current table
+    Table* volatile m_table;
+    // The number of cells of the current table. Changed only when all the
+    // stripes are locked
+    volatile uint m_capacity;
+    // The number of elements
+    volatile counter_t m_count;
+    // The writers locks
+    cMutex m_stripes[StripesCount];
+
+    // The current readers generation
+    volatile counter_t m_epoch;
+    // The readers counters. 2 generations * ReaderSlots * CounterPadding
+    volatile counter_t* m_readers;
+
+    // Protect the retired lists
+    cMutex m_retiredLock;
+    // Only a single thread can free the retired lists
+    cMutex m_reclaimLock;
+    // The retired elements
+    Node* m_retiredNodes;
+    // The retired tables
+    Table* m_retiredTables;
+    // The number of retired elements
+    uint m_retiredCount;
+};
+
+// Include the implementation of the hash in the template .h file
+#include "xStl/data/concurrentHash.inl"
+
+#ifdef XSTL_WINDOWS
+    // Restore the warning levels
+    #pragma warning(pop)
+#endif
+
+#endif // __TBA_STL_CONCURRENTHASH_H
@@ -0,0 +1,589 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * concurrentHash.inl
+ *
+ * Implementation code of the cConcurrentHash template class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/trace.h"
+#include "xStl/except/assert.h"
+#include "xStl/except/exception.h"
+#include "xStl/os/os.h"
+#include "xStl/os/lock.h"
+#include "xStl/os/thread.h"
+#include "xStl/data/concurrentHash.h"
+
+template <class IndexType, class FiledType, class HashFunction>
+cConcurrentHash<IndexType, FiledType, HashFunction>::Table::Table(uint size) :
+    m_size(size),
+    m_buckets(NULL),
+    m_retiredNext(NULL)
+{
+    m_buckets = new Node*[size];
+    for (uint i = 0; i < size; i++)
+    {
+        m_buckets[i] = NULL;
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cConcurrentHash<IndexType, FiledType, HashFunction>::Table::~Table()
+{
+    delete[] m_buckets;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::Table::freeNodes()
+{
+    for (uint i = 0; i < m_size; i++)
+    {
+        Node* node = m_buckets[i];
+        while (node != NULL)
+        {
+            Node* next = node->m_next;
+            delete node;
+            node = next;
+        }
+        m_buckets[i] = NULL;
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cConcurrentHash<IndexType, FiledType, HashFunction>::ReadGuard::ReadGuard(
+        const cConcurrentHash<IndexType, FiledType, HashFunction>& owner) :
+    m_counter(NULL)
+{
+    // Every thread uses it's own counter
+    uint slot = cHashFunction(cThread::getCurrentThreadHandle(), ReaderSlots);
+
+    for (;;)
+    {
+        counter_t epoch = cInterlocked::load(&owner.m_epoch);
+        m_counter = owner.m_readers +
+                    (((epoch & 1) * ReaderSlots) + slot) * CounterPadding;
+        cInterlocked::increment(m_counter);
+
+        // Make sure that the reader is registered in the current generation
+        if (cInterlocked::load(&owner.m_epoch) == epoch)
+            break;
+
+        cInterlocked::decrement(m_counter);
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cConcurrentHash<IndexType, FiledType, HashFunction>::ReadGuard::~ReadGuard()
+{
+    cInterlocked::decrement(m_counter);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cConcurrentHash<IndexType, FiledType, HashFunction>::cConcurrentHash(
+        uint capacity /* = DefaultCapacity */,
+        const HashFunction& hashFunction /* = HashFunction() */) :
+    m_hashFunction(hashFunction),
+    m_initCapacity(roundCapacity(capacity)),
+    m_table(NULL),
+    m_capacity(0),
+    m_count(0),
+    m_epoch(0),
+    m_readers(NULL),
+    m_retiredNodes(NULL),
+    m_retiredTables(NULL),
+    m_retiredCount(0)
+{
+    uint readers = 2 * ReaderSlots * CounterPadding;
+    m_readers = new counter_t[readers];
+    for (uint i = 0; i < readers; i++)
+    {
+        m_readers[i] = 0;
+    }
+
+    m_table = new Table(m_initCapacity);
+    m_capacity = m_initCapacity;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cConcurrentHash<IndexType, FiledType, HashFunction>::~cConcurrentHash()
+{
+    // There are no more readers.
+    Table* table = m_table;
+    table->freeNodes();
+    delete table;
+
+    while (m_retiredNodes != NULL)
+    {
+        Node* next = m_retiredNodes->m_retiredNext;
+        delete m_retiredNodes;
+        m_retiredNodes = next;
+    }
+    while (m_retiredTables != NULL)
+    {
+        Table* next = m_retiredTables->m_retiredNext;
+        delete m_retiredTables;
+        m_retiredTables = next;
+    }
+
+    delete[] m_readers;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+typename cConcurrentHash<IndexType, FiledType, HashFunction>::Node*
+    cConcurrentHash<IndexType, FiledType, HashFunction>::loadNode(Node* const volatile* pointer)
+{
+    return (Node*)cInterlocked::loadPointer((void* const volatile*)pointer);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::storeNode(Node* volatile* pointer,
+                                                                    Node* node)
+{
+    cInterlocked::storePointer((void* volatile*)pointer, node);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+typename cConcurrentHash<IndexType, FiledType, HashFunction>::Table*
+    cConcurrentHash<IndexType, FiledType, HashFunction>::getTable() const
+{
+    return (Table*)cInterlocked::loadPointer((void* const volatile*)&m_table);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cConcurrentHash<IndexType, FiledType, HashFunction>::roundCapacity(uint count)
+{
+    uint ret = 1;
+    while (ret < count)
+    {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+const typename cConcurrentHash<IndexType, FiledType, HashFunction>::Node*
+    cConcurrentHash<IndexType, FiledType, HashFunction>::find(const IndexType& index) const
+{
+    const Table* table = getTable();
+    Node* node = loadNode(&table->m_buckets[m_hashFunction(index, table->m_size)]);
+    while (node != NULL)
+    {
+        if (node->m_index == index)
+            return node;
+        node = loadNode(&node->m_next);
+    }
+
+    return NULL;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cConcurrentHash<IndexType, FiledType, HashFunction>::getStripe(const IndexType& index,
+                                                                    uint capacity) const
+{
+    return m_hashFunction(index, capacity) & (StripesCount - 1);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+typename cConcurrentHash<IndexType, FiledType, HashFunction>::Node* volatile*
+    cConcurrentHash<IndexType, FiledType, HashFunction>::findLink(const IndexType& index)
+{
+    // The table cannot be replaced while the stripe is locked
+    Table* table = m_table;
+    Node* volatile* link = &table->m_buckets[m_hashFunction(index, table->m_size)];
+
+    // Only the owner of the stripe changes the link-list
+    Node* node;
+    while ((node = *link) != NULL)
+    {
+        if (node->m_index == index)
+            break;
+        link = &node->m_next;
+    }
+
+    return link;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::lockAllStripes()
+{
+    // Always lock in the same order, so two threads cannot deadlock
+    for (uint i = 0; i < StripesCount; i++)
+    {
+        m_stripes[i].lock();
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::unlockAllStripes()
+{
+    for (uint i = StripesCount; i > 0; i--)
+    {
+        m_stripes[i - 1].unlock();
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::append(const IndexType& index,
+                                                                 const FiledType& data)
+{
+    bool isExist;
+    for (;;)
+    {
+        uint capacity = m_capacity;
+        cLock lock(m_stripes[getStripe(index, capacity)]);
+        if (capacity != m_capacity)
+        {
+            // The table was resized before the stripe was locked
+            continue;
+        }
+
+        Node* volatile* link = findLink(index);
+        isExist = (*link != NULL);
+        if (!isExist)
+        {
+            storeNode(link, new Node(index, data, NULL));
+            cInterlocked::increment(&m_count);
+        }
+        break;
+    }
+
+    // Test that the object is unique
+    CHECK(!isExist);
+
+    growIfNeeded();
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::insertOrAssign(const IndexType& index,
+                                                                         const FiledType& data)
+{
+    Node* replaced;
+    for (;;)
+    {
+        uint capacity = m_capacity;
+        cLock lock(m_stripes[getStripe(index, capacity)]);
+        if (capacity != m_capacity)
+        {
+            // The table was resized before the stripe was locked
+            continue;
+        }
+
+        Node* volatile* link = findLink(index);
+        replaced = *link;
+        if (replaced == NULL)
+        {
+            storeNode(link, new Node(index, data, NULL));
+            cInterlocked::increment(&m_count);
+        } else
+        {
+            // Readers might still use the old element, replace it
+            storeNode(link, new Node(index, data, replaced->m_next));
+        }
+        break;
+    }
+
+    if (replaced != NULL)
+    {
+        retireNode(replaced);
+    } else
+    {
+        growIfNeeded();
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::remove(const IndexType& index)
+{
+    Node* removed;
+    for (;;)
+    {
+        uint capacity = m_capacity;
+        cLock lock(m_stripes[getStripe(index, capacity)]);
+        if (capacity != m_capacity)
+        {
+            // The table was resized before the stripe was locked
+            continue;
+        }
+
+        Node* volatile* link = findLink(index);
+        removed = *link;
+        if (removed != NULL)
+        {
+            // The removed element still points to the rest of the list, so
+            // readers which are standing on it can continue
+            storeNode(link, removed->m_next);
+            cInterlocked::decrement(&m_count);
+        }
+        break;
+    }
+
+    if (removed == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+
+    retireNode(removed);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::removeAll()
+{
+    Table* newTable = new Table(m_initCapacity);
+
+    lockAllStripes();
+    Table* oldTable = m_table;
+    cInterlocked::storePointer((void* volatile*)&m_table, newTable);
+    m_capacity = m_initCapacity;
+    cInterlocked::exchange(&m_count, 0);
+    unlockAllStripes();
+
+    retireTable(oldTable);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::growIfNeeded()
+{
+    uint capacity = m_capacity;
+    if ((uint)cInterlocked::load(&m_count) > capacity)
+    {
+        resize(capacity * 2);
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::resize(uint newSize)
+{
+    Table* oldTable = NULL;
+    Table* newTable = NULL;
+
+    lockAllStripes();
+    XSTL_TRY
+    {
+        // Another thread might already resized the table
+        if (m_capacity < newSize)
+        {
+            oldTable = m_table;
+            newTable = new Table(newSize);
+
+            // Copy the elements, since readers might still walk the old table
+            for (uint i = 0; i < oldTable->m_size; i++)
+            {
+                for (Node* node = oldTable->m_buckets[i]; node != NULL;
+                     node = node->m_next)
+                {
+                    Node* volatile* bucket =
+                        &newTable->m_buckets[m_hashFunction(node->m_index, newSize)];
+                    *bucket = new Node(node->m_index, node->m_data, *bucket);
+                }
+            }
+
+            // Publish the new table
+            cInterlocked::storePointer((void* volatile*)&m_table, newTable);
+            m_capacity = newSize;
+        }
+    }
+    XSTL_CATCH_ALL
+    {
+        unlockAllStripes();
+        if (newTable != NULL)
+        {
+            newTable->freeNodes();
+            delete newTable;
+        }
+        XSTL_RETHROW;
+    }
+    unlockAllStripes();
+
+    if (oldTable != NULL)
+    {
+        retireTable(oldTable);
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::retireNode(Node* node)
+{
+    bool shouldReclaim;
+    {
+        cLock lock(m_retiredLock);
+        node->m_retiredNext = m_retiredNodes;
+        m_retiredNodes = node;
+        m_retiredCount++;
+        shouldReclaim = (m_retiredCount >= RetiredThreshold);
+    }
+
+    if (shouldReclaim)
+    {
+        reclaim();
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::retireTable(Table* table)
+{
+    {
+        cLock lock(m_retiredLock);
+        for (uint i = 0; i < table->m_size; i++)
+        {
+            for (Node* node = table->m_buckets[i]; node != NULL; node = node->m_next)
+            {
+                node->m_retiredNext = m_retiredNodes;
+                m_retiredNodes = node;
+                m_retiredCount++;
+            }
+        }
+        table->m_retiredNext = m_retiredTables;
+        m_retiredTables = table;
+    }
+
+    reclaim();
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::reclaim()
+{
+    cLock reclaimLock(m_reclaimLock);
+
+    // Take the current retired lists. Elements retired from now on will be
+    // freed by the next call
+    Node* nodes;
+    Table* tables;
+    {
+        cLock lock(m_retiredLock);
+        nodes = m_retiredNodes;
+        tables = m_retiredTables;
+        m_retiredNodes = NULL;
+        m_retiredTables = NULL;
+        m_retiredCount = 0;
+    }
+
+    if ((nodes == NULL) && (tables == NULL))
+        return;
+
+    // Start a new readers generation. New readers cannot reach the retired
+    // elements, so wait until all the readers of the previous generation are
+    // done. (The readers of the generation before were drained by the
+    // previous call)
+    counter_t epoch = cInterlocked::exchangeAdd(&m_epoch, 1);
+    volatile counter_t* readers = m_readers +
+                                  ((epoch & 1) * ReaderSlots * CounterPadding);
+    for (uint i = 0; i < ReaderSlots; i++)
+    {
+        while (cInterlocked::load(readers + (i * CounterPadding)) != 0)
+        {
+            cOS::sleepMillisecond(0);
+        }
+    }
+
+    while (nodes != NULL)
+    {
+        Node* next = nodes->m_retiredNext;
+        delete nodes;
+        nodes = next;
+    }
+    while (tables != NULL)
+    {
+        Table* next = tables->m_retiredNext;
+        delete tables;
+        tables = next;
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cConcurrentHash<IndexType, FiledType, HashFunction>::keys(cList<IndexType>& ret) const
+{
+    ReadGuard guard(*this);
+    const Table* table = getTable();
+    for (uint i = 0; i < table->m_size; i++)
+    {
+        for (Node* node = loadNode(&table->m_buckets[i]); node != NULL;
+             node = loadNode(&node->m_next))
+        {
+            ret.append(node->m_index);
+        }
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cList<IndexType> cConcurrentHash<IndexType, FiledType, HashFunction>::keys() const
+{
+    cList<IndexType> ret;
+    keys(ret);
+    return ret;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cConcurrentHash<IndexType, FiledType, HashFunction>::hasKey(const IndexType& index) const
+{
+    ReadGuard guard(*this);
+    return find(index) != NULL;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cConcurrentHash<IndexType, FiledType, HashFunction>::tryGet(const IndexType& index,
+                                                                 FiledType& data) const
+{
+    ReadGuard guard(*this);
+    const Node* node = find(index);
+    if (node == NULL)
+        return false;
+
+    data = node->m_data;
+    return true;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cConcurrentHash<IndexType, FiledType, HashFunction>::length() const
+{
+    return (uint)cInterlocked::load(&m_count);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cConcurrentHash<IndexType, FiledType, HashFunction>::getCapacity() const
+{
+    return m_capacity;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+FiledType cConcurrentHash<IndexType, FiledType, HashFunction>::operator [] (const IndexType& index) const
+{
+    ReadGuard guard(*this);
+    const Node* node = find(index);
+    if (node == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+
+    return node->m_data;
+}
@@ -41,7 +41,6 @@
  */
 
 #include "xStl/types.h"
-#include "xStl/os/xstlLockable.h"
 
 
 /*
@@ -52,7 +51,11 @@ class cTestCounter;
 /*
  * cCounter
  *
- * A safe counter. A counter which thread-safe and protect using a mutex.
+ * A safe counter. The counter is thread-safe and lock-free: All the
+ * operations are atomic instructions (See cInterlocked) which are also full
+ * memory barriers, so a thread which decreases a reference count to zero sees
+ * all the changes which the other owners made before they released their
+ * references.
  */
 class cCounter
 {
@@ -100,12 +103,6 @@ private:
     // The value of the counter
     volatile counter_t m_value;
 
-    // Windows NT kernel-mode and user mode contains build-in functions
-    #if (!(defined(XSTL_NTDDK) || defined(XSTL_WINDOWS) || defined(XSTL_CE)))
-        // The lock for the counter
-        cXstlLockable m_lock;
-    #endif
-
     /*
      * Prevent copy-constructor and operator =.
      */
@@ -42,6 +42,7 @@
 #include "xStl/types.h"
 #include "xStl/data/char.h"
 #include "xStl/data/string.h"
+#include "xStl/data/stringBuilder.h"
 #include "xStl/data/array.h"
 
 #ifdef XSTL_WINDOWS
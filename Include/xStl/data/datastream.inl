@@ -45,6 +45,7 @@ OSTREAM & hexDumpObject(OSTREAM &out, DUMP<FW_ITR, DT>& object)
 	unsigned int objectLocation = 0;/* The position in the object that dumped */
 	const unsigned int objectSize = sizeof(DT);       /* size of each element */
 	cBuffer data(object.m_elementsInRow);  /* The char display of data at end */
+	cStringBuilder line(256);    /* The current line, written to out at once */
 
 	while (index != object.m_end)
 	{
@@ -54,20 +55,20 @@ OSTREAM & hexDumpObject(OSTREAM &out, DUMP<FW_ITR, DT>& object)
 			if (object.m_segmentName != NULL)
 			{
 				// Print the segment name
-				out << object.m_segmentName << ":";
+				line << object.m_segmentName << ":";
 			}
             if (object.m_flags & DUMP<FW_ITR, DT>::DATA_USE_ADDRESS)
 			{
-                out << HEXADDRESS(address) << "   ";
+                line << HEXADDRESS(address) << "   ";
 			}
 		}
 
 		/* Write the element */
 		unsigned char db = *((unsigned char *)(&(*index)) + objectLocation); /* The element in the queue*/
 		data[element] = DB(db); // Save the data
-		out << (char)(HEXHIGH(db)) << (char)(HEXLOW(db));
+		line << (char)(HEXHIGH(db)) << (char)(HEXLOW(db));
 		if ((element & 1) != 0)
-			out << " ";
+			line << " ";
 
 		/*
 		 * Only if the inner index location is printed
@@ -88,9 +89,12 @@ OSTREAM & hexDumpObject(OSTREAM &out, DUMP<FW_ITR, DT>& object)
 			/* Flash data */
 			for (unsigned int i = 0; i < object.m_elementsInRow; i++)
 			{
-				out << (char)(data[i]);
+				line << (char)(data[i]);
 			}
-			out << endl;
+			line << endl;
+			/* Write the whole line at once */
+			out << line.toString();
+			line.clear();
 		}
 	}
 
@@ -100,15 +104,16 @@ OSTREAM & hexDumpObject(OSTREAM &out, DUMP<FW_ITR, DT>& object)
 		unsigned int i;
 		for (i = 0; i < (object.m_elementsInRow - element); i++)
 		{
-			out << "  ";
+			line << "  ";
 			if (((i + element) & 1) != 0)
-				out << " ";
+				line << " ";
 		}
 		for (i = 0; i < element; i++)
 		{
-			out << (char)(data[i]);
+			line << (char)(data[i]);
 		}
-		out << endl;
+		line << endl;
+		out << line.toString();
 	}
 
 	return out;
@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_DEQUE_H
+#define __TBA_STL_DEQUE_H
+
+/*
+ * deque.h
+ *
+ * Contains the declaration of a double-ended queue, which stores the elements
+ * in fixed-size blocks.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/operators.h"
+#include "xStl/except/exception.h"
+#include "xStl/except/assert.h"
+#include "xStl/utils/algorithm.h"
+
+#ifdef XSTL_WINDOWS
+// Template classes might not use all the local functions the interface has
+// to ofer. Warning C4505 should be over-written for template functions
+#pragma warning(push)
+#pragma warning(disable:4505)
+#endif
+
+/*
+ * template cDeque class
+ *
+ * A sequence which can grow and shrink in both ends. The elements are stored
+ * in blocks of 'BlockBytes' bytes, and a table (the map) points to the blocks
+ * in their order. Appending to any end of the deque never moves the other
+ * elements, so references to elements stays valid until the element is
+ * removed. Iterating the deque scans the elements of each block one after
+ * the other, and access by index is constant time.
+ *
+ * Compared to cList, the elements are not allocated one by one and there are
+ * no links to follow, but elements can be removed only from the two ends.
+ *
+ * Any change of the deque invalidates its iterators.
+ *
+ * requires from T:
+ *  T should have copy constructor.
+ *
+ * NOTE: This class is not thread-safe
+ */
+template <class T>
+class cDeque
+{
+private:
+    /*
+     * The storage of a single element inside a block. The element is
+     * constructed in the block memory.
+     */
+    class Element
+    {
+    public:
+        Element(const T& value) : m_value(value) {}
+
+        #ifdef XSTL_CPP11
+        template <class... Args>
+        Element(Args&&... args) : m_value(t_forward<Args>(args)...) {}
+        #endif
+
+        static void* operator new(size_t, void* position)
+        {
+            return position;
+        }
+
+        static void operator delete(void*, void*)
+        {
+        }
+
+        // The element
+        T m_value;
+    };
+
+public:
+    enum {
+        // The number of bytes in a block
+        BlockBytes = 512,
+        // The number of elements in a block
+        BlockElements = (sizeof(T) < BlockBytes) ? (BlockBytes / sizeof(T)) :
+                                                   1
+    };
+
+    // Forward declaration of the iterator class.
+    class iterator;
+
+    /*
+     * Constructor. Create an empty deque. No memory is allocated until the
+     * first element is added.
+     */
+    cDeque();
+
+    /*
+     * Copy constructor. Copies all the elements of 'other'.
+     */
+    cDeque(const cDeque<T>& other);
+
+    #ifdef XSTL_CPP11
+    /*
+     * Move constructor. Take the elements of 'other', which becomes empty.
+     */
+    cDeque(cDeque<T>&& other);
+    #endif
+
+    /*
+     * Destructor. Destruct all the elements and free the memory.
+     */
+    ~cDeque();
+
+    /*
+     * Add a copy of 'object' to the end of the deque.
+     *
+     * Throws out of memory exception.
+     */
+    void append(const T& object);
+
+    #ifdef XSTL_CPP11
+    /*
+     * Construct a new element at the end of the deque from 'args' and return
+     * it.
+     *
+     * NOTE: Microsoft visual studio .NET version 7.10 cannot compile the
+     *       code of the function if it's found outside the class deceleration.
+     */
+    template <class... Args>
+    T& emplace(Args&&... args)
+    {
+        Element* element = new (reserveLast()) Element(t_forward<Args>(args)...);
+        m_length++;
+        return element->m_value;
+    }
+    #endif
+
+    /*
+     * Add a copy of 'object' to the beginning of the deque. Same as
+     * cList::insert(const T&).
+     *
+     * Throws out of memory exception.
+     */
+    void insert(const T& object);
+
+    /*
+     * Remove the first or the last element.
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' if the deque is empty.
+     */
+    void removeFirst();
+    void removeLast();
+
+    /*
+     * Return the first or the last element.
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' if the deque is empty.
+     */
+    T& getFirst();
+    const T& getFirst() const;
+    T& getLast();
+    const T& getLast() const;
+
+    /*
+     * Return the element at 'index'. The first element is at index 0.
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' if 'index' is not less than 'length()'.
+     */
+    T& operator [] (uint index);
+    const T& operator [] (uint index) const;
+
+    /*
+     * Return the number of elements
+     */
+    uint length() const;
+
+    /*
+     * Return true if the deque has no elements
+     */
+    bool isEmpty() const;
+
+    /*
+     * Remove all the elements and free the blocks.
+     */
+    void removeAll();
+
+    /*
+     * Exchange the elements of the deques. No element is copied.
+     */
+    void swap(cDeque<T>& other);
+
+    /*
+     * Copy operator. Copies all the elements of 'other'.
+     */
+    cDeque<T>& operator = (const cDeque<T>& other);
+
+    #ifdef XSTL_CPP11
+    /*
+     * Move operator. Exchange the elements with 'other', so no element is
+     * copied or allocated.
+     */
+    cDeque<T>& operator = (cDeque<T>&& other);
+    #endif
+
+    /*
+     * Return an iterator to the first element, or to the end of the deque.
+     *
+     * NOTE: Although the functions are declared as const, the iterators can
+     *       be used for non const operation.
+     */
+    iterator begin() const
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end() const
+    {
+        return iterator(this, m_length);
+    }
+
+    /*
+     * iterator class
+     *
+     * Inline interface + definition of the iterator class which access the
+     * deque as a bidirectional iterator. The iterator points to the element
+     * inside the block, so moving to the next element in the same block
+     * doesn't read the map.
+     */
+    friend class iterator;
+    class iterator
+    {
+    friend class cDeque<T>;
+    public:
+        /*
+         * Constructor. Used only in the cDeque class.
+         */
+        iterator(const cDeque<T>* deque, uint index) :
+            m_deque(deque),
+            m_index(index)
+        {
+            locate();
+        }
+
+        /*
+         * Going to the next element in the deque.
+         */
+        void next()
+        {
+            m_index++;
+            m_current++;
+            if (m_current == m_blockEnd)
+                locate();
+        }
+
+        /*
+         * Going to the previous element in the deque.
+         */
+        void prev()
+        {
+            ASSERT(m_index > 0);
+            m_index--;
+            locate();
+        }
+
+        /*
+         * Return whether two iterator points to the same location.
+         */
+        bool operator == (const iterator& other) const
+        {
+            return (m_index == other.m_index) && (m_deque == other.m_deque);
+        }
+
+        /*
+         * Is iterator is less than other.
+         */
+        bool operator < (const iterator& other) const
+        {
+            return m_index < other.m_index;
+        }
+
+        /*
+         * Return a refrence to the data.
+         */
+        T& operator *()
+        {
+            ASSERT(m_index < m_deque->m_length);
+            return m_current->m_value;
+        }
+
+        const T& operator *() const
+        {
+            ASSERT(m_index < m_deque->m_length);
+            return m_current->m_value;
+        }
+
+        /*
+         * Implement operator >, !=, >=, <=
+         */
+        MAKE_SIMPLE_OPERATORS(iterator);
+
+        /*
+         * Implement the two operators ++ and the two operators --.
+         */
+        MAKE_INCREASE_OPERATORS(iterator);
+
+        /*
+         * Increase or decrease the iterator by number of elements.
+         */
+        iterator operator+ (const uint count) const
+        {
+            return iterator(m_deque, m_index + count);
+        }
+
+        iterator operator- (const uint count) const
+        {
+            ASSERT(m_index >= count);
+            return iterator(m_deque, m_index - count);
+        }
+
+    private:
+        /*
+         * Find the block and the element of 'm_index'.
+         */
+        void locate()
+        {
+            if (m_index < m_deque->m_length)
+            {
+                uint position = m_deque->m_start + m_index;
+                Element* block = m_deque->m_map[position / BlockElements];
+                m_current = block + (position % BlockElements);
+                m_blockEnd = block + BlockElements;
+            } else
+            {
+                // The end of the deque
+                m_current = NULL;
+                m_blockEnd = NULL;
+            }
+        }
+
+        // The deque
+        const cDeque<T>* m_deque;
+        // The index of the element
+        uint m_index;
+        // The element and the end of its block
+        Element* m_current;
+        Element* m_blockEnd;
+    };
+
+private:
+    enum {
+        // The number of blocks of the first map
+        InitialMapSize = 8
+    };
+
+    /*
+     * Return the memory for a new last or first element. The block of the
+     * element is allocated, and the map is grown if needed. The caller
+     * constructs the element and updates 'm_length' (and 'm_start').
+     *
+     * Throws out of memory exception.
+     */
+    Element* reserveLast();
+    Element* reserveFirst();
+
+    /*
+     * Allocate the block 'blockIndex' of the map, if it's not allocated.
+     */
+    void allocateBlock(uint blockIndex);
+
+    /*
+     * Release the block 'blockIndex' of the map.
+     */
+    void releaseBlock(uint blockIndex);
+
+    /*
+     * Move the blocks into a new map, so there are free blocks entries at
+     * the beginning and the end of the map.
+     */
+    void growMap();
+
+    /*
+     * Return the element at 'position', counted from the first element of the
+     * map.
+     */
+    Element* getElement(uint position) const;
+
+    // The table of the blocks. Entries which doesn't store elements are NULL
+    Element** m_map;
+    // The number of entries of the map
+    uint m_mapSize;
+    // The position of the first element, counted from the first element of
+    // the map.
+    uint m_start;
+    // The number of elements
+    uint m_length;
+    // A released block which is kept for the next allocation, so a deque
+    // which grows and shrinks around the end of a block doesn't allocate
+    // and free the block again and again.
+    Element* m_spareBlock;
+};
+
+// Include implementation. This is nessasary in template classes.
+#include "xStl/data/deque.inl"
+
+#ifdef XSTL_WINDOWS
+    // Return the warnning behaviour back to it's original mode
+    #pragma warning(pop)
+#endif
+
+#endif // __TBA_STL_DEQUE_H
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * deque.inl
+ *
+ * Implementation code of the cDeque class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/os/os.h"
+
+template <class T>
+cDeque<T>::cDeque() :
+    m_map(NULL),
+    m_mapSize(0),
+    m_start(0),
+    m_length(0),
+    m_spareBlock(NULL)
+{
+}
+
+template <class T>
+cDeque<T>::cDeque(const cDeque<T>& other) :
+    m_map(NULL),
+    m_mapSize(0),
+    m_start(0),
+    m_length(0),
+    m_spareBlock(NULL)
+{
+    for (iterator i = other.begin(); i != other.end(); ++i)
+        append(*i);
+}
+
+#ifdef XSTL_CPP11
+template <class T>
+cDeque<T>::cDeque(cDeque<T>&& other) :
+    m_map(NULL),
+    m_mapSize(0),
+    m_start(0),
+    m_length(0),
+    m_spareBlock(NULL)
+{
+    swap(other);
+}
+
+template <class T>
+cDeque<T>& cDeque<T>::operator = (cDeque<T>&& other)
+{
+    // 'other' receives the previous elements, which are freed by its owner
+    swap(other);
+    return *this;
+}
+#endif // XSTL_CPP11
+
+template <class T>
+cDeque<T>::~cDeque()
+{
+    removeAll();
+    if (m_spareBlock != NULL)
+        cOS::smallMemoryFree(m_spareBlock);
+    if (m_map != NULL)
+        cOS::smallMemoryFree(m_map);
+}
+
+template <class T>
+cDeque<T>& cDeque<T>::operator = (const cDeque<T>& other)
+{
+    if (this != &other)
+    {
+        removeAll();
+        for (iterator i = other.begin(); i != other.end(); ++i)
+            append(*i);
+    }
+    return *this;
+}
+
+template <class T>
+void cDeque<T>::swap(cDeque<T>& other)
+{
+    t_swap(m_map, other.m_map);
+    t_swap(m_mapSize, other.m_mapSize);
+    t_swap(m_start, other.m_start);
+    t_swap(m_length, other.m_length);
+    t_swap(m_spareBlock, other.m_spareBlock);
+}
+
+template <class T>
+typename cDeque<T>::Element* cDeque<T>::getElement(uint position) const
+{
+    return m_map[position / BlockElements] + (position % BlockElements);
+}
+
+template <class T>
+void cDeque<T>::allocateBlock(uint blockIndex)
+{
+    if (m_map[blockIndex] != NULL)
+        return;
+
+    if (m_spareBlock != NULL)
+    {
+        m_map[blockIndex] = m_spareBlock;
+        m_spareBlock = NULL;
+        return;
+    }
+
+    Element* block = (Element*)cOS::smallMemoryAllocation(
+                                        BlockElements * sizeof(Element));
+    if (block == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+    m_map[blockIndex] = block;
+}
+
+template <class T>
+void cDeque<T>::releaseBlock(uint blockIndex)
+{
+    if (m_spareBlock == NULL)
+        m_spareBlock = m_map[blockIndex];
+    else
+        cOS::smallMemoryFree(m_map[blockIndex]);
+    m_map[blockIndex] = NULL;
+}
+
+template <class T>
+void cDeque<T>::growMap()
+{
+    uint firstBlock = m_start / BlockElements;
+    uint usedBlocks = (m_length == 0) ? 0 :
+        ((m_start + m_length - 1) / BlockElements) - firstBlock + 1;
+
+    // Center the blocks in a map which is at least twice their number, so
+    // there are free entries at both ends
+    uint newMapSize = t_max((uint)InitialMapSize, m_mapSize);
+    if ((usedBlocks + 1) * 2 > newMapSize)
+        newMapSize*= 2;
+
+    Element** newMap = (Element**)cOS::smallMemoryAllocation(
+                                        newMapSize * sizeof(Element*));
+    if (newMap == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+    for (uint i = 0; i < newMapSize; i++)
+        newMap[i] = NULL;
+    uint newFirstBlock = (newMapSize - usedBlocks) / 2;
+    if (usedBlocks > 0)
+    {
+        cOS::memcpy(newMap + newFirstBlock, m_map + firstBlock,
+                    usedBlocks * sizeof(Element*));
+    }
+
+    if (m_map != NULL)
+        cOS::smallMemoryFree(m_map);
+    m_map = newMap;
+    m_mapSize = newMapSize;
+    m_start = (newFirstBlock * BlockElements) + (m_start % BlockElements);
+}
+
+template <class T>
+typename cDeque<T>::Element* cDeque<T>::reserveLast()
+{
+    uint position = m_start + m_length;
+    if (position == m_mapSize * BlockElements)
+    {
+        growMap();
+        position = m_start + m_length;
+    }
+
+    allocateBlock(position / BlockElements);
+    return getElement(position);
+}
+
+template <class T>
+typename cDeque<T>::Element* cDeque<T>::reserveFirst()
+{
+    if (m_start == 0)
+        growMap();
+
+    allocateBlock((m_start - 1) / BlockElements);
+    return getElement(m_start - 1);
+}
+
+template <class T>
+void cDeque<T>::append(const T& object)
+{
+    new (reserveLast()) Element(object);
+    m_length++;
+}
+
+template <class T>
+void cDeque<T>::insert(const T& object)
+{
+    new (reserveFirst()) Element(object);
+    m_start--;
+    m_length++;
+}
+
+template <class T>
+void cDeque<T>::removeFirst()
+{
+    if (m_length == 0)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+
+    uint position = m_start;
+    getElement(position)->~Element();
+    m_start++;
+    m_length--;
+
+    // Release the block when its last element was removed
+    if ((m_length == 0) || ((m_start % BlockElements) == 0))
+        releaseBlock(position / BlockElements);
+    if (m_length == 0)
+        removeAll();
+}
+
+template <class T>
+void cDeque<T>::removeLast()
+{
+    if (m_length == 0)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+
+    uint position = m_start + m_length - 1;
+    getElement(position)->~Element();
+    m_length--;
+
+    // Release the block when its first element was removed
+    if ((m_length == 0) || ((position % BlockElements) == 0))
+        releaseBlock(position / BlockElements);
+    if (m_length == 0)
+        removeAll();
+}
+
+template <class T>
+T& cDeque<T>::getFirst()
+{
+    if (m_length == 0)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    return getElement(m_start)->m_value;
+}
+
+template <class T>
+const T& cDeque<T>::getFirst() const
+{
+    if (m_length == 0)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    return getElement(m_start)->m_value;
+}
+
+template <class T>
+T& cDeque<T>::getLast()
+{
+    if (m_length == 0)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    return getElement(m_start + m_length - 1)->m_value;
+}
+
+template <class T>
+const T& cDeque<T>::getLast() const
+{
+    if (m_length == 0)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    return getElement(m_start + m_length - 1)->m_value;
+}
+
+template <class T>
+T& cDeque<T>::operator [] (uint index)
+{
+    if (index >= m_length)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    return getElement(m_start + index)->m_value;
+}
+
+template <class T>
+const T& cDeque<T>::operator [] (uint index) const
+{
+    if (index >= m_length)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    return getElement(m_start + index)->m_value;
+}
+
+template <class T>
+uint cDeque<T>::length() const
+{
+    return m_length;
+}
+
+template <class T>
+bool cDeque<T>::isEmpty() const
+{
+    return m_length == 0;
+}
+
+template <class T>
+void cDeque<T>::removeAll()
+{
+    while (m_length > 0)
+        removeLast();
+    // Start again from the center of the map, so a deque which is used as a
+    // queue doesn't move towards the end of the map
+    m_start = (m_mapSize / 2) * BlockElements;
+}
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_FLATHASH_H
+#define __TBA_STL_FLATHASH_H
+
+/*
+ * flatHash.h
+ *
+ * Interface of the template "flat-hash" class. An open-addressing sibling of
+ * the cHash class which stores the keys and the values inline.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/list.h"
+#include "xStl/data/hash.h"
+
+#ifdef XSTL_WINDOWS
+// Template classes might not use all the local functions the interface has
+// to ofer. Warning C4505 should be over-written for template functions
+#pragma warning(push)
+#pragma warning(disable:4505)
+#endif
+
+/*
+ * class cFlatHash
+ *
+ * Implementation of an open-addressing hash table. Unlike cHash, which keeps
+ * a link-list for every cell, the elements of cFlatHash are stored inside a
+ * single power-of-two array of slots and collisions are resolved by linear
+ * probing. When the number of elements exceeds the maximum load-factor the
+ * table is doubled and all the elements are rehashed.
+ *
+ * The interface is the same as cHash:
+ *   hash.append(IndexType, FiledType);
+ *   hash[IndexType] = FiledType;
+ *
+ * NOTES:
+ *   IndexType must have a complete implementation of operator ==
+ *   IndexType must have an hash function (See cHash). The hash function is
+ *   selected by the HashFunction template argument.
+ *   IndexType and FiledType must have a default constructor and operator =,
+ *   since they are stored inside a cArray.
+ *
+ * Removing elements is done by shifting the following elements of the probe
+ * sequence backward, so the table never contains "deleted" marks and the
+ * look-up time depends only in the load-factor.
+ */
+template <class IndexType, class FiledType,
+          class HashFunction = cHashFunctor<IndexType> >
+class cFlatHash
+{
+public:
+    enum {
+        // The default number of slots in a new table. Must be power of two
+        DefaultCapacity = 16,
+        // The default maximum load-factor, in percents of the slots count
+        DefaultMaxLoadFactor = 75
+    };
+
+    /*
+     * Constructor. Creates an empty hash table.
+     *
+     * capacity      - The initialize number of slots. Rounded up to the next
+     *                 power of two.
+     * maxLoadFactor - The maximum percents of used slots before the table
+     *                 grows. Must be between 1 to 99.
+     * hashFunction  - The function which translates keys into slots
+     */
+    explicit cFlatHash(uint capacity = DefaultCapacity,
+                       uint maxLoadFactor = DefaultMaxLoadFactor,
+                       const HashFunction& hashFunction = HashFunction());
+
+    /*
+     * Copy-constructor. Duplicate the elements from 'other'
+     */
+    cFlatHash(const cFlatHash<IndexType, FiledType, HashFunction>& other);
+
+    /* Hash functions */
+
+    /*
+     * Add an element to the hash. The element is copied into the slots array,
+     * which might be rehashed.
+     *
+     * index - The new index for the object. Must be unique
+     * data  - The data to put in the cell
+     *
+     * Throws exception if the index exist
+     */
+    void append(const IndexType& index, const FiledType& data);
+
+    /*
+     * Add an element to the hash, or change the data of an existing element.
+     * The key is hashed and probed only once (unless the table is rehashed).
+     *
+     * index - The index for the object
+     * data  - The data to put in the cell
+     *
+     * Return a reference to the data stored inside the hash. The reference is
+     * valid until the next append() or remove() operation.
+     */
+    FiledType& insertOrAssign(const IndexType& index, const FiledType& data);
+
+    /*
+     * Return the data of 'index'. If the index doesn't exist a new element
+     * is added with 'data'.
+     *
+     * index - The index for the object
+     * data  - The data to put in the cell incase the index is new
+     *
+     * Return a reference to the data stored inside the hash. The reference is
+     * valid until the next append() or remove() operation.
+     */
+    FiledType& findOrInsert(const IndexType& index,
+                            const FiledType& data = FiledType());
+
+    /*
+     * Search for an element without throwing exception.
+     *
+     * index - The index for the hash table
+     * data  - Will be filled with a pointer to the data stored inside the
+     *         hash, or NULL incase the index is invalid
+     *
+     * Return true if the index was found
+     */
+    bool tryGet(const IndexType& index, FiledType*& data);
+    bool tryGet(const IndexType& index, const FiledType*& data) const;
+
+    /*
+     * Remove a item from the hash
+     *
+     * index - The element to remove
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' exception incase the index is invalid
+     */
+    void remove(const IndexType& index);
+
+    /*
+     * Remove all the elements from the hash. The capacity of the table is
+     * reset to the original capacity.
+     */
+    void removeAll();
+
+    /*
+     * Return a list of keys value.
+     *
+     * ret - Will be filled with the keys
+     */
+    void keys(cList<IndexType>& ret) const;
+
+    /*
+     * Returns a list of keys value in the function return coed
+     */
+    cList<IndexType> keys() const;
+
+    /*
+     * Return true if there is a key in the hash
+     *
+     * index - The index to be query
+     */
+    bool hasKey(const IndexType& index) const;
+
+    /*
+     * Return the number of elements stored in the hash
+     */
+    uint length() const;
+
+    /*
+     * Return the number of slots allocated for the table
+     */
+    uint getCapacity() const;
+
+    /*
+     * Make sure that the table can store 'numberOfElements' elements without
+     * being rehashed.
+     *
+     * numberOfElements - The expected number of elements
+     */
+    void reserve(uint numberOfElements);
+
+    /*
+     * Return the maximum load-factor (in percents)
+     */
+    uint getMaxLoadFactor() const;
+
+    /*
+     * Change the maximum load-factor of the table. Might rehash the table if
+     * the current number of elements exceed the new load-factor.
+     *
+     * maxLoadFactor - The maximum percents of used slots. Must be between 1
+     *                 to 99.
+     */
+    void setMaxLoadFactor(uint maxLoadFactor);
+
+    // Operators
+
+    /*
+     * Operator =. Copies the other hash table to this hash table.
+     */
+    const cFlatHash<IndexType, FiledType, HashFunction>& operator = (const cFlatHash<IndexType, FiledType, HashFunction>& other);
+
+    /*
+     * The map operator. Retrieve index-type and return a reference to the object
+     *
+     * index - The index for the hash table
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' exception when the index is invalid
+     * Return a reference to the object. The reference is valid until the next
+     * append() or remove() operation.
+     */
+    FiledType& operator [] (const IndexType& index);
+
+    /*
+     * The map operator. Retrieve index-type and return a const reference to the
+     * object. This function is the const operator for the previous function.
+     *
+     * index - The index for the hash table
+     *
+     * Throws 'EXCEPTION_OUT_OF_RANGE' exception when the index is invalid
+     * Return a const reference to the object.
+     */
+    const FiledType& operator [] (const IndexType& index) const;
+
+private:
+    /*
+     * A single cell inside the table.
+     */
+    class Slot
+    {
+    public:
+        // Default constructor. Creates an empty slot
+        Slot() : m_used(false) {}
+
+        // The key of the element
+        IndexType m_index;
+        // The stored data
+        FiledType m_data;
+        // Set to true if the slot holds an element
+        bool m_used;
+    };
+
+    /*
+     * Return the first slot in the probe sequence of 'index'
+     *
+     * index    - The key
+     * capacity - The number of slots of the table. Must be power of two
+     */
+    uint homeSlot(const IndexType& index, uint capacity) const;
+
+    /*
+     * Return the smallest power of two which is greater or equal to 'count'
+     */
+    static uint roundCapacity(uint count);
+
+    /*
+     * Scan the probe sequence of 'index'.
+     *
+     * Return the slot which holds 'index', or the first free slot of the
+     * sequence. The caller should check the 'm_used' flag of the returned slot
+     */
+    uint probe(const IndexType& index) const;
+
+    /*
+     * Store a new element in the free slot 'position' returned by probe().
+     * The table is grown first, if the new element exceeds the load-factor.
+     *
+     * Return the slot of the new element
+     */
+    Slot& add(uint position, const IndexType& index, const FiledType& data);
+
+    /*
+     * Allocate a new table with 'newCapacity' slots and move all the elements
+     * into it.
+     */
+    void rehash(uint newCapacity);
+
+    /*
+     * Return true if 'count' elements exceeds the maximum load-factor of
+     * a table with 'capacity' slots.
+     */
+    bool isOverloaded(uint count, uint capacity) const;
+
+    // The slots array. The size is always a power of two
+    cArray<Slot> m_slots;
+    // The number of used slots
+    uint m_count;
+    // The maximum load-factor, in percents
+    uint m_maxLoadFactor;
+    // The capacity the table was constructed with. Used by removeAll()
+    uint m_initCapacity;
+    // The hash function
+    HashFunction m_hashFunction;
+};
+
+// Include the implementation of the hash in the template .h file
+#include "xStl/data/flatHash.inl"
+
+#ifdef XSTL_WINDOWS
+    // Restore the warning levels
+    #pragma warning(pop)
+#endif
+
+#endif // __TBA_STL_FLATHASH_H
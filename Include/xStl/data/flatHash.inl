@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * flatHash.inl
+ *
+ * Implementation code of the cFlatHash template class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/trace.h"
+#include "xStl/except/assert.h"
+#include "xStl/except/exception.h"
+#include "xStl/data/flatHash.h"
+
+template <class IndexType, class FiledType, class HashFunction>
+cFlatHash<IndexType, FiledType, HashFunction>::cFlatHash(uint capacity /* = DefaultCapacity */,
+                                                         uint maxLoadFactor /* = DefaultMaxLoadFactor */,
+                                                         const HashFunction& hashFunction /* = HashFunction() */) :
+    m_slots(roundCapacity(capacity)),
+    m_count(0),
+    m_maxLoadFactor(maxLoadFactor),
+    m_initCapacity(roundCapacity(capacity)),
+    m_hashFunction(hashFunction)
+{
+    CHECK((maxLoadFactor > 0) && (maxLoadFactor < 100));
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cFlatHash<IndexType, FiledType, HashFunction>::cFlatHash(const cFlatHash<IndexType, FiledType, HashFunction>& other) :
+    m_slots(other.m_slots),
+    m_count(other.m_count),
+    m_maxLoadFactor(other.m_maxLoadFactor),
+    m_initCapacity(other.m_initCapacity),
+    m_hashFunction(other.m_hashFunction)
+{
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cFlatHash<IndexType, FiledType, HashFunction>::homeSlot(const IndexType& index,
+                                                             uint capacity) const
+{
+    // The capacity is a power of two, so the mask is always valid
+    return m_hashFunction(index, capacity) & (capacity - 1);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cFlatHash<IndexType, FiledType, HashFunction>::roundCapacity(uint count)
+{
+    uint ret = 1;
+    while (ret < count)
+    {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cFlatHash<IndexType, FiledType, HashFunction>::isOverloaded(uint count,
+                                                                 uint capacity) const
+{
+    // 'uint' is 32 bits on some platforms, so large tables would overflow
+    return ((uint64)count * 100) > ((uint64)capacity * m_maxLoadFactor);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cFlatHash<IndexType, FiledType, HashFunction>::probe(const IndexType& index) const
+{
+    const Slot* slots = m_slots.getBuffer();
+    uint mask = m_slots.getSize() - 1;
+
+    // The load-factor guarantee that there is at least one free slot, so the
+    // scan will always stop.
+    uint position = homeSlot(index, m_slots.getSize());
+    while ((slots[position].m_used) && (!(slots[position].m_index == index)))
+    {
+        position = (position + 1) & mask;
+    }
+
+    return position;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::rehash(uint newCapacity)
+{
+    ASSERT(!isOverloaded(m_count, newCapacity));
+
+    cArray<Slot> newSlots(newCapacity);
+    Slot* destination = newSlots.getBuffer();
+    const Slot* source = m_slots.getBuffer();
+    uint mask = newCapacity - 1;
+
+    for (uint i = 0; i < m_slots.getSize(); i++)
+    {
+        if (!source[i].m_used)
+            continue;
+
+        // All the keys are unique, just find a free slot
+        uint position = homeSlot(source[i].m_index, newCapacity);
+        while (destination[position].m_used)
+        {
+            position = (position + 1) & mask;
+        }
+        destination[position] = source[i];
+    }
+
+    m_slots.swap(newSlots);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+typename cFlatHash<IndexType, FiledType, HashFunction>::Slot&
+    cFlatHash<IndexType, FiledType, HashFunction>::add(uint position,
+                                                       const IndexType& index,
+                                                       const FiledType& data)
+{
+    ASSERT(!m_slots.getBuffer()[position].m_used);
+
+    // Grow the table before the element is placed
+    if (isOverloaded(m_count + 1, m_slots.getSize()))
+    {
+        rehash(m_slots.getSize() * 2);
+        position = probe(index);
+    }
+
+    Slot& slot = m_slots.getBuffer()[position];
+    slot.m_index = index;
+    slot.m_data = data;
+    slot.m_used = true;
+    m_count++;
+    return slot;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::append(const IndexType& index,
+                                                           const FiledType& data)
+{
+    uint position = probe(index);
+
+    // Test that the object is unique
+    CHECK(!m_slots.getBuffer()[position].m_used);
+
+    add(position, index, data);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+FiledType& cFlatHash<IndexType, FiledType, HashFunction>::insertOrAssign(const IndexType& index,
+                                                                         const FiledType& data)
+{
+    uint position = probe(index);
+    Slot& slot = m_slots.getBuffer()[position];
+    if (slot.m_used)
+    {
+        slot.m_data = data;
+        return slot.m_data;
+    }
+
+    return add(position, index, data).m_data;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+FiledType& cFlatHash<IndexType, FiledType, HashFunction>::findOrInsert(const IndexType& index,
+                                                                       const FiledType& data /* = FiledType() */)
+{
+    uint position = probe(index);
+    Slot& slot = m_slots.getBuffer()[position];
+    if (slot.m_used)
+    {
+        return slot.m_data;
+    }
+
+    return add(position, index, data).m_data;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cFlatHash<IndexType, FiledType, HashFunction>::tryGet(const IndexType& index,
+                                                           FiledType*& data)
+{
+    Slot& slot = m_slots.getBuffer()[probe(index)];
+    data = slot.m_used ? &slot.m_data : NULL;
+    return slot.m_used;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cFlatHash<IndexType, FiledType, HashFunction>::tryGet(const IndexType& index,
+                                                           const FiledType*& data) const
+{
+    const Slot& slot = m_slots.getBuffer()[probe(index)];
+    data = slot.m_used ? &slot.m_data : NULL;
+    return slot.m_used;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::remove(const IndexType& index)
+{
+    Slot* slots = m_slots.getBuffer();
+    uint mask = m_slots.getSize() - 1;
+    uint hole = probe(index);
+
+    if (!slots[hole].m_used)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+
+    // Shift backward all the elements of the probe sequence which can be
+    // placed in the hole, so look-ups will never stop before their element.
+    uint next = hole;
+    for (;;)
+    {
+        next = (next + 1) & mask;
+        if (!slots[next].m_used)
+            break;
+
+        // An element can move to the hole, only if it's home slot is not
+        // located cyclically between the hole and it's current position.
+        uint home = homeSlot(slots[next].m_index, m_slots.getSize());
+        bool isBetween = (hole <= next) ? ((hole < home) && (home <= next)) :
+                                          ((hole < home) || (home <= next));
+        if (isBetween)
+            continue;
+
+        slots[hole] = slots[next];
+        hole = next;
+    }
+
+    // Free the key and the data of the last hole
+    slots[hole] = Slot();
+    m_count--;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::removeAll()
+{
+    cArray<Slot> emptySlots(m_initCapacity);
+    m_slots.swap(emptySlots);
+    m_count = 0;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::keys(cList<IndexType>& ret) const
+{
+    const Slot* slots = m_slots.getBuffer();
+    for (uint i = 0; i < m_slots.getSize(); i++)
+    {
+        if (slots[i].m_used)
+        {
+            ret.append(slots[i].m_index);
+        }
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cList<IndexType> cFlatHash<IndexType, FiledType, HashFunction>::keys() const
+{
+    cList<IndexType> ret;
+    keys(ret);
+    return ret;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cFlatHash<IndexType, FiledType, HashFunction>::hasKey(const IndexType& index) const
+{
+    return m_slots.getBuffer()[probe(index)].m_used;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cFlatHash<IndexType, FiledType, HashFunction>::length() const
+{
+    return m_count;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cFlatHash<IndexType, FiledType, HashFunction>::getCapacity() const
+{
+    return m_slots.getSize();
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::reserve(uint numberOfElements)
+{
+    uint capacity = m_slots.getSize();
+    while (isOverloaded(numberOfElements, capacity))
+    {
+        capacity*= 2;
+    }
+
+    if (capacity != m_slots.getSize())
+    {
+        rehash(capacity);
+    }
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+uint cFlatHash<IndexType, FiledType, HashFunction>::getMaxLoadFactor() const
+{
+    return m_maxLoadFactor;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cFlatHash<IndexType, FiledType, HashFunction>::setMaxLoadFactor(uint maxLoadFactor)
+{
+    CHECK((maxLoadFactor > 0) && (maxLoadFactor < 100));
+    m_maxLoadFactor = maxLoadFactor;
+
+    // Grow the table if the current elements exceed the new load-factor
+    reserve(m_count);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+const cFlatHash<IndexType, FiledType, HashFunction>& cFlatHash<IndexType, FiledType, HashFunction>::operator =
+    (const cFlatHash<IndexType, FiledType, HashFunction>& other)
+{
+    if (this != &other)
+    {
+        m_slots = other.m_slots;
+        m_count = other.m_count;
+        m_maxLoadFactor = other.m_maxLoadFactor;
+        m_initCapacity = other.m_initCapacity;
+        m_hashFunction = other.m_hashFunction;
+    }
+
+    return *this;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+FiledType& cFlatHash<IndexType, FiledType, HashFunction>::operator [] (const IndexType& index)
+{
+    const cFlatHash<IndexType, FiledType, HashFunction>* constThis = this;
+
+    // Use the same reference
+    return const_cast<FiledType&>((*constThis)[index]);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+const FiledType& cFlatHash<IndexType, FiledType, HashFunction>::operator [] (const IndexType& index) const
+{
+    const FiledType* data;
+    if (!tryGet(index, data))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+
+    return *data;
+}
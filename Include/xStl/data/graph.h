@@ -35,8 +35,10 @@
 #include "xStl/types.h"
 #include "xStl/operators.h"
 #include "xStl/utils/algorithm.h"
+#include "xStl/except/trace.h"
 #include "xStl/except/assert.h"
 #include "xStl/data/list.h"
+#include "xStl/data/deque.h"
 #include "xStl/data/setArray.h"
 
 #ifdef XSTL_WINDOWS
@@ -67,7 +69,7 @@ public:
     }
 
     /* Returns the list of neighbors the node has */
-    cList<GraphNode*>& getNeighbors()
+    cDeque<GraphNode*>& getNeighbors()
     {
         return m_neighbors;
     }
@@ -123,7 +125,7 @@ public:
 
     bool isNeighbor(const T& id) const
     {
-        typename cList<GraphNode*>::iterator current_node(m_neighbors.begin());
+        typename cDeque<GraphNode*>::iterator current_node(m_neighbors.begin());
         for (; current_node != m_neighbors.end(); ++current_node)
         {
             GraphNode* graphNode = *current_node;
@@ -145,7 +147,7 @@ private:
     // Chosen color for node. Initialized as 0.
     uint m_chosenColor;
     // List of neighbors this node has
-    cList<GraphNode*> m_neighbors;
+    cDeque<GraphNode*> m_neighbors;
     // Number of possible colors
     uint m_numberOfPossibleColors;
 };
@@ -228,11 +230,11 @@ public:
     /*
      * Return the list of nodes in the graph.
      */
-    cList<GraphNode<T,S> >& getNodes();
+    cDeque<GraphNode<T,S> >& getNodes();
 
 private:
     // List of nodes in the graph
-    cList<GraphNode<T,S> > m_nodes;
+    cDeque<GraphNode<T,S> > m_nodes;
 
     // Number of possible colors
     uint m_numberOfPossibleColors;
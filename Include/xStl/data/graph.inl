@@ -48,9 +48,10 @@ cGraph<T,S>::~cGraph()
 }
 
 template <class T, class S>
-cGraph<T,S>::cGraph(const cGraph<T,S> &other)
+cGraph<T,S>::cGraph(const cGraph<T,S> &other) :
+    m_nodes(other.m_nodes),
+    m_numberOfPossibleColors(other.m_numberOfPossibleColors)
 {
-	m_nodes = other.getNodes();
 }
 
 template <class T, class S>
@@ -69,7 +70,7 @@ void cGraph<T,S>::addNode(const T& id, const S& value)
 template <class T, class S>
 bool cGraph<T,S>::isConnected(const  T& id1, const T& id2)
 {
-	typename cList<GraphNode<T,S> >::iterator nodesIterator(m_nodes.begin());
+	typename cDeque<GraphNode<T,S> >::iterator nodesIterator(m_nodes.begin());
 
 	for (; nodesIterator != m_nodes.end(); ++nodesIterator)
 	{
@@ -85,7 +86,7 @@ bool cGraph<T,S>::isConnected(const  T& id1, const T& id2)
 template <class T, class S>
 void cGraph<T,S>::connectNodes(const T& id1, const T& id2, bool dup)
 {
-	typename cList<GraphNode<T,S> >::iterator current_node(m_nodes.begin());
+	typename cDeque<GraphNode<T,S> >::iterator current_node(m_nodes.begin());
 	GraphNode<T,S>* graphNode1 = NULL;
 	GraphNode<T,S>* graphNode2 = NULL;
 
@@ -134,7 +135,7 @@ uint cGraph<T,S>::getNumberOfNodes() const
 template <class T, class S>
 bool cGraph<T,S>::isNodeExists(const T& id) const
 {
-	typename cList<GraphNode<T,S> >::iterator nodesIterator(m_nodes.begin());
+	typename cDeque<GraphNode<T,S> >::iterator nodesIterator(m_nodes.begin());
 	for (; nodesIterator != m_nodes.end(); ++nodesIterator)
 	{
 		GraphNode<T,S>& graphNode = *nodesIterator;
@@ -168,7 +169,7 @@ void cGraph<T,S>::makeClique(cList<T> ids)
 template <class T, class S>
 GraphNode<T,S>* cGraph<T,S>::getNode(const T& id) const
 {
-	typename cList<GraphNode<T,S> >::iterator nodesIterator(m_nodes.begin());
+	typename cDeque<GraphNode<T,S> >::iterator nodesIterator(m_nodes.begin());
 	for (; nodesIterator != m_nodes.end(); ++nodesIterator)
 	{
 		GraphNode<T,S>& graphNode = *nodesIterator;
@@ -181,7 +182,7 @@ GraphNode<T,S>* cGraph<T,S>::getNode(const T& id) const
 }
 
 template <class T, class S>
-cList<GraphNode<T,S> >& cGraph<T,S>::getNodes()
+cDeque<GraphNode<T,S> >& cGraph<T,S>::getNodes()
 {
 	return m_nodes;
 }
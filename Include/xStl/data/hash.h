@@ -47,6 +47,7 @@
 #include "xStl/data/string.h"
 #include "xStl/data/list.h"
 #include "xStl/data/dualElement.h"
+#include "xStl/data/hashFunction.h"
 
 #ifdef XSTL_WINDOWS
 // Template classes might not use all the local functions the interface has
@@ -55,6 +56,87 @@
 #pragma warning(disable:4505)
 #endif
 
+/*
+ * cHashFunction() standart data-types implementation
+ *
+ * See comments at the begining of the class interface.
+ */
+uint cHashFunction(const int& index, uint range);
+uint cHashFunction(const uint32& index, uint range);
+uint cHashFunction(const float& index, uint range);
+uint cHashFunction(const char* index, uint range);
+uint cHashFunction(const cString& index, uint range);
+uint cHashFunction(const cBuffer& index, uint range);
+uint cHashFunction(const addressNumericValue& index, uint range);
+#ifndef XSTL_16BIT
+// 16 bit application doesn't have threads
+uint cHashFunction(const uint64& index, uint range);
+uint cHashFunction(const cOSDef::threadHandle& index, uint range);
+#endif // XSTL_16BIT
+
+/*
+ * class cHashFunctor
+ *
+ * The default hash function of the hash tables. Forwards the call into the
+ * cHashFunction() of the IndexType.
+ */
+template <class IndexType>
+class cHashFunctor
+{
+public:
+    /*
+     * Return the cell of 'index' in a table with 'range' cells.
+     */
+    uint operator () (const IndexType& index, uint range) const
+    {
+        return cHashFunction(index, range);
+    }
+};
+
+/*
+ * class cSeededHashFunctor
+ *
+ * Select a function from the hash family (See hashFunction.h) according to
+ * a seed. Tables which are filled by an external input should use a random
+ * seed, so the input cannot force all the keys into the same cell.
+ *
+ * NOTE: IndexType must have a cHashCode() implementation.
+ */
+template <class IndexType>
+class cSeededHashFunctor
+{
+public:
+    /*
+     * Constructor.
+     *
+     * seed - Select the hash function
+     */
+    explicit cSeededHashFunctor(hashValue seed = cHashMixer::DefaultSeed) :
+        m_seed(seed)
+    {
+    }
+
+    /*
+     * Return the cell of 'index' in a table with 'range' cells.
+     */
+    uint operator () (const IndexType& index, uint range) const
+    {
+        return cHashMixer::reduce(cHashCode(index, m_seed), range);
+    }
+
+    /*
+     * Return the seed of the function
+     */
+    hashValue getSeed() const
+    {
+        return m_seed;
+    }
+
+private:
+    // The selected function
+    hashValue m_seed;
+};
+
 /*
  * class cHash
  *
@@ -74,15 +156,22 @@
  *   from 0 to "range"
  *
  *   Definition:
- *         uint cHash_functoin(const IndexType& index, uint range)
+ *         uint cHashFunction(const IndexType& index, uint range)
+ *
+ *   The function is called through the HashFunction template argument. The
+ *   default cHashFunctor calls the cHashFunction() of the IndexType, the
+ *   cSeededHashFunctor selects a function of the seeded hash family. Any
+ *   class with the operator:
+ *         uint operator () (const IndexType& index, uint range) const
+ *   can be used.
  *
  * In this file there are regular implementation of hash on:
- *   float, int, char *.
- *   cString, cBuffer is also implemented in the array.h, string.h files.
+ *   float, int, char *, cString, cBuffer.
  *
  * TODO: Add copy-on-write feature.
  */
-template <class IndexType, class FiledType>
+template <class IndexType, class FiledType,
+          class HashFunction = cHashFunctor<IndexType> >
 class cHash
 {
 public:
@@ -96,13 +185,17 @@ public:
 
     /*
      * Constructor. Init the hash to be constructed with
+     *
+     * vectorSize   - The number of link-lists of the table
+     * hashFunction - The function which translates keys into link-lists
      */
-    explicit cHash(uint vectorSize = DefaultHashSearch);
+    explicit cHash(uint vectorSize = DefaultHashSearch,
+                   const HashFunction& hashFunction = HashFunction());
 
     /*
      * Copy-constructor. Duplicate the handles from 'other'
      */
-    cHash(const cHash<IndexType, FiledType>& other);
+    cHash(const cHash<IndexType, FiledType, HashFunction>& other);
 
     /*
      * Destructor, free up the memory allocated by the hash
@@ -123,6 +216,41 @@ public:
      */
     void append(const IndexType& index, const FiledType& data);
 
+    /*
+     * Add an element to the hash, or change the data of an existing element.
+     * The key is hashed and searched only once.
+     *
+     * index - The index for the object
+     * data  - The data to put in the cell
+     *
+     * Return a reference to the data stored inside the hash
+     */
+    FiledType& insertOrAssign(const IndexType& index, const FiledType& data);
+
+    /*
+     * Return the data of 'index'. If the index doesn't exist a new element
+     * is added with 'data'. The key is hashed and searched only once.
+     *
+     * index - The index for the object
+     * data  - The data to put in the cell incase the index is new
+     *
+     * Return a reference to the data stored inside the hash
+     */
+    FiledType& findOrInsert(const IndexType& index,
+                            const FiledType& data = FiledType());
+
+    /*
+     * Search for an element without throwing exception.
+     *
+     * index - The index for the hash table
+     * data  - Will be filled with a pointer to the data stored inside the
+     *         hash, or NULL incase the index is invalid
+     *
+     * Return true if the index was found
+     */
+    bool tryGet(const IndexType& index, FiledType*& data);
+    bool tryGet(const IndexType& index, const FiledType*& data) const;
+
     /*
      * Remove a item from the hash
      *
@@ -137,6 +265,19 @@ public:
      */
     void removeAll();
 
+    /*
+     * Allocate the table and the nodes of the hash from 'allocator' (NULL for
+     * the default allocator). See cAllocator.
+     *
+     * Throws exception if the hash isn't empty.
+     */
+    void setAllocator(cAllocator* allocator);
+
+    /*
+     * Return the allocator of the hash, or NULL for the default allocator
+     */
+    cAllocator* getAllocator() const;
+
     /*
      * Return a list of keys value.
      *
@@ -161,12 +302,12 @@ public:
     /*
      * Operator =. Copies the other hash table to this hash table.
      */
-    const cHash<IndexType, FiledType>& operator = (const cHash<IndexType, FiledType>& other);
+    const cHash<IndexType, FiledType, HashFunction>& operator = (const cHash<IndexType, FiledType, HashFunction>& other);
 
     /*
      * Return true if the hash tables are equals.
      */
-    bool operator == (const cHash<IndexType, FiledType> &other) const;
+    bool operator == (const cHash<IndexType, FiledType, HashFunction> &other) const;
 
     /*
      * The map operator. Retrieve index-type and return a reference to the object
@@ -208,30 +349,53 @@ private:
     // The link-list which store by each node
     typedef cList<ElementType> ListType;
 
-    // The hash table data-struct.
-    cArray<ListType>* m_hash;
+    /*
+     * Internal function. Hash the index once and scan the link-list of it's
+     * cell. This is the only bucket lookup of the hash, all other lookups
+     * (find(), remove()) are built on top of it.
+     *
+     * index         - The index to search for
+     * arrayPosition - Will be filled with the cell of the index
+     *
+     * Return the iterator of the element, or m_hash[arrayPosition].end() if
+     * the index doesn't exist
+     */
+    typename ListType::iterator findIterator(const IndexType& index,
+                                             uint& arrayPosition) const;
+
+    /*
+     * Internal function. Hash the index once and scan the link-list of it's
+     * cell.
+     *
+     * index         - The index to search for
+     * arrayPosition - Will be filled with the cell of the index
+     *
+     * Return the element of the index, or NULL if the index doesn't exist
+     */
+    ElementType* find(const IndexType& index, uint& arrayPosition) const;
+
+    /*
+     * Internal function. Add a new element at the end of the link-list
+     * of 'arrayPosition'.
+     *
+     * Return a reference to the new element
+     */
+    ElementType& add(uint arrayPosition, const IndexType& index,
+                     const FiledType& data);
+
+    // The hash table data-struct. The const functions return non-const
+    // elements of the lists (See find())
+    mutable cArray<ListType> m_hash;
 
     // The old vector-size
     uint m_vectorSize;
-};
 
-/*
- * cHashFunction() standart data-types implementation
- *
- * See comments at the begining of the class interface.
- */
-uint cHashFunction(const int& index, uint range);
-uint cHashFunction(const uint32& index, uint range);
-uint cHashFunction(const float& index, uint range);
-uint cHashFunction(const char* index, uint range);
-uint cHashFunction(const cString& index, uint range);
-uint cHashFunction(const cBuffer& index, uint range);
-uint cHashFunction(const addressNumericValue& index, uint range);
-#ifndef XSTL_16BIT
-// 16 bit application doesn't have threads
-uint cHashFunction(const uint64& index, uint range);
-uint cHashFunction(const cOSDef::threadHandle& index, uint range);
-#endif // XSTL_16BIT
+    // The hash function
+    HashFunction m_hashFunction;
+
+    // The allocator of the table and the lists, NULL for the default
+    cAllocator* m_allocator;
+};
 
 // Include the implementation of the hash in the template .h file
 #include "xStl/data/hash.inl"
@@ -41,199 +41,273 @@
 #include "xStl/except/assert.h"
 #include "xStl/data/hash.h"
 
-template <class IndexType, class FiledType>
-cHash<IndexType, FiledType>::cHash(uint vectorSize /* = DefaultHashSearch*/) :
-	m_hash(NULL),
-    m_vectorSize(vectorSize)
+template <class IndexType, class FiledType, class HashFunction>
+cHash<IndexType, FiledType, HashFunction>::cHash(uint vectorSize /* = DefaultHashSearch*/,
+    const HashFunction& hashFunction /* = HashFunction() */) :
+    m_vectorSize(vectorSize),
+    m_hashFunction(hashFunction),
+    m_allocator(NULL)
 {
     initHash(vectorSize);
 }
 
-template <class IndexType, class FiledType>
-void cHash<IndexType, FiledType>::initHash(uint vectorSize)
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::initHash(uint vectorSize)
 {
-    ASSERT(m_hash == NULL);
+    ASSERT(m_hash.getSize() == 0);
 
 	// Create an array of empty lists
-	m_hash = new cArray<ListType>(vectorSize);
+	m_hash.changeSize(vectorSize);
+    if (m_allocator != NULL)
+    {
+        for (uint i = 0; i < vectorSize; i++)
+            m_hash[i].setAllocator(m_allocator);
+    }
 }
 
-template <class IndexType, class FiledType>
-cHash<IndexType, FiledType>::cHash(const cHash<IndexType, FiledType>& other) :
-    m_hash(NULL)
+template <class IndexType, class FiledType, class HashFunction>
+cHash<IndexType, FiledType, HashFunction>::cHash(const cHash<IndexType, FiledType, HashFunction>& other) :
+    m_vectorSize(0),
+    m_hashFunction(other.m_hashFunction),
+    m_allocator(NULL)
 {
 	// Call operator
 	*this = other;
 }
 
-template <class IndexType, class FiledType>
-cHash<IndexType, FiledType>::~cHash()
+template <class IndexType, class FiledType, class HashFunction>
+cHash<IndexType, FiledType, HashFunction>::~cHash()
 {
     freeHash();
 }
 
-template <class IndexType, class FiledType>
-void cHash<IndexType, FiledType>::freeHash()
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::freeHash()
 {
-    ASSERT(m_hash != NULL);
-	delete m_hash;
-    m_hash = NULL;
+    // Destroy the lists, the memory of the array is released too
+    m_hash.changeSize(0, false);
 }
 
-template <class IndexType, class FiledType>
-void cHash<IndexType, FiledType>::append(const IndexType& index, const FiledType& data)
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::setAllocator(cAllocator* allocator)
 {
+    for (uint i = 0; i < m_hash.getSize(); i++)
+    {
+        if (!m_hash[i].isEmpty())
+        {
+            XSTL_THROW(cException, EXCEPTION_FAILED);
+        }
+    }
+
+    freeHash();
+    m_allocator = allocator;
+    m_hash.setAllocator(allocator);
+    initHash(m_vectorSize);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+cAllocator* cHash<IndexType, FiledType, HashFunction>::getAllocator() const
+{
+    return m_allocator;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::append(const IndexType& index, const FiledType& data)
+{
+    uint arrayPosition;
+
     // Test that the object is unique
-    CHECK(!hasKey(index));
+    CHECK(find(index, arrayPosition) == NULL);
+
+    // Object doesn't found
+    // Add the element in the end of the list.
+    add(arrayPosition, index, data);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+typename cHash<IndexType, FiledType, HashFunction>::ListType::iterator
+    cHash<IndexType, FiledType, HashFunction>::findIterator(const IndexType& index,
+                                                            uint& arrayPosition) const
+{
+    // Compute the position of the element in the array
+    arrayPosition = m_hashFunction(index, m_hash.getSize());
 
-	// Compute the position of the element in the array
-	uint arrayPosition = cHashFunction(index, m_hash->getSize());
+    // Start searching in the currect link_list
+    // Recieve the begining iterator of the list and scan it until the end
+    ListType& list = m_hash[arrayPosition];
+    typename ListType::iterator end = list.end();
+    for (typename ListType::iterator i = list.begin(); i != end; i++)
+    {
+        if ((*i).m_a == index)
+        {
+            // We found our elemenet
+            return i;
+        }
+    }
 
-	// Object doesn't found
-	// Add the element in the end of the list.
-	(*m_hash)[arrayPosition].append(cDualElement<IndexType, FiledType>(index, data));
+    return end;
 }
 
-template <class IndexType, class FiledType>
-bool cHash<IndexType, FiledType>::hasKey(const IndexType& index) const
+template <class IndexType, class FiledType, class HashFunction>
+typename cHash<IndexType, FiledType, HashFunction>::ElementType*
+    cHash<IndexType, FiledType, HashFunction>::find(const IndexType& index, uint& arrayPosition) const
 {
-	// Compute the position of the element in the array
-	uint arrayPosition = cHashFunction(index, m_hash->getSize());
+    typename ListType::iterator i = findIterator(index, arrayPosition);
+    if (i == m_hash[arrayPosition].end())
+        return NULL;
 
-	// Start searching in the currect link_list
-	// Recieve the begining iterator of the list and scan it until the end
-	typename cList<ElementType>::iterator i = (*m_hash)[arrayPosition].begin();
-	for (;i != (*m_hash)[arrayPosition].end(); i++)
-	{
-			 if ((*i).m_a == index)
-			 {
-				 // We found our elemenet, exit the searching
-				 break;
-			 }
-	}
+    return &(*i);
+}
 
-	// Test whether we reach the end of the list
-	// e.g. we couldn't find the index in any place
-	// of the list.
-	if (i == (*m_hash)[arrayPosition].end())
-	{
-		return false;
-	}
+template <class IndexType, class FiledType, class HashFunction>
+typename cHash<IndexType, FiledType, HashFunction>::ElementType&
+    cHash<IndexType, FiledType, HashFunction>::add(uint arrayPosition, const IndexType& index,
+                                                   const FiledType& data)
+{
+    ListType& list = m_hash[arrayPosition];
+    list.append(ElementType(index, data));
 
-	return true;
+    // The new element is the last element of the list
+    return *(list.end() - 1);
 }
 
-template <class IndexType, class FiledType>
-void cHash<IndexType, FiledType>::remove(const IndexType &index)
+template <class IndexType, class FiledType, class HashFunction>
+FiledType& cHash<IndexType, FiledType, HashFunction>::insertOrAssign(const IndexType& index,
+                                                                     const FiledType& data)
 {
-	// Compute the position of the element in the array
-	uint arrayPosition = cHashFunction(index, m_hash->getSize());
+    uint arrayPosition;
+    ElementType* element = find(index, arrayPosition);
+    if (element != NULL)
+    {
+        element->m_b = data;
+        return element->m_b;
+    }
 
-	// Start searching in the currect link_list
-	// Recieve the begining iterator of the list and scan it until the end
-	typename cList<ElementType>::iterator i = (*m_hash)[arrayPosition].begin();
-	for (; i != (*m_hash)[arrayPosition].end(); i++)
-	{
-			 if ((*i).m_a == index)
-			 {
-				 // We found our elemenet, exit the searching
-				 break;
-			 }
-	}
+    return add(arrayPosition, index, data).m_b;
+}
 
-	// Test whether we reach the end of the list
-	// e.g. we couldn't find the index in any place
-	// of the list.
-	if (i == (*m_hash)[arrayPosition].end())
-	{
-		XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
-	}
+template <class IndexType, class FiledType, class HashFunction>
+FiledType& cHash<IndexType, FiledType, HashFunction>::findOrInsert(const IndexType& index,
+                                                                   const FiledType& data /* = FiledType() */)
+{
+    uint arrayPosition;
+    ElementType* element = find(index, arrayPosition);
+    if (element != NULL)
+    {
+        return element->m_b;
+    }
 
-	/* Remove i from the list */
-	(*m_hash)[arrayPosition].remove(i);
+    return add(arrayPosition, index, data).m_b;
 }
 
-template <class IndexType, class FiledType>
-void cHash<IndexType, FiledType>::removeAll()
+template <class IndexType, class FiledType, class HashFunction>
+bool cHash<IndexType, FiledType, HashFunction>::tryGet(const IndexType& index, FiledType*& data)
+{
+    uint arrayPosition;
+    ElementType* element = find(index, arrayPosition);
+    data = (element != NULL) ? &element->m_b : NULL;
+    return (element != NULL);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cHash<IndexType, FiledType, HashFunction>::tryGet(const IndexType& index,
+                                                       const FiledType*& data) const
+{
+    uint arrayPosition;
+    const ElementType* element = find(index, arrayPosition);
+    data = (element != NULL) ? &element->m_b : NULL;
+    return (element != NULL);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+bool cHash<IndexType, FiledType, HashFunction>::hasKey(const IndexType& index) const
+{
+    uint arrayPosition;
+    return find(index, arrayPosition) != NULL;
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::remove(const IndexType &index)
+{
+    uint arrayPosition;
+    typename ListType::iterator i = findIterator(index, arrayPosition);
+
+    // Test whether the index exists in the hash
+    if (i == m_hash[arrayPosition].end())
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+
+    // Remove i from the list
+    m_hash[arrayPosition].remove(i);
+}
+
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::removeAll()
 {
     freeHash();
     initHash(m_vectorSize);
 }
 
-template <class IndexType, class FiledType>
-void cHash<IndexType, FiledType>::keys(cList<IndexType>& ret) const
+template <class IndexType, class FiledType, class HashFunction>
+void cHash<IndexType, FiledType, HashFunction>::keys(cList<IndexType>& ret) const
 {
-	for (uint i = 0; i < m_hash->getSize(); i++)
+	for (uint i = 0; i < m_hash.getSize(); i++)
 	{
-		for (typename cList<ElementType>::iterator j = (*m_hash)[i].begin();
-		     j != (*m_hash)[i].end(); j++)
+		for (typename cList<ElementType>::iterator j = m_hash[i].begin();
+		     j != m_hash[i].end(); j++)
 		{
 			ret.append((*j).m_a);
 		}
 	}
 }
 
-template <class IndexType, class FiledType>
-cList<IndexType> cHash<IndexType, FiledType>::keys() const
+template <class IndexType, class FiledType, class HashFunction>
+cList<IndexType> cHash<IndexType, FiledType, HashFunction>::keys() const
 {
 	cList<IndexType> ret;
 	keys(ret);
 	return ret;
 }
 
-template <class IndexType, class FiledType>
-const cHash<IndexType, FiledType> & cHash<IndexType, FiledType>::operator =
-    (const cHash<IndexType, FiledType> &other)
+template <class IndexType, class FiledType, class HashFunction>
+const cHash<IndexType, FiledType, HashFunction> & cHash<IndexType, FiledType, HashFunction>::operator =
+    (const cHash<IndexType, FiledType, HashFunction> &other)
 {
 	if (this != &other)
 	{
-		/* Copy the global array */
-		if (this->m_hash != NULL)
-		{
-			freeHash();
-		}
-		this->m_hash = new cArray<ListType>(*other.m_hash);
-        m_vectorSize = this->m_hash->getSize();
+		/* Copy the global array, keep the allocator */
+		freeHash();
+        m_vectorSize = other.m_hash.getSize();
+        initHash(m_vectorSize);
+        for (uint i = 0; i < m_vectorSize; i++)
+        {
+            m_hash[i] = other.m_hash[i];
+        }
+        m_hashFunction = other.m_hashFunction;
 	}
 
 	return *this;
 }
 
-template <class IndexType, class FiledType>
-FiledType & cHash<IndexType, FiledType>::operator [] (const IndexType &index)
+template <class IndexType, class FiledType, class HashFunction>
+FiledType & cHash<IndexType, FiledType, HashFunction>::operator [] (const IndexType &index)
 {
-    const cHash<IndexType, FiledType>* constThis = this;
+    const cHash<IndexType, FiledType, HashFunction>* constThis = this;
 
     // Use the same reference
     return const_cast<FiledType&>((*constThis)[index]);
 }
 
-template <class IndexType, class FiledType>
-const FiledType & cHash<IndexType, FiledType>::operator [] (const IndexType &index) const
+template <class IndexType, class FiledType, class HashFunction>
+const FiledType & cHash<IndexType, FiledType, HashFunction>::operator [] (const IndexType &index) const
 {
-    // Compute the position of the element in the array
-    uint arrayPosition = cHashFunction(index, m_hash->getSize());
-
-    // Start searching in the currect link_list
-    // Recieve the begining iterator of the list and scan it until the end
-    typename cList<ElementType>::iterator i = (*m_hash)[arrayPosition].begin();
-    for (; i != (*m_hash)[arrayPosition].end(); i++)
-    {
-        if ((*i).m_a == index)
-        {
-            // We found our elemenet, exit the searching
-            break;
-        }
-    }
-
-    // Test whether we reach the end of the list
-    // e.g. we couldn't find the index in any place
-    // of the list.
-    if (i == (*m_hash)[arrayPosition].end())
+    const FiledType* data;
+    if (!tryGet(index, data))
     {
         XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
     }
 
     // Return the refrence in the list
-    return (*i).m_b;
+    return *data;
 }
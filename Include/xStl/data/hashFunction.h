@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_HASHFUNCTION_H
+#define __TBA_STL_HASHFUNCTION_H
+
+/*
+ * hashFunction.h
+ *
+ * The seeded hash-function family used by the hash tables of the xStl. The
+ * functions returns a full width hash-value which should be reduced into the
+ * range of the table (See cHashFunction() in hash.h)
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/osdef.h"
+#include "xStl/data/string.h"
+#include "xStl/data/sarray.h"
+
+/*
+ * The result of a hash function. 16 bit compilers doesn't support 64 bit
+ * numbers and uses a 32 bit mixer.
+ */
+#ifndef XSTL_16BIT
+    typedef uint64 hashValue;
+#else
+    typedef uint32 hashValue;
+#endif
+
+/*
+ * class cHashMixer
+ *
+ * The primitives of the hash family. Every byte of the input affects all the
+ * bits of the output (avalanche), so short identifiers, anagrams and keys
+ * which differ only in their high bits are spread over the entire table.
+ *
+ * Different seeds generate independent functions of the same family.
+ */
+class cHashMixer
+{
+public:
+    enum {
+        // The seed used by the default cHashFunction() implementation
+        DefaultSeed = 0
+    };
+
+    /*
+     * Hash a memory block. The block is processed a word at a time.
+     *
+     * buffer - The memory to hash
+     * length - The number of bytes in 'buffer'
+     * seed   - Select the function of the family
+     */
+    static hashValue hashBuffer(const void* buffer,
+                                uint length,
+                                hashValue seed = DefaultSeed);
+
+    /*
+     * Hash a single integer. Unlike the "index % range", all the bits of the
+     * integer are mixed into the result.
+     *
+     * value - The number to hash
+     * seed  - Select the function of the family
+     */
+    static hashValue hashInteger(hashValue value, hashValue seed = DefaultSeed);
+
+    /*
+     * Reduce a hash-value into the range [0..range)
+     *
+     * hash  - The result of one of the hash functions
+     * range - The number of cells in the table. Must be greater than 0
+     */
+    static uint reduce(hashValue hash, uint range);
+};
+
+/*
+ * cHashCode() standart data-types implementation
+ *
+ * Returns the full width hash-value of 'index' for the function selected by
+ * 'seed'. In order to use the cSeededHashFunctor with a new key type, add a
+ * cHashCode() overload for the key.
+ */
+hashValue cHashCode(const int& index, hashValue seed);
+hashValue cHashCode(const uint32& index, hashValue seed);
+hashValue cHashCode(const float& index, hashValue seed);
+hashValue cHashCode(const char* index, hashValue seed);
+hashValue cHashCode(const cString& index, hashValue seed);
+hashValue cHashCode(const cBuffer& index, hashValue seed);
+hashValue cHashCode(const addressNumericValue& index, hashValue seed);
+#ifndef XSTL_16BIT
+// 16 bit application doesn't have threads
+hashValue cHashCode(const uint64& index, hashValue seed);
+hashValue cHashCode(const cOSDef::threadHandle& index, hashValue seed);
+#endif // XSTL_16BIT
+
+/*
+ * Returns the hash-value of the lower-case form of 'index' (See cStringCase),
+ * so strings which differ only in the case of their letters have the same
+ * hash-value. The string is folded in small blocks on the stack, no memory is
+ * allocated.
+ */
+hashValue cHashCodeNoCase(const cStringView& index, hashValue seed);
+
+#endif // __TBA_STL_HASHFUNCTION_H
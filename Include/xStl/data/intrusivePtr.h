@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_INTRUSIVEPTR_H
+#define __TBA_STL_INTRUSIVEPTR_H
+
+/*
+ * intrusivePtr.h
+ *
+ * Implement a smart-pointer for objects which contain their own reference
+ * counter.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/interlocked.h"
+#include "xStl/except/assert.h"
+
+/*
+ * cIntrusiveRefCount
+ *
+ * A base class for objects which are owned by cIntrusivePtr. The reference
+ * counter is a member of the object, so creating an object doesn't need
+ * another allocation for a counter (See cSmartPtr) and reaching the counter
+ * doesn't need another memory access.
+ *
+ * The counter is changed by atomic operations, so objects can be shared
+ * between threads. The object is destroyed when the last reference is
+ * released (the destructor is virtual).
+ *
+ * Copying an object doesn't copy its references, the new object is not
+ * referenced by anyone.
+ *
+ * Usage:
+ *    class cNode : public cIntrusiveRefCount {
+ *        ...
+ *    };
+ *    typedef cIntrusivePtr<cNode> cNodePtr;
+ *
+ *    cNodePtr node(new cNode());
+ */
+class cIntrusiveRefCount
+{
+public:
+    /*
+     * Add a reference to the object.
+     */
+    void addReference() const
+    {
+        cInterlocked::increment(&m_referenceCount);
+    }
+
+    /*
+     * Remove a reference from the object. When the last reference is removed
+     * the object is deleted.
+     */
+    void releaseReference() const
+    {
+        if (cInterlocked::decrement(&m_referenceCount) == 0)
+            delete this;
+    }
+
+    /*
+     * Return the number of references to the object.
+     */
+    counter_t getReferenceCount() const
+    {
+        return cInterlocked::load(&m_referenceCount);
+    }
+
+protected:
+    /*
+     * Constructor. The new object has no references.
+     */
+    cIntrusiveRefCount() : m_referenceCount(0) {}
+
+    /*
+     * Copy-constructor. The new object has no references.
+     */
+    cIntrusiveRefCount(const cIntrusiveRefCount&) : m_referenceCount(0) {}
+
+    /*
+     * Operator =. The references of the object are not changed.
+     */
+    cIntrusiveRefCount& operator = (const cIntrusiveRefCount&)
+    {
+        return *this;
+    }
+
+    /*
+     * Virtual destructor. Objects are deleted by releaseReference().
+     */
+    virtual ~cIntrusiveRefCount() {}
+
+private:
+    // The number of cIntrusivePtr which are pointing to the object
+    mutable volatile counter_t m_referenceCount;
+};
+
+
+/*
+ * cIntrusivePtr
+ *
+ * A smart-pointer for objects which inherit cIntrusiveRefCount. The class has
+ * the same interface as cSmartPtr, but it is a single pointer and can be
+ * constructed from a raw pointer of an object which is already owned by other
+ * cIntrusivePtr (for example the 'this' pointer).
+ *
+ * Like cSmartPtr, a single cIntrusivePtr instance should not be changed by one
+ * thread while other threads access it.
+ */
+template<class T>
+class cIntrusivePtr
+{
+public:
+    /*
+     * Default constructor. Create NULL pointer reference.
+     */
+    cIntrusivePtr();
+
+    /*
+     * Constructor. Add a reference to 'object'. The object can be NULL.
+     */
+    explicit cIntrusivePtr(T* object);
+
+    /*
+     * Copy-constructor. (with refrence increasment)
+     */
+    cIntrusivePtr(const cIntrusivePtr<T>& other);
+
+    /*
+     * Copy-constructor from a pointer to a derived class.
+     */
+    template<class U>
+    cIntrusivePtr(const cIntrusivePtr<U>& other) :
+        m_object(other.getPointer())
+    {
+        if (m_object != NULL)
+            m_object->addReference();
+    }
+
+    /*
+     * Destructor. Remove the reference from the object.
+     */
+    ~cIntrusivePtr();
+
+    // operators
+
+    /*
+     * Return pointer reference to the object.
+     */
+    inline operator T*(void) { return m_object; }
+    inline T& operator*(void) { return *m_object; }
+    inline T* operator->(void) { return m_object; }
+
+    /*
+     * Return pointer reference to the const object.
+     */
+    inline operator const T*(void) const { return m_object; }
+    inline const T& operator*(void) const { return *m_object; }
+    inline const T* operator->(void) const { return m_object; }
+
+    /*
+     * Copy operator. Dereference the current object and reference the object
+     * of other.
+     */
+    cIntrusivePtr<T>& operator=(const cIntrusivePtr<T>& other);
+
+    /*
+     * Return true if the pointers are pointing to the same object.
+     */
+    bool operator == (const cIntrusivePtr<T>& other) const;
+    bool operator != (const cIntrusivePtr<T>& other) const;
+
+    /*
+     * Return whether the object is NULL.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Return the referenced object.
+     */
+    inline T* getPointer() const { return m_object; }
+
+    /*
+     * Dereference the current object and reference 'object' instead.
+     */
+    void reset(T* object = NULL);
+
+private:
+    // The referenced object
+    T* m_object;
+};
+
+// Implementation call (this is a template function)
+#include "xStl/data/intrusivePtr.inl"
+
+#endif //__TBA_STL_INTRUSIVEPTR_H
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * intrusivePtr.inl
+ *
+ * Implementation code of cIntrusivePtr object.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+template<class T>
+cIntrusivePtr<T>::cIntrusivePtr() :
+    m_object(NULL)
+{
+}
+
+template<class T>
+cIntrusivePtr<T>::cIntrusivePtr(T* object) :
+    m_object(object)
+{
+    if (m_object != NULL)
+        m_object->addReference();
+}
+
+template<class T>
+cIntrusivePtr<T>::cIntrusivePtr(const cIntrusivePtr<T>& other) :
+    m_object(other.m_object)
+{
+    if (m_object != NULL)
+        m_object->addReference();
+}
+
+template<class T>
+cIntrusivePtr<T>::~cIntrusivePtr()
+{
+    if (m_object != NULL)
+        m_object->releaseReference();
+}
+
+template<class T>
+cIntrusivePtr<T>& cIntrusivePtr<T>::operator=(const cIntrusivePtr<T>& other)
+{
+    reset(other.m_object);
+    return *this;
+}
+
+template<class T>
+void cIntrusivePtr<T>::reset(T* object /* = NULL */)
+{
+    // Reference the new object first, since it might be owned by the current
+    // object
+    if (object != NULL)
+        object->addReference();
+    T* old = m_object;
+    m_object = object;
+    if (old != NULL)
+        old->releaseReference();
+}
+
+template<class T>
+bool cIntrusivePtr<T>::operator == (const cIntrusivePtr<T>& other) const
+{
+    return m_object == other.m_object;
+}
+
+template<class T>
+bool cIntrusivePtr<T>::operator != (const cIntrusivePtr<T>& other) const
+{
+    return m_object != other.m_object;
+}
+
+template<class T>
+bool cIntrusivePtr<T>::isEmpty() const
+{
+    return (m_object == NULL);
+}
@@ -44,6 +44,7 @@
 #include "xStl/except/exception.h"
 #include "xStl/except/assert.h"
 #include "xStl/utils/algorithm.h"
+#include "xStl/data/nodePool.h"
 
 #ifdef XSTL_WINDOWS
 // Template classes might not use all the local functions the interface has
@@ -67,7 +68,14 @@
  * The declartion of the stl "list" class which include implementation of the
  * abstract layer of the list, and the implementation of the iterator class.
  *
- * The link-list copyies the element into internal data-struct.
+ * The link-list copyies the element into internal data-struct. The element is
+ * stored inside the node, and the nodes are allocated from a cNodePool which
+ * belongs to the list, so adding an element doesn't call the global operator
+ * new, and removed nodes are recycled by the next additions. The slabs of the
+ * pool can be allocated from a cArena (See setAllocator()).
+ * The pool is created by the first addition and freed when the list becomes
+ * empty by removeAll(), so an empty list (e.g. an unused cHash bucket) doesn't
+ * allocate memory.
  *
  * requires from T:
  *  T must have an equal == operator
@@ -85,32 +93,54 @@ public:
     /*
      * This is internal class which store information about the link-list.
      * The class store pointers to allow terminate entry in the link-list.
+     * The terminate entry is a ListLink which is a member of the list, and
+     * all the other entries are ListNode.
      * The implementation is inside the include file since out-side compilation
      * is carch the system
      */
-    class ListNode
+    class ListLink
     {
     public:
-        ListNode(const T* node) :
-          information(NULL)
+        /* Saves the next and the previous pointers */
+        // The next element
+        ListLink* next;
+        // The previous element
+        ListLink* prev;
+    };
+
+    class ListNode : public ListLink
+    {
+    public:
+        ListNode(const T& node) :
+          information(node)
         {
-            if (node != NULL)
-                information = new T(*node);
         }
 
-        ~ListNode()
+        #ifdef XSTL_CPP11
+        template <class... Args>
+        ListNode(Args&&... args) :
+          information(t_forward<Args>(args)...)
         {
-            if (information != NULL)
-                delete information;
+        }
+        #endif
+
+        /*
+         * The nodes are allocated from the pool of the list. The operator
+         * delete is called only if the constructor of T throws an exception,
+         * use cList::freeNode() otherwise.
+         */
+        static void* operator new(size_t, cNodePool& pool)
+        {
+            return pool.allocate();
+        }
+
+        static void operator delete(void* node, cNodePool& pool)
+        {
+            pool.free(node);
         }
 
-        /* Saves the next and the previous pointers */
         // The content of the entry
-        T* information;
-        // The next element
-        ListNode* next;
-        // The previous element
-        ListNode* prev;
+        T information;
     };
 
     /* Constructor and deconstructor of the list */
@@ -130,6 +160,13 @@ public:
      */
     cList(const cList<T> &other);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Move constructor. Take the entries of 'other', which becomes empty.
+     */
+    cList(cList<T>&& other);
+    #endif
+
     /*
      * Create a new link-list with one element 'object'
      */
@@ -139,13 +176,9 @@ public:
      * Free the link-list memory and create a new list which will be an exact
      * copy of the original link.
      *
-     * assignPointer - Incase the variable is true, the function makes the
-     *                 internal pointer reference to the pointers of 'other'.
-     *
-     * Note: if the "assignPointer" flag will be on, WHICH IS
-     *       NOT RECOMMANDED then a new link-list will be assigned
-     *       to the original data type, and there will be a big probleam
-     *       of memory closion in MTA (Multiple Thread Apartment).
+     * assignPointer - Not supported. The nodes belong to the pool of their
+     *                 list, so they can't be referenced by another list. The
+     *                 entries of 'other' are always copied.
      */
     void clone(const cList<T> &other, bool assignPointer = false);
 
@@ -161,6 +194,31 @@ public:
      */
     void append(const T& node);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Append element to the link-list. The element is moved using the move-
+     * constructor.
+     *
+     * node - The object to be added.
+     */
+    void append(T&& node);
+
+    /*
+     * Construct a new element at the end of the link-list from 'args' and
+     * return it. The element is constructed in place, without any copy.
+     *
+     * NOTE: Microsoft visual studio .NET version 7.10 cannot compile the
+     *       code of the function if it's found outside the class deceleration.
+     */
+    template <class... Args>
+    T& emplace(Args&&... args)
+    {
+        ListNode* node = new (getPool()) ListNode(t_forward<Args>(args)...);
+        appendNode(node);
+        return node->information;
+    }
+    #endif
+
     /*
      * Insert element to the beginning of the link-list. The element is
      * copy using copy-constructor.
@@ -174,6 +232,39 @@ public:
      */
     void removeAll();
 
+    /*
+     * Replace the entries of the link-list with the entries of 'other'.
+     * No element is copied.
+     */
+    void swap(cList<T>& other);
+
+    /*
+     * Allocate the nodes of the list from 'allocator' (NULL for the default
+     * allocator). See cAllocator.
+     *
+     * Throws exception if the list isn't empty.
+     */
+    void setAllocator(cAllocator* allocator);
+
+    /*
+     * Return the allocator of the list nodes, or NULL for the default
+     * allocator.
+     */
+    cAllocator* getAllocator() const;
+
+    /*
+     * Sort the elements of the list with a stable merge-sort. The nodes are
+     * relinked, so no element is copied, no memory is allocated and the
+     * iterators keep pointing to the same elements.
+     *
+     * compare - Functor which returns true if its first argument should be
+     *           placed before the second (See cLessThan). Without it the
+     *           operator < of T is used.
+     */
+    void sort();
+    template <class Compare>
+    void sort(const Compare& compare);
+
     /*
      * Determine whether the list has any items or not.
      * returns true if list has no items. false if it has item(s).
@@ -190,6 +281,9 @@ public:
      * invalid. Don't use it.
      *
      * position - The iterator position.
+     *
+     * Return an iterator to the element after the removed one.
+     * Throws exception if 'position' is the end of the list.
      */
     iterator remove(iterator &position);
 
@@ -267,6 +361,14 @@ public:
      */
     cList<T> & operator = (const cList<T> &other);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Move operator. Exchange the entries with 'other', so no element is
+     * copied or allocated.
+     */
+    cList<T> & operator = (cList<T>&& other);
+    #endif
+
     // TODO: To create a normal list.
     // cList<T> operator , (const cList<T> &other, const T& object);
 
@@ -298,7 +400,7 @@ public:
          *
          * Constructor. Used only in the cList class.
          */
-        iterator(ListNode *position)
+        iterator(ListLink *position)
         {
             m_position = position;
             assertIndex();
@@ -372,7 +474,7 @@ public:
              * Scaning the next of the list to see whether the
              * element is there.
              */
-            ListNode *index = m_position;
+            ListLink *index = m_position;
             while (index != NULL)
             {
                 if (index == other.m_position)
@@ -391,7 +493,7 @@ public:
          */
         T& operator *()
         {
-            return *(m_position->information);
+            return static_cast<ListNode*>(m_position)->information;
         }
 
         /*
@@ -401,7 +503,7 @@ public:
          */
         const T& operator *() const
         {
-            return *(m_position->information);
+            return static_cast<ListNode*>(m_position)->information;
         }
 
 
@@ -432,7 +534,7 @@ public:
          */
         iterator operator+ (const uint count)
         {
-            ListNode *tmp = m_position;
+            ListLink *tmp = m_position;
             for (uint i = 0; i < count; i++)
             {
                 tmp = tmp->next;
@@ -446,7 +548,7 @@ public:
          */
         iterator operator- (const uint count)
         {
-            ListNode *tmp = m_position;
+            ListLink *tmp = m_position;
             for (uint i = 0; i < count; i++)
             {
                 tmp = tmp->prev;
@@ -465,7 +567,7 @@ public:
             ASSERT(m_position != NULL);
         }
         /* Inline data about the list position */
-        ListNode *m_position;
+        ListLink *m_position;
     };
 
 private:
@@ -488,13 +590,59 @@ private:
      */
     void initList();
 
+    /*
+     * Link a new node at the end of the link-list.
+     */
+    void appendNode(ListNode* node);
+
+    /*
+     * Link a new node before 'position'.
+     */
+    void insertNode(ListLink* position, ListNode* node);
+
+    /*
+     * Destruct the element of 'node' and return the node into the pool.
+     */
+    void freeNode(ListLink* node);
+
+    /*
+     * Return the pool of the nodes. The pool is created on the first call.
+     *
+     * Throws out of memory exception.
+     */
+    cNodePool& getPool();
+
+    /*
+     * Free the pool of the nodes and all its memory. The nodes must be
+     * destructed.
+     */
+    void freePool();
+
+    /*
+     * Merge two sorted chains of nodes, which are linked by their next
+     * pointers and terminated by NULL. The nodes of 'first' are placed before
+     * the equal nodes of 'second'. Return the merged chain.
+     */
+    template <class Compare>
+    static ListLink* mergeChains(ListLink* first, ListLink* second,
+                                 const Compare& compare);
+
     // Members
 
+    // The nodes memory, or NULL until the first node is added
+    cNodePool* m_pool;
+
+    // The allocator of the pool and of its slabs
+    cAllocator* m_allocator;
+
     // Pointer to the first element in the link-list
-    ListNode *m_first;
+    ListLink *m_first;
+
+    // Pointer to the last element in the link-list, which is always 'm_end'
+    ListLink *m_last;
 
-    // Pointer to the last element in the link-list
-    ListNode *m_last;
+    // The terminate entry of the link-list
+    ListLink m_end;
 };
 
 // Include implementation. This is nessasary in template classes.
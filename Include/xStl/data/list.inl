@@ -30,20 +30,18 @@
  */
 
 /*
- * array.inl
+ * list.inl
  *
- * Implementation code of the cArray class.
+ * Implementation code of the cList class.
  *
  * Author: Elad Raz <e@eladraz.com>
  */
 template <class T>
-cList<T>::cList()
+cList<T>::cList() :
+    m_pool(NULL),
+    m_allocator(NULL)
 {
-    m_first = NULL;
-    m_last = NULL;
     initList();
-    ASSERT(m_first != NULL);
-    ASSERT(m_last != NULL);
 }
 
 template <class T>
@@ -53,122 +51,260 @@ cList<T>::~cList()
 }
 
 template <class T>
-cList<T>::cList(const cList<T> &other)
+cList<T>::cList(const cList<T> &other) :
+    m_pool(NULL),
+    m_allocator(NULL)
 {
-    m_first = NULL;
-    m_last = NULL;
     initList();
     clone(other);
 }
 
+#ifdef XSTL_CPP11
 template <class T>
-cList<T>::cList(const T& object)
+cList<T>::cList(cList<T>&& other) :
+    m_pool(NULL),
+    m_allocator(NULL)
 {
-    m_first = NULL;
-    m_last = NULL;
     initList();
-    append(object);
+    swap(other);
 }
 
 template <class T>
-void cList<T>::clone(const cList<T> &other, bool assignPointer /* = false */)
+cList<T> & cList<T>::operator = (cList<T>&& other)
 {
-    freeList();	// Clear the memory.
-    if (assignPointer)
+    if (getAllocator() != other.getAllocator())
     {
-        m_first = other.m_first;
-        m_last  = other.m_last;
-    } else
+        // Keep the allocator of this list
+        return *this = static_cast<const cList<T>&>(other);
+    }
+
+    // 'other' receives the previous entries, which are freed by its owner
+    swap(other);
+    return *this;
+}
+
+template <class T>
+void cList<T>::append(T&& node)
+{
+    appendNode(new (getPool()) ListNode(t_move(node)));
+}
+#endif // XSTL_CPP11
+
+template <class T>
+void cList<T>::swap(cList<T>& other)
+{
+    t_swap(m_pool, other.m_pool);
+    t_swap(m_allocator, other.m_allocator);
+    t_swap(m_first, other.m_first);
+    t_swap(m_end.prev, other.m_end.prev);
+
+    // The last nodes should point to the terminate entry of their new list
+    if (m_end.prev == NULL)
+        m_first = m_last;
+    else
+        m_end.prev->next = m_last;
+
+    if (other.m_end.prev == NULL)
+        other.m_first = other.m_last;
+    else
+        other.m_end.prev->next = other.m_last;
+}
+
+template <class T>
+void cList<T>::setAllocator(cAllocator* allocator)
+{
+    if (!isEmpty())
     {
-        /* Start copying data */
-        initList();
+        XSTL_THROW(cException, EXCEPTION_FAILED);
+    }
 
-        cListT iterator index = other.begin();
-        while (index != other.end())
-        {
-            append(*index);
-            index++;
-        }
+    // Release the recycled nodes of the previous allocator
+    freePool();
+    m_allocator = allocator;
+}
+
+template <class T>
+cAllocator* cList<T>::getAllocator() const
+{
+    return m_allocator;
+}
+
+template <class T>
+cList<T>::cList(const T& object) :
+    m_pool(NULL),
+    m_allocator(NULL)
+{
+    initList();
+    append(object);
+}
+
+template <class T>
+void cList<T>::clone(const cList<T> &other, bool /* assignPointer = false */)
+{
+    if (this == &other)
+        return;
+
+    freeList();	// Clear the memory.
+
+    /* Start copying data */
+    cListT iterator index = other.begin();
+    while (index != other.end())
+    {
+        append(*index);
+        index++;
     }
 }
 
 template <class T>
 void cList<T>::append(const T& node)
 {
-    ASSERT(m_first != NULL);
-    ASSERT(m_last != NULL);
+    appendNode(new (getPool()) ListNode(node));
+}
+
+template <class T>
+void cList<T>::sort()
+{
+    sort(cLessThan<T>());
+}
 
-    ListNode *tmp;	// The new node which will be entered.
+template <class T>
+template <class Compare>
+void cList<T>::sort(const Compare& compare)
+{
+    if ((m_first == m_last) || (m_first->next == m_last))
+        return;
 
-    // Create the new node.
-    tmp = new ListNode(&node);
+    // bins[i] is NULL or a sorted chain of 2^i nodes. The nodes of a higher
+    // bin are older, so merging it before a newer chain keeps the order of
+    // equal elements.
+    ListLink* bins[sizeof(uint) * 8];
+    uint usedBins = 0;
+    uint i;
+    ListLink* node = m_first;
+    while (node != m_last)
+    {
+        ListLink* next = node->next;
+        node->next = NULL;
+        ListLink* carry = node;
+        for (i = 0; (i < usedBins) && (bins[i] != NULL); i++)
+        {
+            carry = mergeChains(bins[i], carry, compare);
+            bins[i] = NULL;
+        }
+        if (i == usedBins)
+            usedBins++;
+        bins[i] = carry;
+        node = next;
+    }
 
-    // See whether the list is empty
-    if (m_first == m_last)
+    // Merge the bins, from the newest to the oldest
+    ListLink* sorted = NULL;
+    for (i = 0; i < usedBins; i++)
     {
-        // The list is empty, create the first node.
-        tmp->prev = NULL;
-        tmp->next = m_last;
+        if (bins[i] != NULL)
+        {
+            sorted = (sorted == NULL) ? bins[i] :
+                                        mergeChains(bins[i], sorted, compare);
+        }
+    }
 
-        m_first = tmp;
-        m_last->prev = tmp;
-    } else
+    // Restore the previous pointers and the terminate entry
+    m_first = sorted;
+    ListLink* previous = NULL;
+    for (node = sorted; node != NULL; node = node->next)
     {
-        /* Create an end-point node */
-        tmp->prev = m_last->prev;
-        tmp->next = m_last;
-        m_last->prev->next = tmp;
-        m_last->prev = tmp;
+        node->prev = previous;
+        previous = node;
     }
+    previous->next = m_last;
+    m_last->prev = previous;
 }
 
 template <class T>
-void cList<T>::insert(iterator &position, const T& node)
+template <class Compare>
+typename cList<T>::ListLink* cList<T>::mergeChains(ListLink* first,
+                                                   ListLink* second,
+                                                   const Compare& compare)
 {
-    // Check iterator
-    ASSERT(position.m_position != NULL);
-
-    // Check first element
-    if (m_first == m_last)
+    ListLink head;
+    ListLink* tail = &head;
+    while ((first != NULL) && (second != NULL))
     {
-        append(node);
-        return;
+        if (compare(static_cast<ListNode*>(second)->information,
+                    static_cast<ListNode*>(first)->information))
+        {
+            tail->next = second;
+            second = second->next;
+        } else
+        {
+            tail->next = first;
+            first = first->next;
+        }
+        tail = tail->next;
     }
+    tail->next = (first != NULL) ? first : second;
+    return head.next;
+}
 
-    ListNode *tmp;	// The new node which will be entered.
+template <class T>
+void cList<T>::appendNode(ListNode* node)
+{
+    insertNode(m_last, node);
+}
 
-    // Create the new node.
-    tmp = new ListNode(&node);
-    tmp->prev = position.m_position->prev;
-    tmp->next = position.m_position;
+template <class T>
+void cList<T>::insertNode(ListLink* position, ListNode* node)
+{
+    ASSERT(position != NULL);
 
-    // Link the new entry
-    position.m_position->prev = tmp;
-    if (m_first == position.m_position)
+    // Link the new entry before 'position'
+    node->prev = position->prev;
+    node->next = position;
+    position->prev = node;
+    if (m_first == position)
     {
-        m_first = tmp;
+        m_first = node;
     } else
     {
-        tmp->prev->next = tmp;
+        node->prev->next = node;
     }
 }
 
 template <class T>
-void cList<T>::insert(const T& node)
+void cList<T>::freeNode(ListLink* node)
 {
-    ASSERT(m_first != NULL);
-    ASSERT(m_last != NULL);
+    ListNode* listNode = static_cast<ListNode*>(node);
+    listNode->~ListNode();	// The deconstructor of T will be called.
+    m_pool->free(listNode);
+}
 
-    ListNode *tmp;	// The new node which will be entered.
+template <class T>
+cNodePool& cList<T>::getPool()
+{
+    if (m_pool == NULL)
+        m_pool = cNodePool::create(sizeof(ListNode), m_allocator);
+    return *m_pool;
+}
 
-    // Create the new node.
-    tmp = new ListNode(&node);
-    tmp->prev = NULL;
-    tmp->next = m_first;
+template <class T>
+void cList<T>::freePool()
+{
+    cNodePool::destroy(m_pool);
+    m_pool = NULL;
+}
 
-    // Link the new entry
-    m_first->prev = tmp;
-    m_first = tmp;
+template <class T>
+void cList<T>::insert(iterator &position, const T& node)
+{
+    // Check iterator
+    ASSERT(position.m_position != NULL);
+    insertNode(position.m_position, new (getPool()) ListNode(node));
+}
+
+template <class T>
+void cList<T>::insert(const T& node)
+{
+    insertNode(m_first, new (getPool()) ListNode(node));
 }
 
 template <class T>
@@ -181,7 +317,6 @@ template <class T>
 void cList<T>::removeAll()
 {
     freeList();
-    initList();
 }
 
 // Removes the object at position and returns the
@@ -189,24 +324,23 @@ void cList<T>::removeAll()
 template <class T>
 typename cList<T>::iterator cList<T>::remove(iterator &position)
 {
-    ASSERT(m_first != NULL);
-    ASSERT(m_last != NULL);
+    ListLink *tmp  = position.m_position; // Get the position of the node
+    if (tmp == m_last)
+    {
+        /* The end of the list can't be removed */
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
 
-    ListNode *tmp  = position.m_position; // Get the position of the node
-    ListNode *prev = tmp->prev;
-    ListNode *next = tmp->next;
+    ListLink *prev = tmp->prev;
+    ListLink *next = tmp->next;
 
     /* Delete the node */
-    delete tmp;
+    freeNode(tmp);
     next->prev = prev;
 
     if (prev == NULL)
     {
         /* Delete the m_first */
-        if (m_first == m_last)
-        {
-            XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
-        }
         m_first	= next;
     } else
     {
@@ -219,10 +353,11 @@ typename cList<T>::iterator cList<T>::remove(iterator &position)
 template <class T>
 bool cList<T>::isIn(const T& object)
 {
-    ListNode *tmp = m_first;	// The look-up object
+    ListLink *tmp = m_first;	// The look-up object
 
     /* Go over the link-list */
-    while ((tmp != m_last) && (!(*(tmp->information) == object)))
+    while ((tmp != m_last) &&
+           (!(static_cast<ListNode*>(tmp)->information == object)))
     {
         /* Go to the next node in the list */
         tmp = tmp->next;
@@ -240,10 +375,11 @@ bool cList<T>::isIn(const T& object)
 template <class T>
 void cList<T>::remove(const T& object)
 {
-    ListNode *tmp = m_first;	// The look-up object
+    ListLink *tmp = m_first;	// The look-up object
 
     /* Go over the link-list */
-    while ((tmp != m_last) && (!(*(tmp->information) == object)))
+    while ((tmp != m_last) &&
+           (!(static_cast<ListNode*>(tmp)->information == object)))
     {
         /* Go to the next node in the list */
         tmp = tmp->next;
@@ -256,11 +392,11 @@ void cList<T>::remove(const T& object)
     }
 
     /* The previous node should be point to the next node */
-    ListNode *prev = tmp->prev;
-    ListNode *next = tmp->next; // This could never be NULL!! but m_last
+    ListLink *prev = tmp->prev;
+    ListLink *next = tmp->next; // This could never be NULL!! but m_last
 
     /* Delete the node */
-    delete tmp;
+    freeNode(tmp);
     next->prev = prev;
 
     if (prev == NULL)
@@ -273,7 +409,6 @@ void cList<T>::remove(const T& object)
         prev->next = next;
     }
 }
-
 template <class T>
 uint cList<T>::length() const
 {
@@ -333,40 +468,33 @@ OSTREAM & operator << (OSTREAM &out, cList<S> &object)
 template <class T>
 void cList<T>::initList()
 {
-    ASSERT(m_first == NULL);
-    ASSERT(m_last == NULL);
-
     /* Setup pointers */
-    /* Create an empty node at the end of the list */
-    ListNode *end = new ListNode(NULL);
-
-    end->next = NULL; /* It will always be the last element */
-    end->prev = NULL; /* And for now it is the only element */
+    /* The terminate entry is the only entry of an empty list */
+    m_end.next = NULL; /* It will always be the last element */
+    m_end.prev = NULL; /* And for now it is the only element */
 
-    m_first = end;
-    m_last  = end;
+    m_first = &m_end;
+    m_last  = &m_end;
 }
 
 template <class T>
 void cList<T>::freeList()
 {
-    ASSERT(m_first != NULL);
-    ASSERT(m_last != NULL);
-
-    ListNode *temp = m_first; /* For scaning the list */
-    ListNode *tdel;           /* To delete a node in the list */
+    ListLink *temp = m_first; /* For scaning the list */
+    ListLink *tdel;           /* To delete a node in the list */
 
     /* Scanning the link-list from it's begins Until the end */
-    while (temp != NULL)
+    while (temp != m_last)
     {
         tdel = temp;
         temp = temp->next;	// Get the next pointer.
-        delete tdel;		// Free the memory of the last pointer.
-		                    // The deconstructor of T will be called.
+        // The deconstructor of T will be called. The node memory is released
+        // with the whole pool.
+        static_cast<ListNode*>(tdel)->~ListNode();
     }
 
-    m_first = NULL;
-    m_last  = NULL;
+    /* Release the memory of all the nodes */
+    freePool();
+    m_first = m_last;
+    m_end.prev = NULL;
 }
-
-
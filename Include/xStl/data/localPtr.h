@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_LOCALPTR_H
+#define __TBA_STL_LOCALPTR_H
+
+/*
+ * localPtr.h
+ *
+ * Implement a single-threaded smart-pointer, for object graphs which are
+ * built and destroyed by a single thread.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/counter.h"
+#include "xStl/data/smartptr.h"
+#include "xStl/except/assert.h"
+
+/*
+ * cLocalReference
+ *
+ * The reference counter of cLocalPtr objects. The counter is a plain integer.
+ * Once the object is shared with other threads (See cLocalPtr::share()) all
+ * the local references together hold a single reference over an atomic
+ * counter, which is also the counter of the cSmartPtr objects.
+ */
+class cLocalReference
+{
+public:
+    cLocalReference(DestructionMethod destructionType) :
+        m_references(1),
+        m_destructionType(destructionType),
+        m_sharedCounter(NULL)
+    {
+    }
+
+    // The number of cLocalPtr which are referencing the object
+    uint m_references;
+    // The destruction method of the object
+    DestructionMethod m_destructionType;
+    // The atomic counter, or NULL if the object was never shared
+    cCounter* m_sharedCounter;
+};
+
+
+/*
+ * cLocalPtr
+ *
+ * A smart-pointer with the same ownership semantic as cSmartPtr, but the
+ * reference counter is changed by plain (non-atomic) instructions. Use it for
+ * objects which never leave the thread which created them, such as parser
+ * trees and filter-stream chains of a single request.
+ *
+ * All the cLocalPtr instances of an object must be used by the same thread.
+ * When the object escapes to other threads, call share() which returns a
+ * cSmartPtr to the same object. The cSmartPtr copies can be used by any
+ * thread, and the object is destroyed when both all the local pointers and
+ * all the shared pointers are released.
+ *
+ * Usage:
+ *    cLocalPtr<basicIO> stream(new cMemoryStream());
+ *    ...
+ *    cSmartPtr<basicIO> shared = stream.share();
+ */
+template<class T>
+class cLocalPtr
+{
+public:
+    /*
+     * Default constructor. Create NULL pointer reference.
+     * No memory is allocated for NULL pointers.
+     */
+    cLocalPtr();
+
+    /*
+     * Constructor. Wrap a pointer which a local reference count object.
+     * The object can be NULL.
+     *
+     * object - The object to be wrap.
+     * destructionType - The method of destruction.
+     */
+    explicit cLocalPtr(T* object,
+                       DestructionMethod destructionType = SMARTPTR_DESTRUCT_DELETE);
+
+    /*
+     * Copy-constructor. (with refrence increasment)
+     */
+    cLocalPtr(const cLocalPtr<T>& other);
+
+    /*
+     * Copy-constructor from a pointer to a derived class.
+     */
+    template<class U>
+    cLocalPtr(const cLocalPtr<U>& other) :
+        m_object(other.m_object),
+        m_reference(other.m_reference)
+    {
+        if (m_reference != NULL)
+            m_reference->m_references++;
+    }
+
+    /*
+     * Destructor. Derefrence the pointer and delete it when 0 reaches.
+     */
+    ~cLocalPtr();
+
+    // operators
+
+    /*
+     * Return pointer reference to the object.
+     */
+    inline operator T*(void) { return m_object; }
+    inline T& operator*(void) { return *m_object; }
+    inline T* operator->(void) { return m_object; }
+
+    /*
+     * Return pointer reference to the const object.
+     */
+    inline operator const T*(void) const { return m_object; }
+    inline const T& operator*(void) const { return *m_object; }
+    inline const T* operator->(void) const { return m_object; }
+
+    /*
+     * Copy operator. Dereference the current object and copy the local-pointer
+     * reference by other.
+     */
+    cLocalPtr<T>& operator=(const cLocalPtr<T>& other);
+
+    /*
+     * Return true if the local-pointers pointed to the same object or not.
+     */
+    bool operator == (const cLocalPtr<T>& other) const;
+    bool operator != (const cLocalPtr<T>& other) const;
+
+    /*
+     * Return whether the refrence object is NULL which indicate that the object
+     * is empty
+     */
+    bool isEmpty() const;
+
+    /*
+     * Return the reference object stored by the local-pointer.
+     */
+    inline T* getPointer() { return m_object; }
+    inline const T* getPointer() const { return m_object; }
+
+    /*
+     * Return the number of local pointers which are referencing the object.
+     * The shared references are not counted.
+     */
+    uint getLocalReferences() const;
+
+    /*
+     * Return a cSmartPtr to the object, which can be passed to other threads.
+     * The local pointers keep referencing the same object.
+     *
+     * NOTE: Must be called by the thread which owns the local pointers.
+     */
+    cSmartPtr<T> share() const;
+
+private:
+    // Other instantiations are friends, for the derived class conversion
+    template<class U> friend class cLocalPtr;
+
+    /*
+     * Decrease refrence by one and release the object according to the
+     * destruction method.
+     */
+    void free();
+
+    // The object
+    T* m_object;
+    // The reference counter, or NULL for NULL objects
+    cLocalReference* m_reference;
+};
+
+// Implementation call (this is a template function)
+#include "xStl/data/localPtr.inl"
+
+#endif //__TBA_STL_LOCALPTR_H
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * localPtr.inl
+ *
+ * Implementation code of cLocalPtr object.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+template<class T>
+cLocalPtr<T>::cLocalPtr() :
+    m_object(NULL),
+    m_reference(NULL)
+{
+}
+
+template<class T>
+cLocalPtr<T>::cLocalPtr(T* object,
+                        DestructionMethod destructionType /* = SMARTPTR_DESTRUCT_DELETE */) :
+    m_object(object),
+    m_reference(NULL)
+{
+    // Embedded objects are created only by makeSmartPtr()
+    ASSERT(destructionType != SMARTPTR_DESTRUCT_EMBEDDED);
+    if (m_object != NULL)
+        m_reference = new cLocalReference(destructionType);
+}
+
+template<class T>
+cLocalPtr<T>::cLocalPtr(const cLocalPtr<T>& other) :
+    m_object(other.m_object),
+    m_reference(other.m_reference)
+{
+    if (m_reference != NULL)
+        m_reference->m_references++;
+}
+
+template<class T>
+cLocalPtr<T>::~cLocalPtr()
+{
+    free();
+}
+
+template<class T>
+void cLocalPtr<T>::free()
+{
+    if (m_reference == NULL)
+        return;
+
+    if (--m_reference->m_references == 0)
+    {
+        // The last local reference. If the object was shared, the local
+        // references hold a single reference of the shared counter
+        cCounter* sharedCounter = m_reference->m_sharedCounter;
+        DestructionMethod destructionType = m_reference->m_destructionType;
+        delete m_reference;
+
+        if ((sharedCounter == NULL) || (sharedCounter->decrease() == 0))
+        {
+            switch (destructionType)
+            {
+            case SMARTPTR_DESTRUCT_NONE: break;
+            case SMARTPTR_DESTRUCT_DELETE:       delete m_object; break;
+            case SMARTPTR_DESTRUCT_ARRAY_DELETE: delete[] m_object; break;
+            default:
+                // ERROR.
+                ASSERT(false);
+            }
+            delete sharedCounter;
+        }
+    }
+    m_reference = NULL;
+    m_object = NULL;
+}
+
+template<class T>
+cLocalPtr<T>& cLocalPtr<T>::operator=(const cLocalPtr<T>& other)
+{
+    // Take the new reference before releasing the current one, since 'other'
+    // might be owned by the current object
+    cLocalReference* reference = other.m_reference;
+    T* object = other.m_object;
+    if (reference != NULL)
+        reference->m_references++;
+
+    free();
+    m_reference = reference;
+    m_object = object;
+    return *this;
+}
+
+template<class T>
+bool cLocalPtr<T>::operator == (const cLocalPtr<T>& other) const
+{
+    return m_object == other.m_object;
+}
+
+template<class T>
+bool cLocalPtr<T>::operator != (const cLocalPtr<T>& other) const
+{
+    return m_object != other.m_object;
+}
+
+template<class T>
+bool cLocalPtr<T>::isEmpty() const
+{
+    return (m_object == NULL);
+}
+
+template<class T>
+uint cLocalPtr<T>::getLocalReferences() const
+{
+    if (m_reference == NULL)
+        return 0;
+    return m_reference->m_references;
+}
+
+template<class T>
+cSmartPtr<T> cLocalPtr<T>::share() const
+{
+    if (m_reference == NULL)
+        return cSmartPtr<T>();
+
+    if (m_reference->m_sharedCounter == NULL)
+    {
+        // One reference for the local pointers and one for the new cSmartPtr
+        m_reference->m_sharedCounter = new cCounter(2);
+    }
+    else
+    {
+        m_reference->m_sharedCounter->increase();
+    }
+
+    return cSmartPtr<T>(m_object, *m_reference->m_sharedCounter,
+                        m_reference->m_destructionType);
+}
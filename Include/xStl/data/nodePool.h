@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_NODEPOOL_H
+#define __TBA_STL_NODEPOOL_H
+
+/*
+ * nodePool.h
+ *
+ * A pool of fixed-size memory blocks, used for the nodes of the link-list.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/allocator.h"
+
+/*
+ * cNodePool
+ *
+ * Allocates nodes of a single size out of large memory blocks (slabs), which
+ * are allocated with cOS::smallMemoryAllocation() or with the allocator of
+ * the pool (See setAllocator()). Freed nodes are kept in a
+ * free-list and are recycled by the next allocations. The slabs are freed
+ * only by 'freeAll()' or by the destructor.
+ *
+ * The first slab is allocated on the first allocation and it holds a single
+ * node, so an empty pool doesn't use any memory and a pool with few nodes uses
+ * a little memory. Every new slab is twice the size of the previous one, up to
+ * 'MaxSlabSize' bytes.
+ *
+ * The nodes are aligned to 'NodeAlignment' bytes (if their size is a
+ * multiple of the alignment), so the pool can be used for any object.
+ *
+ * NOTE: This class is not thread-safe
+ */
+class cNodePool
+{
+public:
+    enum {
+        // The alignment of the nodes
+        NodeAlignment = 16,
+        // The number of nodes in the first slab
+        FirstSlabNodes = 1,
+        // The maximum number of bytes in a slab (unless a single node is
+        // larger)
+        MaxSlabSize = 64 * 1024
+    };
+
+    /*
+     * Constructor. Creates an empty pool.
+     *
+     * nodeSize - The number of bytes of each node
+     */
+    explicit cNodePool(uint nodeSize);
+
+    /*
+     * Destructor. Frees all the slabs.
+     */
+    ~cNodePool();
+
+    /*
+     * Allocate a new pool from 'allocator' (NULL for the default allocator),
+     * which allocates its slabs from 'allocator' too. Used by objects which
+     * create their pool only when they need it. The pool must be freed by
+     * 'destroy()', and its allocator must not be changed (See setAllocator()
+     * and swap()).
+     *
+     * nodeSize  - The number of bytes of each node
+     * allocator - The allocator of the pool and of its slabs
+     *
+     * Throws out of memory exception.
+     */
+    static cNodePool* create(uint nodeSize, cAllocator* allocator);
+
+    /*
+     * Free the slabs and the memory of 'pool', which was returned by
+     * 'create()'.
+     */
+    static void destroy(cNodePool* pool);
+
+    /*
+     * Return a new node of 'getNodeSize()' bytes. The memory isn't
+     * initialized.
+     *
+     * Throws out of memory exception.
+     */
+    void* allocate();
+
+    /*
+     * Return the node 'node', which was allocated by this pool, into the
+     * free-list.
+     */
+    void free(void* node);
+
+    /*
+     * Free all the slabs. All the nodes of the pool become invalid.
+     */
+    void freeAll();
+
+    /*
+     * Exchange the slabs, the nodes and the allocators of the two pools. Both
+     * pools must have the same node size.
+     */
+    void swap(cNodePool& other);
+
+    /*
+     * Allocate the slabs from 'allocator' (NULL for the default allocator).
+     * The pool must not have slabs.
+     */
+    void setAllocator(cAllocator* allocator);
+
+    /*
+     * Return the allocator of the slabs, or NULL for the default allocator
+     */
+    cAllocator* getAllocator() const;
+
+    /*
+     * Return the number of bytes of each node
+     */
+    uint getNodeSize() const;
+
+    /*
+     * Return the number of bytes allocated by the pool slabs
+     */
+    uint getAllocatedBytes() const;
+
+private:
+    // Deny copy-constructor and operator =
+    cNodePool(const cNodePool& other);
+    cNodePool& operator = (const cNodePool& other);
+
+    // Construct a pool inside the memory allocated by 'create()'
+    static void* operator new(size_t, void* position) { return position; }
+    static void operator delete(void*, void*) {}
+
+    /*
+     * Allocate a new slab, and make it the current one.
+     *
+     * Throws out of memory exception.
+     */
+    void allocateSlab();
+
+    // A free node, linked into the free-list
+    struct FreeNode
+    {
+        FreeNode* m_next;
+    };
+
+    // The header in the beginning of each slab
+    struct Slab
+    {
+        // The next (older) slab
+        Slab* m_next;
+        // The number of bytes of the slab, including the header
+        uint m_size;
+    };
+
+    // The size of the slab header, which keeps the nodes aligned
+    enum { SlabHeaderSize = ((sizeof(Slab) + NodeAlignment - 1) /
+                             NodeAlignment) * NodeAlignment };
+
+    // The size of each node
+    uint m_nodeSize;
+    // The free nodes
+    FreeNode* m_freeList;
+    // All the slabs, the newest first
+    Slab* m_slabs;
+    // The next node of the newest slab, which was never allocated, and the
+    // end of the newest slab
+    uint8* m_position;
+    uint8* m_end;
+    // The number of nodes in the next slab
+    uint m_nextSlabNodes;
+    // The number of bytes of all the slabs
+    uint m_allocatedBytes;
+    // The allocator of the slabs
+    cAllocator* m_allocator;
+};
+
+#endif // __TBA_STL_NODEPOOL_H
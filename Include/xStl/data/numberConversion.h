@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_NUMBERCONVERSION_H
+#define __TBA_STL_NUMBERCONVERSION_H
+
+/*
+ * numberConversion.h
+ *
+ * Conversion of integers into digits and of digits into integers, used by
+ * the numeric cString constructors, cStringerStream and the Parser.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+
+/*
+ * cNumberConversion
+ *
+ * Formats integers into a caller buffer, without allocating memory. Base 10
+ * numbers are formatted two digits at a time from a table, base 16 numbers
+ * a nibble at a time. The digits of bases above 10 are upper-case letters
+ * (the same as cString::m_baseStrip).
+ *
+ * Parses digits using a table of the digit values, and detects numbers which
+ * doesn't fit into the result.
+ *
+ * The functions are implemented for 'char' and for 'character' strings.
+ *
+ * Usage:
+ *    character buffer[cNumberConversion::BufferLength];
+ *    uint length = cNumberConversion::formatSigned(-1234, buffer);
+ *
+ *    uint64 number;
+ *    uint parsed;
+ *    if (cNumberConversion::parseUnsigned("ff;", 3, 16, number, parsed))
+ *        ... // number is 255, parsed is 2
+ */
+class cNumberConversion
+{
+public:
+    enum {
+        // The smallest and the largest supported bases
+        MinBase = 2,
+        MaxBase = 36,
+        // The number of characters needed in order to format any number: a
+        // sign, 64 binary digits and a null-terminate character.
+        BufferLength = 66
+    };
+
+    /*
+     * Format 'number' into 'buffer'.
+     *
+     * number - The number to format
+     * buffer - Will be filled with the digits and a null-terminate
+     *          character. Must have at least 'BufferLength' characters.
+     * base   - The base of the digits, between MinBase and MaxBase
+     *
+     * Return the number of digits (and sign) characters written.
+     * Throws exception if the base isn't supported.
+     */
+    static uint formatUnsigned(uint64 number, char* buffer, uint base = 10);
+    static uint formatSigned(int64 number, char* buffer, uint base = 10);
+
+    /*
+     * Parse the digits at the beginning of 'string'. The parsing stops at the
+     * first character which isn't a digit of 'base'. Letter digits can be
+     * either lower-case or upper-case.
+     *
+     * string       - The characters to parse
+     * length       - The number of characters in 'string'
+     * base         - The base of the digits, between MinBase and MaxBase
+     * number       - Will be filled with the parsed number
+     * parsedLength - Will be filled with the number of parsed characters
+     * maxValue     - The largest valid number
+     *
+     * Return false if 'string' doesn't start with a digit, or if the number
+     * is greater than 'maxValue'.
+     * Throws exception if the base isn't supported.
+     */
+    static bool parseUnsigned(const char* string, uint length, uint base,
+                              uint64& number, uint& parsedLength,
+                              uint64 maxValue = (uint64)-1);
+
+    #ifdef XSTL_UNICODE
+    static uint formatUnsigned(uint64 number, character* buffer,
+                               uint base = 10);
+    static uint formatSigned(int64 number, character* buffer,
+                             uint base = 10);
+    static bool parseUnsigned(const character* string, uint length,
+                              uint base, uint64& number, uint& parsedLength,
+                              uint64 maxValue = (uint64)-1);
+    #endif
+};
+
+#endif // __TBA_STL_NUMBERCONVERSION_H
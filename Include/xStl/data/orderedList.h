@@ -59,7 +59,12 @@
  * template cOrderedList class
  *
  * A template derived from cList, which keeps the items ordered,
- * as long as only add() is used to add items
+ * as long as only add() is used to add items. Items with the same value are
+ * kept in the order they were added.
+ *
+ * add() scans the list from the end, so it costs O(n) per item unless the
+ * items arrives in ascending order. Use cPriorityQueue (priorityQueue.h)
+ * when only the lowest item is needed.
  *
  * requires from T:
  *  T must have a < operator
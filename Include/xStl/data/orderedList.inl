@@ -49,17 +49,19 @@ cOrderedList<T>::cOrderedList(const cOrderedList<T> &other) : cList<T>(other)
 template <class T>
 void cOrderedList<T>::add(const T& node)
 {
-    typename cList<T>::iterator i = this->begin();
-    while (i != this->end())
+    // Scan from the tail. Items which are added in ascending order (such as
+    // time-stamps) are appended without scanning the list.
+    typename cList<T>::iterator begin = this->begin();
+    typename cList<T>::iterator i = this->end();
+    while (i != begin)
     {
-        if (node < (*i))
-        {
-            this->insert(i, node);
-            return;
-        }
-        i++;
+        typename cList<T>::iterator previous = i;
+        previous.prev();
+        if (!(node < (*previous)))
+            break;
+        i = previous;
     }
-    this->append(node);
+    this->insert(i, node);
 }
 
 template <class T>
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_PRIORITYQUEUE_H
+#define __TBA_STL_PRIORITYQUEUE_H
+
+/*
+ * priorityQueue.h
+ *
+ * Contains the declaration of a priority-queue, which is implemented as a
+ * d-ary heap stored inside an array.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/exception.h"
+#include "xStl/except/assert.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/data/array.h"
+
+#ifdef XSTL_WINDOWS
+// Template classes might not use all the local functions the interface has
+// to ofer. Warning C4505 should be over-written for template functions
+#pragma warning(push)
+#pragma warning(disable:4505)
+#endif
+
+/*
+ * template cPriorityQueue class
+ *
+ * A queue which always returns the element which comes first according to
+ * 'Compare' (The lowest element, for the default cLessThan order). The
+ * elements are kept in a single array ordered as a heap in which every node
+ * has 'Arity' children, so push() and pop() costs O(log n) and top() is
+ * constant time. Wider nodes make the tree shallower and keeps the children
+ * of a node in the same cache line.
+ *
+ * Every element gets a handle when it is pushed. The handle stays the same
+ * while the element moves inside the heap, and can be used to change the
+ * element priority (decreaseKey(), update()) or to remove it from the middle
+ * of the queue. Handles of removed elements are reused by the next push().
+ *
+ * The order of elements with the same priority is not defined.
+ *
+ * requires from T:
+ *  T must have a default constructor and operator =, since it's stored
+ *    inside a cArray.
+ *  Compare must have 'bool operator () (const T& a, const T& b) const' which
+ *    returns true if 'a' should be poped before 'b'.
+ *
+ * NOTE: This class is not thread-safe
+ */
+template <class T, class Compare = cLessThan<T>, uint Arity = 4>
+class cPriorityQueue
+{
+public:
+    // The identity of an element inside the queue
+    typedef uint Handle;
+
+    /*
+     * Constructor. Create an empty queue.
+     *
+     * compare - The order of the elements
+     */
+    explicit cPriorityQueue(const Compare& compare = Compare());
+
+    /*
+     * Return the number of elements in the queue
+     */
+    uint length() const;
+
+    /*
+     * Return true if there are no elements in the queue
+     */
+    bool isEmpty() const;
+
+    /*
+     * Allocate memory for 'capacity' elements, so the next pushes will not
+     * reallocate the heap.
+     */
+    void reserve(uint capacity);
+
+    /*
+     * Add an element to the queue.
+     *
+     * Return the handle of the new element.
+     */
+    Handle push(const T& value);
+
+    /*
+     * Return the first element of the queue.
+     * Throws exception if the queue is empty.
+     */
+    const T& top() const;
+
+    /*
+     * Return the handle of the first element of the queue.
+     * Throws exception if the queue is empty.
+     */
+    Handle topHandle() const;
+
+    /*
+     * Remove the first element of the queue. The handle of the element
+     * becomes invalid.
+     * Throws exception if the queue is empty.
+     */
+    void pop();
+
+    /*
+     * Return true if 'handle' belongs to an element which is still inside the
+     * queue.
+     */
+    bool isValid(Handle handle) const;
+
+    /*
+     * Return the element of 'handle'.
+     * Throws exception if the handle is not valid.
+     */
+    const T& get(Handle handle) const;
+
+    /*
+     * Replace the element of 'handle' with 'value', which must not come after
+     * the current element. The element can only move toward the top.
+     *
+     * Throws exception if the handle is not valid or if 'value' comes after
+     * the current element.
+     */
+    void decreaseKey(Handle handle, const T& value);
+
+    /*
+     * Replace the element of 'handle' with 'value', which can have any
+     * priority.
+     * Throws exception if the handle is not valid.
+     */
+    void update(Handle handle, const T& value);
+
+    /*
+     * Remove the element of 'handle' from the queue.
+     * Throws exception if the handle is not valid.
+     */
+    void remove(Handle handle);
+
+    /*
+     * Replace the content of the queue with the elements of 'values'. The heap
+     * is built in O(n) time, which is faster than pushing the elements one by
+     * one. The element values[i] gets the handle 'i'.
+     */
+    void heapify(const cArray<T>& values);
+
+    /*
+     * Remove all the elements of the queue. All the handles becomes invalid.
+     * The memory is kept for the next pushes.
+     */
+    void removeAll();
+
+    /*
+     * Exchange the elements of this queue with 'other'. Constant time.
+     */
+    void swap(cPriorityQueue<T, Compare, Arity>& other);
+
+private:
+    /*
+     * A node of the heap
+     */
+    class Entry
+    {
+    public:
+        // The element
+        T m_value;
+        // The handle of the element
+        Handle m_handle;
+    };
+
+    // Check that the handle is valid, otherwise throws exception
+    void assertHandle(Handle handle) const;
+
+    // Allocate a new handle for the element at 'position'
+    Handle allocateHandle(uint position);
+
+    // Release the handle of the removed element
+    void freeHandle(Handle handle);
+
+    // Move the entry at 'position' toward the top until the heap is ordered
+    void siftUp(uint position);
+
+    // Move the entry at 'position' toward the leafs until the heap is ordered
+    void siftDown(uint position);
+
+    // Remove the entry at 'position', which can be any node of the heap
+    void removeAt(uint position);
+
+    // The heap. The children of node i are (i * Arity + 1) .. (i * Arity + Arity)
+    cArray<Entry> m_heap;
+    // Translate handle into the position of the element inside m_heap plus
+    // one. Zero marks a released handle.
+    cArray<uint> m_positions;
+    // Released handles, which will be reused before new handles are allocated
+    cArray<Handle> m_freeHandles;
+    // The order of the elements
+    Compare m_compare;
+};
+
+// Include implementation. This is nessasary in template classes.
+#include "xStl/data/priorityQueue.inl"
+
+#ifdef XSTL_WINDOWS
+// Return the warnning behaviour back to it's original mode
+#pragma warning(pop)
+#endif
+
+#endif // __TBA_STL_PRIORITYQUEUE_H
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * priorityQueue.inl
+ *
+ * Implementation code of the cPriorityQueue class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+template <class T, class Compare, uint Arity>
+cPriorityQueue<T, Compare, Arity>::cPriorityQueue(
+        const Compare& compare /* = Compare() */) :
+    m_compare(compare)
+{
+}
+
+template <class T, class Compare, uint Arity>
+uint cPriorityQueue<T, Compare, Arity>::length() const
+{
+    return m_heap.getSize();
+}
+
+template <class T, class Compare, uint Arity>
+bool cPriorityQueue<T, Compare, Arity>::isEmpty() const
+{
+    return m_heap.getSize() == 0;
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::reserve(uint capacity)
+{
+    m_heap.reserve(capacity);
+    m_positions.reserve(capacity);
+}
+
+template <class T, class Compare, uint Arity>
+typename cPriorityQueue<T, Compare, Arity>::Handle
+    cPriorityQueue<T, Compare, Arity>::push(const T& value)
+{
+    uint position = m_heap.getSize();
+    m_heap.changeSize(position + 1);
+    Entry& entry = m_heap[position];
+    entry.m_value = value;
+    entry.m_handle = allocateHandle(position);
+    Handle ret = entry.m_handle;
+    siftUp(position);
+    return ret;
+}
+
+template <class T, class Compare, uint Arity>
+const T& cPriorityQueue<T, Compare, Arity>::top() const
+{
+    if (isEmpty())
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    return m_heap[0].m_value;
+}
+
+template <class T, class Compare, uint Arity>
+typename cPriorityQueue<T, Compare, Arity>::Handle
+    cPriorityQueue<T, Compare, Arity>::topHandle() const
+{
+    if (isEmpty())
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    return m_heap[0].m_handle;
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::pop()
+{
+    if (isEmpty())
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    removeAt(0);
+}
+
+template <class T, class Compare, uint Arity>
+bool cPriorityQueue<T, Compare, Arity>::isValid(Handle handle) const
+{
+    return (handle < m_positions.getSize()) && (m_positions[handle] != 0);
+}
+
+template <class T, class Compare, uint Arity>
+const T& cPriorityQueue<T, Compare, Arity>::get(Handle handle) const
+{
+    assertHandle(handle);
+    return m_heap[m_positions[handle] - 1].m_value;
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::decreaseKey(Handle handle,
+                                                    const T& value)
+{
+    assertHandle(handle);
+    uint position = m_positions[handle] - 1;
+    if (m_compare(m_heap[position].m_value, value))
+    {
+        // The new value comes after the current one
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    m_heap[position].m_value = value;
+    siftUp(position);
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::update(Handle handle, const T& value)
+{
+    assertHandle(handle);
+    uint position = m_positions[handle] - 1;
+    bool isLater = m_compare(m_heap[position].m_value, value);
+    m_heap[position].m_value = value;
+    if (isLater)
+        siftDown(position);
+    else
+        siftUp(position);
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::remove(Handle handle)
+{
+    assertHandle(handle);
+    removeAt(m_positions[handle] - 1);
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::heapify(const cArray<T>& values)
+{
+    uint count = values.getSize();
+    m_heap.changeSize(count);
+    m_positions.changeSize(count);
+    m_freeHandles.changeSize(0);
+    uint i;
+    for (i = 0; i < count; i++)
+    {
+        m_heap[i].m_value = values[i];
+        m_heap[i].m_handle = i;
+        m_positions[i] = i + 1;
+    }
+
+    // Sift down all the inner nodes, from the last one to the root
+    if (count > 1)
+    {
+        i = (count - 2) / Arity + 1;
+        while (i > 0)
+            siftDown(--i);
+    }
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::removeAll()
+{
+    m_heap.changeSize(0);
+    m_positions.changeSize(0);
+    m_freeHandles.changeSize(0);
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::swap(
+        cPriorityQueue<T, Compare, Arity>& other)
+{
+    m_heap.swap(other.m_heap);
+    m_positions.swap(other.m_positions);
+    m_freeHandles.swap(other.m_freeHandles);
+    t_swap(m_compare, other.m_compare);
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::assertHandle(Handle handle) const
+{
+    if (!isValid(handle))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+}
+
+template <class T, class Compare, uint Arity>
+typename cPriorityQueue<T, Compare, Arity>::Handle
+    cPriorityQueue<T, Compare, Arity>::allocateHandle(uint position)
+{
+    Handle handle;
+    uint freeCount = m_freeHandles.getSize();
+    if (freeCount > 0)
+    {
+        handle = m_freeHandles[freeCount - 1];
+        m_freeHandles.changeSize(freeCount - 1);
+    } else
+    {
+        handle = m_positions.getSize();
+        m_positions.changeSize(handle + 1);
+    }
+    m_positions[handle] = position + 1;
+    return handle;
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::freeHandle(Handle handle)
+{
+    m_positions[handle] = 0;
+    m_freeHandles.append(handle);
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::siftUp(uint position)
+{
+    // Keep the moving entry aside and shift the parents down into the hole
+    Entry entry = m_heap[position];
+    while (position > 0)
+    {
+        uint parent = (position - 1) / Arity;
+        if (!m_compare(entry.m_value, m_heap[parent].m_value))
+            break;
+        m_heap[position] = m_heap[parent];
+        m_positions[m_heap[position].m_handle] = position + 1;
+        position = parent;
+    }
+    m_heap[position] = entry;
+    m_positions[entry.m_handle] = position + 1;
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::siftDown(uint position)
+{
+    uint count = m_heap.getSize();
+    Entry entry = m_heap[position];
+    while (true)
+    {
+        uint child = position * Arity + 1;
+        if (child >= count)
+            break;
+
+        // Find the child which comes first
+        uint last = t_min(child + Arity, count);
+        uint best = child;
+        for (child++; child < last; child++)
+        {
+            if (m_compare(m_heap[child].m_value, m_heap[best].m_value))
+                best = child;
+        }
+
+        if (!m_compare(m_heap[best].m_value, entry.m_value))
+            break;
+        m_heap[position] = m_heap[best];
+        m_positions[m_heap[position].m_handle] = position + 1;
+        position = best;
+    }
+    m_heap[position] = entry;
+    m_positions[entry.m_handle] = position + 1;
+}
+
+template <class T, class Compare, uint Arity>
+void cPriorityQueue<T, Compare, Arity>::removeAt(uint position)
+{
+    freeHandle(m_heap[position].m_handle);
+
+    // Fill the hole with the last leaf
+    uint last = m_heap.getSize() - 1;
+    bool isLater = false;
+    if (position != last)
+    {
+        isLater = m_compare(m_heap[position].m_value, m_heap[last].m_value);
+        m_heap[position] = m_heap[last];
+    }
+
+    // Don't keep a copy of the removed element inside the unused memory
+    m_heap[last].m_value = T();
+    m_heap.changeSize(last);
+
+    if (position != last)
+    {
+        m_positions[m_heap[position].m_handle] = position + 1;
+        if (isLater)
+            siftDown(position);
+        else
+            siftUp(position);
+    }
+}
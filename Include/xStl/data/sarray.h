@@ -133,11 +133,12 @@ public:
      */
     cSArray(const cSArray<T> & other);
 
+    #ifdef XSTL_CPP11
     /*
-     * Improve the changing memory by copying the members using memcpy
+     * Move constructor. Take the storage of 'other', which becomes empty.
      */
-    virtual void changeSize(uint newSize,
-                            bool preserveMemory = true);
+    cSArray(cSArray<T>&& other);
+    #endif
 
     /*
      * Insert single object to the end of the array. The copy of the new element
@@ -181,6 +182,13 @@ public:
      */
     cSArray<T>& operator = (const cSArray<T>& other);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Move operator. Take the storage of 'other', which becomes empty.
+     */
+    cSArray<T>& operator = (cSArray<T>&& other);
+    #endif
+
     /*
      * Operators which appends data to the array. Another array
      * or another element.
@@ -232,6 +240,12 @@ protected:
      * Copy from other cArray class.
      */
     virtual void copyFrom(const cArray<T> &other);
+
+    /*
+     * Improve the reallocation of the array by copying the members using
+     * memcpy. See cArray::reallocArray
+     */
+    virtual void reallocArray(uint newCapacity, uint count);
 };
 
 // Template implementation must be include inside the header file
@@ -72,61 +72,58 @@ cSArray<T>::cSArray(const cSArray & other)
 	cSArray<T>::copyFrom(other);
 }
 
+#ifdef XSTL_CPP11
+template <class T>
+cSArray<T>::cSArray(cSArray<T>&& other) :
+    cArray<T>(t_move(other))
+{
+}
+
+template <class T>
+cSArray<T>& cSArray<T>::operator = (cSArray<T>&& other)
+{
+    cArray<T>::operator = (t_move(other));
+    return *this;
+}
+#endif // XSTL_CPP11
+
 template <class T>
 void cSArray<T>::copyFrom(const cArray<T> &other)
 {
     /* Fast copy array */
     this->freeArray();
-    changeSize(other.getSize());
+    this->changeSize(other.getSize());
     cOS::memcpy(this->m_array, other.getBuffer(), this->m_size * sizeof(T));
 }
 
 template <class T>
-void cSArray<T>::changeSize(uint newSize,
-                            bool preserveMemory /*= true*/)
+void cSArray<T>::reallocArray(uint newCapacity, uint count)
 {
-	if ((newSize != 0) && (preserveMemory))
+    ASSERT(count <= newCapacity);
+
+    // Plain-old-data storage is already moved by memcpy/realloc
+    if (cTypeTraits<T>::isPod)
     {
-	    uint new_alloc = this->pageRound(newSize);
-	    T* buffer;
-
-	    /* Create a new buffer and copy the data to it, if needed */
-	    if ((uint)t_abs((int)new_alloc - (int)this->m_alocatedArray) >=
-                                                             this->m_pageSize)
-	    {
-		    /* Need to realloc the buffer */
-		    buffer = new T[new_alloc];
-            if (buffer == NULL)
-            {
-                    XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
-            }
-
-		    if (this->m_array != NULL)
-		    {
-                cOS::memcpy(buffer, this->m_array,
-                            t_min(newSize, this->m_size) * sizeof(T));
-			    delete [] this->m_array;
-		    }
-
-		    /* Assign the new array */
-		    this->m_array = buffer;
-		    this->m_size  = newSize;
-		    this->m_alocatedArray = new_alloc;
-	    } else
-	    {
-		    /* Just increase the space needed */
-		    this->m_size = newSize;
-	    }
-    } else
+        cArray<T>::reallocArray(newCapacity, count);
+        return;
+    }
+
+    T* buffer = cArray<T>::Storage::allocate(newCapacity, this->m_allocator);
+    if (this->m_array != NULL)
     {
-        cArray<T>::changeSize(newSize, preserveMemory);
+        cOS::memcpy(buffer, this->m_array, count * sizeof(T));
+        cArray<T>::Storage::free(this->m_array, this->m_alocatedArray,
+                                 this->m_allocator);
     }
+
+    this->m_array = buffer;
+    this->m_alocatedArray = newCapacity;
 }
 
 template <class T>
 void cSArray<T>::append(const T& object)
 {
-	changeSize(this->m_size + 1);
+	this->changeSize(this->m_size + 1);
     cOS::memcpy(this->m_array + this->m_size - 1, &object, sizeof(T));
 }
 
@@ -138,7 +135,7 @@ void cSArray<T>::append(const cArray<T>& array)
 	uint add_size = array.getSize();
 
 	// Change the size to the size of both array.
-	changeSize(this->m_size + array.getSize());
+	this->changeSize(this->m_size + array.getSize());
 
     // Copy the elements
     cOS::memcpy(this->m_array + org_size, array.getBuffer(), sizeof(T)*add_size);
@@ -150,7 +147,7 @@ void cSArray<T>::copyRange(const cArray<T>& other,
                            uint startLocation,
                            uint count)
 {
-    changeSize(count, false);
+    this->changeSize(count, false);
     cOS::memcpy(this->m_array, other.getBuffer() + startLocation, count * sizeof(T));
 }
 
@@ -174,13 +171,17 @@ template <class T>
 cSArray<T> cSArray<T>::operator + (const cSArray<T>& other)
 {
 	// Create new object, append the data and return it.
-	return (cSArray<T>(*this) += other);
+	cSArray<T> ret(*this);
+	ret.append(other);
+	return ret;
 }
 template <class T>
 cSArray<T> cSArray<T>::operator + (const T & object)
 {
 	// Create new object, append the data and return it.
-	return (cSArray<T>(*this) += object);
+	cSArray<T> ret(*this);
+	ret.append(object);
+	return ret;
 }
 
 template <class T>
@@ -242,7 +243,7 @@ void cSArray<T>::deserialize(basicInput& inputStream)
     inputStream.streamReadUint32(count);
 #endif
 
-    changeSize(count, false);
+    this->changeSize(count, false);
 
 #ifdef XSTL_LINUX
     gccLinuxStreamPipeRead(inputStream, (void*)this->m_array, sizeof(T) * count);
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_SHAREDBUFFER_H
+#define __TBA_STL_SHAREDBUFFER_H
+
+/*
+ * sharedBuffer.h
+ *
+ * A copy-on-write buffer. Copies of the buffer reference the same memory
+ * until one of them is changed.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+#include "xStl/types.h"
+#include "xStl/data/sarray.h"
+#include "xStl/data/smartptr.h"
+
+/*
+ * cSharedBuffer
+ *
+ * Wraps a reference-counted cBuffer (cBufferPtr). Copying a cSharedBuffer
+ * only increases the reference count of the buffer. The const functions read
+ * the shared memory, and the non-const functions make a private copy of the
+ * buffer first, if the buffer is referenced by more than one object.
+ *
+ * Use this class instead of cBuffer for data which is copied many times but
+ * rarely changed.
+ *
+ * Usage:
+ *    cSharedBuffer packet(data, length);
+ *    queue.append(packet);                 // No copy
+ *    packet.getWritableData()[0] = 0;      // packet gets a private copy
+ *
+ * This class is multi-threaded and multi-processor enabled in the same way
+ * as cSmartPtr: different objects which reference the same buffer can be used
+ * by different threads.
+ */
+class cSharedBuffer
+{
+public:
+    /*
+     * Constructor. Creates a buffer of 'size' uninitialized bytes.
+     *
+     * Throws out of memory exception.
+     */
+    explicit cSharedBuffer(uint size = 0);
+
+    /*
+     * Constructor. Copies 'buffer' into a new shared buffer.
+     *
+     * Throws out of memory exception.
+     */
+    explicit cSharedBuffer(const cBuffer& buffer);
+
+    /*
+     * Constructor. Copies 'length' bytes of 'data' into a new shared buffer.
+     *
+     * Throws out of memory exception.
+     */
+    cSharedBuffer(const uint8* data, uint length);
+
+    // The default copy-constructor, operator = and destructor are used. They
+    // increase and decrease the reference count of the buffer.
+
+    /*
+     * Return the number of bytes in the buffer.
+     */
+    uint getSize() const;
+
+    /*
+     * Return the content of the buffer. The memory might be shared with other
+     * objects.
+     */
+    const uint8* getBuffer() const;
+
+    /*
+     * Return the buffer object. The buffer might be shared with other objects.
+     */
+    const cBuffer& getData() const;
+
+    /*
+     * Return the buffer object for changes. If the buffer is shared with other
+     * objects, a private copy of the buffer is made first. The returned
+     * reference is valid until this object is copied or destroyed.
+     *
+     * Throws out of memory exception.
+     */
+    cBuffer& getWritableData();
+
+    /*
+     * Return true if the buffer is shared with other objects.
+     */
+    bool isShared() const;
+
+    /*
+     * Return a byte of the buffer. The non-const version makes a private copy
+     * of a shared buffer. See getWritableData().
+     */
+    uint8 operator[] (uint index) const;
+    uint8& operator[] (uint index);
+
+    /*
+     * Compare the content of the buffers.
+     */
+    bool operator == (const cSharedBuffer& other) const;
+    bool operator != (const cSharedBuffer& other) const;
+
+private:
+    /*
+     * Make a private copy of the buffer, if it's shared.
+     */
+    void detach();
+
+    // The reference-counted buffer
+    cBufferPtr m_buffer;
+};
+
+#endif // __TBA_STL_SHAREDBUFFER_H
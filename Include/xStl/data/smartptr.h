@@ -53,9 +53,16 @@ enum DestructionMethod
 {
     SMARTPTR_DESTRUCT_NONE          = 0, // The destructor didn't call
     SMARTPTR_DESTRUCT_DELETE        = 1, // The delete operator will be called.
-    SMARTPTR_DESTRUCT_ARRAY_DELETE  = 2  // The delete[] operator will be called.
+    SMARTPTR_DESTRUCT_ARRAY_DELETE  = 2, // The delete[] operator will be called.
+    SMARTPTR_DESTRUCT_EMBEDDED      = 3  // The object and the counter are a
+                                         // single allocation. See makeSmartPtr
 };
 
+// Forward deceleration
+template<class T> class cSmartPtrBlock;
+template<class T> class cLocalPtr;
+class cSmartPtrBlockBase;
+
 #ifdef XSTL_WINDOWS
     // Template classes might not use all the local functions the interface has
     // to ofer. Warning C4505 should be over-written for template functions
@@ -74,7 +81,11 @@ enum DestructionMethod
  * the destruction method is save as the previous setting. So far this
  * method will be private until CR results.
  *
- * This class is multi-threaded and multi-processor enabled.
+ * This class is multi-threaded and multi-processor enabled. The reference
+ * counter is changed using atomic operations, so copying and releasing
+ * smart-pointers never takes a lock. Like any other object, a single
+ * smart-pointer instance should not be changed by one thread while other
+ * threads access it; Each thread should hold its own copy.
  */
 template<class T>
 class cSmartPtr
@@ -98,6 +109,12 @@ public:
     explicit cSmartPtr(T* object,
                        DestructionMethod destructionType = SMARTPTR_DESTRUCT_DELETE);
 
+    /*
+     * Constructor. Take the ownership over an object which was allocated
+     * together with its reference counter. Used by makeSmartPtr().
+     */
+    explicit cSmartPtr(cSmartPtrBlock<T>& block);
+
     /*
      * Copy-constructor. (with refrence increasment)
      */
@@ -145,6 +162,8 @@ public:
 
     /*
      * Change the destruction method of the smart-pointer.
+     * The destruction method of objects which were created by makeSmartPtr()
+     * cannot be changed.
      */
     void setDestructMethod(DestructionMethod destructionType);
 
@@ -173,6 +192,15 @@ public:
     const cCounter& getCounter() const;
 
 private:
+    // cLocalPtr::share() creates smart-pointers over its counter
+    template<class U> friend class cLocalPtr;
+
+    /*
+     * Constructor. Take the ownership over a reference which was already
+     * added to 'counter'.
+     */
+    cSmartPtr(T* object, cCounter& counter, DestructionMethod destructionType);
+
     /*
      * Delete the correct reference counter and create new reference.
      * NOTE: The deleted method is the same as the old object!!
@@ -200,10 +228,86 @@ private:
 };
 
 
+/*
+ * cSmartPtrBlockBase
+ *
+ * The reference counter of an object which was created by makeSmartPtr().
+ * Deleting the counter destroys the object (See cSmartPtrBlock).
+ */
+class cSmartPtrBlockBase : public cCounter
+{
+public:
+    cSmartPtrBlockBase() : cCounter(1) {}
+    virtual ~cSmartPtrBlockBase() {}
+};
+
+/*
+ * cSmartPtrBlock
+ *
+ * A reference counter and the object it counts, allocated together. The
+ * object is constructed with the arguments given to makeSmartPtr().
+ */
+template<class T>
+class cSmartPtrBlock : public cSmartPtrBlockBase
+{
+public:
+    cSmartPtrBlock() : m_object() {}
+
+    template<class A1>
+    cSmartPtrBlock(const A1& a1) :
+        m_object(a1) {}
+
+    template<class A1, class A2>
+    cSmartPtrBlock(const A1& a1, const A2& a2) :
+        m_object(a1, a2) {}
+
+    template<class A1, class A2, class A3>
+    cSmartPtrBlock(const A1& a1, const A2& a2, const A3& a3) :
+        m_object(a1, a2, a3) {}
+
+    template<class A1, class A2, class A3, class A4>
+    cSmartPtrBlock(const A1& a1, const A2& a2, const A3& a3, const A4& a4) :
+        m_object(a1, a2, a3, a4) {}
+
+    // The counted object
+    T m_object;
+};
+
+/*
+ * Construct a new object of type T which is owned by a smart-pointer. The
+ * object and its reference counter are a single allocation, instead of the
+ * two allocations of cSmartPtr<T>(new T(...)), and they share the same cache
+ * lines.
+ *
+ * The arguments are passed to the constructor of T by const reference.
+ *
+ * Usage:
+ *    cBufferPtr buffer = makeSmartPtr<cBuffer>(size);
+ */
+template<class T>
+cSmartPtr<T> makeSmartPtr();
+
+template<class T, class A1>
+cSmartPtr<T> makeSmartPtr(const A1& a1);
+
+template<class T, class A1, class A2>
+cSmartPtr<T> makeSmartPtr(const A1& a1, const A2& a2);
+
+template<class T, class A1, class A2, class A3>
+cSmartPtr<T> makeSmartPtr(const A1& a1, const A2& a2, const A3& a3);
+
+template<class T, class A1, class A2, class A3, class A4>
+cSmartPtr<T> makeSmartPtr(const A1& a1, const A2& a2, const A3& a3,
+                          const A4& a4);
+
+
 /*
  * In order that the cSmartPtr class can be in used in multi-threaded and multi
  * processor safely a global lockable should be in used.
  *
+ * NOTE: cSmartPtr doesn't use this lock anymore, since its reference counter
+ *       is atomic. The lock is kept for the code which still uses it.
+ *
  * Note that this lockable should be destruct at the end of all atexit dtors.
  * Win32 ring3 application not free this memory.
  * The XDK calls to this destructor.
@@ -36,8 +36,6 @@
  *
  * Author: Elad Raz <e@eladraz.com>
  */
-#include "xStl/os/lock.h"
-
 template<class T>
 cSmartPtr<T>::cSmartPtr() :
     m_object(NULL),
@@ -56,27 +54,52 @@ cSmartPtr<T>::cSmartPtr(T* object, DestructionMethod destructionType /* = SMARTP
     ASSERT(m_refrenceCounter != NULL);
 }
 
+template<class T>
+cSmartPtr<T>::cSmartPtr(cSmartPtrBlock<T>& block) :
+    m_object(&block.m_object),
+    m_refrenceCounter(&block),
+    m_destructionType(SMARTPTR_DESTRUCT_EMBEDDED)
+{
+}
+
+template<class T>
+cSmartPtr<T>::cSmartPtr(T* object, cCounter& counter,
+                        DestructionMethod destructionType) :
+    m_object(object),
+    m_refrenceCounter(&counter),
+    m_destructionType(destructionType)
+{
+}
+
 template<class T>
 void cSmartPtr<T>::free()
 {
     // Decrease the refrence
     if (decreaseAndTest())
     {
-        if (m_object != NULL)
+        if (m_destructionType == SMARTPTR_DESTRUCT_EMBEDDED)
+        {
+            // The object is destroyed together with its counter
+            delete static_cast<cSmartPtrBlockBase*>(m_refrenceCounter);
+        }
+        else
         {
-            // Destroy the object
-            switch (m_destructionType)
+            if (m_object != NULL)
             {
-            case SMARTPTR_DESTRUCT_NONE: break;
-            case SMARTPTR_DESTRUCT_DELETE:       delete m_object; break;
-            case SMARTPTR_DESTRUCT_ARRAY_DELETE: delete[] m_object; break;
-            default:
-                // ERROR.
-                ASSERT(false);
+                // Destroy the object
+                switch (m_destructionType)
+                {
+                case SMARTPTR_DESTRUCT_NONE: break;
+                case SMARTPTR_DESTRUCT_DELETE:       delete m_object; break;
+                case SMARTPTR_DESTRUCT_ARRAY_DELETE: delete[] m_object; break;
+                default:
+                    // ERROR.
+                    ASSERT(false);
+                }
             }
-        }
 
-        delete m_refrenceCounter;
+            delete m_refrenceCounter;
+        }
     }
     m_refrenceCounter = NULL;
     m_object = NULL;
@@ -85,8 +108,7 @@ void cSmartPtr<T>::free()
 template<class T>
 bool cSmartPtr<T>::decreaseAndTest()
 {
-    // Protected the atomic operation of decreasing and testing
-    cLock lock(cSmartPtrLockable::getInstance().globalSmartPtrLock);
+    // The decrease is atomic, only the last owner gets zero
     return (m_refrenceCounter->decrease() == 0);
 }
 
@@ -98,12 +120,11 @@ cSmartPtr<T>::~cSmartPtr()
 
 template<class T>
 cSmartPtr<T>::cSmartPtr(const cSmartPtr<T>& other) :
-    m_object(NULL)
+    m_object(other.m_object),
+    m_refrenceCounter(other.m_refrenceCounter),
+    m_destructionType(other.m_destructionType)
 {
-    cLock lock(cSmartPtrLockable::getInstance().globalSmartPtrLock);
-    m_refrenceCounter = other.m_refrenceCounter;
-    m_destructionType = other.m_destructionType;
-    m_object = other.m_object;
+    // 'other' holds a reference, so the counter cannot reach zero here
     m_refrenceCounter->increase();
 }
 
@@ -113,6 +134,7 @@ cSmartPtr<T>& cSmartPtr<T>::operator=(T* other)
     free();
     m_object = other;
     m_refrenceCounter = new cCounter(1);
+    return *this;
 }
 
 template<class T>
@@ -120,17 +142,17 @@ cSmartPtr<T>& cSmartPtr<T>::operator=(const cSmartPtr<T>& other)
 {
     if (this != &other)
     {
-        // Decrease object reference
-        free();
+        // Take the new reference before releasing the current one, since
+        // 'other' might be owned by the current object
+        cCounter* refrenceCounter = other.m_refrenceCounter;
+        T* object = other.m_object;
+        DestructionMethod destructionType = other.m_destructionType;
+        refrenceCounter->increase();
 
-        // Increase reference counter. This operation must be atomic!
-        // The object can delete here (even if we have a reference)
-        // because two thread can decrease without locking and...
-        cLock lock(cSmartPtrLockable::getInstance().globalSmartPtrLock);
-        m_refrenceCounter = other.m_refrenceCounter;
-        m_destructionType = other.m_destructionType;
-        m_object          = other.m_object;
-        m_refrenceCounter->increase();
+        free();
+        m_refrenceCounter = refrenceCounter;
+        m_destructionType = destructionType;
+        m_object          = object;
     }
     return *this;
 }
@@ -161,6 +183,11 @@ DestructionMethod cSmartPtr<T>::getDestructMethod()
 template<class T>
 void cSmartPtr<T>::setDestructMethod(DestructionMethod destructionType)
 {
+    // The embedded object must be freed together with its counter
+    ASSERT((m_destructionType != SMARTPTR_DESTRUCT_EMBEDDED) &&
+           (destructionType != SMARTPTR_DESTRUCT_EMBEDDED));
+    if (m_destructionType == SMARTPTR_DESTRUCT_EMBEDDED)
+        return;
     m_destructionType = destructionType;
 }
 
@@ -189,3 +216,34 @@ const cCounter& cSmartPtr<T>::getCounter() const
 {
     return *m_refrenceCounter;
 }
+
+template<class T>
+cSmartPtr<T> makeSmartPtr()
+{
+    return cSmartPtr<T>(*new cSmartPtrBlock<T>());
+}
+
+template<class T, class A1>
+cSmartPtr<T> makeSmartPtr(const A1& a1)
+{
+    return cSmartPtr<T>(*new cSmartPtrBlock<T>(a1));
+}
+
+template<class T, class A1, class A2>
+cSmartPtr<T> makeSmartPtr(const A1& a1, const A2& a2)
+{
+    return cSmartPtr<T>(*new cSmartPtrBlock<T>(a1, a2));
+}
+
+template<class T, class A1, class A2, class A3>
+cSmartPtr<T> makeSmartPtr(const A1& a1, const A2& a2, const A3& a3)
+{
+    return cSmartPtr<T>(*new cSmartPtrBlock<T>(a1, a2, a3));
+}
+
+template<class T, class A1, class A2, class A3, class A4>
+cSmartPtr<T> makeSmartPtr(const A1& a1, const A2& a2, const A3& a3,
+                          const A4& a4)
+{
+    return cSmartPtr<T>(*new cSmartPtrBlock<T>(a1, a2, a3, a4));
+}
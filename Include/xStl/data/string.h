@@ -49,6 +49,8 @@
 #include "xStl/data/sarray.h"
 #include "xStl/data/list.h"
 #include "xStl/data/char.h"
+#include "xStl/data/counter.h"
+#include "xStl/data/stringView.h"
 #include "xStl/data/serializedObject.h"
 #include "xStl/stream/basicIO.h"
 
@@ -69,10 +71,15 @@ class cTestString;
  * enlarge the memory allocated string. After changing the string the
  * application must call the 'rearrangeStringVector' to fix-up the string
  * in the memory.
- * The string class uses the 'page' mechanizm of the cArray class to
- * optimized permormance. The page is a simple way to avoid memory
- * allocation when-ever concating or deleting part of the string.
- * See cArray class description for more information.
+ * Short strings (up to InlineStringLength characters, 23 ASCII characters or
+ * 5 Unicode characters) are stored inside the object itself, so constructing,
+ * copying and destroying them doesn't allocate memory. Longer strings are
+ * stored in a heap block which grows geometrically, like the cArray class, so
+ * concating strings and characters doesn't reallocate the memory for every
+ * operation.
+ * Long strings which are copied many times but rarely changed (hash keys,
+ * list elements, exception messages) can be 'share()'d. Copies of a shared
+ * string reference the same memory until one of them is changed.
  *
  * NOTE: The addition of the NULL terminate character are requiered to be
  *       compatible with older C functions. The cost of appending the NULL
@@ -90,6 +97,12 @@ public:
         // The default page for the string. See page declartion in the cArray
         // class description for more information.
         DefaultStringPage = 30,
+        // The number of bytes of the inline storage, and the maximum number of
+        // characters which are stored inside the object without heap
+        // allocation (including the null-terminate character). Unicode
+        // strings keep fewer characters inline, so the object stays small.
+        InlineBytes = 24,
+        InlineStringLength = (InlineBytes / sizeof(character)) - 1,
         // The constructor of cString can translate 'uint' and 'int' to
         // strings. The alpha-betic of the converstion is the string in the
         // m_baseStrip static const member. For changing the strip compile
@@ -104,7 +117,7 @@ public:
      *
      * string - The string to be wrapped. If this argument is NULL the class
      *          creates a new empty string object.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -118,7 +131,7 @@ public:
      *
      * string - The string to be wrapped. If this argument is NULL the class
      *          creates a new empty string object.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -145,7 +158,7 @@ public:
      * Creates a string object with a single character 'ch'
      *
      * ch     - The character to be inserted.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -160,7 +173,7 @@ public:
      *
      * string - The string to be wrapped. If this argument is NULL the class
      *          creates a new empty string object.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -174,7 +187,7 @@ public:
      *
      * number - The number to be translated.
      * base   - The base for the convertor.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -187,7 +200,7 @@ public:
      *
      * number - The number to be translated.
      * base   - The base for the convertor.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -200,7 +213,7 @@ public:
      *
      * number - The number to be translated.
      * base   - The base for the convertor.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -213,7 +226,7 @@ public:
      *
      * number - The number to be translated.
      * base   - The base for the convertor.
-     * optMem - The page size to be use when handling the string.
+     * optMem - Not in used. Kept for compatibility with the paged strings.
      *
      * Throws out of memory exception.
      */
@@ -227,6 +240,31 @@ public:
      */
     cString(const cString& other);
 
+    /*
+     * Constructor. Copies the characters of a view into a new string.
+     *
+     * Throws out of memory exception.
+     */
+    explicit cString(const cStringView& view);
+
+    #ifdef XSTL_UNICODE
+    /*
+     * Constructor. Copies the characters of an 8-bit text view (for example
+     * a Parser word) into a new string.
+     *
+     * Throws out of memory exception.
+     */
+    explicit cString(const cAsciiStringView& view);
+    #endif
+
+    #ifdef XSTL_CPP11
+    /*
+     * Move-constructor. Takes the memory of 'other' without copying it. 'other'
+     * becomes an empty string.
+     */
+    cString(cString&& other);
+    #endif
+
     /*
      * Destructor. Free up class memory.
      */
@@ -318,11 +356,12 @@ public:
      */
     CompareType compare(const character* other) const;
     CompareType compare(const cString& other) const;
+    CompareType compare(const cStringView& other) const;
 
     /*
      * Compare two strings and ignore uppercase. The return value indicate
      * whether the string is less than, greater than or equal to the 'other'
-     * string
+     * string. Only the case of the ASCII letters is ignored (See cStringCase).
      *
      * other - cString object or character* array.
      *
@@ -330,6 +369,7 @@ public:
      */
     CompareType icompare(const character* other) const;
     CompareType icompare(const cString& other) const;
+    CompareType icompare(const cStringView& other) const;
 
     /*
      * Makes the string to be all upper-case string.
@@ -371,9 +411,13 @@ public:
      * Return the length of the string if the string is not present.
      * If the string is empty, then 'find' will return the length of the string,
      * which is 0.
+     *
+     * The search is vectorized, see cStringSearch.
      */
     uint find(const cString& string,
               uint startIndex = 0) const;
+    uint find(const cStringView& string,
+              uint startIndex = 0) const;
 
     /*
      * Try to find sub-string inside the string starting with the end of the
@@ -391,6 +435,22 @@ public:
      */
     uint rfind(const cString& string,
                uint startIndex = MAX_UINT) const;
+    uint rfind(const cStringView& string,
+               uint startIndex = MAX_UINT) const;
+
+    /*
+     * Find all the positions of 'string' inside the string.
+     *
+     * string        - The string to look for
+     * isOverlapping - Set to true in order to return matches which overlap
+     *                 the previous match (searching "aa" in "aaa" returns 0 and
+     *                 1). Otherwise the search continues after each match.
+     *
+     * Return the positions, in ascending order. An empty 'string' doesn't
+     * match.
+     */
+    cArray<uint> findAll(const cStringView& string,
+                         bool isOverlapping = false) const;
 
     /*
      * Try to find strings which match the 'find' string and replace them with
@@ -398,9 +458,16 @@ public:
      *
      * findString    - The string to look for
      * replaceString - The string to substitue in place of 'find'.
+     *
+     * The string is scanned once, from left to right, and the matches are
+     * replaced in a single allocation. The substituted strings are not
+     * scanned again, so 'replaceString' may contain 'findString'. An empty
+     * 'findString' doesn't change the string.
      */
     cString& replace(const cString& findString,
                      const cString& replaceString);
+    cString& replace(const cStringView& findString,
+                     const cStringView& replaceString);
 
     /*
      * Splits a string into link-list of strings. The strings are traces by the
@@ -413,9 +480,34 @@ public:
      *
      * Returns link-list of string. The link-list should include at least one
      * string. If the link-list has only one item then it will be equal to this
-     * string.
+     * string. A divider at the beginning or at the end of the string yields an
+     * empty string. An empty divider doesn't split the string.
      */
     cList<cString> split(const cString& divider) const;
+    cList<cString> split(const cStringView& divider) const;
+
+    /*
+     * Split the string into 'tokens', the same as split(). The strings which
+     * are already in 'tokens' are overwritten in order to reuse their memory,
+     * and the unused strings are removed from the list.
+     *
+     * 'tokens' must not contain this string.
+     */
+    void split(const cStringView& divider, cList<cString>& tokens) const;
+
+    /*
+     * Split the string, the same as split(), into views of the string. Only
+     * the list nodes are allocated. The views are valid until the string is
+     * changed or destroyed.
+     */
+    cList<cStringView> splitView(const cStringView& divider) const;
+
+    /*
+     * Return a view of the string characters. The view is valid until the
+     * string is changed or destroyed. Sub-strings, searches and tokenizing of
+     * the view don't allocate memory. See cStringView.
+     */
+    cStringView getView() const;
 
     /*
      * Returns a pointer to the string buffer. The pointer is direct pointer to
@@ -440,6 +532,25 @@ public:
      */
     const character* getBuffer() const;
 
+    /*
+     * Move the string memory into a reference-counted storage. Copies of a
+     * shared string (and copies of the copies) don't duplicate the memory, but
+     * reference the same storage. Any change to one of the strings (non-const
+     * 'getBuffer()', non-const 'operator []', 'concat()', etc.) makes a
+     * private copy for the changed string first.
+     *
+     * Short strings are stored inside the object, so they are never shared.
+     *
+     * Throws out of memory exception.
+     */
+    void share();
+
+    /*
+     * Return true if the string memory is a shared reference-counted storage.
+     * See 'share()'.
+     */
+    bool isShared() const;
+
     /*
      * Recalculate the buffer needed to store the string, after the call to
      * non-const 'getBuffer()' function and changing the length of the string.
@@ -484,6 +595,34 @@ public:
     cString& operator = (const cString& other);
     cString& operator = (const character* other);
 
+    #ifdef XSTL_CPP11
+    /*
+     * Move assignment operator. Exchange the memory of the strings, so no
+     * character is copied (unless the strings use different allocators).
+     */
+    cString& operator = (cString&& other);
+    #endif
+
+    /*
+     * Exchange the content of this string with 'other'. No memory is copied.
+     */
+    void swap(cString& other);
+
+    /*
+     * Allocate the memory of the string from 'allocator' (NULL for the default
+     * allocator). See cAllocator. The allocator is kept by operator =, so
+     * assigning a string into an empty string which uses an arena copies the
+     * characters into the arena.
+     *
+     * Throws exception if the string isn't empty.
+     */
+    void setAllocator(cAllocator* allocator);
+
+    /*
+     * Return the allocator of the string, or NULL for the default allocator
+     */
+    cAllocator* getAllocator() const;
+
 
     /*
      * Return true if the two string are equals. This function is equal to the
@@ -508,12 +647,32 @@ public:
      * characters.
      */
     cString& operator += (const cString& other);
-    cString  operator +  (const cString& other) const;
     cString& operator += (const character* string);
+    cString& operator += (const character ch);
+    #ifdef XSTL_CPP11
+    cString  operator +  (const cString& other) const &;
+    cString  operator +  (const character* string) const &;
+    cString  operator +  (const character ch) const &;
+
+    /*
+     * Concating into a temporary string (e.g. a + b + c) appends to the
+     * temporary memory instead of copying it.
+     */
+    cString  operator +  (const cString& other) &&;
+    cString  operator +  (const character* string) &&;
+    cString  operator +  (const character ch) &&;
+    #else
+    cString  operator +  (const cString& other) const;
     cString  operator +  (const character* string) const;
     cString  operator +  (const character ch) const;
-    cString& operator += (const character ch);
+    #endif
 
+    /*
+     * Return a character of the string. The null-terminator at 'length()'
+     * can be read as well.
+     *
+     * Throws EXCEPTION_OUT_OF_RANGE if 'index' is out of the string.
+     */
     character & operator [] (const int index);
     character operator [] (const int index) const;
 
@@ -550,22 +709,120 @@ public:
 private:
     // The friend string class testing.
     friend class cTestString;
+    // Writes the builder characters directly into the string memory.
+    friend class cStringBuilder;
+
+    enum {
+        // The number of characters of the inline storage, including the
+        // null-terminate character.
+        InlineCapacity = InlineStringLength + 1
+    };
+
+    /*
+     * The storage of shared strings. The characters are freed when the last
+     * string releases the storage.
+     */
+    struct SharedStorage {
+        SharedStorage(character* data, cAllocator* allocator);
+
+        // The number of strings which reference the storage
+        cCounter m_references;
+        // The characters of the strings
+        character* m_data;
+        // The allocator of the characters
+        cAllocator* m_allocator;
+    };
+
+    /*
+     * Private function. Used at the constructors. Creates an empty inline
+     * string. The functions assumes all member are uninitiliazed so memory
+     * will not be free.
+     */
+    void createEmptyString();
+
+    /*
+     * Free the heap memory of the string (if any) and create an empty string.
+     */
+    void freeString();
 
     /*
-     * Private function. Used at the constructors. Creates empty string and
-     * init all members. The functions assumes all member are uninitiliazed
-     * so memory will not allocated and therfore will not be free.
+     * Return true if the string is stored inside the object.
+     */
+    bool isInline() const;
+
+    /*
+     * Return the number of characters the string can store, including the
+     * null-terminate character, without reallocation.
+     */
+    uint getCapacity() const;
+
+    /*
+     * Make sure the string can store 'capacity' characters (including the
+     * null-terminate character). The content of the string is preserved. A
+     * shared string gets a private copy of the memory.
+     *
+     * Throws out of memory exception.
+     */
+    void reserve(uint capacity);
+
+    /*
+     * Make a private copy of the memory of a shared string. Must be called
+     * before changing the characters of the string.
      *
-     * optMem - The page size to be use when handling the string.
+     * Throws out of memory exception.
      */
-    void createEmptyString(uint optMem);
+    void detach();
 
-    // The array of character for the string
-    cSArray<character>* m_buffer;
+    /*
+     * Reference the storage of the shared string 'other', if the storage
+     * belongs to the allocator of this string. Otherwise copy the characters.
+     * The current content of this string must be freed.
+     */
+    void copyShared(const cString& other);
+
+    /*
+     * Replace the content of the string with 'length' characters of 'string'.
+     * 'string' must not point into this string memory.
+     */
+    void assign(const character* string, uint length);
+
+    /*
+     * Replace the content of the string with the digits of 'number', preceded
+     * by m_stringNegativeInteger if 'isNegative' is set. Used by the numeric
+     * constructors.
+     */
+    void assignNumber(bool isNegative, uint64 number, uint base);
+
+    /*
+     * Take the memory (and the allocator) of 'other' and make it an empty
+     * string. This string must not have heap memory.
+     */
+    void moveFrom(cString& other);
+
+    // The string data, points to m_inline or to the heap memory. The string
+    // is always null-terminated.
+    character* m_data;
 
     // The length of the string
     uint m_stringLength;
 
+    union {
+        // The storage of short strings
+        character m_inline[InlineCapacity];
+        // The heap strings information
+        struct {
+            // The number of allocated characters
+            uint m_capacity;
+            // The reference-counted storage, or NULL for private memory
+            SharedStorage* m_shared;
+        } m_heap;
+    };
+
+    // The allocator of the private heap memory, NULL for the default
+    // allocator. The memory of a shared storage belongs to the allocator of
+    // the storage.
+    cAllocator* m_allocator;
+
     // TODO:
     //static const character* EmptyString;
 };
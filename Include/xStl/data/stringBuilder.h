@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_STRINGBUILDER_H
+#define __TBA_STL_STRINGBUILDER_H
+
+/*
+ * stringBuilder.h
+ *
+ * Collects a large text out of many small pieces, and converts it into a
+ * cString once.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringView.h"
+
+/*
+ * cStringBuilder
+ *
+ * Appending into a cString grows the string memory, and every time the
+ * memory grows, the whole string is copied. The builder stores the appended
+ * characters in a list of fixed-size blocks instead, so appended characters
+ * are copied once into a block, and once more by 'toString()' into a string
+ * which is allocated at its final size.
+ *
+ * The builder implements the same 'operator <<' as cStringerStream, so it
+ * can be used as the output of templates like 'hexDumpObject()'.
+ *
+ * Usage:
+ *    cStringBuilder builder;
+ *    for (uint i = 0; i < count; i++)
+ *        builder << names[i] << XSTL_CHAR('=') << values[i] << endl;
+ *    cString report(builder.toString());
+ *
+ * NOTE: This class is not thread-safe
+ */
+class cStringBuilder
+{
+public:
+    enum {
+        // The default number of characters in a block
+        DefaultBlockLength = 8192
+    };
+
+    /*
+     * Constructor. Creates an empty builder. No memory is allocated until
+     * the first append.
+     *
+     * blockLength - The number of characters in each block
+     */
+    explicit cStringBuilder(uint blockLength = DefaultBlockLength);
+
+    /*
+     * Destructor. Frees the blocks.
+     */
+    ~cStringBuilder();
+
+    /*
+     * Return the number of characters appended so far
+     */
+    uint length() const;
+
+    /*
+     * Append characters to the end of the builder.
+     *
+     * Throws out of memory exception.
+     */
+    void append(const character* string, uint length);
+    void append(const cStringView& string);
+    void append(const cString& string);
+    void append(character ch);
+
+    /*
+     * Append 'count' copies of 'string' or of 'ch'. Used for padding and for
+     * duplications, see cString::dup() and cString::pad().
+     */
+    void appendRepeated(const cStringView& string, uint count);
+    void appendRepeated(character ch, uint count);
+
+    /*
+     * Append a number, formatted by cNumberConversion.
+     *
+     * base - The base of the digits
+     */
+    void appendNumber(int64 number, uint base = 10);
+    void appendUnsignedNumber(uint64 number, uint base = 10);
+
+    /*
+     * Stream operators. The same as the cStringerStream operators, numbers are
+     * written in base 10.
+     */
+    cStringBuilder& operator << (const cString& string);
+    cStringBuilder& operator << (const cStringView& string);
+    cStringBuilder& operator << (const char* asciiString);
+    cStringBuilder& operator << (const char ch);
+    #ifdef XSTL_UNICODE
+    cStringBuilder& operator << (const character* unicodeString);
+    cStringBuilder& operator << (const character ch);
+    #endif
+    cStringBuilder& operator << (const int32  dword);
+    cStringBuilder& operator << (const int64  qword);
+    cStringBuilder& operator << (const uint32 dword);
+    cStringBuilder& operator << (const uint64 qword);
+
+    /*
+     * Return the number of blocks, and the characters of the block 'index'.
+     * Allows to write a large text into a stream or a file without creating
+     * one large string. The views are valid until the builder is changed.
+     */
+    uint getBlocksCount() const;
+    cStringView getBlock(uint index) const;
+
+    /*
+     * Return a string with all the appended characters. The string memory is
+     * allocated once.
+     *
+     * Throws out of memory exception.
+     */
+    cString toString() const;
+
+    /*
+     * Append all the characters of the builder to the end of 'string'.
+     *
+     * Throws out of memory exception.
+     */
+    void appendTo(cString& string) const;
+
+    /*
+     * Remove all the characters. The first block is kept for the next
+     * appends, the others are freed.
+     */
+    void clear();
+
+private:
+    // Deny copy-constructor and operator =
+    cStringBuilder(const cStringBuilder& other);
+    cStringBuilder& operator = (const cStringBuilder& other);
+
+    /*
+     * Allocate a new last block. Called when the last block is full.
+     */
+    void nextBlock();
+
+    // The number of characters in each block
+    uint m_blockLength;
+    // The blocks. All the blocks, except the last one, are full.
+    cArray<character*> m_blocks;
+    // The last block
+    character* m_block;
+    // The number of characters in the last block. Equals to 'm_blockLength'
+    // when there are no blocks.
+    uint m_blockUsed;
+    // The total number of characters
+    uint m_length;
+};
+
+#endif // __TBA_STL_STRINGBUILDER_H
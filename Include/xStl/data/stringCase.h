@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_STRINGCASE_H
+#define __TBA_STL_STRINGCASE_H
+
+/*
+ * stringCase.h
+ *
+ * Vectorized case conversion and case insensitive comparison used by cString,
+ * cStringView and cWildcardMatcher.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+
+/*
+ * cStringCase
+ *
+ * Case conversion of the ASCII letters, the same as cChar::getUppercase() and
+ * cChar::getLowercase(). All other characters (including non-ASCII characters
+ * of unicode builds) are left untouched. On x86 processors the characters
+ * are converted and compared a whole SSE2 vector at a time (16 bytes), the
+ * remaining characters, and builds for other processors, use the scalar
+ * implementation.
+ *
+ * The case insensitive functions compare the lower-case form of the
+ * characters, the same as strcasecmp() and wcscasecmp() of the "C" locale.
+ *
+ * The functions are implemented for 'char' and for 'character' strings.
+ */
+class cStringCase
+{
+public:
+    /*
+     * Convert the 'length' characters of 'string' into upper/lower case.
+     */
+    static void makeUpper(char* string, uint length);
+    static void makeLower(char* string, uint length);
+
+    /*
+     * Copy the lower-case form of the 'length' characters of 'string' into
+     * 'output'. 'output' must have room for 'length' characters. The
+     * strings may be the same.
+     */
+    static void foldCase(const char* string, uint length, char* output);
+
+    /*
+     * Case insensitive comparison of two strings.
+     *
+     * Return a negative number if 'string1' is lower than 'string2', 0 if the
+     * strings are equal and a positive number otherwise.
+     */
+    static int icompare(const char* string1, uint length1,
+                        const char* string2, uint length2);
+
+    /*
+     * Return true if the two strings are equal, ignoring the case.
+     */
+    static bool iequals(const char* string1, uint length1,
+                        const char* string2, uint length2);
+
+    #ifdef XSTL_UNICODE
+    static void makeUpper(character* string, uint length);
+    static void makeLower(character* string, uint length);
+    static void foldCase(const character* string, uint length,
+                         character* output);
+    static int icompare(const character* string1, uint length1,
+                        const character* string2, uint length2);
+    static bool iequals(const character* string1, uint length1,
+                        const character* string2, uint length2);
+    #endif
+};
+
+#endif // __TBA_STL_STRINGCASE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_STRINGSEARCH_H
+#define __TBA_STL_STRINGSEARCH_H
+
+/*
+ * stringSearch.h
+ *
+ * Vectorized sub-string search engine used by cString and cStringView.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+
+/*
+ * cStringSearch
+ *
+ * Search a needle inside a haystack of characters. The engine compares the
+ * first and the last character of the needle against a whole vector of
+ * positions at once (16 bytes for SSE2, 32 bytes for AVX2), and compares the
+ * rest of the needle only for the positions which passed this filter.
+ *
+ * The engine is selected at runtime according to the CPU features. Builds
+ * for non-x86 processors and for kernel-mode use the scalar engine only.
+ *
+ * The functions are implemented for 'char' and for 'character' strings.
+ */
+class cStringSearch
+{
+public:
+    /*
+     * The search implementations
+     */
+    enum Engine {
+        // Character by character comparison
+        ScalarEngine = 0,
+        // 128-bit vectors
+        SSE2Engine,
+        // 256-bit vectors
+        AVX2Engine
+    };
+
+    /*
+     * Find the first position of 'needle' inside 'haystack' starting at
+     * 'startIndex'.
+     *
+     * Return the position of the needle, or 'length' if the needle couldn't
+     * be found. An empty needle is always found at 'startIndex'.
+     */
+    static uint find(const char* haystack, uint length,
+                     const char* needle, uint needleLength,
+                     uint startIndex = 0);
+
+    /*
+     * Find the last position of 'needle' inside 'haystack' which isn't
+     * greater than 'startIndex'.
+     *
+     * Return the position of the needle, or 'length' if the needle couldn't
+     * be found. An empty needle is always found at 'startIndex'.
+     */
+    static uint rfind(const char* haystack, uint length,
+                      const char* needle, uint needleLength,
+                      uint startIndex = MAX_UINT);
+
+    #ifdef XSTL_UNICODE
+    static uint find(const character* haystack, uint length,
+                     const character* needle, uint needleLength,
+                     uint startIndex = 0);
+    static uint rfind(const character* haystack, uint length,
+                      const character* needle, uint needleLength,
+                      uint startIndex = MAX_UINT);
+    #endif
+
+    /*
+     * Return the engine in used.
+     */
+    static Engine getEngine();
+
+    /*
+     * Return true if the processor (and the build) supports 'engine'.
+     */
+    static bool isEngineSupported(Engine engine);
+
+    /*
+     * Change the engine in used. Used for tests and for benchmarks.
+     *
+     * Throws exception if the engine isn't supported.
+     */
+    static void setEngine(Engine engine);
+
+private:
+    /*
+     * Return the fastest supported engine.
+     */
+    static Engine detectEngine();
+
+    // The engine in used, or -1 before the detection
+    static volatile int m_engine;
+};
+
+#endif // __TBA_STL_STRINGSEARCH_H
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_STRINGVIEW_H
+#define __TBA_STL_STRINGVIEW_H
+
+/*
+ * stringView.h
+ *
+ * A non-owning reference to a sequence of characters.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/operators.h"
+#include "xStl/data/char.h"
+#include "xStl/data/list.h"
+#include "xStl/data/stringSearch.h"
+#include "xStl/data/stringCase.h"
+
+/*
+ * cStringViewT
+ *
+ * A pointer and a length of characters, which are owned by someone else (a
+ * cString, a file buffer, a literal). Sub-views, searches, comparisons and
+ * tokenizing of a view never allocate memory, so a large input can be parsed
+ * without copying it. A view can be materialized into a cString by calling
+ * the explicit cString(const cStringView&) constructor.
+ *
+ * The characters are not null-terminated, and must remain valid (and
+ * unchanged) during the lifetime of the view.
+ *
+ * Usage:
+ *    cString line(XSTL_STRING("GET /index.html HTTP/1.1"));
+ *    cStringView view = line.getView();
+ *    uint position = 0;
+ *    cStringView token;
+ *    while (view.getNextToken(cStringView(XSTL_STRING(" ")), position, token))
+ *        ...
+ *
+ * The template parameter is the character type. cStringView is the view of
+ * 'character' strings and cAsciiStringView is the view of 8-bit text (such as
+ * the Parser input).
+ */
+template <class T>
+class cStringViewT
+{
+public:
+    /*
+     * Default constructor. Creates an empty view.
+     */
+    cStringViewT();
+
+    /*
+     * Constructor. Creates a view of a null-terminated string. If 'string' is
+     * NULL the view is empty.
+     */
+    explicit cStringViewT(const T* string);
+
+    /*
+     * Constructor. Creates a view of 'length' characters at 'data'.
+     */
+    cStringViewT(const T* data, uint length);
+
+    // The default copy-constructor and operator = are used
+
+    /*
+     * Return a pointer to the first character of the view. The characters are
+     * NOT null-terminated.
+     */
+    const T* getBuffer() const;
+
+    /*
+     * Return the number of characters in the view
+     */
+    uint length() const;
+
+    /*
+     * Return true if the view doesn't have any characters
+     */
+    bool isEmpty() const;
+
+    /*
+     * Return the character at 'index'.
+     */
+    T operator [] (uint index) const;
+
+    /*
+     * Return a view of the first 'count' characters. If 'count' is larger
+     * than the length, the whole view is returned.
+     */
+    cStringViewT<T> left(uint count) const;
+
+    /*
+     * Return a view of the last 'count' characters. If 'count' is larger
+     * than the length, the whole view is returned.
+     */
+    cStringViewT<T> right(uint count) const;
+
+    /*
+     * Return a view of 'count' characters starting at 'index'. The view is
+     * trimmed to the end of this view.
+     */
+    cStringViewT<T> mid(uint index, uint count) const;
+
+    /*
+     * Return a view of the characters between 'index1' (included) and
+     * 'index2' (excluded). The indexes are trimmed to the end of this view.
+     */
+    cStringViewT<T> part(uint index1, uint index2) const;
+
+    /*
+     * Search for 'string' starting at 'startIndex'.
+     *
+     * Return the index of the first match, or 'length()' if the string
+     * couldn't be found. An empty string is always found at 'startIndex'.
+     */
+    uint find(const cStringViewT<T>& string, uint startIndex = 0) const;
+
+    /*
+     * Search for the last 'string' which starts at 'startIndex' or before it.
+     *
+     * Return the index of the match, or 'length()' if the string couldn't be
+     * found. An empty string is always found at 'startIndex'.
+     */
+    uint rfind(const cStringViewT<T>& string, uint startIndex = MAX_UINT) const;
+
+    /*
+     * Search for the character 'ch' starting at 'startIndex'.
+     *
+     * Return the index of the first match, or 'length()' if the character
+     * couldn't be found.
+     */
+    uint find(T ch, uint startIndex = 0) const;
+
+    /*
+     * Compare the views by their characters.
+     *
+     * Return a negative number if this view is lower than 'other', 0 if the
+     * views are equal and a positive number if this view is greater.
+     */
+    int compare(const cStringViewT<T>& other) const;
+
+    /*
+     * Same as 'compare' except that the comparison is case insensitive.
+     */
+    int icompare(const cStringViewT<T>& other) const;
+
+    /*
+     * Return true if the view begins with 'prefix'.
+     */
+    bool startsWith(const cStringViewT<T>& prefix) const;
+
+    /*
+     * Tokenize the view without allocating memory. The tokens are the
+     * characters between the 'divider's. A divider at the beginning or at the
+     * end of the view yields an empty token.
+     *
+     * divider  - The string between the tokens. Throws exception if the
+     *            divider is empty.
+     * position - The position of the next token. Should be 0 for the first
+     *            call, and it's advanced by each call.
+     * token    - Will be filled with the next token.
+     *
+     * Return false when there are no more tokens.
+     */
+    bool getNextToken(const cStringViewT<T>& divider,
+                      uint& position,
+                      cStringViewT<T>& token) const;
+
+    /*
+     * Split the view by 'divider'. The list contains views of this view, so
+     * only the list nodes are allocated. See 'getNextToken'.
+     */
+    cList<cStringViewT<T> > split(const cStringViewT<T>& divider) const;
+
+    /*
+     * Compare the characters of the views. Operator < is case insensitive, the
+     * same as cString.
+     */
+    bool operator == (const cStringViewT<T>& other) const;
+    bool operator <  (const cStringViewT<T>& other) const;
+    MAKE_SIMPLE_OPERATORS(cStringViewT<T>);
+
+private:
+    // The first character
+    const T* m_data;
+    // The number of characters
+    uint m_length;
+};
+
+// Template implementation must be include inside the header file
+#include "xStl/data/stringView.inl"
+
+/*
+ * A view of 'character' strings.
+ */
+typedef cStringViewT<character> cStringView;
+
+/*
+ * A view of 8-bit text.
+ */
+typedef cStringViewT<char> cAsciiStringView;
+
+#endif // __TBA_STL_STRINGVIEW_H
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * stringView.inl
+ *
+ * Implementation code of the cStringViewT class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/stringSearch.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/except/assert.h"
+#include "xStl/except/exception.h"
+#include "xStl/utils/algorithm.h"
+
+template <class T>
+cStringViewT<T>::cStringViewT() :
+    m_data(NULL),
+    m_length(0)
+{
+}
+
+template <class T>
+cStringViewT<T>::cStringViewT(const T* string) :
+    m_data(string),
+    m_length(0)
+{
+    if (string != NULL)
+    {
+        while (string[m_length] != 0)
+            m_length++;
+    }
+}
+
+template <class T>
+cStringViewT<T>::cStringViewT(const T* data, uint length) :
+    m_data(data),
+    m_length(length)
+{
+    ASSERT((data != NULL) || (length == 0));
+}
+
+template <class T>
+const T* cStringViewT<T>::getBuffer() const
+{
+    return m_data;
+}
+
+template <class T>
+uint cStringViewT<T>::length() const
+{
+    return m_length;
+}
+
+template <class T>
+bool cStringViewT<T>::isEmpty() const
+{
+    return m_length == 0;
+}
+
+template <class T>
+T cStringViewT<T>::operator [] (uint index) const
+{
+    if (index >= m_length)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    return m_data[index];
+}
+
+template <class T>
+cStringViewT<T> cStringViewT<T>::left(uint count) const
+{
+    return cStringViewT<T>(m_data, t_min(count, m_length));
+}
+
+template <class T>
+cStringViewT<T> cStringViewT<T>::right(uint count) const
+{
+    count = t_min(count, m_length);
+    return cStringViewT<T>(m_data + m_length - count, count);
+}
+
+template <class T>
+cStringViewT<T> cStringViewT<T>::mid(uint index, uint count) const
+{
+    index = t_min(index, m_length);
+    return cStringViewT<T>(m_data + index, t_min(count, m_length - index));
+}
+
+template <class T>
+cStringViewT<T> cStringViewT<T>::part(uint index1, uint index2) const
+{
+    index2 = t_min(index2, m_length);
+    index1 = t_min(index1, index2);
+    return cStringViewT<T>(m_data + index1, index2 - index1);
+}
+
+template <class T>
+uint cStringViewT<T>::find(const cStringViewT<T>& string,
+                           uint startIndex /* = 0 */) const
+{
+    return cStringSearch::find(m_data, m_length,
+                               string.m_data, string.m_length,
+                               startIndex);
+}
+
+template <class T>
+uint cStringViewT<T>::rfind(const cStringViewT<T>& string,
+                            uint startIndex /* = MAX_UINT */) const
+{
+    return cStringSearch::rfind(m_data, m_length,
+                                string.m_data, string.m_length,
+                                startIndex);
+}
+
+template <class T>
+uint cStringViewT<T>::find(T ch, uint startIndex /* = 0 */) const
+{
+    for (uint i = startIndex; i < m_length; i++)
+    {
+        if (m_data[i] == ch)
+            return i;
+    }
+    return m_length;
+}
+
+template <class T>
+int cStringViewT<T>::compare(const cStringViewT<T>& other) const
+{
+    uint count = t_min(m_length, other.m_length);
+    for (uint i = 0; i < count; i++)
+    {
+        if (m_data[i] != other.m_data[i])
+            return (m_data[i] < other.m_data[i]) ? -1 : 1;
+    }
+
+    if (m_length == other.m_length)
+        return 0;
+    return (m_length < other.m_length) ? -1 : 1;
+}
+
+template <class T>
+int cStringViewT<T>::icompare(const cStringViewT<T>& other) const
+{
+    return cStringCase::icompare(m_data, m_length,
+                                 other.m_data, other.m_length);
+}
+
+template <class T>
+bool cStringViewT<T>::startsWith(const cStringViewT<T>& prefix) const
+{
+    return left(prefix.m_length) == prefix;
+}
+
+template <class T>
+bool cStringViewT<T>::getNextToken(const cStringViewT<T>& divider,
+                                   uint& position,
+                                   cStringViewT<T>& token) const
+{
+    // An empty divider never advances the position
+    if (divider.isEmpty())
+    {
+        XSTL_THROW(cException, EXCEPTION_ASSERTION);
+    }
+
+    // The last token was already returned
+    if (position > m_length)
+        return false;
+
+    uint index = find(divider, position);
+    token = part(position, index);
+    if (index == m_length)
+        position = m_length + 1;
+    else
+        position = index + divider.m_length;
+
+    return true;
+}
+
+template <class T>
+cList<cStringViewT<T> > cStringViewT<T>::split(
+                                    const cStringViewT<T>& divider) const
+{
+    cList<cStringViewT<T> > ret;
+
+    uint position = 0;
+    cStringViewT<T> token;
+    while (getNextToken(divider, position, token))
+        ret.append(token);
+
+    return ret;
+}
+
+template <class T>
+bool cStringViewT<T>::operator == (const cStringViewT<T>& other) const
+{
+    if (m_length != other.m_length)
+        return false;
+
+    for (uint i = 0; i < m_length; i++)
+    {
+        if (m_data[i] != other.m_data[i])
+            return false;
+    }
+    return true;
+}
+
+template <class T>
+bool cStringViewT<T>::operator < (const cStringViewT<T>& other) const
+{
+    return icompare(other) < 0;
+}
@@ -42,6 +42,7 @@
  */
 #include "xStl/types.h"
 #include "xStl/data/string.h"
+#include "xStl/data/stringView.h"
 
 /*
  * Matches a string to a pattern. The pattern can contains wildcard characters
@@ -60,6 +61,13 @@ public:
     static bool match(const cString& string,
                       const cString& wildcardPattern,
                       bool isCaseSensetive = true);
+
+    /*
+     * Same as above, for views. The matching doesn't allocate memory.
+     */
+    static bool match(const cStringView& string,
+                      const cStringView& wildcardPattern,
+                      bool isCaseSensetive = true);
 };
 
 #endif // __TBA_STL_WILDCARDMATCHER_H
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_XSTL_OS_INTERLOCKED_H
+#define __TBA_XSTL_OS_INTERLOCKED_H
+
+/*
+ * interlocked.h
+ *
+ * Declare the cInterlocked class, a set of atomic operations over counters and
+ * pointers. The operations are implemented by the compiler intrinsics of every
+ * platform, so they never block and never enter the kernel.
+ *
+ * This file supports the following platfroms:
+ *  - Win32 API (Interlocked functions)
+ *  - GCC/Clang (__atomic built-ins, gcc 4.7 or later)
+ *  - XDK (Windows NT device-driver)
+ *  - 16 bit compilers (No threads, plain operations)
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+
+/*
+ * class cInterlocked
+ *
+ * All the functions are full memory barriers, except loadPointer() which has
+ * an acquire semantic: Memory accesses which follow the load cannot be
+ * re-ordered before it. Together with storePointer() (release semantic) an
+ * object can be fully constructed by a thread and published to other threads
+ * through a single pointer.
+ */
+class cInterlocked
+{
+public:
+    /*
+     * Increase the value by one. Return the new value
+     */
+    static counter_t increment(volatile counter_t* value)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedIncrement(value);
+        #elif defined(XSTL_LINUX)
+            return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+        #else
+            return ++(*value);
+        #endif
+    }
+
+    /*
+     * Decrease the value by one. Return the new value
+     */
+    static counter_t decrement(volatile counter_t* value)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedDecrement(value);
+        #elif defined(XSTL_LINUX)
+            return __atomic_sub_fetch(value, 1, __ATOMIC_SEQ_CST);
+        #else
+            return --(*value);
+        #endif
+    }
+
+    /*
+     * Add 'addend' to the value. Return the previous value
+     */
+    static counter_t exchangeAdd(volatile counter_t* value, counter_t addend)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedExchangeAdd(value, addend);
+        #elif defined(XSTL_LINUX)
+            return __atomic_fetch_add(value, addend, __ATOMIC_SEQ_CST);
+        #else
+            counter_t ret = *value;
+            *value+= addend;
+            return ret;
+        #endif
+    }
+
+    /*
+     * Change the value. Return the previous value
+     */
+    static counter_t exchange(volatile counter_t* value, counter_t newValue)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedExchange(value, newValue);
+        #elif defined(XSTL_LINUX)
+            return __atomic_exchange_n(value, newValue, __ATOMIC_SEQ_CST);
+        #else
+            counter_t ret = *value;
+            *value = newValue;
+            return ret;
+        #endif
+    }
+
+    /*
+     * Change the value to 'newValue' only if it's equal to 'comparand'.
+     * Return the previous value
+     */
+    static counter_t compareExchange(volatile counter_t* value,
+                                     counter_t newValue,
+                                     counter_t comparand)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedCompareExchange(value, newValue, comparand);
+        #elif defined(XSTL_LINUX)
+            __atomic_compare_exchange_n(value, &comparand, newValue, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            return comparand;
+        #else
+            counter_t ret = *value;
+            if (ret == comparand)
+                *value = newValue;
+            return ret;
+        #endif
+    }
+
+    /*
+     * Read the value. The read is a full memory barrier
+     */
+    static counter_t load(const volatile counter_t* value)
+    {
+        #if defined(XSTL_LINUX)
+            return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+        #else
+            return exchangeAdd(const_cast<volatile counter_t*>(value), 0);
+        #endif
+    }
+
+    /*
+     * Read a pointer which was published by storePointer()
+     */
+    static void* loadPointer(void* const volatile* pointer)
+    {
+        #if defined(XSTL_LINUX)
+            return __atomic_load_n(pointer, __ATOMIC_ACQUIRE);
+        #else
+            // Volatile reads have acquire semantic in Microsoft compilers
+            return *pointer;
+        #endif
+    }
+
+    /*
+     * Publish a pointer. All the memory writes which were made before the
+     * call are visible to the threads which reads the new pointer
+     */
+    static void storePointer(void* volatile* pointer, void* value)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            InterlockedExchangePointer(pointer, value);
+        #elif defined(XSTL_LINUX)
+            __atomic_store_n(pointer, value, __ATOMIC_SEQ_CST);
+        #else
+            *pointer = value;
+        #endif
+    }
+
+    /*
+     * Change the pointer. Return the previous pointer
+     */
+    static void* exchangePointer(void* volatile* pointer, void* value)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedExchangePointer(pointer, value);
+        #elif defined(XSTL_LINUX)
+            return __atomic_exchange_n(pointer, value, __ATOMIC_SEQ_CST);
+        #else
+            void* ret = *pointer;
+            *pointer = value;
+            return ret;
+        #endif
+    }
+
+    /*
+     * Change the pointer to 'value' only if it's equal to 'comparand'.
+     * Return the previous pointer
+     */
+    static void* compareExchangePointer(void* volatile* pointer,
+                                        void* value,
+                                        void* comparand)
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_NTDDK) || defined(XSTL_CE)
+            return InterlockedCompareExchangePointer(pointer, value, comparand);
+        #elif defined(XSTL_LINUX)
+            __atomic_compare_exchange_n(pointer, &comparand, value, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            return comparand;
+        #else
+            void* ret = *pointer;
+            if (ret == comparand)
+                *pointer = value;
+            return ret;
+        #endif
+    }
+
+    /*
+     * Full memory barrier
+     */
+    static void memoryBarrier()
+    {
+        #if defined(XSTL_WINDOWS) || defined(XSTL_CE)
+            MemoryBarrier();
+        #elif defined(XSTL_NTDDK)
+            KeMemoryBarrier();
+        #elif defined(XSTL_LINUX)
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        #endif
+    }
+};
+
+#endif // __TBA_XSTL_OS_INTERLOCKED_H
@@ -228,6 +228,12 @@ public:
      */
     static void sleepMicroseconds(uint microseconds);
 
+    /*
+     * Return the number of processors which can execute the threads of the
+     * process. The return value is at least 1.
+     */
+    static uint getNumberOfProcessors();
+
     //
     // OS functions
     //
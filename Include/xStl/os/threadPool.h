@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_OS_THREADPOOL_H
+#define __TBA_STL_OS_THREADPOOL_H
+
+/*
+ * threadPool.h
+ *
+ * A set of worker threads which executes the tasks of a job in parallel.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/os/event.h"
+#include "xStl/os/threadedClass.h"
+
+/*
+ * class cThreadPool
+ *
+ * Holds worker threads which are created once and wait for jobs. A job is a
+ * cThreadPool::cTask object and a number of tasks; execute() calls
+ * task.runTask(i) for every i in [0, tasksCount), spreading the tasks between
+ * the workers and the calling thread, and returns when all the tasks are
+ * completed.
+ *
+ * Usage:
+ *    class cSquare : public cThreadPool::cTask {
+ *    public:
+ *        virtual void runTask(uint index) { m_data[index]*= m_data[index]; }
+ *        uint* m_data;
+ *    };
+ *
+ *    cSquare square;
+ *    square.m_data = array.getBuffer();
+ *    cThreadPool::getDefault().execute(square, array.getSize());
+ *
+ * A pool executes a single job at a time. If execute() is called while the
+ * pool is busy (from another thread, or from inside a task) the tasks are
+ * executed by the calling thread.
+ *
+ * See also xStl/utils/parallel.h
+ */
+class cThreadPool
+{
+public:
+    /*
+     * The interface of a job
+     */
+    class cTask
+    {
+    public:
+        // Virtual destructor. You can inherit from me.
+        virtual ~cTask() {}
+
+        /*
+         * Execute the task number 'index'. Called once for each task, from
+         * any of the threads of the pool.
+         */
+        virtual void runTask(uint index) = 0;
+    };
+
+    /*
+     * Constructor. Start the worker threads.
+     *
+     * workersCount - The number of worker threads. Zero creates a worker for
+     *                each processor, except the processor of the calling
+     *                thread.
+     */
+    explicit cThreadPool(uint workersCount = 0);
+
+    /*
+     * Destructor. Stop and destroy the worker threads.
+     */
+    ~cThreadPool();
+
+    /*
+     * Return the number of threads which are executing a job: The workers
+     * and the calling thread.
+     */
+    uint getConcurrency() const;
+
+    /*
+     * Execute the tasks [0, tasksCount) of 'task' and wait until they are
+     * completed. The calling thread executes tasks as well.
+     *
+     * Throws exception if any of the tasks throws a cException. The rest of
+     * the tasks which didn't start yet are not executed.
+     */
+    void execute(cTask& task, uint tasksCount);
+
+    /*
+     * Return the shared pool of the process, which is created on the first
+     * call with a worker for each processor.
+     */
+    static cThreadPool& getDefault();
+
+    /*
+     * Stop the workers of the shared pool and free it. Called when the
+     * process exits. No thread may use the shared pool during the call.
+     */
+    static void destroyDefault();
+
+private:
+    // Deny copy-constructor and operator =
+    cThreadPool(const cThreadPool& other);
+    cThreadPool& operator = (const cThreadPool& other);
+
+    /*
+     * A worker thread. Waits for its event, helps in the current job and
+     * goes back to sleep.
+     */
+    class cWorker : public cThreadedClass
+    {
+    public:
+        // Constructor
+        cWorker(cThreadPool& pool);
+
+        // The thread loop
+        virtual void run();
+
+        // Set when there is a new job, or when the pool is destroyed
+        cEvent m_wakeUp;
+
+    private:
+        // The pool of the worker
+        cThreadPool& m_pool;
+    };
+
+    /*
+     * Execute the tasks of the current job until no task is left. Called by
+     * the workers and by execute().
+     */
+    void runTasks();
+
+    // The worker threads
+    cArray<cWorker*> m_workers;
+    // Set to non-zero while a job is executed
+    volatile counter_t m_isBusy;
+    // The current job
+    cTask* m_task;
+    // The number of tasks of the current job
+    counter_t m_tasksCount;
+    // The next task which should be executed
+    volatile counter_t m_nextTask;
+    // The number of workers which still execute the current job
+    volatile counter_t m_activeWorkers;
+    // Set when a task of the current job throws an exception
+    volatile bool m_isFailed;
+    // Set when the last worker completes the current job
+    cEvent m_done;
+    // Set when the pool is destroyed
+    volatile bool m_shouldStop;
+    // The shared pool
+    static cThreadPool* volatile m_default;
+};
+
+#endif // __TBA_STL_OS_THREADPOOL_H
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_OS_UNIXOS_SMALLMEMORY_H
+#define __TBA_STL_OS_UNIXOS_SMALLMEMORY_H
+
+/*
+ * smallMemory.h
+ *
+ * The small-memory allocator of the UNIX implementation: Size classes, a
+ * cache of free blocks for each thread and a central depot.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+
+/*
+ * cSmallMemory
+ *
+ * The allocator behind cOS::smallMemoryAllocation(), smallMemoryRealloc() and
+ * smallMemoryFree() on UNIX.
+ *
+ * Blocks up to MaxSmallSize bytes are rounded up to one of SizeClassesCount
+ * size classes: Steps of 16 bytes up to 1kb, and then four classes for every
+ * power of two. The blocks of a class are carved out of spans of
+ * SpanSize bytes which are aligned to their size, so the span of a block (and
+ * the size class written at the head of the span) is found by masking the
+ * address of the block. A map with a bit for every span tells the blocks of
+ * the spans from the large blocks, so every free reads two more words.
+ *
+ * Larger blocks are allocated with malloc() and resized with realloc(), so
+ * they aren't aligned to a span and can grow in place. Their cost over the
+ * system heap is a header of 'Alignment' bytes before the block.
+ *
+ * Every thread keeps a list of free blocks for each size class, so most of
+ * the allocations and frees don't take any lock. When the list of a thread is
+ * empty, a batch of blocks is moved from the central depot of the class. When
+ * the list grows above twice the batch size (for example a thread which frees
+ * the blocks that other threads allocated), a batch is returned to the depot,
+ * where the other threads take it. The lists of a thread are returned to the
+ * depot when the thread exits.
+ *
+ * The spans of the size classes are never returned to the system heap.
+ *
+ * Usage:
+ *     cSmallMemory::Statistics statistics;
+ *     cSmallMemory::getStatistics(statistics);
+ *     cout << "Cache hit ratio: " << statistics.getCacheHitRatio() << endl;
+ */
+class cSmallMemory
+{
+public:
+    enum {
+        // The alignment of all the blocks
+        Alignment = 16,
+        // The largest block which has a size class
+        MaxSmallSize = 32 * 1024,
+        // The number of the size classes, see getSizeClassSize()
+        SizeClassesCount = 84,
+        // The size (and the alignment) of the spans of the size classes
+        SpanSize = 256 * 1024
+    };
+
+    /*
+     * Return a block of 'size' bytes, aligned to 'Alignment'.
+     *
+     * Throws exception if there is no memory.
+     */
+    static void* allocate(uint size);
+
+    /*
+     * Change the size of 'block' to 'newSize' bytes. The block is kept if the
+     * new size has the same size class. Otherwise a new block is allocated and
+     * the content is copied (only if 'preserveMemory' is true).
+     *
+     * block    - A block which was returned by allocate(), or NULL for a new
+     *            block.
+     * newSize  - The new size of the block. 0 frees the block and returns NULL.
+     *
+     * Throws exception if there is no memory, or if 'block' is invalid.
+     */
+    static void* reallocate(void* block, uint newSize, bool preserveMemory);
+
+    /*
+     * Free a block which was returned by allocate(). NULL is ignored.
+     *
+     * Throws exception if 'block' is invalid.
+     */
+    static void free(void* block);
+
+    /*
+     * Return the size class of blocks of 'size' bytes (up to MaxSmallSize)
+     */
+    static uint getSizeClass(uint size);
+
+    /*
+     * Return the number of bytes of the blocks of 'sizeClass'
+     */
+    static uint getSizeClassSize(uint sizeClass);
+
+    /*
+     * Move all the cached blocks of the calling thread into the central depot.
+     * Call it before a thread goes idle for a long time, so other threads can
+     * use its free blocks.
+     */
+    static void flushThreadCache();
+
+    /*
+     * The state of the allocator, summed over all the threads
+     */
+    struct Statistics {
+        // The number of bytes of the used blocks of every size class
+        uint64 m_bytesInUse[SizeClassesCount];
+        // The number of bytes of the used blocks which are larger than
+        // MaxSmallSize
+        uint64 m_largeBytesInUse;
+        // The number of bytes of all the spans of the size classes
+        uint64 m_reservedBytes;
+        // The number of allocations which were served by the cache of a thread
+        uint64 m_cacheHits;
+        // The number of allocations which had to refill the cache of a thread
+        uint64 m_cacheMisses;
+
+        /*
+         * Return the part of the small allocations which were served by the
+         * cache of the thread, between 0 and 1.
+         */
+        double getCacheHitRatio() const;
+    };
+
+    /*
+     * Fill 'statistics' with the current state of the allocator. The counters
+     * of the other threads are read while they run, so the result is a close
+     * estimation.
+     */
+    static void getStatistics(Statistics& statistics);
+};
+
+#endif // __TBA_STL_OS_UNIXOS_SMALLMEMORY_H
@@ -41,7 +41,7 @@
  */
 #include "xStl/types.h"
 #include "xStl/data/char.h"
-#include "xStl/data/list.h"
+#include "xStl/data/deque.h"
 #include "xStl/exceptions.h"
 
 /*
@@ -122,8 +122,8 @@ public:
     character getNextCloserCharacer();
 
 private:
-    // Link list of the current braces state.
-    cList<character> m_state;
+    // Stack of the current braces state.
+    cDeque<character> m_state;
     // Cache of the last braces character
     character m_stateCache;
 
@@ -43,6 +43,7 @@
 #include "xStl/types.h"
 #include "xStl/data/char.h"
 #include "xStl/data/array.h"
+#include "xStl/data/stringView.h"
 #include "xStl/parser/types.h"
 #include "xStl/parser/variable.h"
 #include "xStl/parser/except.h"
@@ -162,6 +163,12 @@ public:
      */
     cString readWord();
 
+    /*
+     * Same as 'readWord' except that the word is not copied. The returned view
+     * points into the parsed data.
+     */
+    cAsciiStringView readWordView();
+
     /*
      * Reads a C name. The name must contains either one of the following
      * characters: letter, digit and _.
@@ -175,6 +182,12 @@ public:
      */
     cString readCString(bool isFirstLetter = true);
 
+    /*
+     * Same as 'readCString' except that the name is not copied. The returned
+     * view points into the parsed data.
+     */
+    cAsciiStringView readCStringView(bool isFirstLetter = true);
+
     /*
      * The function reads a string starting with quate (") and ends with a quate.
      * The function parse the internal special characters such as '\t' '\n' and
@@ -208,6 +221,8 @@ public:
      *
      * TODO! Add base 8 parser.
      *
+     * The digits are parsed by cNumberConversion.
+     *
      * Throws exception if the first character is not a digit.
      * Throws exception if overflow had being occured.
      */
@@ -234,7 +249,10 @@ public:
 
     /*
      * The same as 'readCUnsignedInteger' except the reading format expects
-     * a number in base 16.
+     * a number in base 16, with an optional 'L' or 'H' suffix.
+     *
+     * Throws exception if the number isn't formatted or overflow had being
+     * occured.
      */
     uint readHexString();
 
@@ -44,6 +44,7 @@
 #include "xStl/types.h"
 #include "xStl/data/array.h"
 #include "xStl/data/sarray.h"
+#include "xStl/data/deque.h"
 #include "xStl/data/smartptr.h"
 #include "xStl/except/exception.h"
 #include "xStl/except/assert.h"
@@ -193,7 +194,7 @@ private:
     cBitStream          *m_bit_stream; /* Bit access to the m_stream       */
     unsigned int         m_bitSize;    /* Number of bit in the compression */
     cSArray<LZW_STRING>  m_table;      /* The LZW table                    */
-    cList<unsigned int>  m_readed_codes;              /* Saved information */
+    cDeque<unsigned int> m_readed_codes;              /* Saved information */
 
     unsigned int start_opcodes;
     unsigned int m_write_prefix;
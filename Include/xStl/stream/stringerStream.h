@@ -43,6 +43,7 @@
 
 #include "xStl/types.h"
 #include "xStl/data/string.h"
+#include "xStl/data/stringBuilder.h"
 #include "xStl/data/smartptr.h"
 #include "xStl/stream/basicIO.h"
 #include "xStl/os/xstlLockable.h"
@@ -238,6 +239,39 @@ private:
     cString m_data;
 };
 
+/*
+ * Implementation of the cStringerStream which appends the output strings into
+ * a cStringBuilder. Allows functions which writes into a cStringerStream to
+ * produce a large text without growing a string.
+ *
+ * NOTE: This class is not thread-safe
+ */
+class cStringBuilderStream : public cStringerStream
+{
+public:
+    /*
+     * Constructor. This class shouldn't be wait for endln.
+     *
+     * builder - The builder to append into. Must be valid as long as the
+     *           stream is used.
+     */
+    cStringBuilderStream(cStringBuilder& builder);
+
+protected:
+    /*
+     * Append the string into the builder.
+     * See cStringerStream::outputString
+     */
+    virtual void outputString(const cString& string);
+
+private:
+    // Deny copy-constructor and operator =
+    cStringBuilderStream(const cStringBuilderStream& other);
+    cStringBuilderStream& operator = (const cStringBuilderStream& other);
+    // The output builder
+    cStringBuilder& m_builder;
+};
+
 /*
  * The NULL stringer stream responsible for sending the string message into
  * a void space. The implementation is simple
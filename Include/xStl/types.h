@@ -377,6 +377,19 @@ void* getPtr(addressNumericValue address);
     #define EXTERNC
 #endif
 
+/*
+ * XSTL_CPP11
+ *
+ * Defined when the compiler supports rvalue-references, ref-qualifiers and
+ * variadic templates (C++11). Enables the move semantics of the containers.
+ * Define XSTL_NO_CPP11 in order to force the old code.
+ */
+#if !defined(XSTL_NO_CPP11) && \
+    ((defined(__cplusplus) && (__cplusplus >= 201103L)) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1900)))
+    #define XSTL_CPP11
+#endif
+
 #ifdef XSTL_LINUX
     #define XSTL_PACKED_HEADER
     #define XSTL_PACKED_FOOTER
@@ -42,6 +42,7 @@
 
 #include "xStl/types.h"
 #include "xStl/except/assert.h"
+#include "xStl/utils/typeTraits.h"
 
 /*
  * T& t_min (a,b)
@@ -64,19 +65,83 @@ const T& t_max(const T& a, const T& b)
     return (a < b) ? b : a;
 }
 
+/*
+ * class cLessThan
+ *
+ * The default order of the sorted containers. Returns true if 'a' should
+ * come before 'b', using the operator < of T.
+ */
+template <class T>
+class cLessThan
+{
+public:
+    bool operator () (const T& a, const T& b) const
+    {
+        return a < b;
+    }
+};
+
+#ifdef XSTL_CPP11
+/*
+ * t_move(object)
+ *
+ * Cast 'object' into an rvalue-reference, so the move constructor or the move
+ * assignment operator of T is selected. Same as std::move.
+ */
+template <class T>
+typename cRemoveReference<T>::type&& t_move(T&& object)
+{
+    return static_cast<typename cRemoveReference<T>::type&&>(object);
+}
+
+/*
+ * t_forward<T>(object)
+ *
+ * Pass a forwarding-reference argument keeping its value category. Same as
+ * std::forward.
+ */
+template <class T>
+T&& t_forward(typename cRemoveReference<T>::type& object)
+{
+    return static_cast<T&&>(object);
+}
+template <class T>
+T&& t_forward(typename cRemoveReference<T>::type&& object)
+{
+    return static_cast<T&&>(object);
+}
+#else
+/*
+ * t_move(object)
+ *
+ * Without move semantics the object is copied.
+ */
+template <class T>
+T& t_move(T& object)
+{
+    return object;
+}
+#endif // XSTL_CPP11
 
 /*
  * t_swap(a,b) template function
  *
  * Swap between the variables.
- * T must have a copy constructor and assignment operator (=)
+ * T must have a copy constructor and assignment operator (=). When move
+ * semantics are available, the move constructor and assignment are used.
  */
 template <class T>
 void t_swap(T& a, T& b)
 {
+    #ifdef XSTL_CPP11
+    T c(t_move(a));
+    a = t_move(b);
+    b = t_move(c);
+    #else
     T c(a);
     a = b;
     b = c;
+    #endif
 }
 
 /*
@@ -185,6 +250,9 @@ bool compare(ITR_FW b1, ITR_FW e1, ITR_FW b2, ITR_FW e2)
  *
  * Sort a struct using bidirectonal iterator. Later implementation on other
  * iterator will be welcome.
+ *
+ * NOTE: This is O(n^2). Use sort() for random-access iterators and
+ *       cList<T>::sort() for lists.
  */
 template <class ITR_BD>
 void boubbleSort(ITR_BD begin, ITR_BD end)
@@ -208,6 +276,440 @@ void boubbleSort(ITR_BD begin, ITR_BD end)
         }
 }
 
+/*
+ * Sorting algorithms
+ *
+ * The following templates works on a range of random-access iterators, such
+ * as pointers into the buffer of a cArray:
+ *     sort(array.getBuffer(), array.getBuffer() + array.getSize());
+ * or the cArray<T>::iterator. The iterator must support *i, ++i, --i, i + n,
+ * the distance between two iterators (j - i) and the operators == and <.
+ *
+ * The optional 'compare' argument is a functor (See cLessThan) which returns
+ * true if its first argument should be placed before the second one. Without
+ * it the operator < of the elements is used.
+ *
+ * The sort*() functions are the internal parts of the algorithms. The last
+ * argument of them is a pointer to an element, which is used only in order to
+ * know the type of the elements.
+ */
+
+/*
+ * sortInsertion(begin, end, compare, type)
+ *
+ * Insertion sort. Used for short ranges, and for the ranges which are almost
+ * sorted by sortIntroLoop().
+ */
+template <class ITR_RA, class Compare, class T>
+void sortInsertion(ITR_RA begin, ITR_RA end, const Compare& compare, T*)
+{
+    if (begin == end)
+        return;
+
+    ITR_RA i = begin;
+    for (++i; i != end; ++i)
+    {
+        T value(t_move(*i));
+        ITR_RA hole = i;
+        ITR_RA previous = i;
+        if (compare(value, *begin))
+        {
+            // The element is the lowest, shift all the sorted elements
+            while (hole != begin)
+            {
+                --previous;
+                *hole = t_move(*previous);
+                hole = previous;
+            }
+        } else
+        {
+            // The first element stops the scan
+            --previous;
+            while (compare(value, *previous))
+            {
+                *hole = t_move(*previous);
+                hole = previous;
+                --previous;
+            }
+        }
+        *hole = t_move(value);
+    }
+}
+
+/*
+ * sortSiftDown(begin, position, count, compare, type)
+ *
+ * Move the element at 'position' toward the leafs of the binary heap of
+ * 'count' elements at 'begin'. The greatest element is the root.
+ */
+template <class ITR_RA, class Compare, class T>
+void sortSiftDown(ITR_RA begin, uint position, uint count,
+                  const Compare& compare, T*)
+{
+    T value(t_move(*(begin + position)));
+    while (true)
+    {
+        uint child = position * 2 + 1;
+        if (child >= count)
+            break;
+        if ((child + 1 < count) &&
+            compare(*(begin + child), *(begin + (child + 1))))
+        {
+            child++;
+        }
+        if (!compare(value, *(begin + child)))
+            break;
+        *(begin + position) = t_move(*(begin + child));
+        position = child;
+    }
+    *(begin + position) = t_move(value);
+}
+
+/*
+ * sortMakeHeap(begin, count, compare, type)
+ *
+ * Order 'count' elements at 'begin' as a binary heap.
+ */
+template <class ITR_RA, class Compare, class T>
+void sortMakeHeap(ITR_RA begin, uint count, const Compare& compare, T* type)
+{
+    for (uint i = count / 2; i > 0; i--)
+        sortSiftDown(begin, i - 1, count, compare, type);
+}
+
+/*
+ * sortHeap(begin, count, compare, type)
+ *
+ * Sort a binary heap of 'count' elements at 'begin'.
+ */
+template <class ITR_RA, class Compare, class T>
+void sortHeap(ITR_RA begin, uint count, const Compare& compare, T* type)
+{
+    while (count > 1)
+    {
+        count--;
+        t_swap(*begin, *(begin + count));
+        sortSiftDown(begin, 0, count, compare, type);
+    }
+}
+
+/*
+ * sortPartition(begin, end, compare)
+ *
+ * Move the median of three elements to 'begin' and partition the range
+ * around it. Returns the cut: The elements before the cut are not greater
+ * than the pivot, and the elements from the cut are not lower than it.
+ * The range must have at least 3 elements.
+ */
+template <class ITR_RA, class Compare>
+ITR_RA sortPartition(ITR_RA begin, ITR_RA end, const Compare& compare)
+{
+    ITR_RA a = begin;
+    ++a;
+    ITR_RA b = begin + ((uint)(end - begin) / 2);
+    ITR_RA c = end;
+    --c;
+
+    // Move the median of a, b and c into 'begin'. The two other elements
+    // stops the scans of the partition.
+    if (compare(*a, *b))
+    {
+        if (compare(*b, *c))
+            t_swap(*begin, *b);
+        else if (compare(*a, *c))
+            t_swap(*begin, *c);
+        else
+            t_swap(*begin, *a);
+    } else if (compare(*a, *c))
+        t_swap(*begin, *a);
+    else if (compare(*b, *c))
+        t_swap(*begin, *c);
+    else
+        t_swap(*begin, *b);
+
+    ITR_RA left = begin;
+    ++left;
+    ITR_RA right = end;
+    while (true)
+    {
+        while (compare(*left, *begin))
+            ++left;
+        --right;
+        while (compare(*begin, *right))
+            --right;
+        if (!(left < right))
+            return left;
+        t_swap(*left, *right);
+        ++left;
+    }
+}
+
+/*
+ * sortDepthLimit(count)
+ *
+ * Return the number of partitions before a range of 'count' elements is
+ * sorted by heap-sort (2 * log2(count)).
+ */
+inline uint sortDepthLimit(uint count)
+{
+    uint depth = 0;
+    for (; count > 1; count>>= 1)
+        depth+= 2;
+    return depth;
+}
+
+/*
+ * sortIntroLoop(begin, end, depth, compare, type)
+ *
+ * Quick-sort the range until the parts are shorter than 16 elements. When the
+ * partitions are too unbalanced the part is sorted by heap-sort.
+ */
+template <class ITR_RA, class Compare, class T>
+void sortIntroLoop(ITR_RA begin, ITR_RA end, uint depth,
+                   const Compare& compare, T* type)
+{
+    while ((uint)(end - begin) > 16)
+    {
+        if (depth == 0)
+        {
+            uint count = (uint)(end - begin);
+            sortMakeHeap(begin, count, compare, type);
+            sortHeap(begin, count, compare, type);
+            return;
+        }
+        depth--;
+        ITR_RA cut = sortPartition(begin, end, compare);
+        sortIntroLoop(cut, end, depth, compare, type);
+        end = cut;
+    }
+}
+
+/*
+ * sort(begin, end)
+ * sort(begin, end, compare)
+ *
+ * Sort a range using intro-sort: A quick-sort which switches to heap-sort
+ * when it goes too deep, so the worst case is O(n*log(n)). The sort is not
+ * stable.
+ */
+template <class ITR_RA, class Compare>
+void sort(ITR_RA begin, ITR_RA end, const Compare& compare)
+{
+    if (begin == end)
+        return;
+    sortIntroLoop(begin, end, sortDepthLimit((uint)(end - begin)), compare,
+                  &*begin);
+    sortInsertion(begin, end, compare, &*begin);
+}
+
+template <class ITR_RA, class T>
+void sortDefaultOrder(ITR_RA begin, ITR_RA end, T*)
+{
+    sort(begin, end, cLessThan<T>());
+}
+
+template <class ITR_RA>
+void sort(ITR_RA begin, ITR_RA end)
+{
+    if (begin == end)
+        return;
+    sortDefaultOrder(begin, end, &*begin);
+}
+
+/*
+ * partialSort(begin, middle, end)
+ * partialSort(begin, middle, end, compare)
+ *
+ * Place the lowest (middle - begin) elements of the range, sorted, at
+ * [begin, middle). The order of the rest of the elements is not defined.
+ * Costs O(n*log(middle - begin)).
+ */
+template <class ITR_RA, class Compare>
+void partialSort(ITR_RA begin, ITR_RA middle, ITR_RA end,
+                 const Compare& compare)
+{
+    if (begin == middle)
+        return;
+
+    // Keep the lowest elements in a heap which has the greatest one at the top
+    uint count = (uint)(middle - begin);
+    sortMakeHeap(begin, count, compare, &*begin);
+    for (ITR_RA i = middle; i != end; ++i)
+    {
+        if (compare(*i, *begin))
+        {
+            t_swap(*i, *begin);
+            sortSiftDown(begin, 0, count, compare, &*begin);
+        }
+    }
+    sortHeap(begin, count, compare, &*begin);
+}
+
+template <class ITR_RA, class T>
+void partialSortDefaultOrder(ITR_RA begin, ITR_RA middle, ITR_RA end, T*)
+{
+    partialSort(begin, middle, end, cLessThan<T>());
+}
+
+template <class ITR_RA>
+void partialSort(ITR_RA begin, ITR_RA middle, ITR_RA end)
+{
+    if (begin == middle)
+        return;
+    partialSortDefaultOrder(begin, middle, end, &*begin);
+}
+
+/*
+ * nthElement(begin, nth, end)
+ * nthElement(begin, nth, end, compare)
+ *
+ * Place at 'nth' the element which would be there if the range was sorted.
+ * The elements before 'nth' are not greater than it, and the elements after
+ * it are not lower. Costs O(n) on average (intro-select).
+ */
+template <class ITR_RA, class Compare>
+void nthElement(ITR_RA begin, ITR_RA nth, ITR_RA end, const Compare& compare)
+{
+    if (nth == end)
+        return;
+
+    uint depth = sortDepthLimit((uint)(end - begin));
+    while ((uint)(end - begin) > 3)
+    {
+        if (depth == 0)
+        {
+            ITR_RA last = nth;
+            ++last;
+            partialSort(begin, last, end, compare);
+            return;
+        }
+        depth--;
+        ITR_RA cut = sortPartition(begin, end, compare);
+        if (nth < cut)
+            end = cut;
+        else
+            begin = cut;
+    }
+    sortInsertion(begin, end, compare, &*begin);
+}
+
+template <class ITR_RA, class T>
+void nthElementDefaultOrder(ITR_RA begin, ITR_RA nth, ITR_RA end, T*)
+{
+    nthElement(begin, nth, end, cLessThan<T>());
+}
+
+template <class ITR_RA>
+void nthElement(ITR_RA begin, ITR_RA nth, ITR_RA end)
+{
+    if (nth == end)
+        return;
+    nthElementDefaultOrder(begin, nth, end, &*begin);
+}
+
+/*
+ * class cRadixKey
+ *
+ * The default key of radixSort() for integer types. Signed numbers are
+ * biased, so the negative numbers comes first.
+ */
+template <class T>
+class cRadixKey
+{
+public:
+    uint64 operator () (const T& value) const
+    {
+        uint64 key = (uint64)value;
+        if ((T)(-1) < (T)(0))
+        {
+            // Flip the sign bit and drop the sign extension
+            uint64 mask = ((((uint64)1) << (sizeof(T) * 4)) <<
+                                           (sizeof(T) * 4)) - 1;
+            key = (key ^ (((uint64)1) << (sizeof(T) * 8 - 1))) & mask;
+        }
+        return key;
+    }
+};
+
+/*
+ * radixSort(begin, end)
+ * radixSort(begin, end, key)
+ *
+ * Sort an array by an integer key using a stable LSD radix-sort, one pass
+ * for each byte of the key. Bytes which are the same in all the keys are
+ * skipped, so small keys are sorted in less passes. Costs O(n) for each pass.
+ *
+ * key - Functor with 'uint64 operator () (const T&) const' which returns the
+ *       key of an element. Without it the elements must be integers.
+ *
+ * T must have a default constructor and operator =. A temporary array with
+ * the same number of elements is allocated.
+ */
+template <class T, class KeyFunction>
+void radixSort(T* begin, T* end, const KeyFunction& key)
+{
+    uint count = (uint)(end - begin);
+    if (count < 2)
+        return;
+
+    // Count the digits of all the passes at once
+    uint histogram[sizeof(uint64)][256];
+    uint i, pass;
+    for (pass = 0; pass < sizeof(uint64); pass++)
+        for (i = 0; i < 256; i++)
+            histogram[pass][i] = 0;
+    for (i = 0; i < count; i++)
+    {
+        uint64 value = key(begin[i]);
+        for (pass = 0; pass < sizeof(uint64); pass++)
+        {
+            histogram[pass][value & 0xFF]++;
+            value>>= 8;
+        }
+    }
+
+    T* buffer = new T[count];
+    T* source = begin;
+    T* destination = buffer;
+    uint64 firstKey = key(begin[0]);
+    for (pass = 0; pass < sizeof(uint64); pass++)
+    {
+        uint shift = pass * 8;
+        uint* offsets = histogram[pass];
+        if (offsets[(uint)((firstKey >> shift) & 0xFF)] == count)
+            continue;
+
+        // Translate the counters into the first position of each digit
+        uint position = 0;
+        for (i = 0; i < 256; i++)
+        {
+            uint digitCount = offsets[i];
+            offsets[i] = position;
+            position+= digitCount;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            uint digit = (uint)((key(source[i]) >> shift) & 0xFF);
+            destination[offsets[digit]++] = t_move(source[i]);
+        }
+        t_swap(source, destination);
+    }
+
+    if (source != begin)
+    {
+        for (i = 0; i < count; i++)
+            begin[i] = t_move(source[i]);
+    }
+    delete [] buffer;
+}
+
+template <class T>
+void radixSort(T* begin, T* end)
+{
+    radixSort(begin, end, cRadixKey<T>());
+}
+
 /*
  * Template rotation function.
  *
@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_UTILS_PARALLEL_H
+#define __TBA_STL_UTILS_PARALLEL_H
+
+/*
+ * parallel.h
+ *
+ * Parallel versions of the common loops over arrays: for, transform, reduce
+ * and sort. The work is split into ranges which are executed by the threads
+ * of a cThreadPool.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/data/array.h"
+#include "xStl/os/threadPool.h"
+
+/*
+ * The functors which are given to the following templates are called from
+ * several threads at the same time, so their operator () must be const and
+ * must not change shared data without synchronization.
+ *
+ * All the functions accept cArray and cSArray. The default pool is the shared
+ * cThreadPool::getDefault(). Ranges which are shorter than 'grain' elements
+ * are not split between the threads.
+ */
+
+/*
+ * class cParallelRange
+ *
+ * Split a range of 'count' elements into 'parts' ranges with almost the same
+ * size.
+ */
+class cParallelRange
+{
+public:
+    enum {
+        // The number of ranges for each thread. More ranges than threads
+        // balances the work when some ranges are slower than others.
+        RangesPerThread = 4,
+        // The default grain of the light per-element operations
+        DefaultGrain = 4096
+    };
+
+    /*
+     * Return the number of ranges for 'count' elements, at least 'grain'
+     * elements in a range.
+     */
+    static uint getRangesCount(uint count, uint grain, uint concurrency)
+    {
+        if (grain == 0)
+            grain = 1;
+        uint ranges = count / grain;
+        uint maximum = concurrency * RangesPerThread;
+        if (ranges > maximum)
+            ranges = maximum;
+        if (ranges == 0)
+            ranges = 1;
+        return ranges;
+    }
+
+    /*
+     * Return the first element of the range 'index'. The range ends at the
+     * first element of 'index + 1'.
+     */
+    static uint getStart(uint count, uint parts, uint index)
+    {
+        return (uint)(((uint64)count * index) / parts);
+    }
+};
+
+/*
+ * Internal tasks of the parallel functions.
+ */
+template <class Function>
+class cParallelForTask : public cThreadPool::cTask
+{
+public:
+    cParallelForTask(uint begin, uint count, uint ranges,
+                     const Function& function) :
+        m_begin(begin), m_count(count), m_ranges(ranges), m_function(function)
+    {
+    }
+
+    virtual void runTask(uint index)
+    {
+        uint end = m_begin +
+                   cParallelRange::getStart(m_count, m_ranges, index + 1);
+        for (uint i = m_begin + cParallelRange::getStart(m_count, m_ranges,
+                                                         index);
+             i < end; i++)
+        {
+            m_function(i);
+        }
+    }
+
+private:
+    uint m_begin;
+    uint m_count;
+    uint m_ranges;
+    const Function& m_function;
+};
+
+template <class S, class D, class Function>
+class cParallelTransformTask : public cThreadPool::cTask
+{
+public:
+    cParallelTransformTask(const S* source, D* destination, uint count,
+                           uint ranges, const Function& function) :
+        m_source(source), m_destination(destination), m_count(count),
+        m_ranges(ranges), m_function(function)
+    {
+    }
+
+    virtual void runTask(uint index)
+    {
+        uint end = cParallelRange::getStart(m_count, m_ranges, index + 1);
+        for (uint i = cParallelRange::getStart(m_count, m_ranges, index);
+             i < end; i++)
+        {
+            m_destination[i] = m_function(m_source[i]);
+        }
+    }
+
+private:
+    const S* m_source;
+    D* m_destination;
+    uint m_count;
+    uint m_ranges;
+    const Function& m_function;
+};
+
+template <class T, class Reduce>
+class cParallelReduceTask : public cThreadPool::cTask
+{
+public:
+    cParallelReduceTask(const T* data, uint count, uint ranges,
+                        const Reduce& reduce, T* results) :
+        m_data(data), m_count(count), m_ranges(ranges), m_reduce(reduce),
+        m_results(results)
+    {
+    }
+
+    virtual void runTask(uint index)
+    {
+        uint i = cParallelRange::getStart(m_count, m_ranges, index);
+        uint end = cParallelRange::getStart(m_count, m_ranges, index + 1);
+        T result(m_data[i]);
+        for (i++; i < end; i++)
+            result = m_reduce(result, m_data[i]);
+        m_results[index] = result;
+    }
+
+private:
+    const T* m_data;
+    uint m_count;
+    uint m_ranges;
+    const Reduce& m_reduce;
+    T* m_results;
+};
+
+template <class T, class Compare>
+class cParallelSortTask : public cThreadPool::cTask
+{
+public:
+    cParallelSortTask(T* data, uint count, uint ranges,
+                      const Compare& compare) :
+        m_data(data), m_count(count), m_ranges(ranges), m_compare(compare)
+    {
+    }
+
+    virtual void runTask(uint index)
+    {
+        sort(m_data + cParallelRange::getStart(m_count, m_ranges, index),
+             m_data + cParallelRange::getStart(m_count, m_ranges, index + 1),
+             m_compare);
+    }
+
+private:
+    T* m_data;
+    uint m_count;
+    uint m_ranges;
+    const Compare& m_compare;
+};
+
+template <class T, class Compare>
+class cParallelMergeTask : public cThreadPool::cTask
+{
+public:
+    // Merge the sorted ranges [i*width, (i+1)*width) and
+    // [(i+1)*width, (i+2)*width) of 'source' for every even i
+    cParallelMergeTask(T* source, T* destination, uint count, uint ranges,
+                       uint width, const Compare& compare) :
+        m_source(source), m_destination(destination), m_count(count),
+        m_ranges(ranges), m_width(width), m_compare(compare)
+    {
+    }
+
+    virtual void runTask(uint index)
+    {
+        uint first = index * 2 * m_width;
+        uint start = cParallelRange::getStart(m_count, m_ranges, first);
+        uint middle = cParallelRange::getStart(m_count, m_ranges,
+                                    t_min(first + m_width, m_ranges));
+        uint end = cParallelRange::getStart(m_count, m_ranges,
+                                    t_min(first + 2 * m_width, m_ranges));
+
+        T* a = m_source + start;
+        T* aEnd = m_source + middle;
+        T* b = aEnd;
+        T* bEnd = m_source + end;
+        T* output = m_destination + start;
+        while ((a != aEnd) && (b != bEnd))
+        {
+            if (m_compare(*b, *a))
+                *(output++) = t_move(*(b++));
+            else
+                *(output++) = t_move(*(a++));
+        }
+        while (a != aEnd)
+            *(output++) = t_move(*(a++));
+        while (b != bEnd)
+            *(output++) = t_move(*(b++));
+    }
+
+private:
+    T* m_source;
+    T* m_destination;
+    uint m_count;
+    uint m_ranges;
+    uint m_width;
+    const Compare& m_compare;
+};
+
+/*
+ * parallelFor(begin, end, function[, grain, pool])
+ *
+ * Call function(i) for every i in [begin, end). The order of the calls is not
+ * defined.
+ *
+ * function - Functor with 'void operator () (uint index) const'
+ * grain    - The minimum number of indexes which are executed by a single
+ *            task. The default is one index, for loops with heavy bodies.
+ */
+template <class Function>
+void parallelFor(uint begin, uint end, const Function& function,
+                 uint grain = 1,
+                 cThreadPool& pool = cThreadPool::getDefault())
+{
+    if (end <= begin)
+        return;
+    uint count = end - begin;
+    uint ranges = cParallelRange::getRangesCount(count, grain,
+                                                 pool.getConcurrency());
+    cParallelForTask<Function> task(begin, count, ranges, function);
+    pool.execute(task, ranges);
+}
+
+/*
+ * parallelTransform(source, destination, function[, pool])
+ *
+ * Set destination[i] = function(source[i]) for all the elements of 'source'.
+ * 'destination' is resized to the size of 'source', and can be 'source'
+ * itself.
+ *
+ * function - Functor with 'D operator () (const S& element) const'
+ */
+template <class S, class D, class Function>
+void parallelTransform(const cArray<S>& source, cArray<D>& destination,
+                       const Function& function,
+                       cThreadPool& pool = cThreadPool::getDefault())
+{
+    uint count = source.getSize();
+    destination.changeSize(count);
+    if (count == 0)
+        return;
+    uint ranges = cParallelRange::getRangesCount(count,
+                                                 cParallelRange::DefaultGrain,
+                                                 pool.getConcurrency());
+    cParallelTransformTask<S, D, Function> task(source.getBuffer(),
+                                                destination.getBuffer(),
+                                                count, ranges, function);
+    pool.execute(task, ranges);
+}
+
+/*
+ * parallelReduce(array, initial, reduce[, pool])
+ *
+ * Combine all the elements of 'array' using 'reduce': The result is
+ * reduce(...reduce(reduce(initial, array[0]), array[1])..., array[n - 1]),
+ * except that the elements are combined in ranges first, so 'reduce' must be
+ * associative (for example: sum, minimum, maximum).
+ *
+ * reduce - Functor with 'T operator () (const T& a, const T& b) const'
+ *
+ * Return 'initial' if the array is empty.
+ */
+template <class T, class Reduce>
+T parallelReduce(const cArray<T>& array, const T& initial,
+                 const Reduce& reduce,
+                 cThreadPool& pool = cThreadPool::getDefault())
+{
+    uint count = array.getSize();
+    if (count == 0)
+        return initial;
+    uint ranges = cParallelRange::getRangesCount(count,
+                                                 cParallelRange::DefaultGrain,
+                                                 pool.getConcurrency());
+    cArray<T> results(ranges);
+    cParallelReduceTask<T, Reduce> task(array.getBuffer(), count, ranges,
+                                        reduce, results.getBuffer());
+    pool.execute(task, ranges);
+
+    T result(initial);
+    for (uint i = 0; i < ranges; i++)
+        result = reduce(result, results[i]);
+    return result;
+}
+
+/*
+ * parallelSort(array)
+ * parallelSort(array, compare[, pool])
+ *
+ * Sort the array. Ranges of the array are sorted in parallel by sort() (See
+ * algorithm.h) and merged in pairs, in parallel, until the whole array is
+ * sorted. The sort is not stable. A temporary array of the same size is
+ * allocated.
+ */
+template <class T, class Compare>
+void parallelSort(cArray<T>& array, const Compare& compare,
+                  cThreadPool& pool = cThreadPool::getDefault())
+{
+    uint count = array.getSize();
+    uint concurrency = pool.getConcurrency();
+    if ((concurrency == 1) || (count < cParallelRange::DefaultGrain * 2))
+    {
+        sort(array.getBuffer(), array.getBuffer() + count, compare);
+        return;
+    }
+
+    // Sort a range in each thread
+    uint ranges = cParallelRange::getRangesCount(count,
+                                                 cParallelRange::DefaultGrain,
+                                                 concurrency);
+    ranges = t_min(ranges, concurrency);
+    cParallelSortTask<T, Compare> sortTask(array.getBuffer(), count, ranges,
+                                           compare);
+    pool.execute(sortTask, ranges);
+
+    // The buffer may replace the array, so it uses the same allocator
+    cArray<T> buffer;
+    buffer.setAllocator(array.getAllocator());
+    buffer.changeSize(count);
+
+    // Merge the ranges in pairs. Each round merges ranges of 'width' sorted
+    // parts into ranges of twice the width.
+    T* source = array.getBuffer();
+    T* destination = buffer.getBuffer();
+    uint width;
+    for (width = 1; width < ranges; width*= 2)
+    {
+        uint merges = (ranges + 2 * width - 1) / (2 * width);
+        cParallelMergeTask<T, Compare> mergeTask(source, destination, count,
+                                                 ranges, width, compare);
+        pool.execute(mergeTask, merges);
+        t_swap(source, destination);
+    }
+
+    // The sorted elements are in the temporary array
+    if (source != array.getBuffer())
+        array.swap(buffer);
+}
+
+template <class T>
+void parallelSort(cArray<T>& array)
+{
+    parallelSort(array, cLessThan<T>());
+}
+
+#endif // __TBA_STL_UTILS_PARALLEL_H
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_UTILS_TYPETRAITS_H
+#define __TBA_STL_UTILS_TYPETRAITS_H
+
+/*
+ * typeTraits.h
+ *
+ * Compile-time properties of types. The containers use the traits in order to
+ * select faster implementations for plain-old-data elements (raw memory
+ * allocation and memcpy instead of constructors and operator =).
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+
+/*
+ * Modern compilers can tell whether any type is a POD. Older compilers fall
+ * back into the list of the built-in types below, every other type is handled
+ * as a class with constructors.
+ */
+#if (defined(__GNUC__) && ((__GNUC__ > 4) || \
+                           ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 3)))) || \
+    defined(__clang__) || \
+    (defined(_MSC_VER) && (_MSC_VER >= 1400))
+    #define XSTL_POD_INTRINSIC(type) __is_pod(type)
+#endif
+
+/*
+ * class cTypeTraits
+ *
+ * isPod - Non-zero if T is a plain-old-data type: T has trivial constructor,
+ *         destructor and assignment, so it can be allocated using raw memory
+ *         and copied using memcpy.
+ */
+template <class T>
+class cTypeTraits
+{
+public:
+    enum {
+        #ifdef XSTL_POD_INTRINSIC
+        isPod = XSTL_POD_INTRINSIC(T)
+        #else
+        isPod = 0
+        #endif
+    };
+};
+
+/*
+ * Pointers are always plain-old-data
+ */
+template <class T>
+class cTypeTraits<T*>
+{
+public:
+    enum { isPod = 1 };
+};
+
+#ifdef XSTL_CPP11
+/*
+ * class cRemoveReference
+ *
+ * type - T without reference. Used by t_move and t_forward.
+ */
+template <class T>
+class cRemoveReference
+{
+public:
+    typedef T type;
+};
+
+template <class T>
+class cRemoveReference<T&>
+{
+public:
+    typedef T type;
+};
+
+template <class T>
+class cRemoveReference<T&&>
+{
+public:
+    typedef T type;
+};
+#endif // XSTL_CPP11
+
+/*
+ * Mark 'type' as a plain-old-data type for compilers without the intrinsic.
+ * Must be used in the global namespace.
+ */
+#define XSTL_DECLARE_POD(type)          \
+    template <>                         \
+    class cTypeTraits<type>             \
+    {                                   \
+    public:                             \
+        enum { isPod = 1 };             \
+    };
+
+#ifndef XSTL_POD_INTRINSIC
+XSTL_DECLARE_POD(char)
+XSTL_DECLARE_POD(signed char)
+XSTL_DECLARE_POD(unsigned char)
+XSTL_DECLARE_POD(short)
+XSTL_DECLARE_POD(unsigned short)
+XSTL_DECLARE_POD(int)
+XSTL_DECLARE_POD(unsigned int)
+XSTL_DECLARE_POD(long)
+XSTL_DECLARE_POD(unsigned long)
+XSTL_DECLARE_POD(float)
+XSTL_DECLARE_POD(double)
+#endif
+
+#endif // __TBA_STL_UTILS_TYPETRAITS_H
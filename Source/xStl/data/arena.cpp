@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * arena.cpp
+ *
+ * Implementation file.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+#include "xStl/except/assert.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/data/arena.h"
+
+cArena::cArena(uint chunkSize /* = DefaultChunkSize */,
+               bool useFreeLists /* = false */) :
+    m_chunkSize(t_max(alignSize(chunkSize), (uint)(Alignment * 4))),
+    m_useFreeLists(useFreeLists),
+    m_chunks(NULL),
+    m_position(NULL),
+    m_end(NULL),
+    m_allocatedBytes(0)
+{
+    for (uint i = 0; i < FreeListsCount; i++)
+        m_freeLists[i] = NULL;
+}
+
+cArena::~cArena()
+{
+    freeAll();
+}
+
+uint cArena::alignSize(uint size)
+{
+    if (size == 0)
+        return Alignment;
+    return ((size + Alignment - 1) / Alignment) * Alignment;
+}
+
+uint cArena::getAllocatedBytes() const
+{
+    return m_allocatedBytes;
+}
+
+uint8* cArena::allocateChunk(uint size, bool makeCurrent)
+{
+    uint chunkSize = ChunkHeaderSize + size;
+    Chunk* chunk = (Chunk*)cOS::smallMemoryAllocation(chunkSize);
+    if (chunk == NULL)
+        return NULL;
+    chunk->m_size = chunkSize;
+    m_allocatedBytes+= chunkSize;
+
+    uint8* blocks = ((uint8*)chunk) + ChunkHeaderSize;
+    if (makeCurrent || (m_chunks == NULL))
+    {
+        chunk->m_next = m_chunks;
+        m_chunks = chunk;
+        m_end = ((uint8*)chunk) + chunkSize;
+        // A dedicated block which must be the head of the list is already
+        // fully used
+        m_position = makeCurrent ? blocks : m_end;
+    } else
+    {
+        // Keep the current chunk the newest one
+        chunk->m_next = m_chunks->m_next;
+        m_chunks->m_next = chunk;
+    }
+    return blocks;
+}
+
+void* cArena::allocate(uint size)
+{
+    size = alignSize(size);
+
+    // Recycle a free block
+    if (m_useFreeLists && (size <= MaxFreeListSize))
+    {
+        FreeBlock*& list = m_freeLists[(size / Alignment) - 1];
+        if (list != NULL)
+        {
+            FreeBlock* block = list;
+            list = block->m_next;
+            return block;
+        }
+    }
+
+    if ((uint)(m_end - m_position) < size)
+    {
+        // Large blocks don't waste the rest of the current chunk
+        if (size > (m_chunkSize / 4))
+            return allocateChunk(size, false);
+
+        if (allocateChunk(m_chunkSize, true) == NULL)
+            return NULL;
+    }
+
+    void* ret = m_position;
+    m_position+= size;
+    return ret;
+}
+
+void* cArena::reallocate(void* block, uint oldSize, uint newSize)
+{
+    if (block == NULL)
+        return allocate(newSize);
+
+    uint oldAligned = alignSize(oldSize);
+    uint newAligned = alignSize(newSize);
+    if (newAligned == oldAligned)
+        return block;
+
+    // The last allocation grows or shrinks in place
+    uint8* position = (uint8*)block;
+    if ((position + oldAligned == m_position) &&
+        ((uint)(m_end - position) >= newAligned))
+    {
+        m_position = position + newAligned;
+        return block;
+    }
+
+    // Other blocks are shrunk by keeping them
+    if (newAligned < oldAligned)
+        return block;
+
+    void* ret = allocate(newSize);
+    if (ret == NULL)
+        return NULL;
+    cOS::memcpy(ret, block, t_min(oldSize, newSize));
+    free(block, oldSize);
+    return ret;
+}
+
+void cArena::free(void* block, uint size)
+{
+    if (block == NULL)
+        return;
+
+    size = alignSize(size);
+    if (m_useFreeLists && (size <= MaxFreeListSize))
+    {
+        FreeBlock* freeBlock = (FreeBlock*)block;
+        FreeBlock*& list = m_freeLists[(size / Alignment) - 1];
+        freeBlock->m_next = list;
+        list = freeBlock;
+        return;
+    }
+
+    // Roll back the last allocation
+    if (((uint8*)block) + size == m_position)
+        m_position = (uint8*)block;
+}
+
+void cArena::freeAll()
+{
+    while (m_chunks != NULL)
+    {
+        Chunk* next = m_chunks->m_next;
+        cOS::smallMemoryFree(m_chunks);
+        m_chunks = next;
+    }
+
+    for (uint i = 0; i < FreeListsCount; i++)
+        m_freeLists[i] = NULL;
+    m_position = NULL;
+    m_end = NULL;
+    m_allocatedBytes = 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * caseInsensitiveString.cpp
+ *
+ * Implementation file.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+#include "xStl/types.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/data/hashFunction.h"
+#include "xStl/data/caseInsensitiveString.h"
+
+cCaseInsensitiveString::cCaseInsensitiveString(
+                                    const cString& string /* = cString() */) :
+    m_string(string)
+{
+}
+
+const cString& cCaseInsensitiveString::getString() const
+{
+    return m_string;
+}
+
+bool cCaseInsensitiveString::operator == (
+                                const cCaseInsensitiveString& other) const
+{
+    return cStringCase::iequals(m_string.getBuffer(), m_string.length(),
+                                other.m_string.getBuffer(),
+                                other.m_string.length());
+}
+
+bool cCaseInsensitiveString::operator < (
+                                const cCaseInsensitiveString& other) const
+{
+    return cStringCase::icompare(m_string.getBuffer(), m_string.length(),
+                                 other.m_string.getBuffer(),
+                                 other.m_string.length()) < 0;
+}
+
+uint cHashFunction(const cCaseInsensitiveString& index, uint range)
+{
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed),
+                              range);
+}
+
+hashValue cHashCode(const cCaseInsensitiveString& index, hashValue seed)
+{
+    return cHashCodeNoCase(index.getString().getView(), seed);
+}
@@ -39,52 +39,32 @@
  */
 
 #include "xStl/types.h"
-#include "xStl/os/lock.h"
+#include "xStl/os/interlocked.h"
 #include "xStl/data/counter.h"
 
 cCounter::cCounter(counter_t initValue) :
     m_value(initValue)
-    #if (!(defined(XSTL_NTDDK) || defined(XSTL_WINDOWS) || defined(XSTL_CE)))
-        ,m_lock()
-    #endif
 {
 }
 
 counter_t cCounter::getValue() const
 {
-    return m_value;
+    return cInterlocked::load(&m_value);
 }
 
 counter_t cCounter::increase()
 {
-    #if (!(defined(XSTL_NTDDK) || defined(XSTL_WINDOWS) || defined(XSTL_CE)))
-        cLock lock(m_lock);
-        m_value++;
-        return m_value;
-    #else
-        return InterlockedIncrement((PLONG)&m_value);
-    #endif
+    return cInterlocked::increment(&m_value);
 }
 
 counter_t cCounter::decrease()
 {
-    #if (!(defined(XSTL_NTDDK) || defined(XSTL_WINDOWS) || defined(XSTL_CE)))
-        cLock lock(m_lock);
-        m_value--;
-        return m_value;
-    #else
-        return InterlockedDecrement((PLONG)&m_value);
-    #endif
+    return cInterlocked::decrement(&m_value);
 }
 
 void cCounter::setValue(const counter_t& newValue)
 {
-    #if (!(defined(XSTL_NTDDK) || defined(XSTL_WINDOWS) || defined(XSTL_CE)))
-        cLock lock(m_lock);
-        m_value = newValue;
-    #else
-        InterlockedExchange((PLONG)&m_value, newValue);
-    #endif
+    cInterlocked::exchange(&m_value, newValue);
 }
 
 cCounter& cCounter::operator++()
@@ -65,24 +65,47 @@ character HEXLOW(const uint8& ch)
     return hexUpperStrip[(ch & 0x0F)];
 }
 
+/*
+ * Write 'digits' hex digits of 'value' into 'buffer', followed by a
+ * null-terminate character.
+ */
+static void writeHexDigits(character* buffer, uint32 value, uint digits)
+{
+    buffer[digits] = cChar::getNullCharacter();
+    while (digits > 0)
+    {
+        digits--;
+        buffer[digits] = hexUpperStrip[value & 0x0F];
+        value >>= 4;
+    }
+}
+
 cString HEXBYTE(const uint8 &ch)
 {
-    return cString(hexUpperStrip[(ch >> 4)]) + cString(hexUpperStrip[(ch & 0x0F)]);
+    character buffer[3];
+    writeHexDigits(buffer, ch, 2);
+    return cString(buffer);
 }
 cString HEXWORD(const uint16 &word)
 {
-    return HEXBYTE((uint8)(word >> 8)) + HEXBYTE((uint8)(word & 0xFF));
+    character buffer[5];
+    writeHexDigits(buffer, word, 4);
+    return cString(buffer);
 }
 cString HEXDWORD(const uint32 &dword)
 {
-    return HEXWORD((uint16)(dword >> 16)) + HEXWORD((uint16)(dword & 0xFFFF));
+    character buffer[9];
+    writeHexDigits(buffer, dword, 8);
+    return cString(buffer);
 }
 
 #ifndef XSTL_16BIT
 cString HEXQWORD(const uint64& qword)
 {
-    return HEXDWORD((uint32)(qword >> 32)) +
-           HEXDWORD((uint32)(qword & 0xFFFFFFFF));
+    character buffer[17];
+    writeHexDigits(buffer, (uint32)(qword >> 32), 8);
+    writeHexDigits(buffer + 8, (uint32)(qword & 0xFFFFFFFF), 8);
+    return cString(buffer);
 }
 #endif // XSTL_16BIT
 
@@ -42,61 +42,38 @@
 #include "xStl/os/osdef.h"
 #include "xStl/data/array.h"
 #include "xStl/data/list.h"
+#include "xStl/data/hashFunction.h"
 #include "xStl/data/hash.h"
 #include "xStl/except/exception.h"
 
 uint cHashFunction(const int & index, uint range)
 {
-    return index % range;
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 uint cHashFunction(const uint32& index, uint range)
 {
-    return index % range;
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 uint cHashFunction(const float& index, uint range)
 {
-    // Convert the float bits into number
-    // And then preform the module process.
-    return *((uint *)(&index)) % range;
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 uint cHashFunction(const char* index, uint range)
 {
-    uint byte_sum = 0;
-
-    // Sum all the bytes in the string
-    // and compute the hash.
-    const char* ptr = index;
-    while (*ptr != '\0')
-    {
-        byte_sum+= *(ptr++);
-    }
-
-    return cHashFunction(byte_sum, range);
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 uint cHashFunction(const cString& index, uint range)
 {
-    uint byte_sum = 0;
-    for (int i = 0; i < (int)index.length(); i++)
-    {
-        byte_sum+= (uint)index[i];
-    }
-
-    return cHashFunction(byte_sum, range);
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 uint cHashFunction(const cBuffer& index, uint range)
 {
-    uint byte_sum = 0;
-    for (uint i = 0; i < index.getSize(); i++)
-    {
-        byte_sum+= (uint)index[i];
-    }
-
-    return cHashFunction(byte_sum, range);
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 /*
@@ -112,11 +89,11 @@ uint cHashFunction(const addressNumericValue& index, uint range)
 
 uint cHashFunction(const uint64& index, uint range)
 {
-    return (uint)(index % range);
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 
 uint cHashFunction(const cOSDef::threadHandle& index, uint range)
 {
-    return cHashFunction(getNumeric((const void*)index), range);
+    return cHashMixer::reduce(cHashCode(index, cHashMixer::DefaultSeed), range);
 }
 #endif //XSTL_16BIT
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * hashFunction.cpp
+ *
+ * Implementation file.
+ *
+ * The buffer hash is based on Austin Appleby's MurmurHash64A, and the integer
+ * finalizer is the mixer of Sebastiano Vigna's SplitMix64. Both were placed
+ * in the public domain.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/osdef.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/sarray.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/data/hashFunction.h"
+#include "xStl/utils/algorithm.h"
+
+#ifndef XSTL_16BIT
+
+#ifdef XSTL_LINUX
+    #define HASH_CONSTANT(x) x##ULL
+#else
+    #define HASH_CONSTANT(x) x##ui64
+#endif
+
+// The MurmurHash64A multiplier and shift
+static const hashValue gHashMultiplier = HASH_CONSTANT(0xC6A4A7935BD1E995);
+static const uint gHashShift = 47;
+// Added to the seed of the integer mixer (The golden ratio)
+static const hashValue gGoldenRatio = HASH_CONSTANT(0x9E3779B97F4A7C15);
+
+hashValue cHashMixer::hashBuffer(const void* buffer,
+                                 uint length,
+                                 hashValue seed /* = DefaultSeed */)
+{
+    const uint8* data = (const uint8*)buffer;
+    hashValue hash = seed ^ ((hashValue)length * gHashMultiplier);
+
+    // Mix 8 bytes at a time. The bytes are assembled in little-endian order,
+    // so the result doesn't depend on the alignment or on the endianity.
+    uint blocks = length / 8;
+    for (uint i = 0; i < blocks; i++, data+= 8)
+    {
+        hashValue k = ((hashValue)data[0])       | ((hashValue)data[1] << 8)  |
+                      ((hashValue)data[2] << 16) | ((hashValue)data[3] << 24) |
+                      ((hashValue)data[4] << 32) | ((hashValue)data[5] << 40) |
+                      ((hashValue)data[6] << 48) | ((hashValue)data[7] << 56);
+
+        k*= gHashMultiplier;
+        k^= k >> gHashShift;
+        k*= gHashMultiplier;
+
+        hash^= k;
+        hash*= gHashMultiplier;
+    }
+
+    // Mix the last bytes
+    uint left = length & 7;
+    if (left > 0)
+    {
+        for (uint j = left; j > 0; j--)
+        {
+            hash^= (hashValue)data[j - 1] << (8 * (j - 1));
+        }
+        hash*= gHashMultiplier;
+    }
+
+    hash^= hash >> gHashShift;
+    hash*= gHashMultiplier;
+    hash^= hash >> gHashShift;
+    return hash;
+}
+
+hashValue cHashMixer::hashInteger(hashValue value,
+                                  hashValue seed /* = DefaultSeed */)
+{
+    hashValue hash = value ^ (seed + gGoldenRatio);
+    hash = (hash ^ (hash >> 30)) * HASH_CONSTANT(0xBF58476D1CE4E5B9);
+    hash = (hash ^ (hash >> 27)) * HASH_CONSTANT(0x94D049BB133111EB);
+    return hash ^ (hash >> 31);
+}
+
+#else // XSTL_16BIT
+
+// 16 bit compilers uses the 32 bit FNV-1a for buffers and the 32 bit
+// MurmurHash3 finalizer for integers.
+
+hashValue cHashMixer::hashBuffer(const void* buffer,
+                                 uint length,
+                                 hashValue seed /* = DefaultSeed */)
+{
+    const uint8* data = (const uint8*)buffer;
+    hashValue hash = 2166136261UL ^ seed;
+    for (uint i = 0; i < length; i++)
+    {
+        hash^= data[i];
+        hash*= 16777619UL;
+    }
+    return hashInteger(hash, seed);
+}
+
+hashValue cHashMixer::hashInteger(hashValue value,
+                                  hashValue seed /* = DefaultSeed */)
+{
+    hashValue hash = value ^ (seed + 0x9E3779B9UL);
+    hash = (hash ^ (hash >> 16)) * 0x85EBCA6BUL;
+    hash = (hash ^ (hash >> 13)) * 0xC2B2AE35UL;
+    return hash ^ (hash >> 16);
+}
+
+#endif // XSTL_16BIT
+
+uint cHashMixer::reduce(hashValue hash, uint range)
+{
+    return (uint)(hash % range);
+}
+
+hashValue cHashCode(const int& index, hashValue seed)
+{
+    return cHashMixer::hashInteger((hashValue)index, seed);
+}
+
+hashValue cHashCode(const uint32& index, hashValue seed)
+{
+    return cHashMixer::hashInteger(index, seed);
+}
+
+hashValue cHashCode(const float& index, hashValue seed)
+{
+    // +0.0 and -0.0 are equal, but have a different bits representation
+    if (index == 0)
+        return cHashMixer::hashInteger(0, seed);
+
+    // Hash the bits of the float
+    return cHashMixer::hashBuffer(&index, sizeof(index), seed);
+}
+
+hashValue cHashCode(const char* index, hashValue seed)
+{
+    const char* ptr = index;
+    while (*ptr != '\0')
+    {
+        ptr++;
+    }
+
+    return cHashMixer::hashBuffer(index, (uint)(ptr - index), seed);
+}
+
+hashValue cHashCode(const cString& index, hashValue seed)
+{
+    return cHashMixer::hashBuffer(index.getBuffer(),
+                                  index.length() * sizeof(character),
+                                  seed);
+}
+
+hashValue cHashCode(const cBuffer& index, hashValue seed)
+{
+    return cHashMixer::hashBuffer(index.getBuffer(), index.getSize(), seed);
+}
+
+/*
+ * When addressNumericValue != uint, implement this function
+ *
+hashValue cHashCode(const addressNumericValue& index, hashValue seed)
+{
+    return cHashCode((uint)index, seed);
+}
+*/
+
+#ifndef XSTL_16BIT
+
+hashValue cHashCode(const uint64& index, hashValue seed)
+{
+    return cHashMixer::hashInteger(index, seed);
+}
+
+hashValue cHashCode(const cOSDef::threadHandle& index, hashValue seed)
+{
+    return cHashCode(getNumeric((const void*)index), seed);
+}
+#endif //XSTL_16BIT
+
+hashValue cHashCodeNoCase(const cStringView& index, hashValue seed)
+{
+    enum { BlockLength = 64 };
+    character block[BlockLength];
+
+    const character* data = index.getBuffer();
+    uint length = index.length();
+    hashValue hash = seed;
+    do
+    {
+        // Each block is hashed with the hash-value of the previous blocks
+        uint count = t_min((uint)BlockLength, length);
+        cStringCase::foldCase(data, count, block);
+        hash = cHashMixer::hashBuffer(block, count * sizeof(character), hash);
+        data+= count;
+        length-= count;
+    } while (length > 0);
+
+    return hash;
+}
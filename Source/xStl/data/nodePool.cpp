@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * nodePool.cpp
+ *
+ * Implementation file.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+#include "xStl/except/exception.h"
+#include "xStl/except/assert.h"
+#include "xStl/except/trace.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/data/nodePool.h"
+
+cNodePool::cNodePool(uint nodeSize) :
+    m_freeList(NULL),
+    m_slabs(NULL),
+    m_position(NULL),
+    m_end(NULL),
+    m_nextSlabNodes(FirstSlabNodes),
+    m_allocatedBytes(0),
+    m_allocator(NULL)
+{
+    // A free node must fit inside each node
+    m_nodeSize = t_max(nodeSize, (uint)sizeof(FreeNode));
+    // Keep the next node aligned to the pointers
+    m_nodeSize = ((m_nodeSize + sizeof(void*) - 1) / sizeof(void*)) *
+                 sizeof(void*);
+}
+
+cNodePool::~cNodePool()
+{
+    freeAll();
+}
+
+cNodePool* cNodePool::create(uint nodeSize, cAllocator* allocator)
+{
+    void* memory = cAllocator::allocateMemory(allocator, sizeof(cNodePool));
+    if (memory == NULL)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+
+    cNodePool* pool = new (memory) cNodePool(nodeSize);
+    pool->m_allocator = allocator;
+    return pool;
+}
+
+void cNodePool::destroy(cNodePool* pool)
+{
+    if (pool == NULL)
+        return;
+
+    cAllocator* allocator = pool->m_allocator;
+    pool->~cNodePool();
+    cAllocator::freeMemory(allocator, pool, sizeof(cNodePool));
+}
+
+uint cNodePool::getNodeSize() const
+{
+    return m_nodeSize;
+}
+
+void cNodePool::setAllocator(cAllocator* allocator)
+{
+    CHECK(m_slabs == NULL);
+    m_allocator = allocator;
+}
+
+cAllocator* cNodePool::getAllocator() const
+{
+    return m_allocator;
+}
+
+uint cNodePool::getAllocatedBytes() const
+{
+    return m_allocatedBytes;
+}
+
+void cNodePool::allocateSlab()
+{
+    uint size = SlabHeaderSize + m_nextSlabNodes * m_nodeSize;
+    Slab* slab = (Slab*)cAllocator::allocateMemory(m_allocator, size);
+    if (slab == NULL)
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+
+    slab->m_next = m_slabs;
+    slab->m_size = size;
+    m_slabs = slab;
+    m_allocatedBytes+= size;
+
+    m_position = ((uint8*)slab) + SlabHeaderSize;
+    m_end = ((uint8*)slab) + size;
+
+    // The next slab is twice the size of this one
+    if ((m_nextSlabNodes * 2 * m_nodeSize) <= MaxSlabSize)
+        m_nextSlabNodes*= 2;
+}
+
+void* cNodePool::allocate()
+{
+    // Recycle a free node
+    if (m_freeList != NULL)
+    {
+        FreeNode* node = m_freeList;
+        m_freeList = node->m_next;
+        return node;
+    }
+
+    if (m_position == m_end)
+        allocateSlab();
+
+    void* ret = m_position;
+    m_position+= m_nodeSize;
+    return ret;
+}
+
+void cNodePool::free(void* node)
+{
+    ASSERT(node != NULL);
+    FreeNode* freeNode = (FreeNode*)node;
+    freeNode->m_next = m_freeList;
+    m_freeList = freeNode;
+}
+
+void cNodePool::freeAll()
+{
+    while (m_slabs != NULL)
+    {
+        Slab* next = m_slabs->m_next;
+        cAllocator::freeMemory(m_allocator, m_slabs, m_slabs->m_size);
+        m_slabs = next;
+    }
+
+    m_freeList = NULL;
+    m_position = NULL;
+    m_end = NULL;
+    m_nextSlabNodes = FirstSlabNodes;
+    m_allocatedBytes = 0;
+}
+
+void cNodePool::swap(cNodePool& other)
+{
+    ASSERT(m_nodeSize == other.m_nodeSize);
+    t_swap(m_freeList, other.m_freeList);
+    t_swap(m_slabs, other.m_slabs);
+    t_swap(m_position, other.m_position);
+    t_swap(m_end, other.m_end);
+    t_swap(m_nextSlabNodes, other.m_nextSlabNodes);
+    t_swap(m_allocatedBytes, other.m_allocatedBytes);
+    t_swap(m_allocator, other.m_allocator);
+}
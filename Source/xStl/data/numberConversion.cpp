@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * numberConversion.cpp
+ *
+ * Implementation file.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/exception.h"
+#include "xStl/data/char.h"
+#include "xStl/data/numberConversion.h"
+
+// The digits of all the bases
+static const char gDigits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// The pairs of the decimal digits "00".."99"
+static const char gDecimalPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/*
+ * The value of the ASCII digits and letters. Other characters are marked with
+ * 'XX' (InvalidDigit), which is greater than any base.
+ */
+enum { InvalidDigit = 0xFF };
+#define XX InvalidDigit
+static const uint8 gDigitValues[256] = {
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX
+};
+#undef XX
+
+/*
+ * Return the value of a digit, or 'InvalidDigit'
+ */
+static inline uint getDigitValue(char ch)
+{
+    return gDigitValues[(uint8)ch];
+}
+
+#ifdef XSTL_UNICODE
+static inline uint getDigitValue(character ch)
+{
+    if ((uint32)ch > 0xFF)
+        return InvalidDigit;
+    return gDigitValues[(uint32)ch];
+}
+#endif
+
+/*
+ * Return the number of decimal digits of 'number'
+ */
+static inline uint countDecimalDigits(uint64 number)
+{
+    uint count = 1;
+    for (;;)
+    {
+        // Test four digits for each division
+        if (number < 10) return count;
+        if (number < 100) return count + 1;
+        if (number < 1000) return count + 2;
+        if (number < 10000) return count + 3;
+        number/= 10000;
+        count+= 4;
+    }
+}
+
+static void checkBase(uint base)
+{
+    if ((base < cNumberConversion::MinBase) ||
+        (base > cNumberConversion::MaxBase))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+}
+
+template <class T>
+static uint formatNumber(uint64 number, T* buffer, uint base)
+{
+    checkBase(base);
+
+    uint length;
+    if (base == 10)
+    {
+        // Write two digits at a time from the end of the number
+        length = countDecimalDigits(number);
+        T* output = buffer + length;
+        while (number >= 100)
+        {
+            uint pair = (uint)(number % 100) * 2;
+            number/= 100;
+            *--output = (T)gDecimalPairs[pair + 1];
+            *--output = (T)gDecimalPairs[pair];
+        }
+        if (number >= 10)
+        {
+            uint pair = (uint)number * 2;
+            *--output = (T)gDecimalPairs[pair + 1];
+            *--output = (T)gDecimalPairs[pair];
+        } else
+        {
+            *--output = (T)('0' + (uint)number);
+        }
+    } else if (base == 16)
+    {
+        // The number of nibbles
+        length = 1;
+        while ((length < 16) && ((number >> (length * 4)) != 0))
+            length++;
+        for (uint i = length; i > 0; i--)
+        {
+            buffer[i - 1] = (T)gDigits[number & 0xF];
+            number>>= 4;
+        }
+    } else
+    {
+        // Write the digits backward and reverse them
+        length = 0;
+        do
+        {
+            buffer[length++] = (T)gDigits[number % base];
+            number/= base;
+        } while (number != 0);
+        for (uint i = 0; i < length / 2; i++)
+        {
+            T ch = buffer[i];
+            buffer[i] = buffer[length - i - 1];
+            buffer[length - i - 1] = ch;
+        }
+    }
+
+    buffer[length] = 0;
+    return length;
+}
+
+template <class T>
+static uint formatSignedNumber(int64 number, T* buffer, uint base)
+{
+    if (number >= 0)
+        return formatNumber((uint64)number, buffer, base);
+
+    // The negative value is calculated in unsigned arithmetic, so the
+    // smallest number doesn't overflow
+    buffer[0] = (T)'-';
+    return formatNumber((uint64)0 - (uint64)number, buffer + 1, base) + 1;
+}
+
+template <class T>
+static bool parseNumber(const T* string, uint length, uint base,
+                        uint64& number, uint& parsedLength,
+                        uint64 maxValue)
+{
+    checkBase(base);
+
+    // Numbers above 'cutoff' (or equal to 'cutoff' with a digit above
+    // 'cutlimit') overflows when another digit is added.
+    const uint64 cutoff = maxValue / base;
+    const uint cutlimit = (uint)(maxValue % base);
+
+    uint64 ret = 0;
+    uint i = 0;
+    for (; i < length; i++)
+    {
+        uint digit = getDigitValue(string[i]);
+        if (digit >= base)
+            break;
+        if ((ret > cutoff) || ((ret == cutoff) && (digit > cutlimit)))
+            return false;
+        ret = (ret * base) + digit;
+    }
+
+    if (i == 0)
+        return false;
+
+    number = ret;
+    parsedLength = i;
+    return true;
+}
+
+uint cNumberConversion::formatUnsigned(uint64 number, char* buffer,
+                                       uint base /* = 10 */)
+{
+    return formatNumber(number, buffer, base);
+}
+
+uint cNumberConversion::formatSigned(int64 number, char* buffer,
+                                     uint base /* = 10 */)
+{
+    return formatSignedNumber(number, buffer, base);
+}
+
+bool cNumberConversion::parseUnsigned(const char* string, uint length,
+                                      uint base, uint64& number,
+                                      uint& parsedLength,
+                                      uint64 maxValue /* = (uint64)-1 */)
+{
+    return parseNumber(string, length, base, number, parsedLength, maxValue);
+}
+
+#ifdef XSTL_UNICODE
+uint cNumberConversion::formatUnsigned(uint64 number, character* buffer,
+                                       uint base /* = 10 */)
+{
+    return formatNumber(number, buffer, base);
+}
+
+uint cNumberConversion::formatSigned(int64 number, character* buffer,
+                                     uint base /* = 10 */)
+{
+    return formatSignedNumber(number, buffer, base);
+}
+
+bool cNumberConversion::parseUnsigned(const character* string, uint length,
+                                      uint base, uint64& number,
+                                      uint& parsedLength,
+                                      uint64 maxValue /* = (uint64)-1 */)
+{
+    return parseNumber(string, length, base, number, parsedLength, maxValue);
+}
+#endif // XSTL_UNICODE
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * sharedBuffer.cpp
+ *
+ * Implementation file.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+
+#include "xStl/types.h"
+#include "xStl/data/sarray.h"
+#include "xStl/data/smartptr.h"
+#include "xStl/data/sharedBuffer.h"
+
+cSharedBuffer::cSharedBuffer(uint size /* = 0 */) :
+    m_buffer(makeSmartPtr<cBuffer>(size))
+{
+}
+
+cSharedBuffer::cSharedBuffer(const cBuffer& buffer) :
+    m_buffer(makeSmartPtr<cBuffer>(buffer))
+{
+}
+
+cSharedBuffer::cSharedBuffer(const uint8* data, uint length) :
+    m_buffer(makeSmartPtr<cBuffer>(data, length))
+{
+}
+
+uint cSharedBuffer::getSize() const
+{
+    return m_buffer->getSize();
+}
+
+const uint8* cSharedBuffer::getBuffer() const
+{
+    return m_buffer->getBuffer();
+}
+
+const cBuffer& cSharedBuffer::getData() const
+{
+    return *m_buffer;
+}
+
+cBuffer& cSharedBuffer::getWritableData()
+{
+    detach();
+    return *m_buffer;
+}
+
+bool cSharedBuffer::isShared() const
+{
+    return m_buffer.getCounter().getValue() > 1;
+}
+
+void cSharedBuffer::detach()
+{
+    if (isShared())
+    {
+        const cBuffer& data = *m_buffer;
+        m_buffer = makeSmartPtr<cBuffer>(data);
+    }
+}
+
+uint8 cSharedBuffer::operator[] (uint index) const
+{
+    return (*m_buffer)[index];
+}
+
+uint8& cSharedBuffer::operator[] (uint index)
+{
+    detach();
+    return (*m_buffer)[index];
+}
+
+bool cSharedBuffer::operator == (const cSharedBuffer& other) const
+{
+    if (m_buffer.getPointer() == other.m_buffer.getPointer())
+        return true;
+
+    return *m_buffer == *other.m_buffer;
+}
+
+bool cSharedBuffer::operator != (const cSharedBuffer& other) const
+{
+    return !(*this == other);
+}
@@ -43,9 +43,16 @@
 #include "xStl/except/trace.h"
 #include "xStl/except/exception.h"
 #include "xStl/data/string.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/data/numberConversion.h"
 #include "xStl/data/array.h"
 #include "xStl/data/list.h"
 
+// Compile-time check: The object is a few words long (the virtual table,
+// the data pointer, the length, the allocator and the inline storage).
+typedef char cStringSizeCheck[(sizeof(cString) <=
+                               (4 * sizeof(void*) + sizeof(uint) +
+                                cString::InlineBytes)) ? 1 : -1];
 
 // The default strip in the xStl project
 #ifndef XSTL_UNIQUE_STRIP
@@ -57,50 +64,41 @@
 #endif
 
 cString::cString(const character* string /* = NULL*/,
-                 uint             optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+                 uint                    /* = DefaultStringPage*/) :
+    m_allocator(NULL)
 {
-    if (string == NULL)
-    {
-        // Creates an empty string
-        createEmptyString(optMem);
-    } else
-    {
-        // Construct a string and copy data
-        m_stringLength = cChar::getStrlen(string);
-        m_buffer = new cSArray<character>(m_stringLength + 1, optMem);
+    // Creates an empty string
+    createEmptyString();
 
+    if (string != NULL)
+    {
         // Copy the string
-        cOS::memcpy(m_buffer->getBuffer(), string, m_stringLength * sizeof(character));
-        // Add the null terminate string
-        (*m_buffer)[m_stringLength] = cChar::getNullCharacter();
+        assign(string, cChar::getStrlen(string));
     }
 }
 
 #ifdef XSTL_UNICODE
 cString::cString(const char* string,
-                 uint        optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+                 uint               /* = DefaultStringPage*/) :
+    m_allocator(NULL)
 {
-    if (string == NULL)
-    {
-        // Creates an empty string
-        createEmptyString(optMem);
-    } else
+    // Creates an empty string
+    createEmptyString();
+
+    if (string != NULL)
     {
         // Construct a string and copy data
-        m_stringLength = (uint)strlen(string);
-        m_buffer = new cSArray<character>(m_stringLength + 1, optMem);
+        uint length = (uint)strlen(string);
+        reserve(length + 1);
 
         // Copy the string
-        for (uint i = 0; i < m_stringLength; i++)
+        for (uint i = 0; i < length; i++)
         {
-            m_buffer->getBuffer()[i] = (character) string[i];
+            m_data[i] = (character) string[i];
         }
         // Add the null terminate string
-        (*m_buffer)[m_stringLength] = cChar::getNullCharacter();
+        m_data[length] = cChar::getNullCharacter();
+        m_stringLength = length;
     }
 }
 
@@ -148,187 +146,398 @@ cSArray<unichar> cString::getUnicodeString() const
 
 
 cString::cString(const character ch,
-                 uint            optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+                 uint                 /* = DefaultStringPage*/) :
+    m_allocator(NULL)
 {
     // Init the object
-    createEmptyString(optMem);
+    createEmptyString();
     // Create a minidump array
     character buf[2] = {ch, cChar::getNullCharacter()};
-    // Use operator = to copy to data (Avoids code-duplication)
-    *this = cString(buf, optMem); // Create a cString with one character
+    assign(buf, cChar::getStrlen(buf));
 }
 
 #ifdef XSTL_UNICODE
 cString::cString(const char ch,
-                 uint       optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+                 uint            /* = DefaultStringPage*/) :
+    m_allocator(NULL)
 {
     // This could cause a serious damage
     ASSERT(ch != cChar::getNullCharacter());
 
     // Init the object
-    createEmptyString(optMem);
+    createEmptyString();
     // Create a minidump array
     character buf[2] = {(character)ch, cChar::getNullCharacter()};
-    // Use operator = to copy to data (Avoids code-duplication)
-    *this = cString(buf, optMem); // Create a cString with one character
+    assign(buf, cChar::getStrlen(buf));
 }
 #endif
 
 
 cString::cString(const int32 number,
                  uint        base   /* = DefaultStringBase*/,
-                 uint        optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+                 uint               /* = DefaultStringPage*/) :
+    m_allocator(NULL)
 {
     // Init the object
-    createEmptyString(optMem);
+    createEmptyString();
+    assignNumber(number < 0, t_abs((int64)number), base);
+}
+
+cString::cString(const uint32 number,
+                 uint        base   /* = DefaultStringBase*/,
+                 uint               /* = DefaultStringPage*/) :
+    m_allocator(NULL)
+{
+    // Init members
+    createEmptyString();
+    assignNumber(false, number, base);
+}
 
-    // Covert the number into positive value
-    uint32 nm = t_abs(number);
+cString::cString(const int64 number,
+                 uint        base   /* = DefaultStringBase*/,
+                 uint               /* = DefaultStringPage*/) :
+    m_allocator(NULL)
+{
+    // Init the object
+    createEmptyString();
 
-    /* Check sign */
+    // The absolute value is calculated in unsigned arithmetic, so the
+    // smallest number doesn't overflow
+    uint64 nm = (uint64)number;
     if (number < 0)
-    {
-        concat(m_stringNegativeInteger);
-    }
-
-    /* Covert the number into a string */
-    cString positiveString(nm, base);
-    concat(positiveString);
+        nm = (uint64)0 - nm;
+    assignNumber(number < 0, nm, base);
 }
 
-cString::cString(const uint32 number,
+cString::cString(const uint64 number,
                  uint        base   /* = DefaultStringBase*/,
-                 uint        optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+                 uint               /* = DefaultStringPage*/) :
+    m_allocator(NULL)
+{
+    // Init members
+    createEmptyString();
+    assignNumber(false, number, base);
+}
+
+void cString::assignNumber(bool isNegative, uint64 number, uint base)
 {
     ASSERT_MSG(base < cChar::getStrlen(m_baseStrip),
                XSTL_STRING("cString: There isn't engouth strip for conversion operation."));
+    ASSERT(base >= cNumberConversion::MinBase);
 
-    // Init members
-    createEmptyString(optMem);
+    character buffer[cNumberConversion::BufferLength];
+    uint length;
 
-    uint digit = 0;  // The digit to convert
-    uint x     = 0;  // The left number
+    #ifndef XSTL_UNIQUE_STRIP
+    if ((base >= cNumberConversion::MinBase) &&
+        (base <= cNumberConversion::MaxBase))
+    {
+        // The digits of the conversion module are the same as m_baseStrip
+        if (isNegative)
+        {
+            buffer[0] = m_stringNegativeInteger[0];
+            length = cNumberConversion::formatUnsigned(number, buffer + 1,
+                                                       base) + 1;
+        } else
+        {
+            length = cNumberConversion::formatUnsigned(number, buffer, base);
+        }
+        assign(buffer, length);
+        return;
+    }
+    #endif
+
+    // Convert the digits backward from the end of the buffer
+    character* output = buffer + cNumberConversion::BufferLength;
+    do
+    {
+        *--output = m_baseStrip[number % base];
+        number/= base;
+    } while (number > 0);
+    length = (uint)((buffer + cNumberConversion::BufferLength) - output);
+
+    if (isNegative)
+        concat(m_stringNegativeInteger);
+    cString digits;
+    digits.assign(output, length);
+    concat(digits);
+}
 
-    x = number;
+cString::SharedStorage::SharedStorage(character* data,
+                                      cAllocator* allocator) :
+    m_references(1),
+    m_data(data),
+    m_allocator(allocator)
+{
+}
 
-    if (number == 0)
+cString::cString(const cString& other) :
+    m_allocator(NULL)
+{
+    createEmptyString();
+    if (other.isShared())
+    {
+        copyShared(other);
+    } else
     {
-        *this = cString(m_baseStrip[0]);
+        assign(other.m_data, other.m_stringLength);
     }
+}
 
-    // Start with converting
-    while (x > 0)
+cString::cString(const cStringView& view) :
+    m_allocator(NULL)
+{
+    createEmptyString();
+    assign(view.getBuffer(), view.length());
+}
+
+#ifdef XSTL_UNICODE
+cString::cString(const cAsciiStringView& view) :
+    m_allocator(NULL)
+{
+    createEmptyString();
+    reserve(view.length() + 1);
+
+    for (uint i = 0; i < view.length(); i++)
     {
-        digit = x % base;
-        x     = x / base;
+        m_data[i] = (character)view.getBuffer()[i];
+    }
+    m_data[view.length()] = cChar::getNullCharacter();
+    m_stringLength = view.length();
+}
+#endif // XSTL_UNICODE
 
-        *this = cString(m_baseStrip[digit]) + *this;
+cStringView cString::getView() const
+{
+    return cStringView(m_data, m_stringLength);
+}
+
+#ifdef XSTL_CPP11
+cString::cString(cString&& other) :
+    m_allocator(NULL)
+{
+    createEmptyString();
+    moveFrom(other);
+}
+
+cString & cString::operator = (cString&& other)
+{
+    if (m_allocator != other.m_allocator)
+    {
+        // Keep the allocator of this string
+        return *this = static_cast<const cString&>(other);
+    }
+
+    if (this != &other)
+    {
+        freeString();
+        moveFrom(other);
     }
+    return *this;
 }
+#endif // XSTL_CPP11
 
-cString::cString(const int64 number,
-                 uint        base   /* = DefaultStringBase*/,
-                 uint        optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+void cString::swap(cString& other)
 {
-    // Init the object
-    createEmptyString(optMem);
+    if (this == &other)
+        return;
 
-    // Covert the number into positive value
-    uint64 nm = t_abs(number);
+    cString temp;
+    temp.moveFrom(*this);
+    moveFrom(other);
+    other.moveFrom(temp);
+}
 
-    /* Check sign */
-    if (number < 0)
+void cString::createEmptyString()
+{
+    m_data = m_inline;
+    m_data[0] = cChar::getNullCharacter();
+    m_stringLength = 0;
+}
+
+void cString::freeString()
+{
+    if (isShared())
     {
-        concat(m_stringNegativeInteger);
+        // Free the memory with the last reference
+        SharedStorage* shared = m_heap.m_shared;
+        if (shared->m_references.decrease() == 0)
+        {
+            cArrayStorage<character, true>::free(shared->m_data,
+                                                 m_heap.m_capacity,
+                                                 shared->m_allocator);
+            delete shared;
+        }
+    } else if (!isInline())
+    {
+        cArrayStorage<character, true>::free(m_data, m_heap.m_capacity,
+                                             m_allocator);
     }
+    createEmptyString();
+}
 
-    /* Covert the number into a string */
-    cString positiveString(nm, base);
-    concat(positiveString);
+bool cString::isInline() const
+{
+    return m_data == m_inline;
 }
 
-cString::cString(const uint64 number,
-                 uint        base   /* = DefaultStringBase*/,
-                 uint        optMem /* = DefaultStringPage*/) :
-    m_buffer(NULL),
-    m_stringLength(0)
+uint cString::getCapacity() const
 {
-    ASSERT_MSG(base < cChar::getStrlen(m_baseStrip),
-               XSTL_STRING("cString: There isn't engouth strip for conversion operation."));
+    return isInline() ? (uint)InlineCapacity : m_heap.m_capacity;
+}
 
-    // Init members
-    createEmptyString(optMem);
+bool cString::isShared() const
+{
+    return (!isInline()) && (m_heap.m_shared != NULL);
+}
 
-    uint digit = 0;  // The digit to convert
-    uint64 x   = 0;  // The left number
+void cString::share()
+{
+    if (isInline() || isShared())
+        return;
+
+    m_heap.m_shared = new SharedStorage(m_data, m_allocator);
+}
 
-    x = number;
+void cString::detach()
+{
+    if (!isShared())
+        return;
 
-    if (number == 0)
+    // The last reference can take the memory, if it belongs to the same
+    // allocator
+    if ((m_heap.m_shared->m_references.getValue() == 1) &&
+        (m_heap.m_shared->m_allocator == m_allocator))
     {
-        *this = cString(m_baseStrip[0]);
+        delete m_heap.m_shared;
+        m_heap.m_shared = NULL;
+        return;
     }
 
-    // Start with converting
-    while (x > 0)
-    {
-        digit = x % base;
-        x     = x / base;
+    // Copy the characters and release the shared storage
+    uint capacity = m_heap.m_capacity;
+    uint length = m_stringLength;
+    character* data = cArrayStorage<character, true>::allocate(capacity,
+                                                               m_allocator);
+    cOS::memcpy(data, m_data, (length + 1) * sizeof(character));
+    freeString();
+
+    m_data = data;
+    m_stringLength = length;
+    m_heap.m_capacity = capacity;
+    m_heap.m_shared = NULL;
+}
+
+void cString::copyShared(const cString& other)
+{
+    ASSERT(isInline() && other.isShared());
 
-        *this = cString(m_baseStrip[digit]) + *this;
+    // A storage of another allocator may be released before this string
+    // (for example by cArena::freeAll())
+    if (other.m_heap.m_shared->m_allocator != m_allocator)
+    {
+        assign(other.m_data, other.m_stringLength);
+        return;
     }
+
+    // Reference the same storage
+    other.m_heap.m_shared->m_references.increase();
+    m_data = other.m_data;
+    m_stringLength = other.m_stringLength;
+    m_heap = other.m_heap;
 }
 
+void cString::reserve(uint capacity)
+{
+    detach();
 
+    uint oldCapacity = getCapacity();
+    if (capacity <= oldCapacity)
+        return;
 
-cString::cString(const cString& other) :
-    m_buffer(NULL),
-    m_stringLength(0)
+    // Grow geometrically, the same as cArray
+    uint newCapacity = t_max(capacity, oldCapacity + (oldCapacity / 2));
+    if (isInline())
+    {
+        character* data =
+            cArrayStorage<character, true>::allocate(newCapacity,
+                                                     m_allocator);
+        cOS::memcpy(data, m_inline, (m_stringLength + 1) * sizeof(character));
+        m_data = data;
+        m_heap.m_shared = NULL;
+    } else
+    {
+        m_data = cArrayStorage<character, true>::reallocate(m_data,
+                                                           oldCapacity,
+                                                           newCapacity,
+                                                           oldCapacity,
+                                                           m_allocator);
+    }
+    m_heap.m_capacity = newCapacity;
+}
+
+void cString::assign(const character* string, uint length)
 {
-    // Copy the string
-    m_buffer = new cSArray<character>(*(other.m_buffer));
-    // Copy the string length
+    ASSERT((string < m_data) || (string >= m_data + getCapacity()));
+
+    reserve(length + 1);
+    // An empty view may have a NULL buffer
+    if (length != 0)
+        cOS::memcpy(m_data, string, length * sizeof(character));
+    m_data[length] = cChar::getNullCharacter();
+    m_stringLength = length;
+}
+
+void cString::moveFrom(cString& other)
+{
+    ASSERT(isInline());
+
+    if (other.isInline())
+    {
+        cOS::memcpy(m_inline, other.m_inline,
+                    (other.m_stringLength + 1) * sizeof(character));
+    } else
+    {
+        m_data = other.m_data;
+        m_heap = other.m_heap;
+    }
     m_stringLength = other.m_stringLength;
+    m_allocator = other.m_allocator;
+    other.createEmptyString();
 }
 
-void cString::createEmptyString(uint optMem)
+void cString::setAllocator(cAllocator* allocator)
 {
-    // Assert memory lost
-    ASSERT(m_buffer == NULL);
-    // Reset string length
-    m_stringLength = 0;
-    // Create a buffer to hold the null-terminate character
-    m_buffer = new cSArray<character>(1, optMem);
-    // Puts the null-terminate character
-    (*m_buffer)[0] = cChar::getNullCharacter();
+    if (m_stringLength != 0)
+    {
+        XSTL_THROW(cException, EXCEPTION_FAILED);
+    }
+
+    // Release the memory of the previous allocator
+    freeString();
+    m_allocator = allocator;
+}
+
+cAllocator* cString::getAllocator() const
+{
+    return m_allocator;
 }
 
 cString::~cString()
 {
     // Assertion for the usage in the cString object
-    ASSERT(m_buffer != NULL);
-    ASSERT(cChar::getStrlen(m_buffer->getBuffer()) == m_stringLength);
+    ASSERT(cChar::getStrlen(m_data) == m_stringLength);
 
     // Destory the memory allocated.
-    delete m_buffer;
+    freeString();
 }
 
 uint cString::length() const
 {
     // Do some assertion
-    ASSERT_MSG((*m_buffer)[m_stringLength] == cChar::getNullCharacter(),
+    ASSERT_MSG(m_data[m_stringLength] == cChar::getNullCharacter(),
                XSTL_STRING("cString: Null-terminate character couldn't be founded."));
-    ASSERT_MSG(cChar::getStrlen(m_buffer->getBuffer()) == m_stringLength,
+    ASSERT_MSG(cChar::getStrlen(m_data) == m_stringLength,
                XSTL_STRING("cString: String length is invalid"));
 
     // Return the cached value of the string length
@@ -358,11 +567,7 @@ cString cString::part(uint index1, uint index2) const
         return ret;
 
     // Create the return string
-    ASSERT(ret.m_buffer != NULL);
-    delete ret.m_buffer;
-    ret.m_buffer = new cSArray<character>(m_buffer->getBuffer() + index1, index2 - index1 + 1, m_buffer->getPageSize());
-    (*ret.m_buffer)[index2 - index1] = 0;
-    ret.rearrangeStringVector();
+    ret.assign(m_data + index1, index2 - index1);
 
     return ret;
 }
@@ -382,19 +587,13 @@ cString cString::left(int size) const
     }
 
     /* Copy the array */
-    ASSERT(ret.m_buffer != NULL);
-    delete ret.m_buffer;
-    ret.m_buffer = new cSArray<character>(m_buffer->getBuffer(), size + 1, m_buffer->getPageSize());
-    (*ret.m_buffer)[size] = 0;
-    ret.rearrangeStringVector();
+    ret.assign(m_data, (uint)size);
 
     return ret;
 }
 
 cString cString::right(int size) const
 {
-    cString ret;
-
     if (size > (int)length())
     {
         size = (int)length();
@@ -406,26 +605,28 @@ cString cString::right(int size) const
 
     /* Create the return string */
     /* Copy the array */
-    return cString(m_buffer->getBuffer() + length() - size, m_buffer->getPageSize());
+    return cString(m_data + length() - size);
 }
 
 void cString::concat(const cString& other)
 {
-    // Delete all unnessesry output, including NULL terminate character.
-    m_buffer->changeSize(length());
+    // Notice that 'other' can be this string
+    uint otherLength = other.m_stringLength;
 
     // Expand the string buffer to the right size
-    // Copy the information.
-    (*m_buffer) += *(other.m_buffer);
+    reserve(m_stringLength + otherLength + 1);
 
-    // Delete the other size temporary information.
-    rearrangeStringVector();
+    // Copy the information, including the NULL terminate character.
+    cOS::memcpy(m_data + m_stringLength, other.m_data,
+                otherLength * sizeof(character));
+    m_stringLength+= otherLength;
+    m_data[m_stringLength] = cChar::getNullCharacter();
 }
 
 cString::CompareType cString::compare(const character* other) const
 {
     // Compare string
-    int ret = cChar::strcmp(m_buffer->getBuffer(), other);
+    int ret = cChar::strcmp(m_data, other);
 
     // Translate comparing.
     if (ret < 0)
@@ -441,10 +642,10 @@ cString::CompareType cString::compare(const cString& other) const
     return compare(other.getBuffer());
 }
 
-cString::CompareType cString::icompare(const character* other) const
+cString::CompareType cString::compare(const cStringView& other) const
 {
     // Compare string
-    int ret = cChar::stricmp(m_buffer->getBuffer(), other);
+    int ret = getView().compare(other);
 
     // Translate comparing.
     if (ret < 0)
@@ -455,27 +656,43 @@ cString::CompareType cString::icompare(const character* other) const
     return cString::EqualTo;
 }
 
+cString::CompareType cString::icompare(const character* other) const
+{
+    return icompare(cStringView(other));
+}
+
 cString::CompareType cString::icompare(const cString& other) const
 {
-    return icompare(other.getBuffer());
+    return icompare(other.getView());
+}
+
+cString::CompareType cString::icompare(const cStringView& other) const
+{
+    // Compare string
+    int ret = cStringCase::icompare(m_data, m_stringLength,
+                                    other.getBuffer(), other.length());
+
+    // Translate comparing.
+    if (ret < 0)
+        return cString::LowerThan;
+    if (ret >= 1)
+        return cString::GreaterThan;
+
+    return cString::EqualTo;
 }
 
 cString& cString::makeUpper()
 {
-    for (uint i = 0; i < length(); i++)
-    {
-        (*m_buffer)[i] = cChar::getUppercase((*m_buffer)[i]);
-    }
+    detach();
+    cStringCase::makeUpper(m_data, m_stringLength);
 
     return *this;
 }
 
 cString& cString::makeLower()
 {
-    for (uint i = 0; i < length(); i++)
-    {
-        (*m_buffer)[i] = cChar::getLowercase((*m_buffer)[i]);
-    }
+    detach();
+    cStringCase::makeLower(m_data, m_stringLength);
 
     return *this;
 }
@@ -489,7 +706,7 @@ cString& cString::trim()
 
     /* Trim all the spaces at the beginning */
     uint index = 0, i;
-    while ((index < length()) && (cChar::isBlanket(m_buffer->getBuffer()[index])))
+    while ((index < length()) && (cChar::isBlanket(m_data[index])))
     {
         index++;
     }
@@ -498,7 +715,7 @@ cString& cString::trim()
 
     /* Find the end position */
     i = length() - 1;
-    while ((i >= index) && (cChar::isBlanket(m_buffer->getBuffer()[i])))
+    while ((i >= index) && (cChar::isBlanket(m_data[i])))
     {
         i--;
         size--;
@@ -524,16 +741,16 @@ cString& cString::trimAllSpaces()
 
     for (uint i = 0; i < len; i++)
     {
-        if (cChar::isBlanket((*m_buffer)[i]))
+        if (cChar::isBlanket(m_data[i]))
         {
             if (firstSpace)
             {
                 firstSpace = false;
-                ret+= (*m_buffer)[i];
+                ret+= m_data[i];
             }
         } else
         {
-            ret+= (*m_buffer)[i];
+            ret+= m_data[i];
             firstSpace = true;
         }
     }
@@ -544,163 +761,179 @@ cString& cString::trimAllSpaces()
 
 uint cString::find(const cString& string, uint startIndex /* = 0 */) const
 {
-    uint i  = startIndex;
-    uint ln = length();
-    uint on = string.length();
-    uint len = (ln - on) + 1;
-
-    // Incase of empty string. Always match
-    if (on == 0)
-    {
-        return startIndex;
-    }
-
-    // If this string doesn't have at least the number of characters 'string'
-    // has, the search will probably failed. Returns the length of this string.
-    if (ln < on)
-        return ln;
-
-    while (i < len)
-    {
-        /* Try to find a match */
-        if ((*m_buffer)[i] == string[0])
-        {
-            /* Scan the rest of the string */
-            uint j;
-            for (j = i + 1;
-                 ((j < ln) && (j < i + on) && (string[(int)(j - i)] == (*m_buffer)[j]));
-                 j++)
-            {
-                /* Match is ok */
-            }
-            if (j == i + string.length())
-                return i;
-        }
-        i++;
-    }
+    return find(string.getView(), startIndex);
+}
 
-    return ln;
+uint cString::find(const cStringView& string, uint startIndex /* = 0 */) const
+{
+    return getView().find(string, startIndex);
 }
 
 uint cString::rfind(const cString& string,
                     uint startIndex) const
 {
-    uint i  = startIndex;
-    uint ln = length();
-    uint on = string.length();
-
-    // Incase of empty string. Always match
-    if (on == 0)
-    {
-        return startIndex;
-    }
-
-    // If the current string is empty, search failed.
-    if (ln == 0)
-        return 0;
+    return getView().rfind(string.getView(), startIndex);
+}
 
-    // If this string doesn't have at least the number of characters 'string'
-    // has, the search will probably failed. Returns the length of this string.
-    if (ln < on)
-        return ln;
+uint cString::rfind(const cStringView& string,
+                    uint startIndex) const
+{
+    return getView().rfind(string, startIndex);
+}
 
-    // Set the postion to the end of the string
-    if (i >= ln - on)
-        i = ln - on;
+cArray<uint> cString::findAll(const cStringView& string,
+                              bool isOverlapping /* = false */) const
+{
+    cArray<uint> ret;
+    if (string.isEmpty())
+        return ret;
 
-    bool shouldExit = false;
-    do
+    cStringView view = getView();
+    uint step = isOverlapping ? 1 : string.length();
+    uint position = view.find(string);
+    while (position != m_stringLength)
     {
-        /* Try to find a match */
-        if (m_buffer->getBuffer()[i] == string.m_buffer->getBuffer()[0])
-        {
-            /* Scan the reset of the string */
-            uint j;
-            for (j = i + 1;
-                 ((j < ln) && (j < i + on) && (string.m_buffer->getBuffer()[j - i] == m_buffer->getBuffer()[j]));
-                 j++)
-            {
-                /* Match is ok */
-            }
-            if (j == i + string.length())
-                return i;
-        }
-        // Since i is uint...
-        if (i == 0)
-            shouldExit = true;
-        else
-            i--;
-    } while (!shouldExit);
+        ret.append(position);
+        position = view.find(string, position + step);
+    }
 
-    return ln;
+    return ret;
 }
 
 cString& cString::replace(const cString& findString,
                           const cString& replaceString)
 {
-    uint pos;
-    while ((pos = find(findString)) != length())
+    return replace(findString.getView(), replaceString.getView());
+}
+
+cString& cString::replace(const cStringView& findString,
+                          const cStringView& replaceString)
+{
+    cArray<uint> positions(findAll(findString));
+    uint count = positions.getSize();
+    if (count == 0)
+        return *this;
+
+    // Build the new string in a single allocation
+    uint newLength = m_stringLength -
+                     (count * findString.length()) +
+                     (count * replaceString.length());
+    cString ret;
+    ret.setAllocator(m_allocator);
+    ret.reserve(newLength + 1);
+
+    character* output = ret.m_data;
+    uint last = 0;
+    for (uint i = 0; i < count; i++)
     {
-        // Replace this string
-        *this = left(pos) +
-                replaceString +
-                right(length() - pos - findString.length());
+        uint position = positions[i];
+        cOS::memcpy(output, m_data + last,
+                    (position - last) * sizeof(character));
+        output+= position - last;
+        cOS::memcpy(output, replaceString.getBuffer(),
+                    replaceString.length() * sizeof(character));
+        output+= replaceString.length();
+        last = position + findString.length();
     }
+    cOS::memcpy(output, m_data + last,
+                (m_stringLength - last) * sizeof(character));
+    ret.m_data[newLength] = cChar::getNullCharacter();
+    ret.m_stringLength = newLength;
 
+    swap(ret);
     return *this;
 }
 
 cList<cString> cString::split(const cString& divider) const
+{
+    return split(divider.getView());
+}
+
+cList<cString> cString::split(const cStringView& divider) const
 {
     cList<cString> ret;
+    split(divider, ret);
+    return ret;
+}
 
-    uint index     = 0;
-    uint lastIndex = 0;
+void cString::split(const cStringView& divider, cList<cString>& tokens) const
+{
+    cStringView view = getView();
+    cList<cString>::iterator i = tokens.begin();
 
-    do
+    uint lastIndex = 0;
+    while (true)
     {
-        index = find(divider, (uint)(index + 1));
-        ret.append(part(lastIndex, (uint)index));
-        lastIndex = index + divider.length(); // Ignore the string
+        uint index = divider.isEmpty() ? m_stringLength :
+                                         view.find(divider, lastIndex);
+        cStringView token = view.part(lastIndex, index);
+
+        // Reuse the strings of the list
+        if (i != tokens.end())
+        {
+            (*i).assign(token.getBuffer(), token.length());
+            ++i;
+        } else
+        {
+            tokens.append(cString(token));
+        }
+
+        if (index == m_stringLength)
+            break;
+        lastIndex = index + divider.length();
     }
-    while ((uint)(index) != length());
 
-    return ret;
+    // Remove the unused strings
+    while (i != tokens.end())
+        i = tokens.remove(i);
 }
 
-character* cString::getBuffer(const uint lockSize /* = 0*/)
+cList<cStringView> cString::splitView(const cStringView& divider) const
 {
-    if (lockSize <= m_buffer->getSize())
-    {
-        return m_buffer->getBuffer();
-    } else
+    if (divider.isEmpty())
     {
-        /* Put some more free size in the buffer */
-        m_buffer->changeSize(lockSize);
-        return m_buffer->getBuffer();
+        cList<cStringView> ret;
+        ret.append(getView());
+        return ret;
     }
+
+    return getView().split(divider);
+}
+
+character* cString::getBuffer(const uint lockSize /* = 0*/)
+{
+    /* Put some more free size in the buffer */
+    reserve(lockSize);
+    return m_data;
 }
 
 const character* cString::getBuffer() const
 {
-    return m_buffer->getBuffer();
+    return m_data;
 }
 
 void cString::rearrangeStringVector()
 {
     // Calculate the length of the new string.
-    m_stringLength = cChar::getStrlen(m_buffer->getBuffer());
-    // Delete all unnessecry space
-    m_buffer->changeSize(m_stringLength + 1);
+    m_stringLength = cChar::getStrlen(m_data);
 }
 
 cString cString::dup(const cString& object, uint number)
 {
+    // Allocate the result once. Notice that 'object' is copied from its own
+    // buffer, so the result can't be 'object'.
+    uint objectLength = object.m_stringLength;
     cString ret;
+    ret.reserve(objectLength * number + 1);
+
+    character* position = ret.m_data;
     for (uint i = 0; i < number; i++)
     {
-        ret+= object;
+        cOS::memcpy(position, object.m_data, objectLength * sizeof(character));
+        position+= objectLength;
     }
+    ret.m_stringLength = objectLength * number;
+    ret.m_data[ret.m_stringLength] = cChar::getNullCharacter();
 
     return ret;
 }
@@ -709,20 +942,37 @@ cString cString::pad(const cString& object,
                      uint number,
                      character padding)
 {
-    if (object.length() >= number)
+    uint objectLength = object.m_stringLength;
+    if (objectLength >= number)
         return object;
 
-    return object + dup(" ", number - object.length());
+    cString ret;
+    ret.reserve(number + 1);
+    cOS::memcpy(ret.m_data, object.m_data, objectLength * sizeof(character));
+    for (uint i = objectLength; i < number; i++)
+        ret.m_data[i] = padding;
+    ret.m_stringLength = number;
+    ret.m_data[number] = cChar::getNullCharacter();
+
+    return ret;
 }
 
 cString & cString::operator = (const cString& other)
 {
-    if (this != &other)
+    if ((this != &other) && (m_data != other.m_data))
     {
-        /* Copy the string */
-        delete m_buffer;
-        m_buffer = new cSArray<character>(*other.m_buffer);
-        rearrangeStringVector();
+        if (other.isShared())
+        {
+            /* Reference the shared storage, keep the allocator */
+            freeString();
+            copyShared(other);
+        } else
+        {
+            /* Copy the string, reuse the memory of this string */
+            if (isShared())
+                freeString();
+            assign(other.m_data, other.m_stringLength);
+        }
     }
     return *this;
 }
@@ -771,27 +1021,41 @@ cString & cString::operator += (const character ch)
     }
 
     // Fast insert character
-    m_buffer->changeSize(m_buffer->getSize() + 1, true);
-    (*m_buffer)[m_buffer->getSize() - 1] = cChar::getNullCharacter();
-    (*m_buffer)[m_buffer->getSize() - 2] = ch;
+    reserve(m_stringLength + 2);
+    m_data[m_stringLength] = ch;
 
     // Change string length...
     m_stringLength++;
+    m_data[m_stringLength] = cChar::getNullCharacter();
 
     return *this;
 }
 
+#ifdef XSTL_CPP11
+cString cString::operator + (const cString& other) const &
+#else
 cString cString::operator + (const cString& other) const
+#endif
 {
-    return cString(*this) += other;
+    cString ret(*this);
+    ret+= other;
+    return ret;
 }
 
+#ifdef XSTL_CPP11
+cString cString::operator + (const character* string) const &
+#else
 cString cString::operator + (const character* string) const
+#endif
 {
     return *this + cString(string);
 }
 
+#ifdef XSTL_CPP11
+cString cString::operator + (const character ch) const &
+#else
 cString cString::operator + (const character ch) const
+#endif
 {
     if (ch == cChar::getNullCharacter())
     {
@@ -802,22 +1066,53 @@ cString cString::operator + (const character ch) const
         return *this;
     }
 
-    return cString(*this) += ch;
+    cString ret(*this);
+    ret+= ch;
+    return ret;
 }
 
+#ifdef XSTL_CPP11
+cString cString::operator + (const cString& other) &&
+{
+    concat(other);
+    return t_move(*this);
+}
+
+cString cString::operator + (const character* string) &&
+{
+    concat(cString(string));
+    return t_move(*this);
+}
+
+cString cString::operator + (const character ch) &&
+{
+    (*this)+= ch;
+    return t_move(*this);
+}
+#endif // XSTL_CPP11
+
 
 character& cString::operator[] (const int index)
 {
-    ASSERT(index >= 0);
-    ASSERT(index <= (int)m_buffer->getSize());
-    return (*m_buffer)[index];
+    // The null-terminator can be read
+    if ((index < 0) || ((uint)index > m_stringLength))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+
+    // The character might be changed
+    detach();
+    return m_data[index];
 }
 
 character cString::operator [] (const int index) const
 {
-    ASSERT(index >= 0);
-    ASSERT(index <= (int)m_buffer->getSize());
-    return (*m_buffer)[index];
+    // The null-terminator can be read
+    if ((index < 0) || ((uint)index > m_stringLength))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    return m_data[index];
 }
 
 bool cString::isValid() const
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * stringBuilder.cpp
+ *
+ * Implementation file.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+#include "xStl/except/exception.h"
+#include "xStl/except/assert.h"
+#include "xStl/data/char.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringView.h"
+#include "xStl/data/numberConversion.h"
+#include "xStl/data/stringBuilder.h"
+#include "xStl/utils/algorithm.h"
+
+// The block memory
+typedef cArrayStorage<character, true> BlockStorage;
+
+cStringBuilder::cStringBuilder(uint blockLength /* = DefaultBlockLength */) :
+    m_blockLength(blockLength),
+    m_block(NULL),
+    m_blockUsed(blockLength),
+    m_length(0)
+{
+    ASSERT(blockLength > 0);
+}
+
+cStringBuilder::~cStringBuilder()
+{
+    for (uint i = 0; i < m_blocks.getSize(); i++)
+        BlockStorage::free(m_blocks[i]);
+}
+
+uint cStringBuilder::length() const
+{
+    return m_length;
+}
+
+void cStringBuilder::nextBlock()
+{
+    m_block = BlockStorage::allocate(m_blockLength);
+    m_blocks.append(m_block);
+    m_blockUsed = 0;
+}
+
+void cStringBuilder::append(const character* string, uint length)
+{
+    m_length+= length;
+    while (length > 0)
+    {
+        if (m_blockUsed == m_blockLength)
+            nextBlock();
+
+        uint count = t_min(length, m_blockLength - m_blockUsed);
+        cOS::memcpy(m_block + m_blockUsed, string,
+                    count * sizeof(character));
+        m_blockUsed+= count;
+        string+= count;
+        length-= count;
+    }
+}
+
+void cStringBuilder::append(const cStringView& string)
+{
+    append(string.getBuffer(), string.length());
+}
+
+void cStringBuilder::append(const cString& string)
+{
+    append(string.getBuffer(), string.length());
+}
+
+void cStringBuilder::append(character ch)
+{
+    if (m_blockUsed == m_blockLength)
+        nextBlock();
+
+    m_block[m_blockUsed++] = ch;
+    m_length++;
+}
+
+void cStringBuilder::appendRepeated(const cStringView& string, uint count)
+{
+    for (uint i = 0; i < count; i++)
+        append(string.getBuffer(), string.length());
+}
+
+void cStringBuilder::appendRepeated(character ch, uint count)
+{
+    m_length+= count;
+    while (count > 0)
+    {
+        if (m_blockUsed == m_blockLength)
+            nextBlock();
+
+        uint fill = t_min(count, m_blockLength - m_blockUsed);
+        character* block = m_block + m_blockUsed;
+        for (uint i = 0; i < fill; i++)
+            block[i] = ch;
+        m_blockUsed+= fill;
+        count-= fill;
+    }
+}
+
+void cStringBuilder::appendNumber(int64 number, uint base /* = 10 */)
+{
+    character buffer[cNumberConversion::BufferLength];
+    append(buffer, cNumberConversion::formatSigned(number, buffer, base));
+}
+
+void cStringBuilder::appendUnsignedNumber(uint64 number,
+                                          uint base /* = 10 */)
+{
+    character buffer[cNumberConversion::BufferLength];
+    append(buffer, cNumberConversion::formatUnsigned(number, buffer, base));
+}
+
+cStringBuilder& cStringBuilder::operator << (const cString& string)
+{
+    append(string);
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const cStringView& string)
+{
+    append(string);
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const char* asciiString)
+{
+    #ifdef XSTL_UNICODE
+        // Widen the characters directly into the blocks
+        while (*asciiString != 0)
+        {
+            if (m_blockUsed == m_blockLength)
+                nextBlock();
+
+            while ((m_blockUsed < m_blockLength) && (*asciiString != 0))
+            {
+                m_block[m_blockUsed++] = (character)(*asciiString++);
+                m_length++;
+            }
+        }
+    #else
+        append(asciiString, cChar::getStrlen(asciiString));
+    #endif
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const char ch)
+{
+    append((character)ch);
+    return *this;
+}
+
+#ifdef XSTL_UNICODE
+cStringBuilder& cStringBuilder::operator << (const character* unicodeString)
+{
+    append(unicodeString, cChar::getStrlen(unicodeString));
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const character ch)
+{
+    append(ch);
+    return *this;
+}
+#endif // XSTL_UNICODE
+
+cStringBuilder& cStringBuilder::operator << (const int32 dword)
+{
+    appendNumber(dword);
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const int64 qword)
+{
+    appendNumber(qword);
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const uint32 dword)
+{
+    appendUnsignedNumber(dword);
+    return *this;
+}
+
+cStringBuilder& cStringBuilder::operator << (const uint64 qword)
+{
+    appendUnsignedNumber(qword);
+    return *this;
+}
+
+uint cStringBuilder::getBlocksCount() const
+{
+    return m_blocks.getSize();
+}
+
+cStringView cStringBuilder::getBlock(uint index) const
+{
+    ASSERT(index < m_blocks.getSize());
+    uint count = (index + 1 == m_blocks.getSize()) ? m_blockUsed :
+                                                     m_blockLength;
+    return cStringView(m_blocks[index], count);
+}
+
+cString cStringBuilder::toString() const
+{
+    cString ret;
+    appendTo(ret);
+    return ret;
+}
+
+void cStringBuilder::appendTo(cString& string) const
+{
+    uint start = string.m_stringLength;
+    string.reserve(start + m_length + 1);
+
+    character* position = string.m_data + start;
+    for (uint i = 0; i < m_blocks.getSize(); i++)
+    {
+        cStringView block(getBlock(i));
+        cOS::memcpy(position, block.getBuffer(),
+                    block.length() * sizeof(character));
+        position+= block.length();
+    }
+
+    string.m_stringLength = start + m_length;
+    string.m_data[string.m_stringLength] = cChar::getNullCharacter();
+}
+
+void cStringBuilder::clear()
+{
+    if (m_blocks.getSize() > 0)
+    {
+        for (uint i = 1; i < m_blocks.getSize(); i++)
+            BlockStorage::free(m_blocks[i]);
+        m_blocks.changeSize(1);
+        m_block = m_blocks[0];
+        m_blockUsed = 0;
+    }
+    m_length = 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * stringCase.cpp
+ *
+ * Implementation file.
+ *
+ * The vector implementation is compiled only for x86 processors which
+ * support SSE2 (all the x64 processors).
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/utils/algorithm.h"
+
+#if (!defined(XSTL_NTDDK)) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+    #define XSTL_CASE_SSE2
+    // Avoid the 'uint' declaration of the system headers
+    #undef __USE_MISC
+    #include <emmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+/*
+ * Return the lower-case form of an ASCII letter
+ */
+template <class T>
+static inline T foldCharacter(T ch)
+{
+    if ((ch >= 'A') && (ch <= 'Z'))
+        return (T)(ch | 0x20);
+    return ch;
+}
+
+/*
+ * Return the ordering value of a character. Characters are ordered as
+ * unsigned numbers, the same as strcasecmp()
+ */
+static inline uint32 getOrder(char ch)
+{
+    return (uint8)ch;
+}
+
+#ifdef XSTL_UNICODE
+static inline uint32 getOrder(character ch)
+{
+    return (uint32)ch;
+}
+#endif
+
+#ifdef XSTL_CASE_SSE2
+static inline uint getLowestBit(uint32 mask)
+{
+    #ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+    #else
+        return __builtin_ctz(mask);
+    #endif
+}
+
+template <class T>
+static inline __m128i sse2Set(int value)
+{
+    switch (sizeof(T))
+    {
+    case 1: return _mm_set1_epi8((char)value);
+    case 2: return _mm_set1_epi16((short)value);
+    default: return _mm_set1_epi32(value);
+    }
+}
+
+template <class T>
+static inline __m128i sse2Greater(__m128i a, __m128i b)
+{
+    switch (sizeof(T))
+    {
+    case 1: return _mm_cmpgt_epi8(a, b);
+    case 2: return _mm_cmpgt_epi16(a, b);
+    default: return _mm_cmpgt_epi32(a, b);
+    }
+}
+
+template <class T>
+static inline __m128i sse2Equal(__m128i a, __m128i b)
+{
+    switch (sizeof(T))
+    {
+    case 1: return _mm_cmpeq_epi8(a, b);
+    case 2: return _mm_cmpeq_epi16(a, b);
+    default: return _mm_cmpeq_epi32(a, b);
+    }
+}
+
+/*
+ * Return the 0x20 bit for the characters of 'block' which are in the range
+ * [first..last]. Characters above 0x7F are negative or greater than 'last',
+ * so they are never in the range.
+ */
+template <class T>
+static inline __m128i sse2CaseBit(__m128i block, int first, int last)
+{
+    __m128i inRange = _mm_and_si128(
+                        sse2Greater<T>(block, sse2Set<T>(first - 1)),
+                        sse2Greater<T>(sse2Set<T>(last + 1), block));
+    return _mm_and_si128(inRange, sse2Set<T>(0x20));
+}
+#endif // XSTL_CASE_SSE2
+
+/*
+ * Toggle the case of the letters in the range [first..last]
+ */
+template <class T>
+static void convertCase(const T* string, uint length, T* output,
+                        int first, int last)
+{
+    uint i = 0;
+    #ifdef XSTL_CASE_SSE2
+    enum { Lanes = 16 / sizeof(T) };
+    for (; i + Lanes <= length; i+= Lanes)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(string + i));
+        block = _mm_xor_si128(block, sse2CaseBit<T>(block, first, last));
+        _mm_storeu_si128((__m128i*)(output + i), block);
+    }
+    #endif
+
+    for (; i < length; i++)
+    {
+        T ch = string[i];
+        if ((ch >= first) && (ch <= last))
+            ch = (T)(ch ^ 0x20);
+        output[i] = ch;
+    }
+}
+
+/*
+ * Return the first position in which the lower-case forms of the strings
+ * differ, or 'length' if the strings are equal.
+ */
+template <class T>
+static uint findCaseMismatch(const T* string1, const T* string2, uint length)
+{
+    uint i = 0;
+    #ifdef XSTL_CASE_SSE2
+    enum { Lanes = 16 / sizeof(T) };
+    for (; i + Lanes <= length; i+= Lanes)
+    {
+        __m128i block1 = _mm_loadu_si128((const __m128i*)(string1 + i));
+        __m128i block2 = _mm_loadu_si128((const __m128i*)(string2 + i));
+        block1 = _mm_or_si128(block1, sse2CaseBit<T>(block1, 'A', 'Z'));
+        block2 = _mm_or_si128(block2, sse2CaseBit<T>(block2, 'A', 'Z'));
+        uint32 mask = (uint32)_mm_movemask_epi8(sse2Equal<T>(block1, block2));
+        if (mask != 0xFFFF)
+            return i + (getLowestBit(~mask) / sizeof(T));
+    }
+    #endif
+
+    for (; i < length; i++)
+    {
+        if (foldCharacter(string1[i]) != foldCharacter(string2[i]))
+            return i;
+    }
+    return length;
+}
+
+template <class T>
+static int icompareString(const T* string1, uint length1,
+                          const T* string2, uint length2)
+{
+    uint count = t_min(length1, length2);
+    uint i = findCaseMismatch(string1, string2, count);
+    if (i < count)
+    {
+        return (getOrder(foldCharacter(string1[i])) <
+                getOrder(foldCharacter(string2[i]))) ? -1 : 1;
+    }
+
+    if (length1 == length2)
+        return 0;
+    return (length1 < length2) ? -1 : 1;
+}
+
+template <class T>
+static bool iequalsString(const T* string1, uint length1,
+                          const T* string2, uint length2)
+{
+    if (length1 != length2)
+        return false;
+    return findCaseMismatch(string1, string2, length1) == length1;
+}
+
+void cStringCase::makeUpper(char* string, uint length)
+{
+    convertCase(string, length, string, 'a', 'z');
+}
+
+void cStringCase::makeLower(char* string, uint length)
+{
+    convertCase(string, length, string, 'A', 'Z');
+}
+
+void cStringCase::foldCase(const char* string, uint length, char* output)
+{
+    convertCase(string, length, output, 'A', 'Z');
+}
+
+int cStringCase::icompare(const char* string1, uint length1,
+                          const char* string2, uint length2)
+{
+    return icompareString(string1, length1, string2, length2);
+}
+
+bool cStringCase::iequals(const char* string1, uint length1,
+                          const char* string2, uint length2)
+{
+    return iequalsString(string1, length1, string2, length2);
+}
+
+#ifdef XSTL_UNICODE
+void cStringCase::makeUpper(character* string, uint length)
+{
+    convertCase(string, length, string, 'a', 'z');
+}
+
+void cStringCase::makeLower(character* string, uint length)
+{
+    convertCase(string, length, string, 'A', 'Z');
+}
+
+void cStringCase::foldCase(const character* string, uint length,
+                           character* output)
+{
+    convertCase(string, length, output, 'A', 'Z');
+}
+
+int cStringCase::icompare(const character* string1, uint length1,
+                          const character* string2, uint length2)
+{
+    return icompareString(string1, length1, string2, length2);
+}
+
+bool cStringCase::iequals(const character* string1, uint length1,
+                          const character* string2, uint length2)
+{
+    return iequalsString(string1, length1, string2, length2);
+}
+#endif // XSTL_UNICODE
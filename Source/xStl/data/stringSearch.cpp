@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include "xStl/xStlPrecompiled.h"
+/*
+ * stringSearch.cpp
+ *
+ * Implementation file.
+ *
+ * The vector engines are compiled only for x86 processors. The AVX2 engine
+ * is compiled with the 'avx2' target attribute (gcc/clang) so the rest of
+ * the library doesn't require an AVX2 processor.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/exception.h"
+#include "xStl/data/char.h"
+#include "xStl/data/stringSearch.h"
+#include <string.h>
+
+#if (!defined(XSTL_NTDDK)) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+    #define XSTL_SEARCH_SSE2
+    // Avoid the 'uint' declaration of the system headers
+    #undef __USE_MISC
+    #include <emmintrin.h>
+
+    #if defined(__clang__) || \
+        (defined(__GNUC__) && ((__GNUC__ > 4) || \
+                               ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))))
+        #define XSTL_SEARCH_AVX2
+        #define XSTL_TARGET_AVX2 __attribute__((target("avx2")))
+        #include <immintrin.h>
+    #elif defined(_MSC_VER) && (_MSC_VER >= 1700)
+        #define XSTL_SEARCH_AVX2
+        #define XSTL_TARGET_AVX2
+        #include <immintrin.h>
+        #include <intrin.h>
+    #endif
+#endif
+
+volatile int cStringSearch::m_engine = -1;
+
+/*
+ * Return true if the 'count' characters of 'a' and 'b' are equal
+ */
+template <class T>
+static inline bool isEqual(const T* a, const T* b, uint count)
+{
+    return memcmp(a, b, count * sizeof(T)) == 0;
+}
+
+template <class T>
+static uint scalarFind(const T* haystack, uint length,
+                       const T* needle, uint needleLength,
+                       uint startIndex)
+{
+    const T first = needle[0];
+    uint last = length - needleLength;
+    for (uint i = startIndex; i <= last; i++)
+    {
+        if ((haystack[i] == first) &&
+            isEqual(haystack + i + 1, needle + 1, needleLength - 1))
+        {
+            return i;
+        }
+    }
+    return length;
+}
+
+template <class T>
+static uint scalarRfind(const T* haystack, uint length,
+                        const T* needle, uint needleLength,
+                        uint startIndex)
+{
+    const T first = needle[0];
+    for (uint i = startIndex + 1; i > 0; i--)
+    {
+        if ((haystack[i - 1] == first) &&
+            isEqual(haystack + i, needle + 1, needleLength - 1))
+        {
+            return i - 1;
+        }
+    }
+    return length;
+}
+
+#ifdef XSTL_SEARCH_SSE2
+/*
+ * Bit scanning of the vector compare masks
+ */
+static inline uint getLowestBit(uint32 mask)
+{
+    #ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+    #else
+        return __builtin_ctz(mask);
+    #endif
+}
+
+static inline uint getHighestBit(uint32 mask)
+{
+    #ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse(&index, mask);
+        return index;
+    #else
+        return 31 - __builtin_clz(mask);
+    #endif
+}
+
+/*
+ * Return the byte mask of the positions in the block at 'position' which
+ * their first and last characters matches the needle.
+ */
+template <class T>
+static inline uint32 sse2Match(const T* haystack, uint position,
+                               uint needleLength,
+                               __m128i first, __m128i last)
+{
+    __m128i blockFirst = _mm_loadu_si128((const __m128i*)(haystack + position));
+    __m128i blockLast = _mm_loadu_si128((const __m128i*)
+                                 (haystack + position + needleLength - 1));
+    __m128i eqFirst, eqLast;
+    switch (sizeof(T))
+    {
+    case 1:
+        eqFirst = _mm_cmpeq_epi8(first, blockFirst);
+        eqLast = _mm_cmpeq_epi8(last, blockLast);
+        break;
+    case 2:
+        eqFirst = _mm_cmpeq_epi16(first, blockFirst);
+        eqLast = _mm_cmpeq_epi16(last, blockLast);
+        break;
+    default:
+        eqFirst = _mm_cmpeq_epi32(first, blockFirst);
+        eqLast = _mm_cmpeq_epi32(last, blockLast);
+    }
+    return (uint32)_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast));
+}
+
+template <class T>
+static inline __m128i sse2Set(T ch)
+{
+    switch (sizeof(T))
+    {
+    case 1: return _mm_set1_epi8((char)ch);
+    case 2: return _mm_set1_epi16((short)ch);
+    default: return _mm_set1_epi32((int)ch);
+    }
+}
+
+template <class T>
+static uint sse2Find(const T* haystack, uint length,
+                     const T* needle, uint needleLength,
+                     uint startIndex)
+{
+    enum { Lanes = 16 / sizeof(T), LaneMask = (1 << sizeof(T)) - 1 };
+    const __m128i first = sse2Set(needle[0]);
+    const __m128i last = sse2Set(needle[needleLength - 1]);
+
+    uint i = startIndex;
+    for (; i + Lanes + needleLength - 1 <= length; i+= Lanes)
+    {
+        uint32 mask = sse2Match(haystack, i, needleLength, first, last);
+        while (mask != 0)
+        {
+            uint lane = getLowestBit(mask) / sizeof(T);
+            if (isEqual(haystack + i + lane + 1, needle + 1, needleLength - 1))
+                return i + lane;
+            mask&= ~((uint32)LaneMask << (lane * sizeof(T)));
+        }
+    }
+
+    // The tail of the haystack
+    return scalarFind(haystack, length, needle, needleLength, i);
+}
+
+template <class T>
+static uint sse2Rfind(const T* haystack, uint length,
+                      const T* needle, uint needleLength,
+                      uint startIndex)
+{
+    enum { Lanes = 16 / sizeof(T), LaneMask = (1 << sizeof(T)) - 1 };
+    const __m128i first = sse2Set(needle[0]);
+    const __m128i last = sse2Set(needle[needleLength - 1]);
+
+    // Scan the blocks [i - Lanes + 1, i] backward
+    uint i = startIndex;
+    while (i + 1 >= Lanes)
+    {
+        uint block = i + 1 - Lanes;
+        uint32 mask = sse2Match(haystack, block, needleLength, first, last);
+        while (mask != 0)
+        {
+            uint lane = getHighestBit(mask) / sizeof(T);
+            if (isEqual(haystack + block + lane + 1, needle + 1,
+                        needleLength - 1))
+                return block + lane;
+            mask&= ~((uint32)LaneMask << (lane * sizeof(T)));
+        }
+        if (block == 0)
+            return length;
+        i = block - 1;
+    }
+
+    // The head of the haystack
+    return scalarRfind(haystack, length, needle, needleLength, i);
+}
+#endif // XSTL_SEARCH_SSE2
+
+#ifdef XSTL_SEARCH_AVX2
+template <class T>
+XSTL_TARGET_AVX2
+static inline uint32 avx2Match(const T* haystack, uint position,
+                               uint needleLength,
+                               __m256i first, __m256i last)
+{
+    __m256i blockFirst = _mm256_loadu_si256((const __m256i*)
+                                            (haystack + position));
+    __m256i blockLast = _mm256_loadu_si256((const __m256i*)
+                                 (haystack + position + needleLength - 1));
+    __m256i eqFirst, eqLast;
+    switch (sizeof(T))
+    {
+    case 1:
+        eqFirst = _mm256_cmpeq_epi8(first, blockFirst);
+        eqLast = _mm256_cmpeq_epi8(last, blockLast);
+        break;
+    case 2:
+        eqFirst = _mm256_cmpeq_epi16(first, blockFirst);
+        eqLast = _mm256_cmpeq_epi16(last, blockLast);
+        break;
+    default:
+        eqFirst = _mm256_cmpeq_epi32(first, blockFirst);
+        eqLast = _mm256_cmpeq_epi32(last, blockLast);
+    }
+    return (uint32)_mm256_movemask_epi8(_mm256_and_si256(eqFirst, eqLast));
+}
+
+template <class T>
+XSTL_TARGET_AVX2
+static inline __m256i avx2Set(T ch)
+{
+    switch (sizeof(T))
+    {
+    case 1: return _mm256_set1_epi8((char)ch);
+    case 2: return _mm256_set1_epi16((short)ch);
+    default: return _mm256_set1_epi32((int)ch);
+    }
+}
+
+template <class T>
+XSTL_TARGET_AVX2
+static uint avx2Find(const T* haystack, uint length,
+                     const T* needle, uint needleLength,
+                     uint startIndex)
+{
+    enum { Lanes = 32 / sizeof(T), LaneMask = (1 << sizeof(T)) - 1 };
+    const __m256i first = avx2Set(needle[0]);
+    const __m256i last = avx2Set(needle[needleLength - 1]);
+
+    uint i = startIndex;
+    for (; i + Lanes + needleLength - 1 <= length; i+= Lanes)
+    {
+        uint32 mask = avx2Match(haystack, i, needleLength, first, last);
+        while (mask != 0)
+        {
+            uint lane = getLowestBit(mask) / sizeof(T);
+            if (isEqual(haystack + i + lane + 1, needle + 1, needleLength - 1))
+                return i + lane;
+            mask&= ~((uint32)LaneMask << (lane * sizeof(T)));
+        }
+    }
+
+    // The tail of the haystack
+    return sse2Find(haystack, length, needle, needleLength, i);
+}
+
+template <class T>
+XSTL_TARGET_AVX2
+static uint avx2Rfind(const T* haystack, uint length,
+                      const T* needle, uint needleLength,
+                      uint startIndex)
+{
+    enum { Lanes = 32 / sizeof(T), LaneMask = (1 << sizeof(T)) - 1 };
+    const __m256i first = avx2Set(needle[0]);
+    const __m256i last = avx2Set(needle[needleLength - 1]);
+
+    // Scan the blocks [i - Lanes + 1, i] backward
+    uint i = startIndex;
+    while (i + 1 >= Lanes)
+    {
+        uint block = i + 1 - Lanes;
+        uint32 mask = avx2Match(haystack, block, needleLength, first, last);
+        while (mask != 0)
+        {
+            uint lane = getHighestBit(mask) / sizeof(T);
+            if (isEqual(haystack + block + lane + 1, needle + 1,
+                        needleLength - 1))
+                return block + lane;
+            mask&= ~((uint32)LaneMask << (lane * sizeof(T)));
+        }
+        if (block == 0)
+            return length;
+        i = block - 1;
+    }
+
+    // The head of the haystack
+    return sse2Rfind(haystack, length, needle, needleLength, i);
+}
+#endif // XSTL_SEARCH_AVX2
+
+/*
+ * Dispatch the search to the engine
+ */
+template <class T>
+static uint dispatchFind(cStringSearch::Engine engine,
+                         const T* haystack, uint length,
+                         const T* needle, uint needleLength,
+                         uint startIndex)
+{
+    if (needleLength == 0)
+        return startIndex;
+    if ((needleLength > length) || (startIndex > length - needleLength))
+        return length;
+
+    switch (engine)
+    {
+    #ifdef XSTL_SEARCH_AVX2
+    case cStringSearch::AVX2Engine:
+        return avx2Find(haystack, length, needle, needleLength, startIndex);
+    #endif
+    #ifdef XSTL_SEARCH_SSE2
+    case cStringSearch::SSE2Engine:
+        return sse2Find(haystack, length, needle, needleLength, startIndex);
+    #endif
+    default:
+        return scalarFind(haystack, length, needle, needleLength, startIndex);
+    }
+}
+
+template <class T>
+static uint dispatchRfind(cStringSearch::Engine engine,
+                          const T* haystack, uint length,
+                          const T* needle, uint needleLength,
+                          uint startIndex)
+{
+    if (needleLength == 0)
+        return startIndex;
+    if (needleLength > length)
+        return length;
+
+    // The last possible position
+    if (startIndex > length - needleLength)
+        startIndex = length - needleLength;
+
+    switch (engine)
+    {
+    #ifdef XSTL_SEARCH_AVX2
+    case cStringSearch::AVX2Engine:
+        return avx2Rfind(haystack, length, needle, needleLength, startIndex);
+    #endif
+    #ifdef XSTL_SEARCH_SSE2
+    case cStringSearch::SSE2Engine:
+        return sse2Rfind(haystack, length, needle, needleLength, startIndex);
+    #endif
+    default:
+        return scalarRfind(haystack, length, needle, needleLength, startIndex);
+    }
+}
+
+uint cStringSearch::find(const char* haystack, uint length,
+                         const char* needle, uint needleLength,
+                         uint startIndex /* = 0 */)
+{
+    return dispatchFind(getEngine(), haystack, length, needle, needleLength,
+                        startIndex);
+}
+
+uint cStringSearch::rfind(const char* haystack, uint length,
+                          const char* needle, uint needleLength,
+                          uint startIndex /* = MAX_UINT */)
+{
+    return dispatchRfind(getEngine(), haystack, length, needle, needleLength,
+                         startIndex);
+}
+
+#ifdef XSTL_UNICODE
+uint cStringSearch::find(const character* haystack, uint length,
+                         const character* needle, uint needleLength,
+                         uint startIndex /* = 0 */)
+{
+    return dispatchFind(getEngine(), haystack, length, needle, needleLength,
+                        startIndex);
+}
+
+uint cStringSearch::rfind(const character* haystack, uint length,
+                          const character* needle, uint needleLength,
+                          uint startIndex /* = MAX_UINT */)
+{
+    return dispatchRfind(getEngine(), haystack, length, needle, needleLength,
+                         startIndex);
+}
+#endif // XSTL_UNICODE
+
+cStringSearch::Engine cStringSearch::getEngine()
+{
+    // The detection can be executed by more than one thread at the same time,
+    // all of them will store the same value.
+    int engine = m_engine;
+    if (engine < 0)
+    {
+        engine = detectEngine();
+        m_engine = engine;
+    }
+    return (Engine)engine;
+}
+
+bool cStringSearch::isEngineSupported(Engine engine)
+{
+    return engine <= detectEngine();
+}
+
+void cStringSearch::setEngine(Engine engine)
+{
+    if (!isEngineSupported(engine))
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_RANGE);
+    }
+    m_engine = engine;
+}
+
+cStringSearch::Engine cStringSearch::detectEngine()
+{
+    #ifdef XSTL_SEARCH_AVX2
+        #ifdef _MSC_VER
+            // AVX2 must be supported by the processor (CPUID.7:EBX[5]) and
+            // the YMM registers must be saved by the operating system.
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] >= 7)
+            {
+                __cpuid(info, 1);
+                bool isOsSupported = ((info[2] & (1 << 27)) != 0) &&
+                                     ((info[2] & (1 << 28)) != 0) &&
+                                     ((_xgetbv(0) & 6) == 6);
+                __cpuidex(info, 7, 0);
+                if (isOsSupported && ((info[1] & (1 << 5)) != 0))
+                    return AVX2Engine;
+            }
+        #else
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return AVX2Engine;
+        #endif
+    #endif
+
+    #ifdef XSTL_SEARCH_SSE2
+        return SSE2Engine;
+    #else
+        return ScalarEngine;
+    #endif
+}
@@ -39,23 +39,31 @@
  */
 #include "xStl/types.h"
 #include "xStl/data/string.h"
+#include "xStl/data/stringCase.h"
 #include "xStl/data/wildcardMatcher.h"
 
 bool cWildcardMatcher::match(const cString& string,
                              const cString& wildcardPattern,
                              bool isCaseSensetive)
+{
+    return match(string.getView(), wildcardPattern.getView(), isCaseSensetive);
+}
+
+bool cWildcardMatcher::match(const cStringView& string,
+                             const cStringView& wildcardPattern,
+                             bool isCaseSensetive)
 {
     // Empty pattern is a special case
-    if (wildcardPattern.length() == 0)
-        return string.length() == 0;
+    if (wildcardPattern.isEmpty())
+        return string.isEmpty();
 
     // Reads all character until a wildcard character...
     for (uint i = 0; i < wildcardPattern.length(); i++)
     {
         character ch = wildcardPattern[i];
         // Declared for switch '*' stack variables
-        cString newString;
-        cString secondPattern;
+        cStringView newString;
+        cStringView secondPattern;
         uint j;
         switch (ch)
         {
@@ -82,24 +90,37 @@ bool cWildcardMatcher::match(const cString& string,
             for (j = 0; j < newString.length(); j++)
             {
                 if (match(newString.right(newString.length() - j),
-                          secondPattern))
+                          secondPattern,
+                          isCaseSensetive))
                     return true;
             }
             return false;
             break;
         default:
+            // Compare the whole run of characters until the next wildcard
+            j = i + 1;
+            while ((j < wildcardPattern.length()) &&
+                   (wildcardPattern[j] != XSTL_CHAR('?')) &&
+                   (wildcardPattern[j] != XSTL_CHAR('*')))
+            {
+                j++;
+            }
+
             // Must be equal
-            if (string.length() <= i)
+            if (string.length() < j)
                 return false;
             if (isCaseSensetive)
             {
-                if (string[i] != ch)
+                if (!(string.part(i, j) == wildcardPattern.part(i, j)))
                     return false;
             } else
             {
-                if (cChar::getUppercase(string[i]) != cChar::getUppercase(ch))
+                if (!cStringCase::iequals(string.getBuffer() + i, j - i,
+                                          wildcardPattern.getBuffer() + i,
+                                          j - i))
                     return false;
             }
+            i = j - 1;
         }
     }
 
@@ -47,6 +47,7 @@
 #include "xStl/enc/random.h"
 #include "xStl/os/mutex.h"
 #include "xStl/os/os.h"
+#include "xStl/os/unixOS/smallMemory.h"
 #include "xStl/stream/traceStream.h"
 
 #undef __USE_MISC
@@ -66,23 +67,18 @@ void cOS::memcpy(void* dest,
 
 void* cOS::smallMemoryAllocation(uint size)
 {
-    void* ret = malloc(size);
-    if (size != 0)
-    {
-        CHECK(ret != NULL);
-    }
-    return ret;
+    return cSmallMemory::allocate(size);
 }
 
 void* cOS::smallMemoryRealloc(void* mem, uint newSize,
                               bool preserveMemory)
 {
-    return realloc(mem, newSize);
+    return cSmallMemory::reallocate(mem, newSize, preserveMemory);
 }
 
 void cOS::smallMemoryFree(void* mem)
 {
-    free(mem);
+    cSmallMemory::free(mem);
 }
 
 void cOS::sleepMillisecond(uint milisecond)
@@ -99,6 +95,14 @@ void cOS::sleepMicroseconds(uint micro)
     while (nanosleep(&tm, &tm));
 }
 
+uint cOS::getNumberOfProcessors()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1)
+        return 1;
+    return (uint)count;
+}
+
 cOSDef::systemTime cOS::getSystemTime()
 {
     return time(NULL);
@@ -0,0 +1,581 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * unixSmallMemory.cpp
+ *
+ * Implementation file for UNIX operating system using POSIX API
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/trace.h"
+#include "xStl/except/exception.h"
+#include "xStl/os/os.h"
+#include "xStl/os/interlocked.h"
+#include "xStl/os/unixOS/smallMemory.h"
+
+#if defined(XSTL_LINUX)
+
+#undef __USE_MISC
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The header of every span, followed by the blocks of the span. Large blocks
+ * have the same header right before the block.
+ */
+struct SmallMemoryHeader {
+    // Always HeaderMagic, used to detect invalid blocks
+    uint32 m_magic;
+    // The size class of the blocks, or LargeClass
+    uint32 m_sizeClass;
+    // The number of bytes of a block
+    uint m_size;
+};
+
+enum {
+    // The magic number of a header
+    HeaderMagic = 0x5350414E,
+    // The size class of blocks which are larger than MaxSmallSize
+    LargeClass = cSmallMemory::SizeClassesCount,
+    // The number of bytes of a header, before the first block of a span and
+    // before a large block
+    HeaderSize = cSmallMemory::Alignment,
+    // The span map: A bit for every span of the 48 bits address space, in
+    // leaves which cover 8gb each
+    SpanShift = 18,
+    SpanMapLeafBits = 15,
+    SpanMapLeafSize = 1 << SpanMapLeafBits,
+    SpanMapRootSize = 1 << (48 - SpanShift - SpanMapLeafBits),
+    // Batches move between 2 and 64 blocks, about 8kb of memory
+    BatchBytes = 8 * 1024,
+    MinBatchSize = 2,
+    MaxBatchSize = 64
+};
+
+/*
+ * A singly-linked list of free blocks. The first word of every free block
+ * points to the next block.
+ */
+struct SmallMemoryFreeList {
+    void* m_head;
+    uint m_count;
+};
+
+/*
+ * The blocks which are cached by a single thread. The counters are changed
+ * only by the owner thread and are read by getStatistics().
+ */
+struct SmallMemoryThreadCache {
+    SmallMemoryFreeList m_lists[cSmallMemory::SizeClassesCount];
+    uint64 m_allocations[cSmallMemory::SizeClassesCount];
+    uint64 m_frees[cSmallMemory::SizeClassesCount];
+    uint64 m_largeAllocatedBytes;
+    uint64 m_largeFreedBytes;
+    uint64 m_misses;
+    // All the caches of the living threads
+    SmallMemoryThreadCache* m_next;
+    SmallMemoryThreadCache* m_previous;
+};
+
+/*
+ * The central depot of a size class. The free blocks which were returned by
+ * the threads, and the unused part of the last span.
+ */
+struct SmallMemoryDepot {
+    counter_t m_lock;
+    SmallMemoryFreeList m_list;
+    uint8* m_spanPosition;
+    uint8* m_spanEnd;
+};
+
+// All the globals are zero initialized, so the allocator works before (and
+// after) the constructors of the global objects.
+static SmallMemoryDepot g_depots[cSmallMemory::SizeClassesCount];
+// The caches of the threads and the counters of the threads that exited
+static counter_t g_cachesLock;
+static SmallMemoryThreadCache* g_caches;
+static SmallMemoryThreadCache g_exitedThreads;
+static uint64 g_reservedBytes;
+// The spans of the size classes, so a block can be told from a large block
+// without touching the memory around it
+static uint8* volatile g_spanMap[SpanMapRootSize];
+static counter_t g_spanMapLock;
+// The cache of the current thread. The library is loaded with the program,
+// so the faster static TLS model can be used
+static __thread SmallMemoryThreadCache* g_threadCache
+    __attribute__((tls_model("initial-exec")));
+// Returns the cache of an exiting thread to the depot
+static pthread_key_t g_threadCacheKey;
+static pthread_once_t g_threadCacheKeyOnce = PTHREAD_ONCE_INIT;
+
+/*
+ * Spin-locks. The locks are held only while a few pointers are changed.
+ */
+static void lockSmallMemory(counter_t* lock)
+{
+    while (cInterlocked::exchange(lock, 1) != 0)
+        sched_yield();
+}
+
+static void unlockSmallMemory(counter_t* lock)
+{
+    cInterlocked::exchange(lock, 0);
+}
+
+/*
+ * Add to a counter of a thread cache. Only the owner thread changes the
+ * counter, other threads may read it at the same time.
+ */
+static void addCounter(uint64* counter, uint64 value)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value,
+                     __ATOMIC_RELAXED);
+}
+
+static uint64 readCounter(const uint64* counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+/*
+ * Add a new span into the span map. Return false if there is no memory.
+ */
+static bool registerSpan(void* span)
+{
+    addressNumericValue index = (addressNumericValue)span >> SpanShift;
+    addressNumericValue root = index >> SpanMapLeafBits;
+    if (root >= SpanMapRootSize)
+        return false;
+
+    lockSmallMemory(&g_spanMapLock);
+    uint8* leaf = g_spanMap[root];
+    if (leaf == NULL)
+    {
+        leaf = (uint8*)calloc(SpanMapLeafSize / 8, 1);
+        if (leaf == NULL)
+        {
+            unlockSmallMemory(&g_spanMapLock);
+            return false;
+        }
+        cInterlocked::storePointer((void* volatile*)&g_spanMap[root], leaf);
+    }
+    // Blocks of the span reach other threads only through a depot lock, which
+    // publishes the bit as well
+    index&= SpanMapLeafSize - 1;
+    __atomic_fetch_or(&leaf[index / 8], (uint8)(1 << (index % 8)),
+                      __ATOMIC_RELAXED);
+    unlockSmallMemory(&g_spanMapLock);
+    return true;
+}
+
+/*
+ * Return the header of a block. The span map is read before any memory
+ * around the block, because a large block can't be masked into a span.
+ */
+static SmallMemoryHeader* getHeader(void* block)
+{
+    SmallMemoryHeader* header = (SmallMemoryHeader*)((uint8*)block - HeaderSize);
+    addressNumericValue index = (addressNumericValue)block >> SpanShift;
+    addressNumericValue root = index >> SpanMapLeafBits;
+    if (root < SpanMapRootSize)
+    {
+        uint8* leaf = (uint8*)cInterlocked::loadPointer(
+                                    (void* const volatile*)&g_spanMap[root]);
+        index&= SpanMapLeafSize - 1;
+        if ((leaf != NULL) &&
+            ((__atomic_load_n(&leaf[index / 8], __ATOMIC_RELAXED) &
+              (1 << (index % 8))) != 0))
+        {
+            header = (SmallMemoryHeader*)((addressNumericValue)block &
+                ~((addressNumericValue)cSmallMemory::SpanSize - 1));
+        }
+    }
+    CHECK(header->m_magic == HeaderMagic);
+    return header;
+}
+
+static uint getBatchSize(uint sizeClass)
+{
+    uint count = BatchBytes / cSmallMemory::getSizeClassSize(sizeClass);
+    if (count < MinBatchSize)
+        return MinBatchSize;
+    if (count > MaxBatchSize)
+        return MaxBatchSize;
+    return count;
+}
+
+/*
+ * Move 'count' blocks from the head of 'list' into the depot of the class
+ */
+static void releaseBatch(SmallMemoryFreeList& list, uint sizeClass, uint count)
+{
+    void* first = list.m_head;
+    void* last = first;
+    for (uint i = 1; i < count; i++)
+        last = *(void**)last;
+    list.m_head = *(void**)last;
+    list.m_count-= count;
+
+    SmallMemoryDepot& depot = g_depots[sizeClass];
+    lockSmallMemory(&depot.m_lock);
+    *(void**)last = depot.m_list.m_head;
+    depot.m_list.m_head = first;
+    depot.m_list.m_count+= count;
+    unlockSmallMemory(&depot.m_lock);
+}
+
+/*
+ * Move a batch of blocks from the depot of the class into 'list'. Blocks are
+ * carved from the current span, and a new span is allocated, when the depot
+ * is empty.
+ */
+static void refillBatch(SmallMemoryFreeList& list, uint sizeClass)
+{
+    uint count = getBatchSize(sizeClass);
+    uint size = cSmallMemory::getSizeClassSize(sizeClass);
+    SmallMemoryDepot& depot = g_depots[sizeClass];
+
+    lockSmallMemory(&depot.m_lock);
+    // Take the returned blocks first
+    while ((count > 0) && (depot.m_list.m_head != NULL))
+    {
+        void* block = depot.m_list.m_head;
+        depot.m_list.m_head = *(void**)block;
+        depot.m_list.m_count--;
+        *(void**)block = list.m_head;
+        list.m_head = block;
+        list.m_count++;
+        count--;
+    }
+
+    while (count > 0)
+    {
+        if (depot.m_spanPosition + size > depot.m_spanEnd)
+        {
+            void* memory = NULL;
+            if ((posix_memalign(&memory, cSmallMemory::SpanSize,
+                                cSmallMemory::SpanSize) != 0) ||
+                (!registerSpan(memory)))
+            {
+                unlockSmallMemory(&depot.m_lock);
+                ::free(memory);
+                if (list.m_head != NULL)
+                    return;
+                XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+            }
+            SmallMemoryHeader* span = (SmallMemoryHeader*)memory;
+            span->m_magic = HeaderMagic;
+            span->m_sizeClass = (uint32)sizeClass;
+            span->m_size = size;
+            depot.m_spanPosition = (uint8*)memory + HeaderSize;
+            depot.m_spanEnd = (uint8*)memory + cSmallMemory::SpanSize;
+            __atomic_fetch_add(&g_reservedBytes, (uint64)cSmallMemory::SpanSize,
+                               __ATOMIC_RELAXED);
+        }
+
+        void* block = depot.m_spanPosition;
+        depot.m_spanPosition+= size;
+        *(void**)block = list.m_head;
+        list.m_head = block;
+        list.m_count++;
+        count--;
+    }
+    unlockSmallMemory(&depot.m_lock);
+}
+
+/*
+ * Return all the blocks of a cache to the depot
+ */
+static void flushCache(SmallMemoryThreadCache* cache)
+{
+    for (uint i = 0; i < cSmallMemory::SizeClassesCount; i++)
+    {
+        if (cache->m_lists[i].m_count > 0)
+            releaseBatch(cache->m_lists[i], i, cache->m_lists[i].m_count);
+    }
+}
+
+/*
+ * Called when a thread with a cache exits
+ */
+static void destroyThreadCache(void* data)
+{
+    SmallMemoryThreadCache* cache = (SmallMemoryThreadCache*)data;
+    flushCache(cache);
+
+    lockSmallMemory(&g_cachesLock);
+    // Keep the counters of the thread
+    for (uint i = 0; i < cSmallMemory::SizeClassesCount; i++)
+    {
+        g_exitedThreads.m_allocations[i]+= cache->m_allocations[i];
+        g_exitedThreads.m_frees[i]+= cache->m_frees[i];
+    }
+    g_exitedThreads.m_largeAllocatedBytes+= cache->m_largeAllocatedBytes;
+    g_exitedThreads.m_largeFreedBytes+= cache->m_largeFreedBytes;
+    g_exitedThreads.m_misses+= cache->m_misses;
+
+    if (cache->m_previous != NULL)
+        cache->m_previous->m_next = cache->m_next;
+    else
+        g_caches = cache->m_next;
+    if (cache->m_next != NULL)
+        cache->m_next->m_previous = cache->m_previous;
+    unlockSmallMemory(&g_cachesLock);
+
+    // Destructors which run after this one get a new cache
+    g_threadCache = NULL;
+    ::free(cache);
+}
+
+static void createThreadCacheKey()
+{
+    pthread_key_create(&g_threadCacheKey, destroyThreadCache);
+}
+
+/*
+ * Return the cache of the calling thread. The cache is created by the first
+ * allocation of the thread.
+ */
+static SmallMemoryThreadCache* getThreadCache()
+{
+    SmallMemoryThreadCache* cache = g_threadCache;
+    if (cache != NULL)
+        return cache;
+
+    cache = (SmallMemoryThreadCache*)calloc(1, sizeof(SmallMemoryThreadCache));
+    if (cache == NULL)
+    {
+        XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+    }
+    pthread_once(&g_threadCacheKeyOnce, createThreadCacheKey);
+    pthread_setspecific(g_threadCacheKey, cache);
+
+    lockSmallMemory(&g_cachesLock);
+    cache->m_next = g_caches;
+    if (g_caches != NULL)
+        g_caches->m_previous = cache;
+    g_caches = cache;
+    unlockSmallMemory(&g_cachesLock);
+
+    g_threadCache = cache;
+    return cache;
+}
+
+uint cSmallMemory::getSizeClass(uint size)
+{
+    if (size <= 1024)
+        return (size == 0) ? 0 : (uint)((size - 1) >> 4);
+
+    // Four classes between every two powers of two
+    uint bit = 63 - __builtin_clzll((unsigned long long)(size - 1));
+    return (uint)(60 + (bit - 10) * 4 + ((size - 1) >> (bit - 2)));
+}
+
+uint cSmallMemory::getSizeClassSize(uint sizeClass)
+{
+    if (sizeClass < 64)
+        return (sizeClass + 1) * 16;
+
+    uint base = 1024 << ((sizeClass - 64) / 4);
+    return base + ((sizeClass - 64) % 4 + 1) * (base / 4);
+}
+
+void* cSmallMemory::allocate(uint size)
+{
+    SmallMemoryThreadCache* cache = getThreadCache();
+    if (size > MaxSmallSize)
+    {
+        SmallMemoryHeader* header = NULL;
+        if (size <= MAX_UINT - HeaderSize)
+            header = (SmallMemoryHeader*)malloc(HeaderSize + size);
+        if (header == NULL)
+        {
+            XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+        }
+        ASSERT(((addressNumericValue)header % Alignment) == 0);
+        header->m_magic = HeaderMagic;
+        header->m_sizeClass = LargeClass;
+        header->m_size = size;
+        addCounter(&cache->m_largeAllocatedBytes, size);
+        return (uint8*)header + HeaderSize;
+    }
+
+    uint sizeClass = getSizeClass(size);
+    SmallMemoryFreeList& list = cache->m_lists[sizeClass];
+    if (list.m_head == NULL)
+    {
+        refillBatch(list, sizeClass);
+        addCounter(&cache->m_misses, 1);
+    }
+
+    void* block = list.m_head;
+    list.m_head = *(void**)block;
+    list.m_count--;
+    addCounter(&cache->m_allocations[sizeClass], 1);
+    return block;
+}
+
+void cSmallMemory::free(void* block)
+{
+    if (block == NULL)
+        return;
+
+    SmallMemoryHeader* header = getHeader(block);
+    SmallMemoryThreadCache* cache = getThreadCache();
+    if (header->m_sizeClass == LargeClass)
+    {
+        addCounter(&cache->m_largeFreedBytes, header->m_size);
+        header->m_magic = 0;
+        ::free(header);
+        return;
+    }
+
+    uint sizeClass = header->m_sizeClass;
+    SmallMemoryFreeList& list = cache->m_lists[sizeClass];
+    *(void**)block = list.m_head;
+    list.m_head = block;
+    list.m_count++;
+    addCounter(&cache->m_frees[sizeClass], 1);
+
+    // Give the other threads a batch
+    uint batchSize = getBatchSize(sizeClass);
+    if (list.m_count > batchSize * 2)
+        releaseBatch(list, sizeClass, batchSize);
+}
+
+void* cSmallMemory::reallocate(void* block,
+                               uint newSize,
+                               bool preserveMemory)
+{
+    if (block == NULL)
+        return allocate(newSize);
+    if (newSize == 0)
+    {
+        free(block);
+        return NULL;
+    }
+
+    SmallMemoryHeader* header = getHeader(block);
+    uint oldSize = header->m_size;
+    if (header->m_sizeClass == LargeClass)
+    {
+        if ((newSize > MaxSmallSize) && (newSize <= MAX_UINT - HeaderSize))
+        {
+            // The system heap may grow or shrink the block in place
+            SmallMemoryHeader* newHeader =
+                (SmallMemoryHeader*)realloc(header, HeaderSize + newSize);
+            if (newHeader == NULL)
+            {
+                XSTL_THROW(cException, EXCEPTION_OUT_OF_MEM);
+            }
+            SmallMemoryThreadCache* cache = getThreadCache();
+            addCounter(&cache->m_largeFreedBytes, oldSize);
+            addCounter(&cache->m_largeAllocatedBytes, newSize);
+            newHeader->m_size = newSize;
+            return (uint8*)newHeader + HeaderSize;
+        }
+    } else if ((newSize <= MaxSmallSize) &&
+               (getSizeClass(newSize) == header->m_sizeClass))
+    {
+        return block;
+    }
+
+    void* ret = allocate(newSize);
+    if (preserveMemory)
+        ::memcpy(ret, block, (oldSize < newSize) ? oldSize : newSize);
+    free(block);
+    return ret;
+}
+
+void cSmallMemory::flushThreadCache()
+{
+    if (g_threadCache != NULL)
+        flushCache(g_threadCache);
+}
+
+void cSmallMemory::getStatistics(Statistics& statistics)
+{
+    int64 blocks[SizeClassesCount];
+    uint64 allocations = 0;
+    uint i;
+    lockSmallMemory(&g_cachesLock);
+    for (i = 0; i < SizeClassesCount; i++)
+    {
+        blocks[i] = (int64)(g_exitedThreads.m_allocations[i] -
+                            g_exitedThreads.m_frees[i]);
+        allocations+= g_exitedThreads.m_allocations[i];
+    }
+    int64 largeBytes = (int64)(g_exitedThreads.m_largeAllocatedBytes -
+                               g_exitedThreads.m_largeFreedBytes);
+    uint64 misses = g_exitedThreads.m_misses;
+
+    for (SmallMemoryThreadCache* cache = g_caches; cache != NULL;
+         cache = cache->m_next)
+    {
+        // Read the misses first, so they never exceed the allocations
+        misses+= readCounter(&cache->m_misses);
+        for (i = 0; i < SizeClassesCount; i++)
+        {
+            uint64 threadAllocations = readCounter(&cache->m_allocations[i]);
+            blocks[i]+= (int64)(threadAllocations -
+                                readCounter(&cache->m_frees[i]));
+            allocations+= threadAllocations;
+        }
+        largeBytes+= (int64)(readCounter(&cache->m_largeAllocatedBytes) -
+                             readCounter(&cache->m_largeFreedBytes));
+    }
+    unlockSmallMemory(&g_cachesLock);
+
+    // A block may be freed by another thread while the counters are read
+    for (i = 0; i < SizeClassesCount; i++)
+        statistics.m_bytesInUse[i] = (blocks[i] < 0) ? 0 :
+                                     (uint64)blocks[i] * getSizeClassSize(i);
+    statistics.m_largeBytesInUse = (largeBytes < 0) ? 0 : (uint64)largeBytes;
+    statistics.m_reservedBytes = __atomic_load_n(&g_reservedBytes,
+                                                 __ATOMIC_RELAXED);
+    // Every small allocation which didn't refill the cache is a hit
+    statistics.m_cacheMisses = misses;
+    statistics.m_cacheHits = allocations - misses;
+}
+
+double cSmallMemory::Statistics::getCacheHitRatio() const
+{
+    uint64 total = m_cacheHits + m_cacheMisses;
+    if (total == 0)
+        return 0;
+    return (double)m_cacheHits / (double)total;
+}
+
+#endif // XSTL_LINUX
@@ -130,6 +130,15 @@ void cOS::sleepMicroseconds(uint microseconds)
     ::Sleep(microseconds / 1000);
 }
 
+uint cOS::getNumberOfProcessors()
+{
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    if (info.dwNumberOfProcessors < 1)
+        return 1;
+    return info.dwNumberOfProcessors;
+}
+
 cOSDef::systemTime cOS::getSystemTime()
 {
     FILETIME localTime;
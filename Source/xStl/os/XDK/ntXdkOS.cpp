@@ -144,6 +144,11 @@ void cOS::sleepMicroseconds(uint microseconds)
     }
 }
 
+uint cOS::getNumberOfProcessors()
+{
+    return (uint)KeNumberProcessors;
+}
+
 cOSDef::systemTime cOS::getSystemTime()
 {
     LARGE_INTEGER currentTime;
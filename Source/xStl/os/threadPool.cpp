@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * threadPool.cpp
+ *
+ * Implementation file
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/except/trace.h"
+#include "xStl/except/exception.h"
+#include "xStl/os/os.h"
+#include "xStl/os/interlocked.h"
+#include "xStl/os/threadPool.h"
+#include "xStl/stream/traceStream.h"
+
+cThreadPool* volatile cThreadPool::m_default = NULL;
+
+/*
+ * Stops the workers of the default pool when the process exits, before the
+ * static objects which the tasks may use are destroyed.
+ */
+class cDefaultThreadPoolDestroyer
+{
+public:
+    ~cDefaultThreadPoolDestroyer()
+    {
+        cThreadPool::destroyDefault();
+    }
+};
+static cDefaultThreadPoolDestroyer g_defaultThreadPoolDestroyer;
+
+cThreadPool::cWorker::cWorker(cThreadPool& pool) :
+    m_pool(pool)
+{
+}
+
+void cThreadPool::cWorker::run()
+{
+    while (true)
+    {
+        m_wakeUp.wait();
+        m_wakeUp.resetEvent();
+        if (m_pool.m_shouldStop)
+            return;
+
+        m_pool.runTasks();
+
+        // The last worker wakes the thread which waits for the job
+        if (cInterlocked::decrement(&m_pool.m_activeWorkers) == 0)
+            m_pool.m_done.setEvent();
+    }
+}
+
+cThreadPool::cThreadPool(uint workersCount /* = 0 */) :
+    m_isBusy(0),
+    m_task(NULL),
+    m_tasksCount(0),
+    m_nextTask(0),
+    m_activeWorkers(0),
+    m_isFailed(false),
+    m_shouldStop(false)
+{
+    if (workersCount == 0)
+        workersCount = cOS::getNumberOfProcessors() - 1;
+
+    m_workers.changeSize(workersCount);
+    uint i;
+    for (i = 0; i < workersCount; i++)
+        m_workers[i] = NULL;
+    for (i = 0; i < workersCount; i++)
+    {
+        m_workers[i] = new cWorker(*this);
+        m_workers[i]->start();
+    }
+}
+
+cThreadPool::~cThreadPool()
+{
+    m_shouldStop = true;
+    uint i;
+    for (i = 0; i < m_workers.getSize(); i++)
+    {
+        if (m_workers[i] != NULL)
+            m_workers[i]->m_wakeUp.setEvent();
+    }
+    for (i = 0; i < m_workers.getSize(); i++)
+    {
+        if (m_workers[i] != NULL)
+        {
+            m_workers[i]->wait();
+            delete m_workers[i];
+        }
+    }
+}
+
+uint cThreadPool::getConcurrency() const
+{
+    return m_workers.getSize() + 1;
+}
+
+void cThreadPool::execute(cTask& task, uint tasksCount)
+{
+    CHECK(tasksCount < 0x7FFFFFFF);
+    if (tasksCount == 0)
+        return;
+
+    // A single task, or a busy pool, are executed by the calling thread
+    if ((tasksCount == 1) || (m_workers.getSize() == 0) ||
+        (cInterlocked::compareExchange(&m_isBusy, 1, 0) != 0))
+    {
+        for (uint i = 0; i < tasksCount; i++)
+            task.runTask(i);
+        return;
+    }
+
+    m_task = &task;
+    m_tasksCount = (counter_t)tasksCount;
+    m_nextTask = 0;
+    m_isFailed = false;
+
+    // Wake the workers. There is no need for more workers than tasks.
+    uint workers = t_min(m_workers.getSize(), tasksCount - 1);
+    m_activeWorkers = (counter_t)workers;
+    m_done.resetEvent();
+    uint i;
+    for (i = 0; i < workers; i++)
+        m_workers[i]->m_wakeUp.setEvent();
+
+    runTasks();
+    m_done.wait();
+
+    bool isFailed = m_isFailed;
+    m_task = NULL;
+    cInterlocked::exchange(&m_isBusy, 0);
+
+    if (isFailed)
+    {
+        XSTL_THROW(cException, EXCEPTION_FAILED);
+    }
+}
+
+void cThreadPool::runTasks()
+{
+    while (!m_isFailed)
+    {
+        counter_t index = cInterlocked::increment(&m_nextTask) - 1;
+        if (index >= m_tasksCount)
+            break;
+
+        XSTL_TRY
+        {
+            m_task->runTask((uint)index);
+        }
+        XSTL_CATCH(cException& e)
+        {
+            traceHigh("ThreadPool: Exception " << e.getMessage() << "(" <<
+                                                  e.getID() << ")" <<
+                                                  " throwed " << endl);
+            m_isFailed = true;
+        }
+        XSTL_CATCH_ALL
+        {
+            // The worker must survive the task, or execute() waits forever.
+            // The pool threads are never canceled, so there is no forced
+            // unwinding to catch here.
+            traceHigh("ThreadPool: Unknown exception throwed" << endl);
+            m_isFailed = true;
+        }
+    }
+}
+
+cThreadPool& cThreadPool::getDefault()
+{
+    cThreadPool* pool = (cThreadPool*)cInterlocked::loadPointer(
+                                                (void* const volatile*)&m_default);
+    if (pool != NULL)
+        return *pool;
+
+    // Two threads might create a pool at the same time, only one is kept
+    pool = new cThreadPool();
+    if (cInterlocked::compareExchangePointer((void* volatile*)&m_default,
+                                             pool, NULL) != NULL)
+    {
+        delete pool;
+    }
+    return *(cThreadPool*)cInterlocked::loadPointer(
+                                            (void* const volatile*)&m_default);
+}
+
+void cThreadPool::destroyDefault()
+{
+    cThreadPool* pool = (cThreadPool*)cInterlocked::exchangePointer(
+                                            (void* volatile*)&m_default, NULL);
+    if (pool != NULL)
+        delete pool;
+}
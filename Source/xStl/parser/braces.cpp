@@ -69,8 +69,8 @@ Braces::Braces(character braces) :
 
 bool Braces::eatCharacter(character data)
 {
-    // Tests that the list isn't empty
-    ASSERT(m_state.begin() != m_state.end());
+    // Tests that the stack isn't empty
+    ASSERT(!m_state.isEmpty());
 
     if (isOpenBrace(data))
     {
@@ -88,20 +88,15 @@ bool Braces::eatCharacter(character data)
         }
 
         // Pop the last braces
-        cList<character>::iterator i = m_state.end();
-        i.prev();
-        ASSERT((*i) == m_stateCache);
-        if (m_state.begin() == i)
+        ASSERT(m_state.getLast() == m_stateCache);
+        m_state.removeLast();
+        if (m_state.isEmpty())
         {
             // end of the block
-            m_state.remove(i);
             return true;
         }
 
-        cList<character>::iterator j = i;
-        j.prev();
-        m_state.remove(i);
-        m_stateCache = *j;
+        m_stateCache = m_state.getLast();
     }
 
     // Nothing to do
@@ -174,8 +169,8 @@ character Braces::getCloseCharacter(character open)
 
 character Braces::getNextCloserCharacer()
 {
-    // Tests that the list isn't empty
-    ASSERT(m_state.begin() != m_state.end());
+    // Tests that the stack isn't empty
+    ASSERT(!m_state.isEmpty());
 
     return getCloseCharacter(m_stateCache);
 }
@@ -43,6 +43,7 @@
 #include "xStl/data/array.h"
 #include "xStl/data/string.h"
 #include "xStl/data/char.h"
+#include "xStl/data/numberConversion.h"
 #include "xStl/parser/parser.h"
 #include "xStl/parser/braces.h"
 
@@ -183,28 +184,35 @@ cString Parser::getBlanks()
 
 cString Parser::readWord()
 {
-    cString ret;
+    return cString(readWordView());
+}
 
+cAsciiStringView Parser::readWordView()
+{
     if (isEOS())
-        return ret;
+        return cAsciiStringView();
     char ch = peekChar();
 
     PARSER_INTERNAL_CHECK(!cChar::isBlanket(ch), "Letter was excpected");
 
-    while ((!cChar::isBlanket(ch)) &&
-           (!cChar::isNewLine(ch)))
+    // A word never contains a new-line, so the line-number is not changed
+    const char* start = m_pointer;
+    while ((!internalIsEOS(m_pointer)) &&
+           (!cChar::isBlanket(*m_pointer)) &&
+           (!cChar::isNewLine(*m_pointer)))
     {
-        readChar();
-        ret+= ch;
-        if (isEOS())
-            break;
-        ch = peekChar();
+        m_pointer++;
     }
 
-    return ret;
+    return cAsciiStringView(start, (uint)(m_pointer - start));
 }
 
 cString Parser::readCString(bool isFirstLetter)
+{
+    return cString(readCStringView(isFirstLetter));
+}
+
+cAsciiStringView Parser::readCStringView(bool isFirstLetter)
 {
     char ch = readChar();
     // The first character must be a letter
@@ -213,22 +221,18 @@ cString Parser::readCString(bool isFirstLetter)
         PARSER_INTERNAL_CHECK(cChar::isLetter(ch) || (ch == '_'), "Letter was excpected");
     }
 
-    // Read the string
-    cString ret(ch);
-
-    if (!isEOS()) do
+    // Read the string. The rest of the characters are never new-lines, so the
+    // line-number is not changed
+    const char* start = m_pointer - 1;
+    while ((!internalIsEOS(m_pointer)) &&
+           (cChar::isLetter(*m_pointer) ||
+            cChar::isDigit(*m_pointer) ||
+            (*m_pointer == '_')))
     {
-        ch = peekChar();
-        if (cChar::isLetter(ch) ||
-            cChar::isDigit(ch) ||
-            (ch == '_'))
-        {
-            ret+= (character)readChar();
-        } else
-            break;
-    } while (!isEOS());
+        m_pointer++;
+    }
 
-    return ret;
+    return cAsciiStringView(start, (uint)(m_pointer - start));
 }
 
 cString Parser::readQuateString(bool isCString)
@@ -328,11 +332,10 @@ bool Parser::isCUnsignedInteger(uint* retNumber,
     if (shouldAdvancePosition)
         object = this;
 
-    // Flags which marks wheter the base of the number is 16.
-    bool isHex = false;
     // Test the first character special marks
-    cString number = object->readCString(false);
+    cAsciiStringView number = object->readCStringView(false);
     uint i = 0;
+    uint base = 10;
     if (number[0] == '0')
     {
         // Test that the number is not zero
@@ -346,78 +349,63 @@ bool Parser::isCUnsignedInteger(uint* retNumber,
         if (number[1] != 'x')
             return false; // PARSER_INTERNAL_CHECK "Hexdecimal number was excpected"
         i = 2;
-        isHex = true;
+        base = 16;
     }
 
     // Try to read CUnsignedInteger
-    uint ret = 0;
-    uint base = isHex ? 16 : 10;
-    for (; i < number.length(); i++)
+    uint64 ret;
+    uint parsedLength;
+    if (!cNumberConversion::parseUnsigned(number.getBuffer() + i,
+                                          number.length() - i,
+                                          base,
+                                          ret,
+                                          parsedLength,
+                                          MAX_UINT))
     {
-        character nextDigit = cChar::getUppercase(number[i]);
-        if (cChar::isLetter(nextDigit))
-        {
-            // Test 64-bit number reading
-            if (nextDigit == 'L')
-            {
-                if (i != (number.length() - 1))
-                    return false; // PARSER_INTERNAL_CHECK("Long number invalid position");
-                // Stop scan and return value.
-                break;
-            }
+        return false; // PARSER_INTERNAL_CHECK("Digit out of range") or overflow
+    }
+    i+= parsedLength;
 
-            // Hex number
-            if (!(isHex && (nextDigit >= 'A') && (nextDigit <= 'F')))
-                return false; // PARSER_INTERNAL_CHECK("Digit out of range");
-            // TODO! Check for overflow
-            ret*= base;
-            ret+= nextDigit - 'A' + 10;
-        } else
+    // Test 64-bit number reading
+    if (i != number.length())
+    {
+        if ((i != (number.length() - 1)) ||
+            (cChar::getUppercase(number[i]) != 'L'))
         {
-            if (!cChar::isDigit(nextDigit))
-                return false;
-            // TODO! Check for overflow
-            ret*= base;
-            ret+= cChar::getDigit(nextDigit);
+            return false; // PARSER_INTERNAL_CHECK("Long number invalid position");
         }
     }
 
     // Check for return value
     if (retNumber != NULL)
-        *retNumber = ret;
+        *retNumber = (uint)ret;
     return true;
 }
 
 uint Parser::readHexString()
 {
     // Test the first character special marks
-    cString number = readCString(false);
-
-    uint ret = 0;
-    for (uint i = 0; i < number.length(); i++)
+    cAsciiStringView number = readCStringView(false);
+
+    uint64 ret;
+    uint parsedLength;
+    PARSER_INTERNAL_CHECK(cNumberConversion::parseUnsigned(number.getBuffer(),
+                                                           number.length(),
+                                                           16,
+                                                           ret,
+                                                           parsedLength,
+                                                           MAX_UINT),
+                          "Hexdecimal number was excpected");
+
+    // Test 64-bit number reading
+    if (parsedLength != number.length())
     {
-        character nextDigit = cChar::getUppercase(number[i]);
-        if (cChar::isLetter(nextDigit))
-        {
-            // Test 64-bit number reading
-            if ((nextDigit == 'L') || (nextDigit == 'H'))
-            {
-                PARSER_INTERNAL_CHECK(i == (number.length() - 1), "Long number invalid position");
-                return ret;
-            }
-
-            // Hex number
-            PARSER_INTERNAL_CHECK((nextDigit >= 'A') && (nextDigit <= 'F'), "Digit out of range");
-            ret*= 16;
-            ret+= nextDigit - 'A' + 10;
-        } else
-        {
-            ret*= 16;
-            ret+= cChar::getDigit(nextDigit);
-        }
+        character suffix = cChar::getUppercase(number[parsedLength]);
+        PARSER_INTERNAL_CHECK((suffix == 'L') || (suffix == 'H'), "Digit out of range");
+        PARSER_INTERNAL_CHECK(parsedLength == (number.length() - 1), "Long number invalid position");
     }
 
-    return ret;
+    return (uint)ret;
 }
 
 bool Parser::readSignedValue()
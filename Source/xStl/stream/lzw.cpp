@@ -40,6 +40,7 @@
 #include "xStl/types.h"
 #include "xStl/os/os.h"
 #include "xStl/data/array.h"
+#include "xStl/data/deque.h"
 #include "xStl/data/smartptr.h"
 #include "xStl/except/assert.h"
 #include "xStl/except/exception.h"
@@ -320,9 +321,9 @@ uint cLZWcompression::read(void *buffer, const uint length)
     unsigned int  retv = 0;
 
     /* Write out all old-information */
-    while (m_readed_codes.begin() != m_readed_codes.end())
+    while (!m_readed_codes.isEmpty())
     {
-        unsigned int resolved = *(m_readed_codes.begin());
+        unsigned int resolved = m_readed_codes.getFirst();
         XSTL_TRY
         {
             bits_pipe.writeBits(resolved, (uint8)m_bitSize);
@@ -332,8 +333,7 @@ uint cLZWcompression::read(void *buffer, const uint length)
             /* End of length */
             return copyStream(bits_pipe, mem, buffer);
         }
-        cList<unsigned int>::iterator start = m_readed_codes.begin();
-        m_readed_codes.remove(start);
+        m_readed_codes.removeFirst();
     }
 
     /* EOF reached */
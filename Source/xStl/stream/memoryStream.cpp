@@ -49,7 +49,7 @@ cMemoryStream::cMemoryStream(uint pageSize  /* = DEFAULT_STREAM_PAGE_SIZE*/,
                              bool fixedSize /* = false */) :
     m_fixedSize(fixedSize),
     m_filePosition(0),
-    m_data(new cBuffer(initSize, pageSize))
+    m_data(makeSmartPtr<cBuffer>(initSize, pageSize))
 {
     initSeek();
 }
@@ -59,7 +59,8 @@ cMemoryStream::cMemoryStream(const cBuffer& initData,
                              bool fixedSize   /* = false */) :
     m_fixedSize(fixedSize),
     m_filePosition(0),
-    m_data(new cBuffer(initData.getBuffer(), initData.getSize(), pageSize))
+    m_data(makeSmartPtr<cBuffer>(initData.getBuffer(), initData.getSize(),
+                                 pageSize))
 {
     initSeek();
 }
@@ -175,7 +176,7 @@ void cMemoryStream::seek(const int distance, const basicInput::seekMethod method
 cMemoryStream::cMemoryStream(const cMemoryStream& other) :
     m_fixedSize(other.m_fixedSize),
     m_filePosition(other.m_filePosition),
-    m_data(new cBuffer(*other.m_data))
+    m_data(makeSmartPtr<cBuffer>(*other.m_data))
 {
     initSeek();
 }
@@ -41,6 +41,7 @@
 #include "xStl/os/lock.h"
 #include "xStl/data/array.h"
 #include "xStl/data/string.h"
+#include "xStl/data/stringBuilder.h"
 #include "xStl/data/datastream.h"
 #include "xStl/utils/algorithm.h"
 #include "xStl/except/exception.h"
@@ -246,3 +247,14 @@ void cStringStream::outputString(const cString& string)
 {
     m_data+= string;
 }
+
+cStringBuilderStream::cStringBuilderStream(cStringBuilder& builder) :
+    cStringerStream(false),
+    m_builder(builder)
+{
+}
+
+void cStringBuilderStream::outputString(const cString& string)
+{
+    m_builder.append(string);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_arena.cpp
+ *
+ * Build and tear down a large tree, once with heap nodes which are deleted one
+ * by one, and once with nodes (and the arrays of their children) inside a
+ * cArena which is released with a single freeAll().
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/arena.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkArena : public cBenchmarkObject
+{
+public:
+    enum { Nodes = 10000000,
+           Degree = 4 };
+
+    // A node of the tree
+    class cNode
+    {
+    public:
+        cNode(uint value, cArena* arena) : m_value(value)
+        {
+            if (arena != NULL)
+                m_children.setAllocator(arena);
+        }
+
+        // Heap trees delete their children, arena trees are released at once
+        void destroy()
+        {
+            for (uint i = 0; i < m_children.getSize(); i++)
+            {
+                m_children[i]->destroy();
+                delete m_children[i];
+            }
+        }
+
+        uint sum() const
+        {
+            uint ret = m_value;
+            for (uint i = 0; i < m_children.getSize(); i++)
+                ret+= m_children[i]->sum();
+            return ret;
+        }
+
+        cArray<cNode*> m_children;
+        uint m_value;
+    };
+
+    // Build a tree of 'Nodes' nodes. Node i is a child of node (i-1)/Degree
+    static cNode* build(cArray<cNode*>& nodes, cArena* arena)
+    {
+        nodes.changeSize(Nodes, false);
+        for (uint i = 0; i < Nodes; i++)
+        {
+            if (arena != NULL)
+                nodes[i] = new (*arena) cNode(i, arena);
+            else
+                nodes[i] = new cNode(i, NULL);
+            if (i != 0)
+                nodes[(i - 1) / Degree]->m_children.append(nodes[i]);
+        }
+        return nodes[0];
+    }
+
+    static void measure(const char* name, cArena* arena)
+    {
+        uint64 allocations = getAllocationsCount();
+        cBenchmarkTimer timer;
+        cNode* root;
+        {
+            cArray<cNode*> nodes;
+            root = build(nodes, arena);
+        }
+        uint64 buildTime = timer.getMilliseconds();
+        allocations = getAllocationsCount() - allocations;
+        uint checksum = root->sum();
+
+        timer.start();
+        if (arena != NULL)
+        {
+            arena->freeAll();
+        } else
+        {
+            root->destroy();
+            delete root;
+        }
+        uint64 destroyTime = timer.getMilliseconds();
+
+        cout << "  " << name << buildTime << "          " << destroyTime
+             << "            " << allocations << "   (" << checksum << ")"
+             << endl;
+    }
+
+    virtual void run()
+    {
+        cout << "  tree of " << Nodes << " nodes, " << Degree
+             << " children per node" << endl;
+        cout << "  memory      build(ms)  teardown(ms)  operator new calls"
+             << endl;
+        measure("heap        ", NULL);
+        cArena arena(1024 * 1024);
+        measure("cArena      ", &arena);
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkArena g_globalBenchmarkArena;
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_array.cpp
+ *
+ * Measure the growth policy of cArray by appending 10M bytes, one at a time,
+ * into a cBuffer, a cBuffer with legacy growth and a reserved cBuffer, and by
+ * appending characters into a cString.
+ *
+ * The copy throughput of the plain-old-data storage (memcpy/realloc) is
+ * compared against the element-by-element storage in GB/s.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+// A byte with a constructor, forces cArray into element-by-element storage
+class cByte
+{
+public:
+    cByte() : m_value(0) {}
+    cByte(uint8 value) : m_value(value) {}
+    uint8 m_value;
+};
+
+class cBenchmarkArray : public cBenchmarkObject
+{
+public:
+    // Print the throughput of 'bytes' bytes handled in 'microseconds'
+    static void printThroughput(const char* name, uint64 bytes,
+                                uint64 microseconds)
+    {
+        uint64 mbPerSecond = (microseconds == 0) ? 0 :
+                             (bytes / microseconds);
+        cout << "  " << name << ": " << (uint32)(mbPerSecond / 1000) << "."
+             << (uint32)((mbPerSecond % 1000) / 100) << " GB/s" << endl;
+    }
+
+    // Append and copy ranges of a 'chunk' elements array into a 64MB array
+    template <class ArrayType>
+    void measureThroughput(const char* appendName, const char* rangeName,
+                           uint32 chunk)
+    {
+        enum { TotalBytes = 64 * 1024 * 1024 };
+        uint32 i;
+        ArrayType source;
+        for (i = 0; i < chunk; i++)
+            source.append((uint8)i);
+
+        cBenchmarkTimer timer;
+        ArrayType destination;
+        for (i = 0; i < TotalBytes / chunk; i++)
+            destination.append(source);
+        printThroughput(appendName, TotalBytes, timer.getMicroseconds());
+
+        timer.start();
+        ArrayType range;
+        uint32 ranges = TotalBytes / chunk;
+        for (i = 0; i < ranges; i++)
+            range.copyRange(destination, (i * chunk) % (TotalBytes - chunk),
+                            chunk);
+        printThroughput(rangeName, TotalBytes, timer.getMicroseconds());
+    }
+
+    // Without geometric growth every append copies the whole buffer, limit
+    // the legacy measurement so it completes in a reasonable time.
+    enum { MaxLegacyAppends = 100000 };
+
+    void measure(const char* name, cBuffer& buffer, uint32 count)
+    {
+        uint32 reallocations = 0;
+        uint capacity = buffer.getCapacity();
+        cBenchmarkTimer timer;
+        for (uint32 i = 0; i < count; i++)
+        {
+            buffer.append((uint8)i);
+            if (buffer.getCapacity() != capacity)
+            {
+                capacity = buffer.getCapacity();
+                reallocations++;
+            }
+        }
+        uint64 appendTime = timer.getMicroseconds();
+
+        cout << "  " << name << " " << count << " bytes: " << appendTime
+             << " us, " << reallocations << " reallocations, capacity "
+             << buffer.getCapacity() << endl;
+    }
+
+    virtual void run()
+    {
+        static const uint32 sizes[] = { MaxLegacyAppends, 10000000 };
+        for (uint i = 0; i < arraysize(sizes); i++)
+        {
+            uint32 count = sizes[i];
+            if (count <= MaxLegacyAppends)
+            {
+                cBuffer legacy;
+                legacy.setGrowthFactor(cBuffer::NoGrowth);
+                measure("cBuffer (no growth)", legacy, count);
+            } else
+            {
+                cout << "  cBuffer (no growth) " << count
+                     << " bytes: skipped (quadratic)" << endl;
+            }
+
+            cBuffer geometric;
+            measure("cBuffer            ", geometric, count);
+
+            cBuffer reserved;
+            reserved.reserve(count);
+            measure("cBuffer+reserve    ", reserved, count);
+
+            cBenchmarkTimer timer;
+            cString string;
+            for (uint32 j = 0; j < count; j++)
+                string+= (character)('a' + (j % 26));
+            cout << "  cString             " << count << " chars: "
+                 << timer.getMicroseconds() << " us" << endl;
+        }
+
+        static const uint32 chunks[] = { 64, 4096 };
+        for (uint j = 0; j < arraysize(chunks); j++)
+        {
+            cout << "  " << chunks[j] << " bytes chunks:" << endl;
+            measureThroughput<cBuffer>("  cBuffer append         ",
+                                       "  cBuffer copyRange      ",
+                                       chunks[j]);
+            measureThroughput<cArray<uint8> >("  cArray<uint8> append   ",
+                                              "  cArray<uint8> copyRange",
+                                              chunks[j]);
+            measureThroughput<cArray<cByte> >("  cArray<cByte> append   ",
+                                              "  cArray<cByte> copyRange",
+                                              chunks[j]);
+        }
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkArray g_globalBenchmarkArray;
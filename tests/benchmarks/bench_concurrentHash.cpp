@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_concurrentHash.cpp
+ *
+ * Measure the throughput of a shared symbol-cache like map under 1, 2, 4, 8
+ * and 16 threads, with 90% look-ups and 10% updates. Compares cHash protected
+ * by a single cMutex with the cConcurrentHash.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/hash.h"
+#include "xStl/data/concurrentHash.h"
+#include "xStl/os/mutex.h"
+#include "xStl/os/lock.h"
+#include "xStl/os/threadedClass.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+/*
+ * cHash wrapped by a mutex, which is the way the hash was shared so far.
+ */
+class cLockedHash
+{
+public:
+    // The table has enough lists, so the mutex is the bottleneck and not the
+    // link-lists length
+    cLockedHash() : m_hash(1 << 17) {}
+
+    void insertOrAssign(uint32 index, uint32 data)
+    {
+        cLock lock(m_lock);
+        m_hash.insertOrAssign(index, data);
+    }
+
+    bool tryGet(uint32 index, uint32& data)
+    {
+        cLock lock(m_lock);
+        const uint32* ret;
+        if (!m_hash.tryGet(index, ret))
+            return false;
+        data = *ret;
+        return true;
+    }
+
+private:
+    cMutex m_lock;
+    cHash<uint32, uint32> m_hash;
+};
+
+/*
+ * A worker thread. Every 10th operation is an update.
+ */
+template <class MapType>
+class cMapWorker : public cThreadedClass
+{
+public:
+    cMapWorker(MapType& map, uint32 seed, uint32 operations, uint32 keys) :
+        m_map(map), m_seed(seed), m_operations(operations), m_keys(keys),
+        m_found(0)
+    {
+    }
+
+    virtual void run()
+    {
+        // Xorshift random generator
+        uint32 random = m_seed;
+        uint32 found = 0;
+        for (uint32 i = 0; i < m_operations; i++)
+        {
+            random^= random << 13;
+            random^= random >> 17;
+            random^= random << 5;
+            uint32 key = random % m_keys;
+            if ((i % 10) == 0)
+            {
+                m_map.insertOrAssign(key, i);
+            } else
+            {
+                uint32 data;
+                if (m_map.tryGet(key, data))
+                    found++;
+            }
+        }
+        m_found = found;
+    }
+
+    MapType& m_map;
+    uint32 m_seed;
+    uint32 m_operations;
+    uint32 m_keys;
+    volatile uint32 m_found;
+};
+
+class cBenchmarkConcurrentHash : public cBenchmarkObject
+{
+public:
+    enum {
+        // The number of symbols in the cache
+        KEYS = 100000,
+        // The total number of operations, divided between the threads
+        OPERATIONS = 4000000,
+        // The maximum number of threads
+        MAX_THREADS = 16
+    };
+
+    template <class MapType>
+    void measure(const char* name, MapType& map, uint32 threadsCount)
+    {
+        uint32 i;
+        for (i = 0; i < KEYS; i++)
+            map.insertOrAssign(i, i);
+
+        cMapWorker<MapType>* workers[MAX_THREADS];
+        for (i = 0; i < threadsCount; i++)
+            workers[i] = new cMapWorker<MapType>(map, (i + 1) * 2654435761U,
+                                                 OPERATIONS / threadsCount, KEYS);
+
+        cBenchmarkTimer timer;
+        for (i = 0; i < threadsCount; i++)
+            workers[i]->start();
+        for (i = 0; i < threadsCount; i++)
+            workers[i]->wait();
+        uint64 time = timer.getMicroseconds();
+
+        for (i = 0; i < threadsCount; i++)
+            delete workers[i];
+
+        cout << "  " << name << " " << threadsCount << " threads: " << time
+             << " us, " << (uint64)OPERATIONS * 1000000 / (time + 1)
+             << " operations/sec" << endl;
+    }
+
+    virtual void run()
+    {
+        for (uint32 threads = 1; threads <= MAX_THREADS; threads*= 2)
+        {
+            cLockedHash locked;
+            measure("cHash+cMutex   ", locked, threads);
+
+            cConcurrentHash<uint32, uint32> concurrent;
+            measure("cConcurrentHash", concurrent, threads);
+        }
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkConcurrentHash g_globalBenchmarkConcurrentHash;
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_deque.cpp
+ *
+ * Compare cDeque with cList on the workloads of their internal users: a
+ * queue of 10M elements (cLZWcompression), a stack which grows and shrinks
+ * (Braces) and appending and scanning small sequences (the neighbors of the
+ * cGraph nodes).
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/list.h"
+#include "xStl/data/deque.h"
+#include "xStl/data/graph.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkDeque : public cBenchmarkObject
+{
+public:
+    enum { Elements = 10000000,
+           StackRounds = 200000,
+           GraphNodes = 2000,
+           GraphEdges = 40000 };
+
+    // Print the time of a workload
+    static void report(const char* name, const cBenchmarkTimer& timer)
+    {
+        cout << "  " << name << ": " << timer.getMilliseconds() << " ms"
+             << endl;
+    }
+
+    // Append, scan and empty a queue
+    static uint64 queueList()
+    {
+        uint64 checksum = 0;
+        cList<uint32> queue;
+        uint i;
+        for (i = 0; i < Elements; i++)
+            queue.append(i);
+        cList<uint32>::iterator end = queue.end();
+        for (cList<uint32>::iterator j = queue.begin(); j != end; ++j)
+            checksum+= *j;
+        while (!queue.isEmpty())
+        {
+            cList<uint32>::iterator first = queue.begin();
+            checksum+= *first;
+            queue.remove(first);
+        }
+        return checksum;
+    }
+
+    static uint64 queueDeque()
+    {
+        uint64 checksum = 0;
+        cDeque<uint32> queue;
+        uint i;
+        for (i = 0; i < Elements; i++)
+            queue.append(i);
+        cDeque<uint32>::iterator end = queue.end();
+        for (cDeque<uint32>::iterator j = queue.begin(); j != end; ++j)
+            checksum+= *j;
+        while (!queue.isEmpty())
+        {
+            checksum+= queue.getFirst();
+            queue.removeFirst();
+        }
+        return checksum;
+    }
+
+    // Push and pop nested braces, 1 to 64 levels deep
+    static uint64 stackList()
+    {
+        uint64 checksum = 0;
+        cList<character> stack;
+        for (uint i = 0; i < StackRounds; i++)
+        {
+            uint depth = 1 + (i % 64);
+            uint j;
+            for (j = 0; j < depth; j++)
+                stack.append((character)('(' + (j & 1)));
+            for (j = 0; j < depth; j++)
+            {
+                cList<character>::iterator last = stack.end();
+                last.prev();
+                checksum+= *last;
+                stack.remove(last);
+            }
+        }
+        return checksum;
+    }
+
+    static uint64 stackDeque()
+    {
+        uint64 checksum = 0;
+        cDeque<character> stack;
+        for (uint i = 0; i < StackRounds; i++)
+        {
+            uint depth = 1 + (i % 64);
+            uint j;
+            for (j = 0; j < depth; j++)
+                stack.append((character)('(' + (j & 1)));
+            for (j = 0; j < depth; j++)
+            {
+                checksum+= stack.getLast();
+                stack.removeLast();
+            }
+        }
+        return checksum;
+    }
+
+    // Build a graph, which scans the nodes and the neighbors for each edge
+    static uint64 graph()
+    {
+        cGraph<uint32, uint32> graph(4);
+        uint i;
+        for (i = 0; i < GraphNodes; i++)
+            graph.addNode(i, i);
+        for (i = 0; i < GraphEdges; i++)
+        {
+            uint32 a = (uint32)((i * 2654435761U) % GraphNodes);
+            uint32 b = (uint32)((i * 40503U + 7) % GraphNodes);
+            graph.connectNodes(a, b);
+        }
+
+        uint64 checksum = 0;
+        for (i = 0; i < GraphNodes; i++)
+            checksum+= graph.isConnected(i, (i + 1) % GraphNodes) ? 1 : 0;
+        return checksum + graph.getNumberOfNodes();
+    }
+
+    virtual void run()
+    {
+        uint64 checksum = 0;
+
+        cBenchmarkTimer timer;
+        checksum+= queueList();
+        report("queue, cList      ", timer);
+
+        timer.start();
+        checksum+= queueDeque();
+        report("queue, cDeque     ", timer);
+
+        timer.start();
+        checksum+= stackList();
+        report("stack, cList      ", timer);
+
+        timer.start();
+        checksum+= stackDeque();
+        report("stack, cDeque     ", timer);
+
+        timer.start();
+        checksum+= graph();
+        report("cGraph build      ", timer);
+
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkDeque g_globalBenchmarkDeque;
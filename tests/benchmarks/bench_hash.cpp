@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_hash.cpp
+ *
+ * Compare the chained cHash against the open-addressing cFlatHash for
+ * insertion, successful look-ups and failed look-ups.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/hash.h"
+#include "xStl/data/flatHash.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+// Spread the keys over the 32 bit range (Knuth's multiplicative constant is
+// odd, so all the keys are unique)
+static uint32 makeKey(uint32 i)
+{
+    return (uint32)(i * 2654435761U);
+}
+
+class cBenchmarkHash : public cBenchmarkObject
+{
+public:
+    // The chained hash has 256 lists, so above this number of keys it
+    // degenerates into a quadratic link-list walk.
+    enum { MaxChainedHashKeys = 100000 };
+
+    template <class HashType>
+    void measure(const char* name, HashType& hash, uint32 count)
+    {
+        uint32 i;
+        uint32 found = 0;
+        cBenchmarkTimer timer;
+
+        for (i = 0; i < count; i++)
+            hash.append(makeKey(i), i);
+        uint64 insertTime = timer.getMicroseconds();
+
+        timer.start();
+        for (i = 0; i < count; i++)
+            found+= hash[makeKey(i)];
+        uint64 lookupTime = timer.getMicroseconds();
+
+        timer.start();
+        for (i = count; i < count * 2; i++)
+            if (hash.hasKey(makeKey(i)))
+                found++;
+        uint64 missTime = timer.getMicroseconds();
+
+        cout << "  " << name << " " << count << " keys: insert "
+             << insertTime << " us, lookup " << lookupTime
+             << " us, miss " << missTime << " us (" << found << ")" << endl;
+    }
+
+    virtual void run()
+    {
+        static const uint32 sizes[] = { 1000, 100000, 10000000 };
+        for (uint i = 0; i < arraysize(sizes); i++)
+        {
+            uint32 count = sizes[i];
+            if (count <= MaxChainedHashKeys)
+            {
+                cHash<uint32, uint32> chained;
+                measure("cHash            ", chained, count);
+            } else
+            {
+                cout << "  cHash             " << count
+                     << " keys: skipped (quadratic)" << endl;
+            }
+
+            cFlatHash<uint32, uint32> flat;
+            measure("cFlatHash        ", flat, count);
+
+            cFlatHash<uint32, uint32> reserved;
+            reserved.reserve(count);
+            measure("cFlatHash+reserve", reserved, count);
+        }
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkHash g_globalBenchmarkHash;
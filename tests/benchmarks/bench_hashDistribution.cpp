@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_hashDistribution.cpp
+ *
+ * Compare the bucket-length distribution of the legacy byte-sum string hash
+ * with the seeded hash family over a corpus of identifiers.
+ *
+ * The corpus is made of generated C++ style identifiers. More identifiers can
+ * be loaded from the source files listed (separated by ';') in the
+ * XSTL_HASH_CORPUS environment variable.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+// The system headers must be included before xStl redefines 'uint'
+#include <stdlib.h>
+
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/data/hash.h"
+#include "xStl/data/flatHash.h"
+#include "xStl/except/exception.h"
+#include "xStl/stream/fileStream.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+// The hash function of the previous versions of the cHash
+static uint legacyHashFunction(const cString& index, uint range)
+{
+    uint byte_sum = 0;
+    for (int i = 0; i < (int)index.length(); i++)
+    {
+        byte_sum+= (uint)index[i];
+    }
+
+    return byte_sum % range;
+}
+
+class cBenchmarkHashDistribution : public cBenchmarkObject
+{
+public:
+    // The number of histogram columns. The last column counts all the longer
+    // buckets.
+    enum { HistogramColumns = 8 };
+
+    // Add 'identifier' to the corpus, unless it already exist
+    void addIdentifier(const cString& identifier)
+    {
+        if ((identifier.length() == 0) || (m_unique.hasKey(identifier)))
+            return;
+        m_unique.append(identifier, m_corpus.getSize());
+        m_corpus.append(identifier);
+    }
+
+    // Generate identifiers such as "m_bufferSize", "getLength", "pNode2"
+    void generateCorpus()
+    {
+        static const char* prefixes[] = { "", "m_", "g_", "p", "is", "get", "set", "sz" };
+        static const char* words[] = { "buffer", "size", "length", "index",
+            "value", "name", "count", "data", "handle", "stream", "node",
+            "list", "hash", "key", "file", "thread", "mutex", "event", "string",
+            "array", "offset", "address", "range", "filter" };
+        static const char* suffixes[] = { "", "s", "1", "2", "Ptr", "Count",
+            "Size", "Length" };
+
+        for (uint i = 0; i < arraysize(prefixes); i++)
+        for (uint j = 0; j < arraysize(words); j++)
+        for (uint k = 0; k < arraysize(suffixes); k++)
+        {
+            cString word(words[j]);
+            cString prefix(prefixes[i]);
+            // Camel-case after a non member prefix
+            if ((prefix.length() > 0) && (prefix[prefix.length() - 1] != '_'))
+            {
+                cString first(word.left(1));
+                word = first.makeUpper() + word.right(word.length() - 1);
+            }
+            addIdentifier(prefix + word + cString(suffixes[k]));
+        }
+
+        // Temporary variables
+        for (uint32 t = 0; t < 1000; t++)
+            addIdentifier(cString("tmp") + cString(t));
+    }
+
+    // Tokenize the identifiers of a source file into the corpus
+    void loadCorpusFile(const cString& filename)
+    {
+        cBuffer data;
+        XSTL_TRY
+        {
+            cFileStream file(filename);
+            file.readAllStream(data);
+        }
+        XSTL_CATCH_ALL
+        {
+            cout << "  Cannot read " << filename << endl;
+            return;
+        }
+
+        cString identifier;
+        for (uint i = 0; i <= data.getSize(); i++)
+        {
+            char ch = (i < data.getSize()) ? (char)data[i] : ' ';
+            bool isIdentifier = ((ch >= 'a') && (ch <= 'z')) ||
+                                ((ch >= 'A') && (ch <= 'Z')) ||
+                                ((ch >= '0') && (ch <= '9') &&
+                                 (identifier.length() > 0)) ||
+                                (ch == '_');
+            if (isIdentifier)
+            {
+                identifier+= cString(ch);
+            } else
+            {
+                addIdentifier(identifier);
+                identifier = cString();
+            }
+        }
+    }
+
+    // Print the histogram of the bucket lengths
+    template <class HashFunction>
+    void measure(const char* name, HashFunction hashFunction, uint range)
+    {
+        cArray<uint32> buckets(range);
+        uint i;
+        for (i = 0; i < range; i++)
+            buckets[i] = 0;
+        for (i = 0; i < m_corpus.getSize(); i++)
+            buckets[hashFunction(m_corpus[i], range)]++;
+
+        uint32 histogram[HistogramColumns];
+        for (i = 0; i < HistogramColumns; i++)
+            histogram[i] = 0;
+        uint32 longest = 0;
+        for (i = 0; i < range; i++)
+        {
+            uint32 length = buckets[i];
+            if (length > longest)
+                longest = length;
+            histogram[(length < HistogramColumns - 1) ? length :
+                                                        HistogramColumns - 1]++;
+        }
+
+        cout << "  " << name << " " << range << " buckets:";
+        for (i = 0; i < HistogramColumns; i++)
+            cout << " " << histogram[i];
+        cout << "  longest " << longest << endl;
+    }
+
+    virtual void run()
+    {
+        generateCorpus();
+
+        const char* corpus = getenv("XSTL_HASH_CORPUS");
+        if (corpus != NULL)
+        {
+            cString files(corpus);
+            cString filename;
+            for (uint i = 0; i <= files.length(); i++)
+            {
+                if ((i == files.length()) || (files[i] == ';'))
+                {
+                    if (filename.length() > 0)
+                        loadCorpusFile(filename);
+                    filename = cString();
+                } else
+                {
+                    filename+= cString(files[i]);
+                }
+            }
+        }
+
+        cout << "  " << m_corpus.getSize() << " unique identifiers" << endl;
+        cout << "  Number of buckets holding 0, 1, 2, .., 6, 7+ identifiers"
+             << endl;
+
+        static const uint ranges[] = { 256, 4096 };
+        for (uint r = 0; r < arraysize(ranges); r++)
+        {
+            measure("byte-sum   ", legacyHashFunction, ranges[r]);
+            measure("cHashCode  ", cHashFunctor<cString>(), ranges[r]);
+            measure("seed 0x5eed", cSeededHashFunctor<cString>(0x5eed), ranges[r]);
+        }
+    }
+
+    virtual cString getName() { return __FILE__; }
+
+private:
+    // The identifiers
+    cArray<cString> m_corpus;
+    // Filter duplicated identifiers
+    cFlatHash<cString, uint> m_unique;
+};
+
+// Instance benchmark object
+cBenchmarkHashDistribution g_globalBenchmarkHashDistribution;
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_intrusivePtr.cpp
+ *
+ * Compare the reference-counted pointers: cSmartPtr over a new object (an
+ * allocation for the object and another one for the counter), makeSmartPtr
+ * (a single allocation) and cIntrusivePtr (the counter is a member of the
+ * object).
+ *
+ * For each pointer type the benchmark counts the allocations needed to
+ * create the objects, and measures a pointer-chasing walk over the objects
+ * in a random order. Every step copies the pointer, so the walk touches both
+ * the object and its counter.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/smartptr.h"
+#include "xStl/data/intrusivePtr.h"
+#include "xStl/data/string.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkIntrusivePtr : public cBenchmarkObject
+{
+public:
+    enum { Objects = 1000000,
+           Walks = 4 };
+
+    // The object of the walk. 'm_next' is the index of the next object
+    class cObject
+    {
+    public:
+        cObject() : m_value(0), m_next(0) {}
+
+        uint m_value;
+        uint m_next;
+        uint m_payload[6];
+    };
+
+    class cCountedObject : public cObject, public cIntrusiveRefCount
+    {
+    };
+
+    // Create the objects of every pointer type
+    class cSmartFactory
+    {
+    public:
+        typedef cSmartPtr<cObject> Ptr;
+        static Ptr create() { return Ptr(new cObject()); }
+    };
+
+    class cMakeFactory
+    {
+    public:
+        typedef cSmartPtr<cObject> Ptr;
+        static Ptr create() { return makeSmartPtr<cObject>(); }
+    };
+
+    class cIntrusiveFactory
+    {
+    public:
+        typedef cIntrusivePtr<cCountedObject> Ptr;
+        static Ptr create() { return Ptr(new cCountedObject()); }
+    };
+
+    // Create the objects, walk over them and destroy them
+    template <class Factory>
+    static void measure(const char* name)
+    {
+        typedef typename Factory::Ptr Ptr;
+        cArray<Ptr> objects(Objects);
+
+        uint64 allocations = getAllocationsCount();
+        cBenchmarkTimer timer;
+        uint i;
+        for (i = 0; i < Objects; i++)
+        {
+            objects[i] = Factory::create();
+            objects[i]->m_value = i;
+        }
+        uint64 createTime = timer.getMilliseconds();
+        allocations = getAllocationsCount() - allocations;
+
+        // Link the objects in a random order (a single cycle)
+        uint32 seed = 12345;
+        cArray<uint> order(Objects);
+        for (i = 0; i < Objects; i++)
+            order[i] = i;
+        for (i = Objects - 1; i > 0; i--)
+        {
+            seed = seed * 1103515245 + 12345;
+            t_swap(order[i], order[(seed >> 8) % (i + 1)]);
+        }
+        for (i = 0; i < Objects; i++)
+            objects[order[i]]->m_next = order[(i + 1) % Objects];
+
+        timer.start();
+        uint64 sum = 0;
+        uint index = order[0];
+        for (i = 0; i < Objects * Walks; i++)
+        {
+            Ptr object(objects[index]);
+            sum+= object->m_value;
+            index = object->m_next;
+        }
+        uint64 walkTime = timer.getMilliseconds();
+
+        timer.start();
+        objects.changeSize(0, false);
+        uint64 destroyTime = timer.getMilliseconds();
+
+        cout << "  " << name << allocations << "          "
+             << createTime << "           " << walkTime << "        "
+             << destroyTime << "   (" << sum << ")" << endl;
+    }
+
+    virtual void run()
+    {
+        cout << "  " << Objects << " objects, " << Walks << " walks" << endl;
+        cout << "  pointer          allocations  create(ms)  walk(ms)  "
+                "destroy(ms)" << endl;
+        measure<cSmartFactory>("cSmartPtr(new)   ");
+        measure<cMakeFactory>("makeSmartPtr     ");
+        measure<cIntrusiveFactory>("cIntrusivePtr    ");
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkIntrusivePtr g_globalBenchmarkIntrusivePtr;
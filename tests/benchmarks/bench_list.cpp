@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_list.cpp
+ *
+ * Measure the time, the heap memory and the number of operator new calls of
+ * appending 10M elements into a cList, iterating them, removing half of them
+ * by iterators, appending them again (into the recycled nodes) and freeing
+ * the list.
+ * Measure also the memory of the buckets of a sparse cHash, which are cList
+ * objects.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+#include "xStl/data/allocator.h"
+#include "xStl/data/list.h"
+#include "xStl/data/hash.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkList : public cBenchmarkObject
+{
+public:
+    enum { Elements = 10000000,
+           Buckets = 100000 };
+
+    // An allocator which counts the allocated bytes
+    class cCountingAllocator : public cAllocator
+    {
+    public:
+        cCountingAllocator() : m_bytes(0) {}
+
+        virtual void* allocate(uint size)
+        {
+            m_bytes+= size;
+            return cOS::smallMemoryAllocation(size);
+        }
+
+        virtual void* reallocate(void* block, uint oldSize, uint newSize)
+        {
+            m_bytes+= newSize;
+            m_bytes-= oldSize;
+            return cOS::smallMemoryRealloc(block, newSize);
+        }
+
+        virtual void free(void* block, uint size)
+        {
+            m_bytes-= size;
+            cOS::smallMemoryFree(block);
+        }
+
+        // The number of allocated bytes
+        uint m_bytes;
+    };
+
+    // Print the time of a workload
+    static void report(const char* name, const cBenchmarkTimer& timer)
+    {
+        cout << "  " << name << ": " << timer.getMilliseconds() << " ms"
+             << endl;
+    }
+
+    template <class T>
+    static void measure(const char* typeName)
+    {
+        uint64 checksum = 0;
+        uint i;
+
+        cout << "  cList<" << typeName << ">" << endl;
+        uint64 heap = getHeapBytes();
+        uint64 allocations = getAllocationsCount();
+        cBenchmarkTimer timer;
+        {
+            cList<T> list;
+
+            for (i = 0; i < Elements; i++)
+                list.append((T)i);
+            report("append   ", timer);
+
+            cout << "  memory    : "
+                 << ((getHeapBytes() - heap) >> 20) << " MB, "
+                 << (getAllocationsCount() - allocations)
+                 << " operator new calls" << endl;
+
+            timer.start();
+            typename cList<T>::iterator end = list.end();
+            for (typename cList<T>::iterator j = list.begin(); j != end; j++)
+                checksum+= (uint64)(*j);
+            report("iterate  ", timer);
+
+            // Remove every other element
+            timer.start();
+            typename cList<T>::iterator j = list.begin();
+            while (j != end)
+            {
+                j = list.remove(j);
+                if (j != end)
+                    j++;
+            }
+            report("remove   ", timer);
+
+            timer.start();
+            for (i = 0; i < Elements / 2; i++)
+                list.append((T)i);
+            report("re-append", timer);
+
+            timer.start();
+        }
+        report("free     ", timer);
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    // Print the memory of a hash of 'Buckets' buckets with 'elements'
+    // elements
+    static void measureBuckets(uint elements)
+    {
+        cCountingAllocator allocator;
+        cHash<uint32, uint32> hash(Buckets);
+        hash.setAllocator(&allocator);
+        for (uint i = 0; i < elements; i++)
+            hash.append((uint32)i, (uint32)i);
+
+        cout << "  " << elements << " elements: "
+             << (allocator.m_bytes / Buckets) << " bytes per bucket" << endl;
+    }
+
+    virtual void run()
+    {
+        measure<uint32>("uint32");
+        measure<uint64>("uint64");
+
+        cout << "  cHash<uint32, uint32> of " << Buckets << " buckets, "
+             << "sizeof(cList<uint32>) = " << (uint)sizeof(cList<uint32>)
+             << endl;
+        measureBuckets(0);
+        measureBuckets(Buckets / 10);
+        measureBuckets(Buckets);
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkList g_globalBenchmarkList;
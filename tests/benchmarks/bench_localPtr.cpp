@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_localPtr.cpp
+ *
+ * Build and tear down deep filter-stream chains, where each filter holds a
+ * pointer to the stream below it, with cSmartPtr (atomic reference counter)
+ * and with cLocalPtr (plain reference counter).
+ *
+ * The filters are a model of the filterStream decorators, since filterStream
+ * itself holds a cSmartPtr<basicIO>. Every filter gets the lower stream by a
+ * const reference and keeps a copy, and every read passes through the whole
+ * chain.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/smartptr.h"
+#include "xStl/data/localPtr.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkLocalPtr : public cBenchmarkObject
+{
+public:
+    enum { Chains = 100000,
+           Depth = 32 };
+
+    // A stream decorator over the stream 'm_down'
+    template <template <class> class PtrType>
+    class cFilter
+    {
+    public:
+        typedef PtrType<cFilter> Ptr;
+
+        cFilter(const Ptr& down, uint key) : m_down(down), m_key(key) {}
+
+        uint read(uint data) const
+        {
+            if (m_down.isEmpty())
+                return data;
+            return m_down->read(data) ^ m_key;
+        }
+
+    private:
+        Ptr m_down;
+        uint m_key;
+    };
+
+    // Build and destroy the chains
+    template <template <class> class PtrType>
+    static void measure(const char* name)
+    {
+        typedef typename cFilter<PtrType>::Ptr Ptr;
+        uint64 allocations = getAllocationsCount();
+        uint64 buildTime = 0;
+        uint64 destroyTime = 0;
+        uint checksum = 0;
+        for (uint i = 0; i < Chains; i++)
+        {
+            cBenchmarkTimer timer;
+            Ptr top;
+            for (uint j = 0; j < Depth; j++)
+                top = Ptr(new cFilter<PtrType>(top, i + j));
+            checksum+= top->read(i);
+            buildTime+= timer.getMicroseconds();
+
+            timer.start();
+            top = Ptr();
+            destroyTime+= timer.getMicroseconds();
+        }
+        allocations = getAllocationsCount() - allocations;
+
+        cout << "  " << name << (buildTime / 1000) << "          "
+             << (destroyTime / 1000) << "            "
+             << (allocations / Chains) << "   (" << checksum << ")" << endl;
+    }
+
+    virtual void run()
+    {
+        cout << "  " << Chains << " chains of " << Depth << " filters" << endl;
+        cout << "  pointer     build(ms)  teardown(ms)  allocations/chain"
+             << endl;
+        measure<cSmartPtr>("cSmartPtr   ");
+        measure<cLocalPtr>("cLocalPtr   ");
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkLocalPtr g_globalBenchmarkLocalPtr;
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_numberConversion.cpp
+ *
+ * Measure the throughput, in millions of numbers per second, of the numeric
+ * cString constructors, of cStringerStream integer output and of
+ * cNumberConversion formatting and parsing. The parsing is compared against
+ * a character by character loop which uses cChar (the way the Parser used to
+ * parse numbers).
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/numberConversion.h"
+#include "xStl/stream/stringerStream.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkNumberConversion : public cBenchmarkObject
+{
+public:
+    enum { Numbers = 2000000,
+           ParsedNumbers = 1000 };
+
+    // Print the throughput of a workload
+    static void report(const char* name, const cBenchmarkTimer& timer)
+    {
+        uint64 time = t_max(timer.getMicroseconds(), (uint64)1);
+        cout << "  " << name << ": " << time << " us, "
+             << (uint64)(Numbers / time) << "."
+             << (uint64)(((Numbers * 10) / time) % 10) << " M/s" << endl;
+    }
+
+    // Return a number of 1 to 10 digits
+    static uint32 getNumber(uint i)
+    {
+        return (uint32)((i * 2654435761U) >> (i % 29));
+    }
+
+    // Return a number which fits in the inline storage of cString
+    static uint32 getShortNumber(uint i)
+    {
+        uint32 limit = 1;
+        for (uint j = 0; j < cString::InlineStringLength; j++)
+            limit*= 10;
+        return getNumber(i) % limit;
+    }
+
+    // Return a 10 digits number, which is stored in the heap by cString
+    static uint32 getLongNumber(uint i)
+    {
+        return 1000000000U + (getNumber(i) % 1000000000U);
+    }
+
+    virtual void run()
+    {
+        uint64 checksum = 0;
+        uint i;
+
+        cBenchmarkTimer timer;
+        for (i = 0; i < Numbers; i++)
+            checksum+= cString(getNumber(i)).length();
+        report("cString decimal     ", timer);
+
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+            checksum+= cString((uint64)getNumber(i) << 20, 16).length();
+        report("cString hex         ", timer);
+
+        cNullStringerStream null;
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+            null << getNumber(i);
+        report("stringer decimal    ", timer);
+
+        // The numbers which fit in the inline storage don't allocate
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+            null << getShortNumber(i);
+        report("stringer inline     ", timer);
+
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+            null << getLongNumber(i);
+        report("stringer 10 digits  ", timer);
+
+        character buffer[cNumberConversion::BufferLength];
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+            checksum+= cNumberConversion::formatUnsigned(getNumber(i), buffer);
+        report("format decimal      ", timer);
+
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+            checksum+= cNumberConversion::formatUnsigned(getNumber(i), buffer, 16);
+        report("format hex          ", timer);
+
+        // Parse the formatted numbers
+        char text[ParsedNumbers][cNumberConversion::BufferLength];
+        uint lengths[ParsedNumbers];
+        for (i = 0; i < ParsedNumbers; i++)
+            lengths[i] = cNumberConversion::formatUnsigned(getNumber(i), text[i]);
+
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+        {
+            const char* digits = text[i % (ParsedNumbers)];
+            uint number = 0;
+            for (uint j = 0; cChar::isDigit(digits[j]); j++)
+            {
+                number*= 10;
+                number+= cChar::getDigit(digits[j]);
+            }
+            checksum+= number;
+        }
+        report("parse cChar loop    ", timer);
+
+        timer.start();
+        for (i = 0; i < Numbers; i++)
+        {
+            uint64 number;
+            uint parsedLength;
+            uint index = i % (ParsedNumbers);
+            if (cNumberConversion::parseUnsigned(text[index], lengths[index],
+                                                 10, number, parsedLength))
+            {
+                checksum+= number;
+            }
+        }
+        report("parse decimal       ", timer);
+
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkNumberConversion g_globalBenchmarkNumberConversion;
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_parallel.cpp
+ *
+ * Scaling of the parallel algorithms with the number of threads. Every
+ * workload is executed by pools of 1 thread (the calling thread only) up to
+ * the number of processors, or at least 4 threads.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/os/os.h"
+#include "xStl/os/threadPool.h"
+#include "xStl/utils/parallel.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkParallel : public cBenchmarkObject
+{
+public:
+    enum { Elements = 10000000 };
+
+    // A loop body with some computation
+    class cHashIndex
+    {
+    public:
+        cHashIndex(uint32* data) : m_data(data) {}
+        void operator () (uint index) const
+        {
+            uint32 value = (uint32)index;
+            for (uint i = 0; i < 16; i++)
+                value = (value ^ (value >> 15)) * 2654435761U;
+            m_data[index] = value;
+        }
+        uint32* m_data;
+    };
+
+    class cSquare
+    {
+    public:
+        uint64 operator () (const uint32& value) const
+        {
+            return (uint64)value * value;
+        }
+    };
+
+    class cSum
+    {
+    public:
+        uint64 operator () (const uint64& a, const uint64& b) const
+        {
+            return a + b;
+        }
+    };
+
+    // Fill the array with pseudo random numbers
+    static void generate(cArray<uint32>& array)
+    {
+        uint32 seed = 12345;
+        for (uint i = 0; i < array.getSize(); i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            array[i] = seed;
+        }
+    }
+
+    virtual void run()
+    {
+        uint processors = cOS::getNumberOfProcessors();
+        uint maximum = t_max(processors, (uint)4);
+        cout << "  " << processors << " processors" << endl;
+        cout << "  threads   for(ms)  transform(ms)  reduce(ms)  sort(ms)"
+             << endl;
+
+        cArray<uint32> data(Elements);
+        cArray<uint64> squares;
+        uint64 checksum = 0;
+        for (uint threads = 1; threads <= maximum; threads*= 2)
+        {
+            cThreadPool pool(threads - 1);
+            cBenchmarkTimer timer;
+
+            parallelFor(0, Elements, cHashIndex(data.getBuffer()), 1024, pool);
+            uint forTime = timer.getMilliseconds();
+
+            timer.start();
+            parallelTransform(data, squares, cSquare(), pool);
+            uint transformTime = timer.getMilliseconds();
+
+            timer.start();
+            checksum+= parallelReduce(squares, (uint64)0, cSum(), pool);
+            uint reduceTime = timer.getMilliseconds();
+
+            generate(data);
+            timer.start();
+            parallelSort(data, cLessThan<uint32>(), pool);
+            uint sortTime = timer.getMilliseconds();
+            checksum+= data[Elements / 2];
+
+            cout << "  " << threads << "         " << forTime << "       "
+                 << transformTime << "             " << reduceTime
+                 << "          " << sortTime << endl;
+        }
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkParallel g_globalBenchmarkParallel;
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_priorityQueue.cpp
+ *
+ * Scheduler-like workloads for cPriorityQueue at 1M elements, compared with
+ * cOrderedList which is used as a sorted queue. The random order of
+ * cOrderedList is measured with less elements, since every add() scans the
+ * list.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/priorityQueue.h"
+#include "xStl/data/orderedList.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkPriorityQueue : public cBenchmarkObject
+{
+public:
+    enum { Elements = 1000000,
+           OrderedListElements = 20000 };
+
+    // Print the time of a workload
+    static void report(const char* name, const cBenchmarkTimer& timer)
+    {
+        cout << "  " << name << ": " << timer.getMilliseconds() << " ms"
+             << endl;
+    }
+
+    // Pseudo random keys, the same for all the tests
+    static uint32 key(uint32 i)
+    {
+        return (i * 2654435761U) >> 4;
+    }
+
+    // Push all the keys and pop them
+    template <class Queue>
+    static uint64 pushPop(Queue& queue, uint count)
+    {
+        uint64 checksum = 0;
+        uint i;
+        for (i = 0; i < count; i++)
+            queue.push(key(i));
+        while (!queue.isEmpty())
+        {
+            checksum+= queue.top();
+            queue.pop();
+        }
+        return checksum;
+    }
+
+    // Build the heap at once and pop all the keys
+    static uint64 heapifyPop()
+    {
+        cArray<uint32> keys(Elements);
+        for (uint i = 0; i < Elements; i++)
+            keys[i] = key(i);
+        cPriorityQueue<uint32> queue;
+        queue.heapify(keys);
+        uint64 checksum = 0;
+        while (!queue.isEmpty())
+        {
+            checksum+= queue.top();
+            queue.pop();
+        }
+        return checksum;
+    }
+
+    // Lower the priority of every element once, as a shortest-path search
+    // does, and pop them
+    static uint64 decreaseKeys()
+    {
+        cPriorityQueue<uint32> queue;
+        queue.reserve(Elements);
+        uint i;
+        for (i = 0; i < Elements; i++)
+            queue.push(key(i) | 0x80000000);
+        for (i = 0; i < Elements; i++)
+            queue.decreaseKey(i, key(i));
+        uint64 checksum = 0;
+        while (!queue.isEmpty())
+        {
+            checksum+= queue.top();
+            queue.pop();
+        }
+        return checksum;
+    }
+
+    // Add the keys in random or ascending order to an ordered-list and empty
+    // it
+    static uint64 orderedList(uint count, bool ascending)
+    {
+        cOrderedList<uint32> list;
+        uint i;
+        for (i = 0; i < count; i++)
+            list.add(ascending ? i : key(i));
+        uint64 checksum = 0;
+        while (!list.isEmpty())
+        {
+            checksum+= list.first();
+            list.pop2null();
+        }
+        return checksum;
+    }
+
+    virtual void run()
+    {
+        uint64 checksum = 0;
+
+        cBenchmarkTimer timer;
+        cPriorityQueue<uint32> quaternary;
+        checksum+= pushPop(quaternary, Elements);
+        report("1M push/pop, 4-ary heap       ", timer);
+
+        timer.start();
+        cPriorityQueue<uint32, cLessThan<uint32>, 2> binary;
+        checksum+= pushPop(binary, Elements);
+        report("1M push/pop, binary heap      ", timer);
+
+        timer.start();
+        checksum+= heapifyPop();
+        report("1M heapify/pop                ", timer);
+
+        timer.start();
+        checksum+= decreaseKeys();
+        report("1M push/decreaseKey/pop       ", timer);
+
+        timer.start();
+        checksum+= orderedList(OrderedListElements, false);
+        report("20K random add, cOrderedList  ", timer);
+
+        timer.start();
+        checksum+= orderedList(OrderedListElements, true);
+        report("20K ascending add, cOrderedList", timer);
+
+        timer.start();
+        checksum+= orderedList(Elements, true);
+        report("1M ascending add, cOrderedList", timer);
+
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkPriorityQueue g_globalBenchmarkPriorityQueue;
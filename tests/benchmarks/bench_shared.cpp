@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_shared.cpp
+ *
+ * Measure the copy cost and the memory footprint of shared (copy-on-write)
+ * strings and buffers against private copies. Long strings and buffers are
+ * copied into a list, the way hash keys and queued packets are copied.
+ *
+ * The memory footprint is the number of bytes of the distinct character
+ * (or byte) storages referenced by the list.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/list.h"
+#include "xStl/data/sarray.h"
+#include "xStl/data/string.h"
+#include "xStl/data/sharedBuffer.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkShared : public cBenchmarkObject
+{
+public:
+    enum { Copies = 100000,
+           StringLength = 256,
+           BufferSize = 4096 };
+
+    // Print the measurement of a workload
+    static void report(const char* name, uint64 footprint,
+                       const cBenchmarkTimer& timer)
+    {
+        cout << "  " << name << ": " << footprint << " bytes, "
+             << timer.getMicroseconds() << " us" << endl;
+    }
+
+    // Copy 'string' into a list, and return the memory footprint
+    static uint64 copyString(const cString& string)
+    {
+        cList<cString> list;
+        for (uint i = 0; i < Copies; i++)
+        {
+            list.append(string);
+        }
+
+        uint64 footprint = 0;
+        const character* last = NULL;
+        for (cList<cString>::iterator i = list.begin(); i != list.end(); ++i)
+        {
+            const cString& copy = *i;
+            if (copy.getBuffer() != last)
+            {
+                footprint+= (copy.length() + 1) * sizeof(character);
+                last = copy.getBuffer();
+            }
+        }
+        return footprint;
+    }
+
+    // Copy 'buffer' into a list, and return the memory footprint
+    template <class T>
+    static uint64 copyBuffer(const T& buffer)
+    {
+        cList<T> list;
+        for (uint i = 0; i < Copies; i++)
+        {
+            list.append(buffer);
+        }
+
+        uint64 footprint = 0;
+        const uint8* last = NULL;
+        for (typename cList<T>::iterator i = list.begin(); i != list.end(); ++i)
+        {
+            const T& copy = *i;
+            if (copy.getBuffer() != last)
+            {
+                footprint+= copy.getSize();
+                last = copy.getBuffer();
+            }
+        }
+        return footprint;
+    }
+
+    virtual void run()
+    {
+        cString string(cString::dup(XSTL_STRING("identifier"),
+                                    StringLength / 10));
+
+        cBenchmarkTimer timer;
+        uint64 footprint = copyString(string);
+        report("private strings", footprint, timer);
+
+        string.share();
+        timer.start();
+        footprint = copyString(string);
+        report("shared strings ", footprint, timer);
+
+        cBuffer buffer(BufferSize);
+        memset(buffer.getBuffer(), 0x5A, BufferSize);
+        timer.start();
+        footprint = copyBuffer(buffer);
+        report("private buffers", footprint, timer);
+
+        cSharedBuffer sharedBuffer(buffer);
+        timer.start();
+        footprint = copyBuffer(sharedBuffer);
+        report("shared buffers ", footprint, timer);
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkShared g_globalBenchmarkShared;
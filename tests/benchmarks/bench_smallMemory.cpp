@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_smallMemory.cpp
+ *
+ * Allocation churn from 1 up to 8 threads, with cOS::smallMemoryAllocation()
+ * (the thread-caching size classes allocator) and with the system malloc()
+ * (the previous implementation of the small-memory functions).
+ *
+ * The local test keeps a working set of blocks in every thread and replaces
+ * random blocks with blocks of random sizes. The remote test allocates blocks
+ * in one set of threads and frees them in another.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+// The system headers must be included before xStl redefines 'uint'
+#include <stdlib.h>
+#include "xStl/types.h"
+#include "xStl/data/string.h"
+#include "xStl/os/os.h"
+#include "xStl/os/threadedClass.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+#ifdef XSTL_LINUX
+
+#include "xStl/os/unixOS/smallMemory.h"
+
+class cBenchmarkSmallMemory : public cBenchmarkObject
+{
+public:
+    enum { Operations = 2000000,
+           WorkingSet = 1024,
+           RemoteBlocks = 100000,
+           MaxThreads = 8 };
+
+    // The allocation functions which are measured
+    struct Functions {
+        void* (*m_allocate)(uint size);
+        void (*m_free)(void* block);
+    };
+
+    static void* osAllocate(uint size) { return cOS::smallMemoryAllocation(size); }
+    static void osFree(void* block) { cOS::smallMemoryFree(block); }
+    static void* mallocAllocate(uint size) { return malloc(size); }
+    static void mallocFree(void* block) { free(block); }
+
+    // Return a size between 8 and 1024 bytes, mostly small
+    static uint randomSize(uint32& seed)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint value = (seed >> 16) & 0x3FF;
+        return ((value * value) >> 10) + 8;
+    }
+
+    // Replace random blocks of the working set
+    class cChurnThread : public cThreadedClass
+    {
+    public:
+        cChurnThread(const Functions& functions, uint32 seed) :
+            m_functions(functions), m_seed(seed) {}
+
+        virtual void run()
+        {
+            void* blocks[WorkingSet];
+            uint i;
+            for (i = 0; i < WorkingSet; i++)
+                blocks[i] = m_functions.m_allocate(randomSize(m_seed));
+            for (i = 0; i < Operations; i++)
+            {
+                uint slot = (m_seed >> 8) % WorkingSet;
+                m_functions.m_free(blocks[slot]);
+                blocks[slot] = m_functions.m_allocate(randomSize(m_seed));
+            }
+            for (i = 0; i < WorkingSet; i++)
+                m_functions.m_free(blocks[i]);
+        }
+
+    private:
+        Functions m_functions;
+        uint32 m_seed;
+    };
+
+    // Allocate all the blocks, or free all the blocks
+    class cRemoteThread : public cThreadedClass
+    {
+    public:
+        cRemoteThread(const Functions& functions, void** blocks, bool allocate) :
+            m_functions(functions), m_blocks(blocks), m_allocate(allocate) {}
+
+        virtual void run()
+        {
+            uint32 seed = 1;
+            for (uint i = 0; i < RemoteBlocks; i++)
+            {
+                if (m_allocate)
+                    m_blocks[i] = m_functions.m_allocate(randomSize(seed));
+                else
+                    m_functions.m_free(m_blocks[i]);
+            }
+        }
+
+    private:
+        Functions m_functions;
+        void** m_blocks;
+        bool m_allocate;
+    };
+
+    // Start all the threads and wait for them
+    static void runThreads(cThreadedClass** threads, uint count)
+    {
+        uint i;
+        for (i = 0; i < count; i++)
+            threads[i]->start();
+        for (i = 0; i < count; i++)
+            threads[i]->wait();
+        for (i = 0; i < count; i++)
+            delete threads[i];
+    }
+
+    static uint measureChurn(const Functions& functions, uint threadsCount)
+    {
+        cThreadedClass* threads[MaxThreads];
+        for (uint i = 0; i < threadsCount; i++)
+            threads[i] = new cChurnThread(functions, i + 1);
+
+        cBenchmarkTimer timer;
+        runThreads(threads, threadsCount);
+        return (uint)timer.getMilliseconds();
+    }
+
+    // Thread i allocates the blocks which thread i+1 frees
+    static uint measureRemote(const Functions& functions, uint threadsCount)
+    {
+        void** blocks[MaxThreads];
+        cThreadedClass* threads[MaxThreads];
+        uint i;
+        for (i = 0; i < threadsCount; i++)
+            blocks[i] = (void**)malloc(RemoteBlocks * sizeof(void*));
+
+        cBenchmarkTimer timer;
+        for (i = 0; i < threadsCount; i++)
+            threads[i] = new cRemoteThread(functions, blocks[i], true);
+        runThreads(threads, threadsCount);
+        for (i = 0; i < threadsCount; i++)
+            threads[i] = new cRemoteThread(functions,
+                                           blocks[(i + 1) % threadsCount],
+                                           false);
+        runThreads(threads, threadsCount);
+        uint elapsed = (uint)timer.getMilliseconds();
+
+        for (i = 0; i < threadsCount; i++)
+            free(blocks[i]);
+        return elapsed;
+    }
+
+    virtual void run()
+    {
+        Functions smallMemory = { osAllocate, osFree };
+        Functions system = { mallocAllocate, mallocFree };
+
+        cout << "  " << cOS::getNumberOfProcessors() << " processors, "
+             << Operations << " operations per thread, " << RemoteBlocks
+             << " remote blocks per thread" << endl;
+        cout << "  threads   churn: malloc(ms)  smallMemory(ms)"
+             << "   remote: malloc(ms)  smallMemory(ms)" << endl;
+        for (uint threads = 1; threads <= MaxThreads; threads*= 2)
+        {
+            uint mallocChurn = measureChurn(system, threads);
+            uint smallChurn = measureChurn(smallMemory, threads);
+            uint mallocRemote = measureRemote(system, threads);
+            uint smallRemote = measureRemote(smallMemory, threads);
+            cout << "  " << threads << "                " << mallocChurn
+                 << "               " << smallChurn << "                 "
+                 << mallocRemote << "               " << smallRemote << endl;
+        }
+
+        cSmallMemory::Statistics statistics;
+        cSmallMemory::getStatistics(statistics);
+        cout << "  cache hit ratio: "
+             << (uint)(statistics.getCacheHitRatio() * 100) << "%, reserved "
+             << (uint)(statistics.m_reservedBytes / 1024) << "kb" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkSmallMemory g_globalBenchmarkSmallMemory;
+
+#endif // XSTL_LINUX
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_smartptr.cpp
+ *
+ * Copy and release smart-pointers from 1 up to 32 threads. Every thread
+ * performs the same number of copies, either of a single object shared by
+ * all threads (all the threads change the same reference counter) or of an
+ * object which is private to the thread.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/smartptr.h"
+#include "xStl/data/string.h"
+#include "xStl/os/os.h"
+#include "xStl/os/threadedClass.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkSmartPtr : public cBenchmarkObject
+{
+public:
+    enum { Copies = 1000000,
+           MaxThreads = 32 };
+
+    // Copy and release 'object' over and over
+    class cCopyThread : public cThreadedClass
+    {
+    public:
+        cCopyThread(const cSmartPtr<uint>& object) : m_object(object) {}
+
+        virtual void run()
+        {
+            cSmartPtr<uint> other(m_object);
+            for (uint i = 0; i < Copies; i++)
+            {
+                cSmartPtr<uint> copy(m_object);
+                other = copy;
+            }
+        }
+
+    private:
+        cSmartPtr<uint> m_object;
+    };
+
+    // Run 'threadsCount' threads and return the elapsed time
+    static uint measure(uint threadsCount, bool shared)
+    {
+        cSmartPtr<uint> object(new uint(0));
+        cCopyThread* threads[MaxThreads];
+        uint i;
+        for (i = 0; i < threadsCount; i++)
+        {
+            if (shared)
+                threads[i] = new cCopyThread(object);
+            else
+                threads[i] = new cCopyThread(cSmartPtr<uint>(new uint(i)));
+        }
+
+        cBenchmarkTimer timer;
+        for (i = 0; i < threadsCount; i++)
+            threads[i]->start();
+        for (i = 0; i < threadsCount; i++)
+            threads[i]->wait();
+        uint elapsed = timer.getMilliseconds();
+
+        for (i = 0; i < threadsCount; i++)
+            delete threads[i];
+        return elapsed;
+    }
+
+    virtual void run()
+    {
+        cout << "  " << cOS::getNumberOfProcessors() << " processors, "
+             << Copies << " copies per thread" << endl;
+        cout << "  threads   shared(ms)  private(ms)" << endl;
+        for (uint threads = 1; threads <= MaxThreads; threads*= 2)
+        {
+            uint sharedTime = measure(threads, true);
+            uint privateTime = measure(threads, false);
+            cout << "  " << threads << "         " << sharedTime
+                 << "          " << privateTime << endl;
+        }
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkSmartPtr g_globalBenchmarkSmartPtr;
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_sort.cpp
+ *
+ * Measure the sort algorithms of algorithm.h on arrays of 1M to 100M
+ * integers, and the merge-sort of cList. The O(n^2) boubbleSort is measured
+ * only on a small array.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/data/array.h"
+#include "xStl/data/list.h"
+#include "xStl/data/string.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkSort : public cBenchmarkObject
+{
+public:
+    enum { BoubbleElements = 20000,
+           ListElements = 10000000,
+           SelectElements = 10000000,
+           TopElements = 100 };
+
+    // Print the time of a workload
+    static void report(const char* name, uint count,
+                       const cBenchmarkTimer& timer)
+    {
+        cout << "  " << name << " " << count << ": "
+             << timer.getMilliseconds() << " ms" << endl;
+    }
+
+    // Fill the array with pseudo random numbers
+    static void generate(cArray<uint32>& array, uint count)
+    {
+        array.changeSize(count);
+        uint32 seed = 12345;
+        for (uint i = 0; i < count; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            array[i] = seed;
+        }
+    }
+
+    // Return a value which depends on all the elements and their order
+    static uint64 checksum(const cArray<uint32>& array)
+    {
+        uint64 ret = 0;
+        for (uint i = 0; i < array.getSize(); i++)
+            ret = ret * 31 + array[i];
+        return ret;
+    }
+
+    virtual void run()
+    {
+        uint64 check = 0;
+        cArray<uint32> array;
+        cBenchmarkTimer timer;
+
+        generate(array, BoubbleElements);
+        timer.start();
+        boubbleSort(array.getBuffer(), array.getBuffer() + array.getSize());
+        report("boubbleSort, random     ", BoubbleElements, timer);
+        check+= checksum(array);
+
+        static const uint sizes[] = {1000000, 10000000, 100000000};
+        for (uint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            uint count = sizes[s];
+            generate(array, count);
+            timer.start();
+            sort(array.getBuffer(), array.getBuffer() + count);
+            report("sort, random            ", count, timer);
+            check+= checksum(array);
+
+            timer.start();
+            sort(array.getBuffer(), array.getBuffer() + count);
+            report("sort, sorted            ", count, timer);
+
+            generate(array, count);
+            timer.start();
+            radixSort(array.getBuffer(), array.getBuffer() + count);
+            report("radixSort, random       ", count, timer);
+            check+= checksum(array);
+        }
+
+        generate(array, SelectElements);
+        timer.start();
+        sort(array.begin(), array.end());
+        report("sort, cArray::iterator  ", SelectElements, timer);
+        check+= checksum(array);
+
+        generate(array, SelectElements);
+        timer.start();
+        partialSort(array.getBuffer(), array.getBuffer() + TopElements,
+                    array.getBuffer() + SelectElements);
+        report("partialSort 100 lowest  ", SelectElements, timer);
+        check+= array[TopElements - 1];
+
+        generate(array, SelectElements);
+        timer.start();
+        nthElement(array.getBuffer(), array.getBuffer() + SelectElements / 2,
+                   array.getBuffer() + SelectElements);
+        report("nthElement, median      ", SelectElements, timer);
+        check+= array[SelectElements / 2];
+        array.changeSize(0, false);
+
+        cList<uint32> list;
+        uint32 seed = 12345;
+        for (uint i = 0; i < ListElements; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            list.append(seed);
+        }
+        timer.start();
+        list.sort();
+        report("cList::sort, random     ", ListElements, timer);
+        check+= *list.begin();
+
+        cout << "  (" << check << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkSort g_globalBenchmarkSort;
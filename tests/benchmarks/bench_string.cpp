@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_string.cpp
+ *
+ * Count the heap allocations (calls to operator new) and the time of typical
+ * string-building workloads: concatenation chains, sub-strings assignments,
+ * splitting and collecting strings into containers. The last workloads
+ * construct, copy and destroy millions of short identifiers, and tokenize a
+ * multi-megabyte text using cString and using cStringView. The last
+ * workloads replace and split a 100MB text.
+ *
+ * Compile with XSTL_NO_CPP11 in order to measure the copying implementation.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/list.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringView.h"
+#include "xStl/data/wildcardMatcher.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkString : public cBenchmarkObject
+{
+public:
+    enum { Iterations = 100000,
+           ShortStrings = 10000000,
+           TextLines = 100000,
+           LargeTextBytes = 100 * 1024 * 1024 };
+
+    // Print the measurement of a workload
+    static void report(const char* name, uint64 allocations,
+                       const cBenchmarkTimer& timer)
+    {
+        uint64 time = timer.getMicroseconds();
+        cout << "  " << name << ": " << (uint32)(allocations / Iterations)
+             << "." << (uint32)(((allocations * 10) / Iterations) % 10)
+             << " allocations/iteration, " << time << " us" << endl;
+    }
+
+    virtual void run()
+    {
+        uint i;
+        uint32 checksum = 0;
+        cString name(XSTL_STRING("benchmark"));
+        cString path(XSTL_STRING("/usr/local/share/xstl/data/file.txt"));
+
+        // a + b + c + d
+        uint64 allocations = getAllocationsCount();
+        cBenchmarkTimer timer;
+        for (i = 0; i < Iterations; i++)
+        {
+            cString line = name + XSTL_STRING(": ") + path +
+                           XSTL_CHAR(';') + name;
+            checksum+= line.length();
+        }
+        report("concat chain     ", getAllocationsCount() - allocations, timer);
+
+        // s = s.left() / mid() / right()
+        allocations = getAllocationsCount();
+        timer.start();
+        for (i = 0; i < Iterations; i++)
+        {
+            cString part;
+            part = path.left(10);
+            part = path.mid(5, 10);
+            part = path.right(8);
+            checksum+= part.length();
+        }
+        report("sub-string assign", getAllocationsCount() - allocations, timer);
+
+        // split
+        allocations = getAllocationsCount();
+        timer.start();
+        for (i = 0; i < Iterations / 10; i++)
+        {
+            cList<cString> parts = path.split(XSTL_STRING("/"));
+            checksum+= parts.length();
+        }
+        report("split (x10)      ", (getAllocationsCount() - allocations) * 10,
+               timer);
+
+        // Collect strings into an array
+        allocations = getAllocationsCount();
+        timer.start();
+        cArray<cString> strings;
+        for (i = 0; i < Iterations; i++)
+        {
+            strings.append(name + XSTL_CHAR('.') + path.right(3));
+        }
+        checksum+= strings.getSize();
+        report("array collect    ", getAllocationsCount() - allocations, timer);
+
+        // Collect strings into a list
+        allocations = getAllocationsCount();
+        timer.start();
+        cList<cString> list;
+        for (i = 0; i < Iterations; i++)
+        {
+            list.append(path.left(4) + name);
+        }
+        checksum+= list.isEmpty() ? 0 : 1;
+        report("list collect     ", getAllocationsCount() - allocations, timer);
+
+        // Construct, copy and destroy short identifiers
+        static const character* identifiers[] = {
+            XSTL_STRING("i"), XSTL_STRING("count"), XSTL_STRING("m_buffer"),
+            XSTL_STRING("getStringLength"), XSTL_STRING("TRACE_LEVEL_INFO") };
+        allocations = getAllocationsCount();
+        timer.start();
+        for (i = 0; i < ShortStrings; i++)
+        {
+            cString identifier(identifiers[i % 5]);
+            cString copy(identifier);
+            checksum+= copy.length();
+        }
+        uint64 time = timer.getMicroseconds();
+        allocations = getAllocationsCount() - allocations;
+        cout << "  short strings    : "
+             << (uint32)(allocations / ShortStrings) << "."
+             << (uint32)(((allocations * 10) / ShortStrings) % 10)
+             << " allocations/string, " << time << " us" << endl;
+
+        // Tokenize a text of 'TextLines' lines
+        cString text;
+        for (i = 0; i < TextLines; i++)
+        {
+            text+= path;
+            text+= XSTL_CHAR('\n');
+        }
+        cout << "  text size        : " << text.length() << " characters"
+             << endl;
+
+        const cString newLine(XSTL_STRING("\n"));
+        const cString divider(XSTL_STRING("/"));
+        const cString pattern(XSTL_STRING("*.txt"));
+        allocations = getAllocationsCount();
+        timer.start();
+        cList<cString> lines = text.split(newLine);
+        for (cList<cString>::iterator line = lines.begin();
+             line != lines.end(); ++line)
+        {
+            checksum+= (*line).split(divider).length();
+            if (cWildcardMatcher::match(*line, pattern))
+                checksum++;
+        }
+        time = timer.getMicroseconds();
+        allocations = getAllocationsCount() - allocations;
+        cout << "  tokenize cString : " << allocations << " allocations, "
+             << time << " us" << endl;
+
+        const cStringView newLineView = newLine.getView();
+        const cStringView dividerView = divider.getView();
+        const cStringView patternView = pattern.getView();
+        cStringView textView = text.getView();
+        allocations = getAllocationsCount();
+        timer.start();
+        uint linePosition = 0;
+        cStringView line;
+        while (textView.getNextToken(newLineView, linePosition, line))
+        {
+            uint wordPosition = 0;
+            cStringView word;
+            while (line.getNextToken(dividerView, wordPosition, word))
+                checksum++;
+            if (cWildcardMatcher::match(line, patternView))
+                checksum++;
+        }
+        time = timer.getMicroseconds();
+        allocations = getAllocationsCount() - allocations;
+        cout << "  tokenize view    : " << allocations << " allocations, "
+             << time << " us" << endl;
+
+        // Replace and split a large text
+        cString largeText;
+        uint largeLength = LargeTextBytes / sizeof(character);
+        while (largeText.length() + path.length() < largeLength)
+        {
+            largeText+= path;
+            largeText+= XSTL_CHAR('\n');
+        }
+        cout << "  large text size  : " << (LargeTextBytes >> 20) << " MB"
+             << endl;
+
+        timer.start();
+        cString replaced(largeText);
+        replaced.replace(newLine, cString(XSTL_STRING("\r\n")));
+        cout << "  replace          : " << timer.getMicroseconds() << " us"
+             << endl;
+        checksum+= replaced.length();
+
+        timer.start();
+        cList<cString> largeLines = largeText.split(newLine);
+        cout << "  split            : " << timer.getMicroseconds() << " us"
+             << endl;
+        checksum+= largeLines.length();
+
+        timer.start();
+        largeText.split(newLineView, largeLines);
+        cout << "  split into list  : " << timer.getMicroseconds() << " us"
+             << endl;
+
+        timer.start();
+        cList<cStringView> largeViews = largeText.splitView(newLineView);
+        cout << "  split views      : " << timer.getMicroseconds() << " us"
+             << endl;
+        checksum+= largeViews.length();
+
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkString g_globalBenchmarkString;
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_stringBuilder.cpp
+ *
+ * Measure the throughput of building 1GB of text out of short lines: by
+ * concatenating into a cString, by a cStringBuilder (into a string, and into
+ * blocks which are read one at a time), by a cStringStream and by a
+ * cStringBuilderStream.
+ * Also measure the hex dump of a buffer into a cStringStream.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringBuilder.h"
+#include "xStl/data/datastream.h"
+#include "xStl/stream/stringerStream.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkStringBuilder : public cBenchmarkObject
+{
+public:
+    enum { OutputBytes = 1024 * 1024 * 1024,
+           DumpBytes = 4 * 1024 * 1024 };
+
+    // Print the throughput of a workload which produced 'bytes' of text
+    static void report(const char* name, const cBenchmarkTimer& timer,
+                       uint64 bytes)
+    {
+        uint64 time = t_max(timer.getMicroseconds(), (uint64)1);
+        cout << "  " << name << ": " << time << " us, "
+             << (uint64)(bytes / time) << " MB/s" << endl;
+    }
+
+    virtual void run()
+    {
+        const cString line("The quick brown fox jumps over the lazy dog\n");
+        const uint lines = OutputBytes / (line.length() * sizeof(character));
+        const uint64 bytes = (uint64)lines * line.length() * sizeof(character);
+        uint64 checksum = 0;
+        uint i;
+
+        cout << "  " << (bytes >> 20) << " MB of text" << endl;
+
+        cBenchmarkTimer timer;
+        {
+            cString text;
+            for (i = 0; i < lines; i++)
+                text+= line;
+            checksum+= text.length();
+        }
+        report("cString +=          ", timer, bytes);
+
+        timer.start();
+        {
+            cStringBuilder builder;
+            for (i = 0; i < lines; i++)
+                builder << line;
+            checksum+= builder.toString().length();
+        }
+        report("cStringBuilder      ", timer, bytes);
+
+        // Write the blocks out without creating one large string
+        timer.start();
+        {
+            cStringBuilder builder;
+            for (i = 0; i < lines; i++)
+                builder << line;
+            for (i = 0; i < builder.getBlocksCount(); i++)
+                checksum+= builder.getBlock(i).getBuffer()[0];
+        }
+        report("cStringBuilder block", timer, bytes);
+
+        timer.start();
+        {
+            cStringStream stream;
+            for (i = 0; i < lines; i++)
+                stream << line;
+            checksum+= stream.getData().length();
+        }
+        report("cStringStream       ", timer, bytes);
+
+        timer.start();
+        {
+            cStringBuilder builder;
+            cStringBuilderStream stream(builder);
+            for (i = 0; i < lines; i++)
+                stream << line;
+            checksum+= builder.getBlocksCount();
+        }
+        report("cStringBuilderStream", timer, bytes);
+
+        // A hex dump, about 4 characters of text for each byte
+        cBuffer data(DumpBytes);
+        for (i = 0; i < DumpBytes; i++)
+            data[i] = (uint8)(i * 7);
+        timer.start();
+        {
+            cStringStream stream;
+            DATA dump(data.begin(), data.end());
+            stream << dump;
+            checksum+= stream.getData().length();
+        }
+        report("hex dump (input MB) ", timer, DumpBytes);
+
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkStringBuilder g_globalBenchmarkStringBuilder;
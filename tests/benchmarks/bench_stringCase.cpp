@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_stringCase.cpp
+ *
+ * Measure the case conversion and the case insensitive comparison of
+ * cStringCase against the character by character implementation (cChar),
+ * and the lookup of case insensitive keys in a cHash with
+ * cCaseInsensitiveString against keys which are copied and converted to
+ * lower-case before each lookup.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/hash.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/data/caseInsensitiveString.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkStringCase : public cBenchmarkObject
+{
+public:
+    enum { TextLength = 16 * 1024 * 1024,
+           Keys = 1000,
+           Lookups = 1000000 };
+
+    static void report(const char* name, const cBenchmarkTimer& timer)
+    {
+        cout << "  " << name << ": " << timer.getMicroseconds() << " us"
+             << endl;
+    }
+
+    virtual void run()
+    {
+        static const character sentence[] =
+            XSTL_STRING("The Quick Brown Fox Jumps Over The Lazy Dog. ");
+        cString text;
+        while (text.length() < TextLength)
+            text+= sentence;
+        cout << "  text size        : " << text.length() << " characters"
+             << endl;
+
+        uint64 checksum = 0;
+
+        // Case conversion
+        cString upper(text);
+        cBenchmarkTimer timer;
+        character* buffer = upper.getBuffer();
+        for (uint i = 0; i < upper.length(); i++)
+            buffer[i] = cChar::getUppercase(buffer[i]);
+        report("makeUpper cChar  ", timer);
+
+        cString vectorUpper(text);
+        timer.start();
+        vectorUpper.makeUpper();
+        report("makeUpper        ", timer);
+        checksum+= (upper == vectorUpper) ? 1 : 0;
+
+        // Case insensitive comparison
+        timer.start();
+        checksum+= cChar::stricmp(text.getBuffer(), upper.getBuffer());
+        report("icompare stricmp ", timer);
+
+        timer.start();
+        checksum+= text.icompare(upper);
+        report("icompare         ", timer);
+
+        // Case insensitive keys. The keys are looked up in a different case
+        // than the case they were added with.
+        cHash<cString, int> lowerHash;
+        cHash<cCaseInsensitiveString, int> keyHash;
+        cString keys[Keys];
+        cCaseInsensitiveString lookupKeys[Keys];
+        for (uint i = 0; i < Keys; i++)
+        {
+            cString key(cString(XSTL_STRING("X-Application-Header-Name-")) +
+                        cString(i));
+            cString lower(key);
+            lower.makeLower();
+            lowerHash.append(lower, i);
+            keyHash.append(lower, i);
+
+            key.makeUpper();
+            keys[i] = key;
+            lookupKeys[i] = key;
+        }
+
+        timer.start();
+        for (uint i = 0; i < Lookups; i++)
+        {
+            cString lower(keys[i % Keys]);
+            lower.makeLower();
+            checksum+= lowerHash[lower];
+        }
+        report("lower-case keys  ", timer);
+
+        timer.start();
+        for (uint i = 0; i < Lookups; i++)
+            checksum+= keyHash[lookupKeys[i % Keys]];
+        report("insensitive keys ", timer);
+
+        cout << "  (" << checksum << ")" << endl;
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkStringCase g_globalBenchmarkStringCase;
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * bench_stringSearch.cpp
+ *
+ * Measure the sub-string search engines over large text haystacks. The
+ * haystack is a random lower-case text, so the first character of the needle
+ * appears every few bytes. The needles are placed at the end (for find) and at
+ * the beginning (for rfind) so the whole haystack is scanned.
+ *
+ * Haystacks which cannot be allocated are skipped.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringSearch.h"
+#include "xStl/os/osrand.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+class cBenchmarkStringSearch : public cBenchmarkObject
+{
+public:
+    enum { PatternLength = 4093 };
+
+    // Run a single haystack size over all the supported engines
+    static void runHaystack(const char* haystack, uint length)
+    {
+        static const char needle[] = "needle";
+        static const char reverseNeedle[] = "eldeen";
+        const uint needleLength = sizeof(needle) - 1;
+
+        cout << "  " << (length >> 20) << "MB:" << endl;
+        static const char* names[] = { "scalar", "sse2  ", "avx2  " };
+        for (int engine = cStringSearch::ScalarEngine;
+             engine <= cStringSearch::AVX2Engine;
+             engine++)
+        {
+            if (!cStringSearch::isEngineSupported((cStringSearch::Engine)engine))
+                continue;
+            cStringSearch::setEngine((cStringSearch::Engine)engine);
+
+            cBenchmarkTimer timer;
+            uint position = cStringSearch::find(haystack, length,
+                                                needle, needleLength);
+            uint64 findTime = timer.getMicroseconds();
+            timer.start();
+            uint reversePosition = cStringSearch::rfind(haystack, length,
+                                                        reverseNeedle,
+                                                        needleLength);
+            uint64 rfindTime = timer.getMicroseconds();
+
+            cout << "    " << names[engine] << " find: " << findTime
+                 << " us (" << ((uint64)length / t_max(findTime, (uint64)1))
+                 << " MB/s)  rfind: " << rfindTime << " us  ["
+                 << position << "," << reversePosition << "]" << endl;
+        }
+    }
+
+    virtual void run()
+    {
+        cStringSearch::Engine original = cStringSearch::getEngine();
+
+        // A random text pattern
+        char pattern[PatternLength];
+        for (uint i = 0; i < PatternLength; i++)
+            pattern[i] = (char)('a' + (cOSRand::rand() % 26));
+
+        static const uint sizes[] = { 1, 16, 256, 1024 };
+        for (uint i = 0; i < arraysize(sizes); i++)
+        {
+            uint length = sizes[i] << 20;
+            XSTL_TRY
+            {
+                cBuffer haystack(length);
+                char* data = (char*)haystack.getBuffer();
+                for (uint j = 0; j < length; j+= PatternLength)
+                    memcpy(data + j, pattern, t_min((uint)PatternLength, length - j));
+                memcpy(data, "eldeen", 6);
+                memcpy(data + length - 6, "needle", 6);
+                runHaystack(data, length);
+            }
+            XSTL_CATCH_ALL
+            {
+                cout << "  " << sizes[i] << "MB: cannot allocate, skipped"
+                     << endl;
+            }
+        }
+
+        cStringSearch::setEngine(original);
+    }
+
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance benchmark object
+cBenchmarkStringSearch g_globalBenchmarkStringSearch;
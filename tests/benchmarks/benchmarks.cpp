@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * benchmarks.cpp
+ *
+ * Main module for all xStl benchmarks. Execute all the registered benchmarks,
+ * or only the benchmarks which their name contains one of the command-line
+ * arguments.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+// The system headers must be included before xStl redefines 'uint'
+#include <new>
+#include <stdlib.h>
+#ifdef LINUX
+    #include <sys/time.h>
+    #include <malloc.h>
+#endif
+
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/list.h"
+#include "xStl/except/exception.h"
+#include "xStl/stream/ioStream.h"
+#include "benchmarks.h"
+
+/*
+ * All the constructed class are register inside a link-list which execute them.
+ */
+class benchmarks_container{
+public:
+    static cList<cBenchmarkObject*>& get_benchmarks()
+    {
+        static cList<cBenchmarkObject*> g_benchmarks;
+        return g_benchmarks;
+    }
+};
+
+// The number of calls to the global operator new
+static volatile uint64 g_allocationsCount = 0;
+
+/*
+ * Count every allocation of the program. The operators are plain malloc/free
+ * wrappers.
+ */
+void* operator new(size_t size)
+{
+    g_allocationsCount++;
+    void* ret = malloc((size == 0) ? 1 : size);
+    if (ret == NULL)
+        throw std::bad_alloc();
+    return ret;
+}
+
+void* operator new[](size_t size)
+{
+    g_allocationsCount++;
+    void* ret = malloc((size == 0) ? 1 : size);
+    if (ret == NULL)
+        throw std::bad_alloc();
+    return ret;
+}
+
+void operator delete(void* ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    free(ptr);
+}
+
+cBenchmarkObject::cBenchmarkObject()
+{
+    benchmarks_container::get_benchmarks().append(this);
+}
+
+uint64 cBenchmarkObject::getAllocationsCount()
+{
+    return g_allocationsCount;
+}
+
+uint64 cBenchmarkObject::getHeapBytes()
+{
+    #ifdef XSTL_LINUX
+        struct mallinfo2 info = mallinfo2();
+        return (uint64)info.uordblks + (uint64)info.hblkhd;
+    #else
+        return 0;
+    #endif
+}
+
+cBenchmarkTimer::cBenchmarkTimer()
+{
+    start();
+}
+
+void cBenchmarkTimer::start()
+{
+    m_start = now();
+}
+
+uint64 cBenchmarkTimer::getMicroseconds() const
+{
+    return now() - m_start;
+}
+
+uint64 cBenchmarkTimer::getMilliseconds() const
+{
+    return getMicroseconds() / 1000;
+}
+
+uint64 cBenchmarkTimer::now()
+{
+    #ifdef XSTL_LINUX
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        return ((uint64)tv.tv_sec * 1000000) + (uint64)tv.tv_usec;
+    #else
+        return (uint64)GetTickCount() * 1000;
+    #endif
+}
+
+/*
+ * main
+ *
+ * Scan all registered modules and execute the selected ones.
+ */
+int main(const int argc, const char** argv)
+{
+    XSTL_TRY
+    {
+        cout << endl;
+        cout << "xStl benchmarks" << endl << endl;
+
+        for (cList<cBenchmarkObject*>::iterator i = benchmarks_container::get_benchmarks().begin();
+                                                i!= benchmarks_container::get_benchmarks().end();
+                                                i++)
+        {
+            // Filter the benchmarks by the command-line
+            bool shouldRun = (argc <= 1);
+            for (int j = 1; j < argc; j++)
+            {
+                cString filter(argv[j]);
+                if ((*i)->getName().find(filter) != (*i)->getName().length())
+                    shouldRun = true;
+            }
+            if (!shouldRun)
+                continue;
+
+            cout << "Benchmark " << (*i)->getName() << endl;
+            XSTL_TRY
+            {
+                (*i)->run();
+            }
+            XSTL_CATCH (cException& e)
+            {
+                cout << endl << "Exception: " << e.getMessage() << " (" << e.getID() << ')' << endl;
+                return RC_ERROR;
+            }
+            cout << endl;
+        }
+        return RC_OK;
+    }
+    XSTL_CATCH(...)
+    {
+        cout << "Unexcpected error at benchmarks module... "  << endl;
+        return RC_ERROR;
+    }
+}
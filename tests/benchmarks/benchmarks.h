@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+#ifndef __TBA_STL_BENCHMARKS_H
+#define __TBA_STL_BENCHMARKS_H
+
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/list.h"
+#include "xStl/except/exception.h"
+#include "xStl/stream/ioStream.h"
+
+/*
+ * benchmarks.h
+ *
+ * Declare the global cBenchmarkObject which instance a benchmark object. Same
+ * as the cTestObject, the object register itself to a list which is executed
+ * by the benchmarks main module.
+ *
+ * Benchmarks are not part of the uni-tests, since they take a long time and
+ * their result is a time measurement and not a pass/fail state.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+class cBenchmarkObject
+{
+public:
+    /*
+     * Default constructor must be public.
+     */
+    cBenchmarkObject();
+
+    /*
+     * Virtual dtor.
+     */
+    virtual ~cBenchmarkObject() {};
+
+    /*
+     * Execute the benchmark and print the measurements into 'cout'.
+     */
+    virtual void run() = 0;
+
+    /*
+     * Returns the name for the benchmark module.
+     */
+    virtual cString getName() = 0;
+
+    /*
+     * Return the number of calls to the global operator new since the program
+     * started. Used for allocation-count benchmarks.
+     */
+    static uint64 getAllocationsCount();
+
+    /*
+     * Return the number of bytes the program allocated from the heap (and
+     * didn't free yet), or 0 if it isn't known on this platform.
+     */
+    static uint64 getHeapBytes();
+};
+
+/*
+ * Measure time intervals in micro-seconds resolution.
+ */
+class cBenchmarkTimer
+{
+public:
+    /*
+     * Constructor. Start the measurement.
+     */
+    cBenchmarkTimer();
+
+    /*
+     * Restart the measurement.
+     */
+    void start();
+
+    /*
+     * Return the number of micro-seconds since the last call to start().
+     */
+    uint64 getMicroseconds() const;
+
+    /*
+     * Return the number of milli-seconds since the last call to start().
+     */
+    uint64 getMilliseconds() const;
+
+    /*
+     * Return the current time in micro-seconds.
+     */
+    static uint64 now();
+
+private:
+    // The start time
+    uint64 m_start;
+};
+
+#endif //__TBA_STL_BENCHMARKS_H
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_algorithm.cpp
+ *
+ * Test the sort algorithms of algorithm.h and the sort of cList.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/utils/algorithm.h"
+#include "xStl/data/array.h"
+#include "xStl/data/list.h"
+#include "xStl/data/string.h"
+#include "xStl/os/osrand.h"
+#include "../../xStl/tests/tests.h"
+
+class cTestAlgorithm : public cTestObject
+{
+public:
+    // An element which is ordered only by its key
+    class cItem
+    {
+    public:
+        cItem(uint key = 0, uint order = 0) : m_key(key), m_order(order) {}
+        bool operator < (const cItem& other) const { return m_key < other.m_key; }
+        bool operator == (const cItem& other) const
+        {
+            return (m_key == other.m_key) && (m_order == other.m_order);
+        }
+
+        uint m_key;
+        uint m_order;
+    };
+
+    // Reverse order
+    class cGreaterThan
+    {
+    public:
+        bool operator () (uint a, uint b) const { return a > b; }
+    };
+
+    // The key of a cItem for the radix sort
+    class cItemKey
+    {
+    public:
+        uint64 operator () (const cItem& item) const { return item.m_key; }
+    };
+
+    // Generate 'count' numbers. 'kind' selects random, sorted, reversed, few
+    // distinct values or an "organ pipe" sequence
+    static void generate(cArray<uint>& array, uint count, uint kind)
+    {
+        array.changeSize(count);
+        for (uint i = 0; i < count; i++)
+        {
+            switch (kind)
+            {
+            case 0: array[i] = cOSRand::rand() % 100000; break;
+            case 1: array[i] = i; break;
+            case 2: array[i] = count - i; break;
+            case 3: array[i] = cOSRand::rand() % 4; break;
+            default: array[i] = (i < count / 2) ? i : (count - i); break;
+            }
+        }
+    }
+
+    // Return true if the array is sorted
+    static bool isSorted(const cArray<uint>& array)
+    {
+        for (uint i = 1; i < array.getSize(); i++)
+            if (array[i] < array[i - 1])
+                return false;
+        return true;
+    }
+
+    // Return true if both arrays has the same elements in the same order
+    static bool isEqual(const cArray<uint>& a, const cArray<uint>& b)
+    {
+        if (a.getSize() != b.getSize())
+            return false;
+        for (uint i = 0; i < a.getSize(); i++)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+
+    // Return the sum of the elements, to check that the elements were kept
+    static uint64 sum(const cArray<uint>& array)
+    {
+        uint64 ret = 0;
+        for (uint i = 0; i < array.getSize(); i++)
+            ret+= array[i];
+        return ret;
+    }
+
+    void test_sort()
+    {
+        static const uint sizes[] = {0, 1, 2, 3, 15, 16, 17, 100, 1000, 20000};
+        for (uint kind = 0; kind < 5; kind++)
+        {
+            for (uint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+            {
+                cArray<uint> array;
+                generate(array, sizes[s], kind);
+                uint64 total = sum(array);
+                cArray<uint> original(array);
+                cArray<uint> copy(array);
+
+                sort(array.getBuffer(), array.getBuffer() + array.getSize());
+                TESTS_ASSERT(isSorted(array));
+                TESTS_ASSERT_EQUAL(sum(array), total);
+
+                // The array iterators
+                sort(copy.begin(), copy.end());
+                TESTS_ASSERT(isEqual(copy, array));
+
+                // Radix sort
+                copy = original;
+                radixSort(copy.getBuffer(), copy.getBuffer() + copy.getSize());
+                TESTS_ASSERT(isEqual(copy, array));
+
+                // Reverse order
+                sort(copy.getBuffer(), copy.getBuffer() + copy.getSize(),
+                     cGreaterThan());
+                for (uint i = 0; i < copy.getSize(); i++)
+                    TESTS_ASSERT_EQUAL(copy[i], array[copy.getSize() - i - 1]);
+            }
+        }
+
+        // Elements which are not integers
+        cArray<cString> strings;
+        strings.append(XSTL_STRING("delta"));
+        strings.append(XSTL_STRING("alpha"));
+        strings.append(XSTL_STRING("charlie"));
+        strings.append(XSTL_STRING("bravo"));
+        sort(strings.begin(), strings.end());
+        TESTS_ASSERT_EQUAL(strings[0], XSTL_STRING("alpha"));
+        TESTS_ASSERT_EQUAL(strings[1], XSTL_STRING("bravo"));
+        TESTS_ASSERT_EQUAL(strings[3], XSTL_STRING("delta"));
+    }
+
+    void test_radixSort()
+    {
+        // Signed numbers
+        int32 numbers[1000];
+        int64 wide[1000];
+        uint i;
+        for (i = 0; i < 1000; i++)
+        {
+            numbers[i] = (int32)(cOSRand::rand() % 2000) - 1000;
+            wide[i] = (int64)numbers[i] * 0x10000 * 0x10000;
+        }
+        numbers[0] = -0x7FFFFFFF - 1;
+        numbers[1] = 0x7FFFFFFF;
+        radixSort(numbers, numbers + 1000);
+        radixSort(wide, wide + 1000);
+        for (i = 1; i < 1000; i++)
+        {
+            TESTS_ASSERT(numbers[i - 1] <= numbers[i]);
+            TESTS_ASSERT(wide[i - 1] <= wide[i]);
+        }
+        TESTS_ASSERT_EQUAL(numbers[0], -0x7FFFFFFF - 1);
+        TESTS_ASSERT_EQUAL(numbers[999], 0x7FFFFFFF);
+
+        // The radix sort is stable
+        cArray<cItem> items;
+        for (i = 0; i < 5000; i++)
+            items.append(cItem(cOSRand::rand() % 300, i));
+        radixSort(items.getBuffer(), items.getBuffer() + items.getSize(),
+                  cItemKey());
+        for (i = 1; i < items.getSize(); i++)
+        {
+            TESTS_ASSERT(!(items[i] < items[i - 1]));
+            if (items[i].m_key == items[i - 1].m_key)
+                TESTS_ASSERT(items[i].m_order > items[i - 1].m_order);
+        }
+    }
+
+    void test_partialSort()
+    {
+        for (uint kind = 0; kind < 5; kind++)
+        {
+            cArray<uint> sorted;
+            generate(sorted, 5000, kind);
+            cArray<uint> array(sorted);
+            sort(sorted.getBuffer(), sorted.getBuffer() + sorted.getSize());
+
+            static const uint positions[] = {0, 1, 7, 2500, 4999, 5000};
+            for (uint p = 0; p < sizeof(positions) / sizeof(positions[0]); p++)
+            {
+                uint position = positions[p];
+                cArray<uint> copy(array);
+                uint* begin = copy.getBuffer();
+                uint* end = begin + copy.getSize();
+                partialSort(begin, begin + position, end);
+                uint i;
+                for (i = 0; i < position; i++)
+                    TESTS_ASSERT_EQUAL(copy[i], sorted[i]);
+                TESTS_ASSERT_EQUAL(sum(copy), sum(array));
+
+                if (position == copy.getSize())
+                    continue;
+                copy = array;
+                begin = copy.getBuffer();
+                end = begin + copy.getSize();
+                nthElement(begin, begin + position, end);
+                TESTS_ASSERT_EQUAL(copy[position], sorted[position]);
+                for (i = 0; i < position; i++)
+                    TESTS_ASSERT(copy[i] <= copy[position]);
+                for (i = position + 1; i < copy.getSize(); i++)
+                    TESTS_ASSERT(copy[i] >= copy[position]);
+            }
+        }
+    }
+
+    void test_listSort()
+    {
+        cList<cItem> list;
+        list.sort();
+        TESTS_ASSERT(list.isEmpty());
+        list.append(cItem(1, 0));
+        list.sort();
+        TESTS_ASSERT_EQUAL(list.length(), 1);
+
+        uint i;
+        for (i = 1; i < 3000; i++)
+            list.append(cItem(cOSRand::rand() % 100, i));
+        cList<cItem>::iterator first = list.begin();
+        cItem* firstAddress = &(*first);
+        list.sort();
+
+        TESTS_ASSERT_EQUAL(list.length(), 3000);
+        cList<cItem>::iterator j = list.begin();
+        cItem previous = *j;
+        for (++j, i = 1; j != list.end(); ++j, i++)
+        {
+            TESTS_ASSERT(!((*j) < previous));
+            if ((*j).m_key == previous.m_key)
+                TESTS_ASSERT((*j).m_order > previous.m_order);
+            previous = *j;
+        }
+        TESTS_ASSERT_EQUAL(i, 3000);
+
+        // The nodes were relinked, not copied
+        TESTS_ASSERT(firstAddress->m_order == 0);
+
+        // The links backward are valid
+        j = list.end();
+        for (i = 0; i < 3000; i++)
+            --j;
+        TESTS_ASSERT(j == list.begin());
+
+        // The list is usable after the sort
+        list.append(cItem(0, 5000));
+        list.insert(cItem(200, 5001));
+        TESTS_ASSERT_EQUAL(list.length(), 3002);
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_sort();
+        test_radixSort();
+        test_partialSort();
+        test_listSort();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestAlgorithm g_globalTestAlgorithm;
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_arena.cpp
+ *
+ * Test the cArena allocator and the allocators of the containers.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+#include "xStl/data/allocator.h"
+#include "xStl/data/arena.h"
+#include "xStl/data/array.h"
+#include "xStl/data/list.h"
+#include "xStl/data/string.h"
+#include "xStl/data/hash.h"
+#include "xStl/os/threadPool.h"
+#include "xStl/utils/parallel.h"
+#include "xStl/except/trace.h"
+#include "tests.h"
+
+class cTestArena : public cTestObject
+{
+public:
+    // An allocator which counts the blocks it owns
+    class cCountingAllocator : public cAllocator
+    {
+    public:
+        cCountingAllocator() : m_blocks(0), m_bytes(0) {}
+
+        virtual void* allocate(uint size)
+        {
+            m_blocks++;
+            m_bytes+= size;
+            return cOS::smallMemoryAllocation(size);
+        }
+
+        virtual void* reallocate(void* block, uint oldSize, uint newSize)
+        {
+            if (block == NULL)
+                return allocate(newSize);
+            m_bytes+= newSize;
+            m_bytes-= oldSize;
+            return cOS::smallMemoryRealloc(block, newSize);
+        }
+
+        virtual void free(void* block, uint size)
+        {
+            m_blocks--;
+            m_bytes-= size;
+            cOS::smallMemoryFree(block);
+        }
+
+        // The number of allocated blocks and bytes
+        int m_blocks;
+        int m_bytes;
+    };
+
+    // An object which counts its instances
+    class cObject
+    {
+    public:
+        cObject() : m_value(7) { g_instances++; }
+        cObject(const cObject& other) : m_value(other.m_value) { g_instances++; }
+        ~cObject() { g_instances--; }
+        bool operator == (const cObject& other) const { return m_value == other.m_value; }
+
+        int m_value;
+        static int g_instances;
+    };
+
+    static bool isAligned(void* block)
+    {
+        return ((addressNumericValue)block % cArena::Alignment) == 0;
+    }
+
+    void testArena()
+    {
+        cArena arena(1024);
+        TESTS_ASSERT_EQUAL(arena.getAllocatedBytes(), 0);
+
+        // Bump allocations are consecutive and aligned
+        uint8* a = (uint8*)arena.allocate(10);
+        uint8* b = (uint8*)arena.allocate(1);
+        TESTS_ASSERT(isAligned(a));
+        TESTS_ASSERT(isAligned(b));
+        TESTS_ASSERT(b == a + cArena::Alignment);
+        TESTS_ASSERT(arena.getAllocatedBytes() >= 1024);
+
+        // The last allocation is rolled back
+        arena.free(b, 1);
+        TESTS_ASSERT(arena.allocate(16) == b);
+
+        // The last allocation grows in place
+        uint8* c = (uint8*)arena.allocate(16);
+        memset(c, 0x5A, 16);
+        TESTS_ASSERT(arena.reallocate(c, 16, 100) == c);
+        TESTS_ASSERT_EQUAL(c[15], 0x5A);
+
+        // Other blocks are copied
+        uint8* d = (uint8*)arena.reallocate(a, 10, 64);
+        TESTS_ASSERT(d != a);
+        TESTS_ASSERT(isAligned(d));
+
+        // Large blocks get their own chunk, the current chunk is kept
+        uint8* e = (uint8*)arena.allocate(16);
+        uint8* large = (uint8*)arena.allocate(4000);
+        TESTS_ASSERT(large != NULL);
+        TESTS_ASSERT(arena.allocate(16) == e + 16);
+        memset(large, 0, 4000);
+
+        // Many allocations
+        for (uint i = 0; i < 1000; i++)
+        {
+            uint8* block = (uint8*)arena.allocate(i % 100);
+            TESTS_ASSERT(isAligned(block));
+            memset(block, 0, i % 100);
+        }
+
+        arena.freeAll();
+        TESTS_ASSERT_EQUAL(arena.getAllocatedBytes(), 0);
+        TESTS_ASSERT(arena.allocate(16) != NULL);
+    }
+
+    void testLargeFirst()
+    {
+        // A large first allocation must not become the bump position
+        cArena arena;
+        uint8* large = (uint8*)arena.allocate(20000);
+        uint8* small = (uint8*)arena.allocate(16);
+        TESTS_ASSERT(large != NULL);
+        TESTS_ASSERT(small != NULL);
+        TESTS_ASSERT((small + 16 <= large) || (small >= large + 20000));
+        TESTS_ASSERT(arena.allocate(16) == small + 16);
+
+        // Rolling back the large block doesn't hand its memory out twice
+        arena.free(large, 20000);
+        uint8* other = (uint8*)arena.allocate(16);
+        TESTS_ASSERT(other != small);
+
+        // An array whose first block is large
+        cArena arrayArena;
+        cArray<uint8> array;
+        array.setAllocator(&arrayArena);
+        array.changeSize(20000);
+        memset(array.getBuffer(), 0x5A, 20000);
+        uint8* next = (uint8*)arrayArena.allocate(16);
+        memset(next, 0, 16);
+        TESTS_ASSERT_EQUAL(array[0], 0x5A);
+        TESTS_ASSERT_EQUAL(array[19999], 0x5A);
+    }
+
+    void testFreeLists()
+    {
+        cArena arena(4096, true);
+        void* a = arena.allocate(24);
+        void* b = arena.allocate(24);
+        void* c = arena.allocate(100);
+        arena.free(a, 24);
+        arena.free(c, 100);
+
+        // The same size class is recycled
+        TESTS_ASSERT(arena.allocate(20) == a);
+        TESTS_ASSERT(arena.allocate(112) == c);
+        void* d = arena.allocate(24);
+        TESTS_ASSERT((d != a) && (d != b));
+    }
+
+    void testObjects()
+    {
+        cArena arena;
+        int instances = cObject::g_instances;
+        cObject* object = new (arena) cObject();
+        TESTS_ASSERT_EQUAL(object->m_value, 7);
+        TESTS_ASSERT(isAligned(object));
+        object->~cObject();
+        TESTS_ASSERT_EQUAL(cObject::g_instances, instances);
+    }
+
+    void testArray()
+    {
+        cCountingAllocator allocator;
+        {
+            cArray<uint> array;
+            array.setAllocator(&allocator);
+            TESTS_ASSERT(array.getAllocator() == &allocator);
+            for (uint i = 0; i < 1000; i++)
+                array.append(i);
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 1);
+            TESTS_ASSERT_EQUAL(array[999], 999);
+
+            // Copies use the default allocator
+            cArray<uint> copy(array);
+            TESTS_ASSERT(copy.getAllocator() == NULL);
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 1);
+
+            // operator = keeps the allocator
+            cArray<uint> other;
+            other.setAllocator(&allocator);
+            other = copy;
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 2);
+            TESTS_ASSERT_EQUAL(other[500], 500);
+
+            // swap exchanges the allocators
+            copy.swap(other);
+            TESTS_ASSERT(copy.getAllocator() == &allocator);
+            TESTS_ASSERT(other.getAllocator() == NULL);
+
+            // The allocator can be replaced only while the array is empty
+            TESTS_EXCEPTION(array.setAllocator(NULL));
+        }
+        TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+        TESTS_ASSERT_EQUAL(allocator.m_bytes, 0);
+
+        // Non plain-old-data elements are constructed and destroyed
+        int instances = cObject::g_instances;
+        {
+            cArray<cObject> array;
+            array.setAllocator(&allocator);
+            array.changeSize(100);
+            TESTS_ASSERT(cObject::g_instances >= instances + 100);
+            TESTS_ASSERT_EQUAL(array[99].m_value, 7);
+            array[5].m_value = 8;
+            array.changeSize(1000);
+            TESTS_ASSERT_EQUAL(array[5].m_value, 8);
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 1);
+        }
+        TESTS_ASSERT_EQUAL(cObject::g_instances, instances);
+        TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+    }
+
+    void testList()
+    {
+        cCountingAllocator allocator;
+        {
+            cList<cString> list;
+            list.setAllocator(&allocator);
+            for (uint i = 0; i < 1000; i++)
+                list.append(cString(i));
+            TESTS_ASSERT(allocator.m_blocks > 0);
+            TESTS_ASSERT_EQUAL(list.length(), 1000);
+            TESTS_ASSERT_EQUAL(*list.begin(), XSTL_STRING("0"));
+            TESTS_EXCEPTION(list.setAllocator(NULL));
+
+            list.removeAll();
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+            list.append(XSTL_STRING("again"));
+            TESTS_ASSERT(allocator.m_blocks > 0);
+        }
+        TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+        TESTS_ASSERT_EQUAL(allocator.m_bytes, 0);
+    }
+
+    void testString()
+    {
+        cCountingAllocator allocator;
+        cString longString(XSTL_STRING("A string which is longer than the ")
+                           XSTL_STRING("inline storage of the string"));
+        {
+            cString string;
+            string.setAllocator(&allocator);
+            TESTS_ASSERT(string.getAllocator() == &allocator);
+
+            // Short strings don't allocate
+            string = XSTL_STRING("abc");
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+
+            string = longString;
+            TESTS_ASSERT_EQUAL(allocator.m_blocks, 1);
+            TESTS_ASSERT_EQUAL(string, longString);
+            string+= longString;
+            TESTS_ASSERT_EQUAL(string.length(), longString.length() * 2);
+
+            // Shared strings free their memory with the allocator
+            cString shared;
+            shared.setAllocator(&allocator);
+            shared = longString;
+            shared.share();
+            cString reference(shared);
+            shared = XSTL_STRING("x");
+            TESTS_ASSERT_EQUAL(reference, longString);
+
+            // Copies of a shared string of an allocator don't reference it
+            cString sharedArena;
+            sharedArena.setAllocator(&allocator);
+            sharedArena = longString;
+            sharedArena.share();
+            cString copy(sharedArena);
+            TESTS_ASSERT(copy.getAllocator() == NULL);
+            TESTS_ASSERT(!copy.isShared());
+            TESTS_ASSERT_EQUAL(copy, longString);
+            cString assigned;
+            assigned = sharedArena;
+            TESTS_ASSERT(!assigned.isShared());
+            cString sameAllocator;
+            sameAllocator.setAllocator(&allocator);
+            sameAllocator = sharedArena;
+            TESTS_ASSERT(sameAllocator.isShared());
+
+            // Assigning a shared string keeps the allocator
+            cString other;
+            other.setAllocator(&allocator);
+            other = reference;
+            TESTS_ASSERT(other.getAllocator() == &allocator);
+            other+= XSTL_STRING("!");
+            TESTS_ASSERT(other.getAllocator() == &allocator);
+
+            // swap exchanges the allocators
+            cString plain(longString);
+            plain.swap(string);
+            TESTS_ASSERT(plain.getAllocator() == &allocator);
+            TESTS_ASSERT(string.getAllocator() == NULL);
+            TESTS_EXCEPTION(plain.setAllocator(NULL));
+
+            // replace() keeps the allocator
+            plain.replace(XSTL_STRING("string"), XSTL_STRING("text"));
+            TESTS_ASSERT(plain.getAllocator() == &allocator);
+            TESTS_ASSERT(plain.find(XSTL_STRING("text")) < plain.length());
+        }
+        TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+        TESTS_ASSERT_EQUAL(allocator.m_bytes, 0);
+    }
+
+    void testParallelSort()
+    {
+        cCountingAllocator allocator;
+        {
+            cThreadPool pool(4);
+            cArray<uint> array;
+            array.setAllocator(&allocator);
+            uint count = 100000;
+            for (uint i = 0; i < count; i++)
+                array.append((i * 7919) % count);
+            parallelSort(array, cLessThan<uint>(), pool);
+            TESTS_ASSERT(array.getAllocator() == &allocator);
+            for (uint j = 0; j < count; j++)
+                TESTS_ASSERT_EQUAL(array[j], j);
+        }
+        TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+        TESTS_ASSERT_EQUAL(allocator.m_bytes, 0);
+    }
+
+    void testHash()
+    {
+        cCountingAllocator allocator;
+        {
+            cHash<uint, uint> hash;
+            hash.setAllocator(&allocator);
+            TESTS_ASSERT(hash.getAllocator() == &allocator);
+            for (uint i = 0; i < 1000; i++)
+                hash.append(i, i * 2);
+            TESTS_ASSERT(allocator.m_blocks > 1);
+            TESTS_ASSERT_EQUAL(hash[500], 1000);
+            TESTS_EXCEPTION(hash.setAllocator(NULL));
+
+            cHash<uint, uint> copy(hash);
+            TESTS_ASSERT(copy.getAllocator() == NULL);
+            TESTS_ASSERT_EQUAL(copy[999], 1998);
+
+            hash.removeAll();
+            TESTS_ASSERT(!hash.hasKey(500));
+            hash.append(1, 2);
+            TESTS_ASSERT(hash.getAllocator() == &allocator);
+
+            copy = hash;
+            TESTS_ASSERT(copy.getAllocator() == NULL);
+            TESTS_ASSERT_EQUAL(copy[1], 2);
+            TESTS_ASSERT(!copy.hasKey(500));
+        }
+        TESTS_ASSERT_EQUAL(allocator.m_blocks, 0);
+        TESTS_ASSERT_EQUAL(allocator.m_bytes, 0);
+
+        // A hash inside an arena
+        cArena arena;
+        cHash<uint, uint>* hash = new (arena) cHash<uint, uint>();
+        hash->setAllocator(&arena);
+        for (uint i = 0; i < 1000; i++)
+            hash->append(i, i);
+        TESTS_ASSERT_EQUAL((*hash)[123], 123);
+        arena.freeAll();
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        testArena();
+        testLargeFirst();
+        testFreeLists();
+        testObjects();
+        testArray();
+        testList();
+        testString();
+        testParallelSort();
+        testHash();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+int cTestArena::cObject::g_instances = 0;
+
+// Instance test object
+cTestArena g_globalTestArena;
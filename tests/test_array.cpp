@@ -73,6 +73,13 @@ public:
     unsigned int m_global;
 };
 
+// Plain-old-data element
+struct TESTPOD
+{
+    uint32 m_a;
+    uint8 m_b;
+};
+
 
 class cTestArray : public cTestObject
 {
@@ -224,6 +231,186 @@ public:
         }
     }
 
+    // Test the geometric growth and the capacity control methods
+    void test_capacity()
+    {
+        uint i;
+        cBuffer buffer;
+        TESTS_ASSERT_EQUAL(buffer.getCapacity(), 0);
+        TESTS_ASSERT_EQUAL(buffer.getGrowthFactor(), cBuffer::DefaultGrowthFactor);
+
+        // Appending must reallocate only a logarithmic number of times
+        uint reallocations = 0;
+        uint lastCapacity = 0;
+        for (i = 0; i < 100000; i++)
+        {
+            buffer.append((uint8)i);
+            TESTS_ASSERT(buffer.getCapacity() >= buffer.getSize());
+            if (buffer.getCapacity() != lastCapacity)
+            {
+                reallocations++;
+                lastCapacity = buffer.getCapacity();
+            }
+        }
+        TESTS_ASSERT(reallocations < 40);
+        for (i = 0; i < 100000; i++)
+            TESTS_ASSERT_EQUAL(buffer[i], (uint8)i);
+
+        // Small shrinks keep the allocation
+        buffer.changeSize(90000);
+        TESTS_ASSERT_EQUAL(buffer.getCapacity(), lastCapacity);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), 90000);
+
+        // Large shrinks release it
+        buffer.changeSize(1000);
+        TESTS_ASSERT(buffer.getCapacity() < lastCapacity);
+        for (i = 0; i < 1000; i++)
+            TESTS_ASSERT_EQUAL(buffer[i], (uint8)i);
+
+        buffer.shrinkToFit();
+        TESTS_ASSERT_EQUAL(buffer.getCapacity(), 1000);
+
+        // Reserve doesn't change the size nor the content
+        buffer.reserve(5000);
+        TESTS_ASSERT_EQUAL(buffer.getCapacity(), 5000);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), 1000);
+        uint8* data = buffer.getBuffer();
+        for (i = 1000; i < 5000; i++)
+            buffer.append((uint8)i);
+        TESTS_ASSERT(data == buffer.getBuffer());
+        for (i = 0; i < 5000; i++)
+            TESTS_ASSERT_EQUAL(buffer[i], (uint8)i);
+        buffer.reserve(10);
+        TESTS_ASSERT_EQUAL(buffer.getCapacity(), 5000);
+
+        buffer.changeSize(0);
+        buffer.shrinkToFit();
+        TESTS_ASSERT_EQUAL(buffer.getCapacity(), 0);
+        TESTS_ASSERT(buffer.getBuffer() == NULL);
+
+        // Disabled growth allocates exactly the page-rounded size
+        cArray<uint32> paged;
+        paged.setPageSize(16);
+        paged.setGrowthFactor(cArray<uint32>::NoGrowth);
+        for (i = 0; i < 100; i++)
+        {
+            paged.append(i);
+            TESTS_ASSERT_EQUAL(paged.getCapacity(), paged.pageRound(i + 1));
+        }
+        TESTS_EXCEPTION(paged.setGrowthFactor(cArray<uint32>::NoGrowth - 1));
+
+        // Non-POD arrays are copied correctly on growth
+        cArray<cString> strings;
+        for (i = 0; i < 1000; i++)
+            strings.append(cString(i));
+        for (i = 0; i < 1000; i++)
+            TESTS_ASSERT_EQUAL(strings[i], cString(i));
+        strings.shrinkToFit();
+        TESTS_ASSERT_EQUAL(strings.getCapacity(), 1000);
+    }
+
+    // Test the plain-old-data storage of the array
+    void test_pod()
+    {
+        uint i;
+        TESTS_ASSERT(cTypeTraits<uint8>::isPod);
+        TESTS_ASSERT(cTypeTraits<uint32>::isPod);
+        TESTS_ASSERT(cTypeTraits<TESTARRAY*>::isPod);
+        TESTS_ASSERT(!cTypeTraits<cString>::isPod);
+        #ifdef XSTL_POD_INTRINSIC
+        TESTS_ASSERT(cTypeTraits<TESTPOD>::isPod);
+        TESTS_ASSERT(!cTypeTraits<TESTARRAY>::isPod);
+        #endif
+
+        cArray<TESTPOD> pods;
+        for (i = 0; i < 1000; i++)
+        {
+            TESTPOD pod = { (uint32)i, (uint8)(i * 3) };
+            pods.append(pod);
+        }
+
+        cArray<TESTPOD> copy(pods);
+        copy.append(pods);
+        TESTS_ASSERT_EQUAL(copy.getSize(), 2000);
+        for (i = 0; i < 2000; i++)
+        {
+            TESTS_ASSERT_EQUAL(copy[i].m_a, i % 1000);
+            TESTS_ASSERT_EQUAL(copy[i].m_b, (uint8)((i % 1000) * 3));
+        }
+
+        cArray<TESTPOD> range;
+        range.copyRange(copy, 990, 20);
+        TESTS_ASSERT_EQUAL(range.getSize(), 20);
+        for (i = 0; i < 20; i++)
+            TESTS_ASSERT_EQUAL(range[i].m_a, (990 + i) % 1000);
+
+        // Grow and shrink through realloc
+        cBuffer buffer;
+        for (i = 0; i < 10000; i++)
+            buffer.append((uint8)i);
+        buffer.changeSize(100);
+        buffer.shrinkToFit();
+        for (i = 0; i < 100; i++)
+            TESTS_ASSERT_EQUAL(buffer[i], (uint8)i);
+        buffer.changeSize(50, false);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), 50);
+        cBuffer other(buffer);
+        TESTS_ASSERT(other == buffer);
+        buffer.append(buffer);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), 100);
+        for (i = 0; i < 50; i++)
+            TESTS_ASSERT_EQUAL(buffer[i], buffer[i + 50]);
+    }
+
+    // Test the move semantics of the arrays
+    void test_move()
+    {
+        #ifdef XSTL_CPP11
+        uint i;
+        cBuffer buffer;
+        for (i = 0; i < 100; i++)
+            buffer.append((uint8)i);
+        uint8* data = buffer.getBuffer();
+
+        cBuffer moved(t_move(buffer));
+        TESTS_ASSERT(moved.getBuffer() == data);
+        TESTS_ASSERT_EQUAL(moved.getSize(), 100);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), 0);
+        TESTS_ASSERT(buffer.getBuffer() == NULL);
+
+        buffer.append((uint8)1);
+        buffer = t_move(moved);
+        TESTS_ASSERT(buffer.getBuffer() == data);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), 100);
+        TESTS_ASSERT_EQUAL(moved.getSize(), 0);
+
+        // Strings are moved into the array, and when the array grows.
+        // (Long strings are used, short strings are stored inline)
+        const cString prefix(XSTL_STRING("A string which is too long to be stored inline #"));
+        cArray<cString> strings;
+        for (i = 0; i < 100; i++)
+        {
+            cString string(prefix + cString(i));
+            const character* stringData = string.getBuffer();
+            strings.append(t_move(string));
+            TESTS_ASSERT(strings[i].getBuffer() == stringData);
+        }
+        const character* firstData = strings[0].getBuffer();
+        strings.reserve(1000);
+        TESTS_ASSERT(strings[0].getBuffer() == firstData);
+
+        cString& emplaced = strings.emplace(XSTL_STRING("emplaced"));
+        TESTS_ASSERT_EQUAL(strings.getSize(), 101);
+        TESTS_ASSERT_EQUAL(emplaced, XSTL_STRING("emplaced"));
+        for (i = 0; i < 100; i++)
+            TESTS_ASSERT_EQUAL(strings[i], prefix + cString(i));
+
+        cArray<cString> movedStrings(t_move(strings));
+        TESTS_ASSERT_EQUAL(movedStrings.getSize(), 101);
+        TESTS_ASSERT_EQUAL(strings.getSize(), 0);
+        #endif
+    }
+
     // Perform the test
     virtual void test()
     {
@@ -236,6 +423,9 @@ public:
         test_array_members();
         test_page_round();
         test_swap();
+        test_capacity();
+        test_pod();
+        test_move();
     };
 
     // Return the name of the module
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_concurrentHash.cpp
+ *
+ * Test the template cConcurrentHash class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/concurrentHash.h"
+#include "xStl/data/string.h"
+#include "xStl/os/threadedClass.h"
+#include "tests.h"
+
+class cTestConcurrentHash : public cTestObject
+{
+public:
+    typedef cConcurrentHash<uint32, uint32> HashType;
+
+    // Add, replace and remove a range of keys while other threads are reading
+    class WriterThread : public cThreadedClass
+    {
+    public:
+        enum { KEYS_COUNT = 3000 };
+
+        WriterThread(HashType& hash, uint32 base) : m_hash(hash), m_base(base) {}
+
+        virtual void run()
+        {
+            uint32 i;
+            for (i = 0; i < KEYS_COUNT; i++)
+                m_hash.append(m_base + i, i);
+            for (i = 0; i < KEYS_COUNT; i++)
+                m_hash.insertOrAssign(m_base + i, i * 2);
+            for (i = 0; i < KEYS_COUNT; i+= 2)
+                m_hash.remove(m_base + i);
+        }
+
+        HashType& m_hash;
+        uint32 m_base;
+    };
+
+    // Read the constant keys again and again
+    class ReaderThread : public cThreadedClass
+    {
+    public:
+        enum { CONSTANT_KEYS = 100, LOOPS = 200 };
+
+        ReaderThread(HashType& hash) : m_hash(hash), m_errors(0) {}
+
+        virtual void run()
+        {
+            for (uint32 loop = 0; loop < LOOPS; loop++)
+            {
+                for (uint32 i = 0; i < CONSTANT_KEYS; i++)
+                {
+                    uint32 data;
+                    if ((!m_hash.tryGet(i, data)) || (data != i + 1))
+                        m_errors++;
+                }
+            }
+        }
+
+        HashType& m_hash;
+        volatile uint m_errors;
+    };
+
+    // Test the interface in a single thread
+    void test_singleThread()
+    {
+        cConcurrentHash<cString, cString> hash(4);
+
+        TESTS_EXCEPTION(hash["First"]);
+        TESTS_EXCEPTION(hash.remove("First"));
+
+        hash.append("First", "1");
+        hash.append("Second", "2");
+        hash.append("Third", "3");
+        TESTS_EXCEPTION(hash.append("Second", "4"));
+
+        TESTS_ASSERT(!hash.hasKey("FIRST"));
+        TESTS_ASSERT(hash.hasKey("First"));
+        TESTS_ASSERT_EQUAL(hash.length(), 3);
+        TESTS_ASSERT_EQUAL(hash["Third"], "3");
+        hash.insertOrAssign("Third", "33");
+        TESTS_ASSERT_EQUAL(hash["Third"], "33");
+        TESTS_ASSERT_EQUAL(hash.length(), 3);
+        TESTS_ASSERT_EQUAL(hash.keys().length(), 3);
+
+        cString data;
+        TESTS_ASSERT(hash.tryGet("Second", data));
+        TESTS_ASSERT_EQUAL(data, "2");
+        TESTS_ASSERT(!hash.tryGet("Fourth", data));
+
+        hash.remove("Second");
+        TESTS_ASSERT(!hash.hasKey("Second"));
+        TESTS_ASSERT_EQUAL(hash.length(), 2);
+
+        // Resize
+        cConcurrentHash<uint32, uint32> numbers(2);
+        uint32 i;
+        for (i = 0; i < 5000; i++)
+            numbers.append(i, i);
+        TESTS_ASSERT(numbers.getCapacity() >= 4096);
+        for (i = 0; i < 5000; i++)
+            TESTS_ASSERT_EQUAL(numbers[i], i);
+
+        numbers.removeAll();
+        TESTS_ASSERT_EQUAL(numbers.length(), 0);
+        TESTS_ASSERT_EQUAL(numbers.getCapacity(), 2);
+        TESTS_ASSERT(!numbers.hasKey(5));
+    }
+
+    // Writers and readers on the same hash
+    void test_threads()
+    {
+        enum { WRITERS = 4, READERS = 4 };
+        HashType hash(16);
+        uint32 i;
+
+        // The readers keys are never changed
+        for (i = 0; i < ReaderThread::CONSTANT_KEYS; i++)
+            hash.append(i, i + 1);
+
+        WriterThread* writers[WRITERS];
+        ReaderThread* readers[READERS];
+        for (i = 0; i < WRITERS; i++)
+            writers[i] = new WriterThread(hash, (i + 1) * 100000);
+        for (i = 0; i < READERS; i++)
+            readers[i] = new ReaderThread(hash);
+
+        for (i = 0; i < WRITERS; i++)
+            writers[i]->start();
+        for (i = 0; i < READERS; i++)
+            readers[i]->start();
+
+        for (i = 0; i < WRITERS; i++)
+        {
+            writers[i]->wait();
+            TESTS_ASSERT(writers[i]->isDone());
+        }
+        for (i = 0; i < READERS; i++)
+        {
+            readers[i]->wait();
+            TESTS_ASSERT(readers[i]->isDone());
+            TESTS_ASSERT_EQUAL(readers[i]->m_errors, 0);
+        }
+
+        // Only the odd keys of every writer remain
+        TESTS_ASSERT_EQUAL(hash.length(), ReaderThread::CONSTANT_KEYS +
+                                          WRITERS * WriterThread::KEYS_COUNT / 2);
+        for (i = 0; i < WRITERS; i++)
+        {
+            uint32 base = (i + 1) * 100000;
+            for (uint32 j = 0; j < WriterThread::KEYS_COUNT; j++)
+            {
+                uint32 data;
+                bool isExist = hash.tryGet(base + j, data);
+                TESTS_ASSERT_EQUAL(isExist, ((j % 2) == 1));
+                if (isExist)
+                    TESTS_ASSERT_EQUAL(data, j * 2);
+            }
+        }
+
+        for (i = 0; i < WRITERS; i++)
+            delete writers[i];
+        for (i = 0; i < READERS; i++)
+            delete readers[i];
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_singleThread();
+        test_threads();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestConcurrentHash g_globalTestConcurrentHash;
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_deque.cpp
+ *
+ * Test the template cDeque class against an array of the expected elements.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/deque.h"
+#include "xStl/data/string.h"
+#include "xStl/os/osrand.h"
+#include "../../xStl/tests/tests.h"
+
+class cTestDeque : public cTestObject
+{
+public:
+    // Counts the living instances, in order to test the destruction of the
+    // elements
+    class cCounted
+    {
+    public:
+        cCounted(uint value) : m_value(value) { gLiving++; }
+        cCounted(const cCounted& other) : m_value(other.m_value) { gLiving++; }
+        ~cCounted() { gLiving--; }
+
+        uint m_value;
+        static int gLiving;
+    };
+
+    // Compare the deque with the expected elements, by index and by iterators
+    void compare(const cDeque<cCounted>& deque, const cArray<uint>& expected,
+                 uint first)
+    {
+        uint count = expected.getSize() - first;
+        TESTS_ASSERT_EQUAL(deque.length(), count);
+        TESTS_ASSERT_EQUAL(deque.isEmpty(), count == 0);
+
+        uint i = first;
+        for (cDeque<cCounted>::iterator j = deque.begin(); j != deque.end();
+             ++j, i++)
+        {
+            TESTS_ASSERT_EQUAL((*j).m_value, expected[i]);
+        }
+        TESTS_ASSERT_EQUAL(i, expected.getSize());
+
+        if (count > 0)
+        {
+            TESTS_ASSERT_EQUAL(deque.getFirst().m_value, expected[first]);
+            TESTS_ASSERT_EQUAL(deque.getLast().m_value,
+                               expected[expected.getSize() - 1]);
+            uint index = cOSRand::rand() % count;
+            TESTS_ASSERT_EQUAL(deque[index].m_value, expected[first + index]);
+        }
+    }
+
+    // Random operations at both ends, crossing many blocks
+    void test_random()
+    {
+        {
+            cDeque<cCounted> deque;
+            // The expected elements are expected[first..size-1]
+            cArray<uint> expected;
+            uint first = 0;
+
+            for (uint round = 0; round < 20000; round++)
+            {
+                uint value = cOSRand::rand();
+                switch (cOSRand::rand() % 6)
+                {
+                case 0:
+                case 1:
+                    deque.append(cCounted(value));
+                    expected.append(value);
+                    break;
+                case 2:
+                    {
+                        // Insert at the beginning of the expected array
+                        deque.insert(cCounted(value));
+                        cArray<uint> prefix;
+                        prefix.append(value);
+                        for (uint i = first; i < expected.getSize(); i++)
+                            prefix.append(expected[i]);
+                        expected = prefix;
+                        first = 0;
+                    }
+                    break;
+                case 3:
+                    if (deque.isEmpty())
+                    {
+                        TESTS_EXCEPTION(deque.removeFirst());
+                    } else
+                    {
+                        deque.removeFirst();
+                        first++;
+                    }
+                    break;
+                case 4:
+                    if (deque.isEmpty())
+                    {
+                        TESTS_EXCEPTION(deque.removeLast());
+                    } else
+                    {
+                        deque.removeLast();
+                        expected.changeSize(expected.getSize() - 1);
+                    }
+                    break;
+                case 5:
+                    TESTS_ASSERT_EQUAL(cCounted::gLiving,
+                                       (int)(expected.getSize() - first));
+                    break;
+                }
+
+                if ((round % 500) == 0)
+                    compare(deque, expected, first);
+            }
+            compare(deque, expected, first);
+
+            // Copy, assign and swap
+            cDeque<cCounted> copy(deque);
+            compare(copy, expected, first);
+            cDeque<cCounted> other;
+            other.append(cCounted(1));
+            other = copy;
+            compare(other, expected, first);
+            other = other;
+            compare(other, expected, first);
+            cDeque<cCounted> empty;
+            empty.swap(other);
+            compare(empty, expected, first);
+            TESTS_ASSERT(other.isEmpty());
+
+            deque.removeAll();
+            TESTS_ASSERT(deque.isEmpty());
+            TESTS_EXCEPTION(deque.getFirst());
+            TESTS_EXCEPTION(deque[0]);
+            deque.append(cCounted(5));
+            TESTS_ASSERT_EQUAL(deque[0].m_value, 5);
+        }
+        TESTS_ASSERT_EQUAL(cCounted::gLiving, 0);
+    }
+
+    // Test the deque as a queue and as a stack
+    void test_queue()
+    {
+        cDeque<uint> queue;
+        uint next = 0;
+        uint i;
+        for (i = 0; i < 100000; i++)
+        {
+            queue.append(i);
+            queue.append(i);
+            TESTS_ASSERT_EQUAL(queue.getFirst(), next / 2);
+            queue.removeFirst();
+            next++;
+        }
+        TESTS_ASSERT_EQUAL(queue.length(), 100000);
+
+        // The elements doesn't move when the deque grows
+        uint* address = &queue.getLast();
+        for (i = 0; i < 100000; i++)
+            queue.insert(i);
+        TESTS_ASSERT(address == &queue.getLast());
+
+        cDeque<character> stack;
+        for (i = 0; i < 1000; i++)
+            stack.append((character)('a' + (i % 26)));
+        for (i = 1000; i > 0; i--)
+        {
+            TESTS_ASSERT_EQUAL(stack.getLast(), (character)('a' + ((i - 1) % 26)));
+            stack.removeLast();
+        }
+        TESTS_ASSERT(stack.isEmpty());
+
+        #ifdef XSTL_CPP11
+        cDeque<cString> strings;
+        cString& emplaced = strings.emplace(XSTL_STRING("emplaced"));
+        TESTS_ASSERT_EQUAL(emplaced, XSTL_STRING("emplaced"));
+        cDeque<cString> moved(t_move(strings));
+        TESTS_ASSERT(strings.isEmpty());
+        TESTS_ASSERT_EQUAL(moved.getFirst(), XSTL_STRING("emplaced"));
+        #endif
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_random();
+        test_queue();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+int cTestDeque::cCounted::gLiving = 0;
+
+// Instance test object
+cTestDeque g_globalTestDeque;
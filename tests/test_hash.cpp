@@ -38,6 +38,7 @@
  */
 #include "xStl/types.h"
 #include "xStl/data/hash.h"
+#include "xStl/data/flatHash.h"
 #include "xStl/data/string.h"
 #include "xStl/os/os.h"
 #include "tests.h"
@@ -112,11 +113,179 @@ public:
         TESTS_ASSERT_EQUAL(hash["First"], "1");
     };
 
+    // Test the open-addressing hash, including rehashing and removal
+    void test_flatHash()
+    {
+        cFlatHash<cString, cString> hash(2);
+
+        // Test exception for non exist value
+        TESTS_EXCEPTION(hash["First"] = "1");
+        TESTS_EXCEPTION(hash.remove("First"));
+
+        hash.append("First", "1");
+        hash.append("Second", "2");
+        hash.append("Third", "3");
+        TESTS_EXCEPTION(hash.append("Second", "4"));
+
+        TESTS_ASSERT(!hash.hasKey("FIRST"));
+        TESTS_ASSERT(hash.hasKey("First"));
+        TESTS_ASSERT(hash.hasKey("Second"));
+        TESTS_ASSERT(hash.hasKey("Third"));
+        TESTS_ASSERT_EQUAL(hash.length(), 3);
+        TESTS_ASSERT_EQUAL(hash["Third"], "3");
+        hash["Third"] = "33";
+        TESTS_ASSERT_EQUAL(hash["Third"], "33");
+        TESTS_ASSERT_EQUAL(hash.keys().length(), 3);
+
+        // Force many collisions and rehashes, and remove half of the keys
+        cFlatHash<uint32, uint32> numbers;
+        uint32 i;
+        for (i = 0; i < 5000; i++)
+        {
+            numbers.append(i * 64, i);
+        }
+        TESTS_ASSERT_EQUAL(numbers.length(), 5000);
+        TESTS_ASSERT(numbers.getCapacity() * numbers.getMaxLoadFactor() >= 5000 * 100);
+        for (i = 0; i < 5000; i+= 2)
+        {
+            numbers.remove(i * 64);
+        }
+        for (i = 0; i < 5000; i++)
+        {
+            TESTS_ASSERT_EQUAL(numbers.hasKey(i * 64), ((i % 2) == 1));
+            if ((i % 2) == 1)
+            {
+                TESTS_ASSERT_EQUAL(numbers[i * 64], i);
+            }
+        }
+
+        // Reserve should avoid rehashing
+        cFlatHash<uint32, uint32> reserved;
+        reserved.reserve(1000);
+        uint capacity = reserved.getCapacity();
+        for (i = 0; i < 1000; i++)
+        {
+            reserved.append(i, i);
+        }
+        TESTS_ASSERT_EQUAL(reserved.getCapacity(), capacity);
+
+        // Load-factor changes
+        reserved.setMaxLoadFactor(25);
+        TESTS_ASSERT(reserved.getCapacity() >= 4000);
+        TESTS_EXCEPTION(reserved.setMaxLoadFactor(100));
+
+        reserved.removeAll();
+        TESTS_ASSERT_EQUAL(reserved.length(), 0);
+        TESTS_ASSERT(!reserved.hasKey(5));
+    }
+
+    // Test the hash-function family and the hash-function template argument
+    void test_hashFunction()
+    {
+        // Anagrams and keys which differ only in their high bits should not
+        // be mapped into the same cell
+        TESTS_ASSERT(cHashFunction(cString("abcd"), 1024) !=
+                     cHashFunction(cString("dcba"), 1024));
+        TESTS_ASSERT(cHashFunction((uint32)0x10000, 256) !=
+                     cHashFunction((uint32)0x20000, 256));
+        TESTS_ASSERT_EQUAL(cHashFunction(0.0f, 256), cHashFunction(-0.0f, 256));
+
+        // The hash of a buffer is deterministic and depends on every byte
+        cBuffer first(16);
+        cBuffer second(16);
+        for (uint i = 0; i < 16; i++)
+        {
+            first[i] = (uint8)i;
+            second[i] = (uint8)i;
+        }
+        TESTS_ASSERT_EQUAL(cHashCode(first, 1), cHashCode(second, 1));
+        second[15] = 0x80;
+        TESTS_ASSERT(cHashCode(first, 1) != cHashCode(second, 1));
+
+        // Different seeds selects different functions
+        TESTS_ASSERT(cHashCode(cString("Identifier"), 1) !=
+                     cHashCode(cString("Identifier"), 2));
+
+        // Tables with a seeded hash function
+        typedef cSeededHashFunctor<cString> SeededHash;
+        cHash<cString, uint32, SeededHash> hash(64, SeededHash(0x1234));
+        cFlatHash<cString, uint32, SeededHash> flat(16,
+            cFlatHash<cString, uint32, SeededHash>::DefaultMaxLoadFactor,
+            SeededHash(0x5678));
+        for (uint32 j = 0; j < 200; j++)
+        {
+            hash.append(cString(j), j);
+            flat.append(cString(j), j);
+        }
+        cHash<cString, uint32, SeededHash> hashCopy(hash);
+        cFlatHash<cString, uint32, SeededHash> flatCopy(flat);
+        for (uint32 k = 0; k < 200; k++)
+        {
+            TESTS_ASSERT_EQUAL(hashCopy[cString(k)], k);
+            TESTS_ASSERT_EQUAL(flatCopy[cString(k)], k);
+        }
+        TESTS_ASSERT(!hashCopy.hasKey("200"));
+        TESTS_ASSERT(!flatCopy.hasKey("200"));
+    }
+
+    // Test the single-pass API of a hash table with cString keys and uint32
+    // data
+    template <class HashType>
+    void test_singlePass(HashType& hash)
+    {
+        uint32* data = NULL;
+        const uint32* constData = NULL;
+        const HashType& constHash = hash;
+
+        TESTS_ASSERT(!hash.tryGet("First", data));
+        TESTS_ASSERT(data == NULL);
+
+        // Insert and assign
+        TESTS_ASSERT_EQUAL(hash.insertOrAssign("First", 1), 1);
+        TESTS_ASSERT_EQUAL(hash.insertOrAssign("First", 2), 2);
+        hash.insertOrAssign("Second", 3) = 4;
+        TESTS_ASSERT_EQUAL(hash["Second"], 4);
+        TESTS_EXCEPTION(hash.append("First", 5));
+
+        // Find or insert
+        TESTS_ASSERT_EQUAL(hash.findOrInsert("First", 6), 2);
+        TESTS_ASSERT_EQUAL(hash.findOrInsert("Third", 7), 7);
+        hash.findOrInsert("Counter")++;
+        hash.findOrInsert("Counter")++;
+        TESTS_ASSERT_EQUAL(hash["Counter"], 2);
+
+        // tryGet
+        TESTS_ASSERT(hash.tryGet("Third", data));
+        TESTS_ASSERT_EQUAL(*data, 7);
+        *data = 8;
+        TESTS_ASSERT(constHash.tryGet("Third", constData));
+        TESTS_ASSERT_EQUAL(*constData, 8);
+        TESTS_ASSERT(!constHash.tryGet("Fourth", constData));
+        TESTS_ASSERT(constData == NULL);
+        TESTS_EXCEPTION(constHash["Fourth"]);
+        TESTS_ASSERT_EQUAL(hash.keys().length(), 4);
+
+        // Many elements
+        for (uint32 i = 0; i < 1000; i++)
+        {
+            hash.findOrInsert(cString(i % 100), 0)+= i;
+        }
+        TESTS_ASSERT_EQUAL(hash.keys().length(), 104);
+        TESTS_ASSERT_EQUAL(hash["99"], 99 * 10 + 100 * 45);
+    }
+
     // Perform the test
     virtual void test()
     {
         // Start the tests.
         test_hash();
+        test_flatHash();
+        test_hashFunction();
+
+        cHash<cString, uint32> hash;
+        test_singlePass(hash);
+        cFlatHash<cString, uint32> flatHash(2);
+        test_singlePass(flatHash);
     };
 
     // Return the name of the module
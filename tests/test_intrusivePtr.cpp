@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_intrusivePtr.cpp
+ *
+ * Test the cIntrusivePtr class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/intrusivePtr.h"
+#include "xStl/data/list.h"
+#include "xStl/except/trace.h"
+#include "tests.h"
+
+class cTestIntrusivePtr : public cTestObject
+{
+public:
+    // A counted object which counts its destructions
+    class cNode : public cIntrusiveRefCount
+    {
+    public:
+        cNode(int value) : m_value(value) {}
+        virtual ~cNode() { g_destructed++; }
+
+        int m_value;
+        static int g_destructed;
+    };
+
+    class cDerivedNode : public cNode
+    {
+    public:
+        cDerivedNode(int value) : cNode(value), m_next() {}
+
+        cIntrusivePtr<cNode> m_next;
+    };
+
+    void testReferences()
+    {
+        int destructed = cNode::g_destructed;
+        {
+            cIntrusivePtr<cNode> empty;
+            TESTS_ASSERT(empty.isEmpty());
+            TESTS_ASSERT(empty.getPointer() == NULL);
+
+            cIntrusivePtr<cNode> node1(new cNode(10));
+            TESTS_ASSERT(!node1.isEmpty());
+            TESTS_ASSERT_EQUAL(node1->m_value, 10);
+            TESTS_ASSERT_EQUAL(node1->getReferenceCount(), 1);
+
+            cIntrusivePtr<cNode> node2(node1);
+            TESTS_ASSERT_EQUAL(node1->getReferenceCount(), 2);
+            TESTS_ASSERT(node1 == node2);
+
+            // A raw pointer of an owned object
+            cIntrusivePtr<cNode> node3(node1.getPointer());
+            TESTS_ASSERT_EQUAL(node1->getReferenceCount(), 3);
+
+            node2 = empty;
+            node3.reset();
+            TESTS_ASSERT_EQUAL(node1->getReferenceCount(), 1);
+            TESTS_ASSERT(node1 != node2);
+
+            // Self assignment
+            node1 = node1;
+            TESTS_ASSERT_EQUAL(node1->getReferenceCount(), 1);
+            TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed);
+
+            node1.reset(new cNode(20));
+            TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 1);
+            TESTS_ASSERT_EQUAL(node1->m_value, 20);
+
+            // A copy of an object is not referenced
+            cNode copy(*node1);
+            TESTS_ASSERT_EQUAL(copy.getReferenceCount(), 0);
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 3);
+    }
+
+    void testDerived()
+    {
+        int destructed = cNode::g_destructed;
+        {
+            cIntrusivePtr<cDerivedNode> head(new cDerivedNode(1));
+            head->m_next = cIntrusivePtr<cNode>(new cDerivedNode(2));
+
+            // Derived to base conversion
+            cIntrusivePtr<cNode> base(head);
+            TESTS_ASSERT_EQUAL(head->getReferenceCount(), 2);
+            TESTS_ASSERT_EQUAL(base->m_value, 1);
+
+            // Release the head, the next node is kept by "base"
+            base = head->m_next;
+            head = cIntrusivePtr<cDerivedNode>();
+            TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 1);
+            TESTS_ASSERT_EQUAL(base->m_value, 2);
+            TESTS_ASSERT_EQUAL(base->getReferenceCount(), 1);
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 2);
+
+        // Inside containers
+        {
+            cList<cIntrusivePtr<cNode> > list;
+            cIntrusivePtr<cNode> node(new cNode(5));
+            for (uint i = 0; i < 100; i++)
+                list.append(node);
+            TESTS_ASSERT_EQUAL(node->getReferenceCount(), 101);
+            list.removeAll();
+            TESTS_ASSERT_EQUAL(node->getReferenceCount(), 1);
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 3);
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        testReferences();
+        testDerived();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+int cTestIntrusivePtr::cNode::g_destructed = 0;
+
+// Instance test object
+cTestIntrusivePtr g_globalTestIntrusivePtr;
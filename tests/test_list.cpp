@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_list.cpp
+ *
+ * Test the template cList class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/list.h"
+#include "xStl/data/nodePool.h"
+#include "xStl/data/arena.h"
+#include "xStl/data/string.h"
+#include "../../xStl/tests/tests.h"
+
+class cTestList : public cTestObject
+{
+public:
+    // Test the basic operations of the list
+    void test_list()
+    {
+        cList<uint32> list;
+        TESTS_ASSERT(list.isEmpty());
+        uint32 i;
+        for (i = 0; i < 100; i++)
+            list.append(i);
+        list.insert(1000);
+        TESTS_ASSERT_EQUAL(list.length(), 101);
+        TESTS_ASSERT_EQUAL(*list.begin(), 1000);
+
+        list.remove(1000);
+        i = 0;
+        for (cList<uint32>::iterator j = list.begin(); j != list.end(); j++)
+            TESTS_ASSERT_EQUAL(*j, i++);
+        TESTS_ASSERT(list.isIn(50));
+        TESTS_ASSERT(!list.isIn(500));
+        TESTS_EXCEPTION(list.remove(500));
+
+        cList<uint32> copy(list);
+        TESTS_ASSERT_EQUAL(copy.length(), 100);
+        list.removeAll();
+        TESTS_ASSERT(list.isEmpty());
+        TESTS_ASSERT_EQUAL(copy.length(), 100);
+
+        list.swap(copy);
+        TESTS_ASSERT_EQUAL(list.length(), 100);
+        TESTS_ASSERT(copy.isEmpty());
+    }
+
+    // Test the move semantics of the list
+    void test_move()
+    {
+        #ifdef XSTL_CPP11
+        cList<cString> list;
+        cString string(XSTL_STRING("A moved string which is stored on the heap"));
+        const character* data = string.getBuffer();
+        list.append(t_move(string));
+        TESTS_ASSERT((*list.begin()).getBuffer() == data);
+
+        cString& emplaced = list.emplace(XSTL_STRING("emplaced"));
+        TESTS_ASSERT_EQUAL(emplaced, XSTL_STRING("emplaced"));
+        TESTS_ASSERT_EQUAL(list.length(), 2);
+
+        cList<cString> moved(t_move(list));
+        TESTS_ASSERT_EQUAL(moved.length(), 2);
+        TESTS_ASSERT(list.isEmpty());
+        TESTS_ASSERT((*moved.begin()).getBuffer() == data);
+
+        // The list remains usable after the move
+        list.append(cString(XSTL_STRING("again")));
+        TESTS_ASSERT_EQUAL(list.length(), 1);
+
+        list = t_move(moved);
+        TESTS_ASSERT_EQUAL(list.length(), 2);
+        TESTS_ASSERT((*list.begin()).getBuffer() == data);
+        #endif
+    }
+
+    // Counts the living instances, in order to test the destruction of the
+    // elements
+    class cCounted
+    {
+    public:
+        cCounted(uint value) : m_value(value) { gLiving++; }
+        cCounted(const cCounted& other) : m_value(other.m_value) { gLiving++; }
+        ~cCounted() { gLiving--; }
+        bool operator == (const cCounted& other) const
+        {
+            return m_value == other.m_value;
+        }
+
+        uint m_value;
+        static int gLiving;
+    };
+
+    // Test the removal by iterators and the recycling of the nodes
+    void test_nodes()
+    {
+        {
+            cList<cCounted> list;
+            uint i;
+            for (i = 0; i < 1000; i++)
+                list.append(cCounted(i));
+            TESTS_ASSERT_EQUAL(cCounted::gLiving, 1000);
+
+            // Remove the odd elements, remove() returns the next element
+            cList<cCounted>::iterator j = list.begin();
+            while (j != list.end())
+            {
+                if (((*j).m_value & 1) != 0)
+                    j = list.remove(j);
+                else
+                    j++;
+            }
+            TESTS_ASSERT_EQUAL(cCounted::gLiving, 500);
+            TESTS_ASSERT_EQUAL(list.length(), 500);
+
+            // The end of the list can't be removed
+            cList<cCounted>::iterator end = list.end();
+            TESTS_EXCEPTION(list.remove(end));
+
+            // Remove the first element, and insert elements in the middle
+            j = list.begin();
+            j = list.remove(j);
+            TESTS_ASSERT_EQUAL((*j).m_value, 2);
+            j++;
+            list.insert(j, cCounted(3));
+            list.insert(cCounted(0));
+            const uint expected[] = {0, 2, 3, 4, 6};
+            i = 0;
+            for (j = list.begin(); i < 5; j++, i++)
+                TESTS_ASSERT_EQUAL((*j).m_value, expected[i]);
+            TESTS_ASSERT_EQUAL(list.length(), 501);
+
+            // Backward iteration from the end
+            j = list.end();
+            j--;
+            TESTS_ASSERT_EQUAL((*j).m_value, 998);
+
+            // Assigning the list to itself doesn't change it
+            cList<cCounted>& self = list;
+            list = self;
+            TESTS_ASSERT_EQUAL(list.length(), 501);
+
+            // Swap with an empty list and back
+            cList<cCounted> other;
+            other.swap(list);
+            TESTS_ASSERT(list.isEmpty());
+            TESTS_ASSERT_EQUAL(other.length(), 501);
+            list.append(cCounted(7));
+            list.swap(other);
+            TESTS_ASSERT_EQUAL(list.length(), 501);
+            TESTS_ASSERT_EQUAL(other.length(), 1);
+            TESTS_ASSERT_EQUAL((*other.begin()).m_value, 7);
+            j = list.end();
+            j--;
+            TESTS_ASSERT_EQUAL((*j).m_value, 998);
+            list.append(cCounted(1000));
+            other.append(cCounted(8));
+            TESTS_ASSERT_EQUAL(list.length(), 502);
+            TESTS_ASSERT_EQUAL(other.length(), 2);
+
+            list.removeAll();
+            TESTS_ASSERT_EQUAL(cCounted::gLiving, 2);
+        }
+        TESTS_ASSERT_EQUAL(cCounted::gLiving, 0);
+
+        // Removed nodes are recycled
+        cNodePool pool(sizeof(uint64));
+        void* a = pool.allocate();
+        void* b = pool.allocate();
+        TESTS_ASSERT(a != b);
+        pool.free(a);
+        TESTS_ASSERT(pool.allocate() == a);
+        uint allocated = pool.getAllocatedBytes();
+        for (uint k = 0; k < 100; k++)
+            pool.free(pool.allocate());
+        TESTS_ASSERT_EQUAL(pool.getAllocatedBytes(), allocated);
+        pool.freeAll();
+        TESTS_ASSERT_EQUAL(pool.getAllocatedBytes(), 0);
+
+        // The pool of a list is allocated only for its nodes
+        cArena arena;
+        {
+            cList<uint32> lazy;
+            lazy.setAllocator(&arena);
+            TESTS_ASSERT_EQUAL(arena.getAllocatedBytes(), 0);
+            lazy.append(1);
+            TESTS_ASSERT(arena.getAllocatedBytes() > 0);
+            lazy.removeAll();
+            lazy.append(2);
+            TESTS_ASSERT_EQUAL(*lazy.begin(), 2);
+            TESTS_ASSERT(lazy.getAllocator() == &arena);
+        }
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_list();
+        test_move();
+        test_nodes();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+int cTestList::cCounted::gLiving = 0;
+
+// Instance test object
+cTestList g_globalTestList;
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_localPtr.cpp
+ *
+ * Test the cLocalPtr class.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/localPtr.h"
+#include "xStl/data/smartptr.h"
+#include "xStl/os/threadedClass.h"
+#include "xStl/except/trace.h"
+#include "tests.h"
+
+class cTestLocalPtr : public cTestObject
+{
+public:
+    // An object which counts its destructions
+    class cNode
+    {
+    public:
+        cNode(int value) : m_value(value) {}
+        virtual ~cNode() { g_destructed++; }
+
+        int m_value;
+        static volatile int g_destructed;
+    };
+
+    class cDerivedNode : public cNode
+    {
+    public:
+        cDerivedNode(int value) : cNode(value) {}
+    };
+
+    // Release a shared pointer from another thread
+    class cReleaseThread : public cThreadedClass
+    {
+    public:
+        cReleaseThread(const cSmartPtr<cNode>& node) : m_node(node) {}
+        virtual void run() { m_node = cSmartPtr<cNode>(); }
+
+    private:
+        cSmartPtr<cNode> m_node;
+    };
+
+    void testOwnership()
+    {
+        int destructed = cNode::g_destructed;
+        {
+            cLocalPtr<cNode> empty;
+            TESTS_ASSERT(empty.isEmpty());
+            TESTS_ASSERT_EQUAL(empty.getLocalReferences(), 0);
+            cLocalPtr<cNode> empty2(empty);
+            TESTS_ASSERT(empty2 == empty);
+
+            cLocalPtr<cNode> node1(new cNode(10));
+            TESTS_ASSERT_EQUAL(node1->m_value, 10);
+            TESTS_ASSERT_EQUAL(node1.getLocalReferences(), 1);
+
+            cLocalPtr<cNode> node2(node1);
+            TESTS_ASSERT_EQUAL(node1.getLocalReferences(), 2);
+            TESTS_ASSERT(node1 == node2);
+
+            node2 = empty;
+            TESTS_ASSERT_EQUAL(node1.getLocalReferences(), 1);
+            TESTS_ASSERT(node1 != node2);
+
+            // Self assignment
+            node1 = node1;
+            TESTS_ASSERT_EQUAL(node1.getLocalReferences(), 1);
+
+            // Derived to base conversion
+            cLocalPtr<cDerivedNode> derived(new cDerivedNode(20));
+            node2 = derived;
+            TESTS_ASSERT_EQUAL(derived.getLocalReferences(), 2);
+            TESTS_ASSERT_EQUAL(node2->m_value, 20);
+            TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed);
+
+            node1 = node2;
+            TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 1);
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 2);
+    }
+
+    void testShare()
+    {
+        int destructed = cNode::g_destructed;
+
+        // The local pointers are released first
+        cSmartPtr<cNode> shared;
+        {
+            cLocalPtr<cNode> local(new cNode(1));
+            shared = local.share();
+            TESTS_ASSERT(shared.getPointer() == local.getPointer());
+            TESTS_ASSERT_EQUAL(shared.getCounter().getValue(), 2);
+
+            cSmartPtr<cNode> shared2 = local.share();
+            TESTS_ASSERT_EQUAL(shared.getCounter().getValue(), 3);
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed);
+        TESTS_ASSERT_EQUAL(shared->m_value, 1);
+        TESTS_ASSERT_EQUAL(shared.getCounter().getValue(), 1);
+        shared = cSmartPtr<cNode>();
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 1);
+
+        // The shared pointers are released first
+        {
+            cLocalPtr<cNode> local(new cNode(2));
+            cLocalPtr<cNode> local2(local);
+            {
+                cSmartPtr<cNode> shared3 = local2.share();
+            }
+            TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 1);
+            TESTS_ASSERT_EQUAL(local2->m_value, 2);
+
+            // The object can be shared again
+            cSmartPtr<cNode> shared4 = local.share();
+            TESTS_ASSERT_EQUAL(shared4.getCounter().getValue(), 2);
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 2);
+
+        // The last reference is released by another thread
+        cReleaseThread* thread;
+        {
+            cLocalPtr<cNode> local(new cNode(3));
+            thread = new cReleaseThread(local.share());
+        }
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 2);
+        thread->start();
+        thread->wait();
+        TESTS_ASSERT_EQUAL(cNode::g_destructed, destructed + 3);
+        delete thread;
+
+        // Sharing NULL
+        cLocalPtr<cNode> empty;
+        TESTS_ASSERT(empty.share().isEmpty());
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        testOwnership();
+        testShare();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+volatile int cTestLocalPtr::cNode::g_destructed = 0;
+
+// Instance test object
+cTestLocalPtr g_globalTestLocalPtr;
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_numberConversion.cpp
+ *
+ * Test the formatting and the parsing of numbers against a simple
+ * implementation, and the numeric cString constructors.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/numberConversion.h"
+#include "xStl/os/osrand.h"
+#include "tests.h"
+
+class cTestNumberConversion : public cTestObject
+{
+public:
+    // The reference implementation
+    static cString simpleFormat(uint64 number, uint base)
+    {
+        static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        cString ret;
+        do
+        {
+            ret = cString((character)digits[number % base]) + ret;
+            number/= base;
+        } while (number != 0);
+        return ret;
+    }
+
+    // Return a random number with a random number of bits
+    static uint64 randomNumber()
+    {
+        uint64 number = ((uint64)cOSRand::rand() << 32) ^ cOSRand::rand();
+        uint bits = cOSRand::rand() % 65;
+        if (bits == 64)
+            return number;
+        return number & ((((uint64)1) << bits) - 1);
+    }
+
+    template <class T>
+    void testFormatAndParse()
+    {
+        T buffer[cNumberConversion::BufferLength];
+        static const uint64 edges[] = { 0, 1, 9, 10, 99, 100, 255, 256,
+                                        0xFFFFFFFF, (uint64)1 << 32,
+                                        (uint64)-1 };
+        for (uint round = 0; round < 2000; round++)
+        {
+            uint64 number = (round < arraysize(edges)) ? edges[round] :
+                                                         randomNumber();
+            uint base = (round % 3 == 0) ? 10 :
+                        (round % 3 == 1) ? 16 :
+                        cNumberConversion::MinBase +
+                            (cOSRand::rand() % (cNumberConversion::MaxBase - 1));
+
+            uint length = cNumberConversion::formatUnsigned(number, buffer,
+                                                            base);
+            cString expected = simpleFormat(number, base);
+            TESTS_ASSERT_EQUAL(length, expected.length());
+            TESTS_ASSERT_EQUAL(buffer[length], 0);
+            for (uint i = 0; i < length; i++)
+                TESTS_ASSERT_EQUAL((character)buffer[i], expected[i]);
+
+            // Parse the number back, followed by a non-digit
+            uint64 parsed = 0;
+            uint parsedLength = 0;
+            buffer[length] = (T)'#';
+            TESTS_ASSERT(cNumberConversion::parseUnsigned(buffer, length + 1,
+                                                          base, parsed,
+                                                          parsedLength));
+            TESTS_ASSERT_EQUAL(parsed, number);
+            TESTS_ASSERT_EQUAL(parsedLength, length);
+        }
+
+        // Signed numbers
+        TESTS_ASSERT_EQUAL(cNumberConversion::formatSigned(-1234, buffer), 5);
+        TESTS_ASSERT_EQUAL(buffer[0], (T)'-');
+        TESTS_ASSERT_EQUAL(buffer[4], (T)'4');
+        TESTS_ASSERT_EQUAL(cNumberConversion::formatSigned(
+            (int64)((uint64)1 << 63), buffer), 20);
+        TESTS_ASSERT_EQUAL(buffer[19], (T)'8');
+        TESTS_ASSERT_EQUAL(cNumberConversion::formatSigned(-255, buffer, 16), 3);
+        TESTS_ASSERT_EQUAL(buffer[1], (T)'F');
+
+        // Lower-case digits
+        static const char lowerHex[] = "deadBEEF";
+        for (uint i = 0; i < sizeof(lowerHex); i++)
+            buffer[i] = (T)lowerHex[i];
+        uint64 number = 0;
+        uint parsedLength = 0;
+        TESTS_ASSERT(cNumberConversion::parseUnsigned(buffer, 8, 16, number,
+                                                      parsedLength));
+        TESTS_ASSERT_EQUAL(number, 0xDEADBEEF);
+
+        // Overflows and invalid numbers
+        static const char tooLarge[] = "18446744073709551616";
+        for (uint i = 0; i < sizeof(tooLarge); i++)
+            buffer[i] = (T)tooLarge[i];
+        TESTS_ASSERT(!cNumberConversion::parseUnsigned(buffer, 20, 10, number,
+                                                       parsedLength));
+        TESTS_ASSERT(cNumberConversion::parseUnsigned(buffer, 19, 10, number,
+                                                      parsedLength));
+        TESTS_ASSERT(!cNumberConversion::parseUnsigned(buffer, 19, 10, number,
+                                                       parsedLength,
+                                                       0xFFFFFFFF));
+        TESTS_ASSERT(cNumberConversion::parseUnsigned(buffer, 2, 10, number,
+                                                      parsedLength, 18));
+        TESTS_ASSERT(!cNumberConversion::parseUnsigned(buffer, 2, 10, number,
+                                                       parsedLength, 17));
+        TESTS_ASSERT(!cNumberConversion::parseUnsigned(buffer, 0, 10, number,
+                                                       parsedLength));
+        buffer[0] = (T)'z';
+        TESTS_ASSERT(!cNumberConversion::parseUnsigned(buffer, 1, 16, number,
+                                                       parsedLength));
+        if (sizeof(T) > 1)
+        {
+            // A wide character which its low byte is a digit
+            buffer[0] = (T)0x131;
+            TESTS_ASSERT(!cNumberConversion::parseUnsigned(buffer, 1, 36,
+                                                           number,
+                                                           parsedLength));
+        }
+
+        TESTS_EXCEPTION(cNumberConversion::formatUnsigned(1, buffer, 1));
+        TESTS_EXCEPTION(cNumberConversion::formatUnsigned(1, buffer, 37));
+        TESTS_EXCEPTION(cNumberConversion::parseUnsigned(buffer, 1, 0, number,
+                                                         parsedLength));
+    }
+
+    void test_string()
+    {
+        TESTS_ASSERT_EQUAL(cString((uint32)0), XSTL_STRING("0"));
+        TESTS_ASSERT_EQUAL(cString((int32)-15, 16), XSTL_STRING("-F"));
+        TESTS_ASSERT_EQUAL(cString((int32)0x80000000), XSTL_STRING("-2147483648"));
+        TESTS_ASSERT_EQUAL(cString((uint32)0xFFFFFFFF), XSTL_STRING("4294967295"));
+        TESTS_ASSERT_EQUAL(cString((int64)((uint64)1 << 63)),
+                           XSTL_STRING("-9223372036854775808"));
+        TESTS_ASSERT_EQUAL(cString((uint64)-1, 2), cString::dup(XSTL_STRING("1"), 64));
+        TESTS_ASSERT_EQUAL(cString((uint32)35, 36), XSTL_STRING("Z"));
+        // Bases above 36 use the rest of the strip
+        TESTS_ASSERT_EQUAL(cString((uint32)36, 37), XSTL_STRING("!"));
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        testFormatAndParse<char>();
+        testFormatAndParse<character>();
+        test_string();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestNumberConversion g_globalTestNumberConversion;
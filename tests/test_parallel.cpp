@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_parallel.cpp
+ *
+ * Test the cThreadPool class and the parallel algorithms.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/os/interlocked.h"
+#include "xStl/os/threadPool.h"
+#include "xStl/os/osrand.h"
+#include "xStl/utils/parallel.h"
+#include "../../xStl/tests/tests.h"
+
+class cTestParallel : public cTestObject
+{
+public:
+    // Count the executions of every task
+    class cCountTask : public cThreadPool::cTask
+    {
+    public:
+        cCountTask(uint count) : m_counters(count)
+        {
+            for (uint i = 0; i < count; i++)
+                m_counters[i] = 0;
+        }
+
+        virtual void runTask(uint index)
+        {
+            cInterlocked::increment(&m_counters[index]);
+        }
+
+        cArray<counter_t> m_counters;
+    };
+
+    // Throws exception on one of the tasks. 'isUnknown' throws a type which
+    // isn't a cException.
+    class cThrowTask : public cThreadPool::cTask
+    {
+    public:
+        cThrowTask(bool isUnknown = false) : m_isUnknown(isUnknown) {}
+
+        virtual void runTask(uint index)
+        {
+            if (index == 17)
+            {
+                if (m_isUnknown)
+                    throw (int)index;
+                XSTL_THROW(cException, EXCEPTION_FAILED);
+            }
+        }
+
+    private:
+        bool m_isUnknown;
+    };
+
+    // Calls the pool from inside a task
+    class cNestedTask : public cThreadPool::cTask
+    {
+    public:
+        cNestedTask(cThreadPool& pool) : m_pool(pool), m_inner(64) {}
+
+        virtual void runTask(uint)
+        {
+            m_pool.execute(m_inner, 64);
+        }
+
+        cThreadPool& m_pool;
+        cCountTask m_inner;
+    };
+
+    // Functors of the parallel algorithms
+    class cMarkIndex
+    {
+    public:
+        cMarkIndex(uint* data) : m_data(data) {}
+        void operator () (uint index) const { m_data[index]+= index; }
+        uint* m_data;
+    };
+
+    class cSquare
+    {
+    public:
+        uint64 operator () (const uint& value) const
+        {
+            return (uint64)value * value;
+        }
+    };
+
+    class cSum
+    {
+    public:
+        uint64 operator () (const uint64& a, const uint64& b) const
+        {
+            return a + b;
+        }
+    };
+
+    class cMinimum
+    {
+    public:
+        uint operator () (const uint& a, const uint& b) const
+        {
+            return t_min(a, b);
+        }
+    };
+
+    class cGreaterThan
+    {
+    public:
+        bool operator () (const uint& a, const uint& b) const { return a > b; }
+    };
+
+    void test_pool(uint workers)
+    {
+        cThreadPool pool(workers);
+        TESTS_ASSERT_EQUAL(pool.getConcurrency(), workers + 1);
+
+        static const uint counts[] = {0, 1, 2, 7, 100, 10000};
+        for (uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+        {
+            // Reuse the same workers for several jobs
+            for (uint round = 0; round < 3; round++)
+            {
+                cCountTask task(counts[c]);
+                pool.execute(task, counts[c]);
+                for (uint i = 0; i < counts[c]; i++)
+                    TESTS_ASSERT_EQUAL(task.m_counters[i], 1);
+            }
+        }
+
+        cThrowTask throwTask;
+        TESTS_EXCEPTION(pool.execute(throwTask, 100));
+        cThrowTask unknownTask(true);
+        TESTS_ALL_EXCEPTION(pool.execute(unknownTask, 100));
+
+        // The pool works after an exception
+        cCountTask task(50);
+        pool.execute(task, 50);
+        for (uint i = 0; i < 50; i++)
+            TESTS_ASSERT_EQUAL(task.m_counters[i], 1);
+
+        // A job inside a job is executed by the calling thread
+        cNestedTask nested(pool);
+        pool.execute(nested, 10);
+        for (uint i = 0; i < 64; i++)
+            TESTS_ASSERT_EQUAL(nested.m_inner.m_counters[i], 10);
+    }
+
+    void test_algorithms(uint workers)
+    {
+        cThreadPool pool(workers);
+        uint i;
+
+        // parallelFor
+        cArray<uint> data(20000);
+        for (i = 0; i < data.getSize(); i++)
+            data[i] = 1;
+        parallelFor(100, data.getSize(), cMarkIndex(data.getBuffer()), 1,
+                    pool);
+        parallelFor(5, 5, cMarkIndex(data.getBuffer()), 1, pool);
+        for (i = 0; i < data.getSize(); i++)
+            TESTS_ASSERT_EQUAL(data[i], (i < 100) ? 1 : i + 1);
+
+        // parallelTransform and parallelReduce
+        static const uint sizes[] = {0, 1, 100, 5000, 100000};
+        for (uint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            cArray<uint> source(sizes[s]);
+            uint64 expected = 7;
+            uint lowest = 1000000;
+            for (i = 0; i < sizes[s]; i++)
+            {
+                source[i] = cOSRand::rand() % 100000;
+                expected+= (uint64)source[i] * source[i];
+                lowest = t_min(lowest, source[i]);
+            }
+
+            cArray<uint64> squares;
+            parallelTransform(source, squares, cSquare(), pool);
+            TESTS_ASSERT_EQUAL(squares.getSize(), sizes[s]);
+            for (i = 0; i < sizes[s]; i++)
+                TESTS_ASSERT_EQUAL(squares[i], (uint64)source[i] * source[i]);
+
+            TESTS_ASSERT_EQUAL(parallelReduce(squares, (uint64)7, cSum(), pool),
+                               expected);
+            TESTS_ASSERT_EQUAL(parallelReduce(source, (uint)1000000, cMinimum(),
+                                              pool),
+                               lowest);
+
+            // parallelSort
+            cArray<uint> sorted(source);
+            parallelSort(sorted, cLessThan<uint>(), pool);
+            TESTS_ASSERT_EQUAL(sorted.getSize(), source.getSize());
+            uint64 sum = 0;
+            for (i = 0; i < sorted.getSize(); i++)
+            {
+                sum+= sorted[i];
+                if (i > 0)
+                    TESTS_ASSERT(sorted[i - 1] <= sorted[i]);
+            }
+            uint64 sourceSum = 0;
+            for (i = 0; i < source.getSize(); i++)
+                sourceSum+= source[i];
+            TESTS_ASSERT_EQUAL(sum, sourceSum);
+
+            parallelSort(sorted, cGreaterThan(), pool);
+            for (i = 1; i < sorted.getSize(); i++)
+                TESTS_ASSERT(sorted[i - 1] >= sorted[i]);
+        }
+
+        // The default pool
+        cArray<cString> strings;
+        for (i = 0; i < 10000; i++)
+            strings.append(cString(cOSRand::rand() % 1000));
+        parallelSort(strings);
+        for (i = 1; i < strings.getSize(); i++)
+            TESTS_ASSERT(!(strings[i] < strings[i - 1]));
+    }
+
+    void test_default()
+    {
+        cCountTask task(20);
+        cThreadPool::getDefault().execute(task, 20);
+
+        // A new shared pool is created after the old one is destroyed
+        cThreadPool::destroyDefault();
+        cThreadPool::destroyDefault();
+        cCountTask other(20);
+        cThreadPool::getDefault().execute(other, 20);
+        for (uint i = 0; i < 20; i++)
+            TESTS_ASSERT_EQUAL(other.m_counters[i], 1);
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_pool(0);
+        test_pool(1);
+        test_pool(4);
+        test_algorithms(0);
+        test_algorithms(1);
+        test_algorithms(2);
+        test_algorithms(6);
+        test_default();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestParallel g_globalTestParallel;
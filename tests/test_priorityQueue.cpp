@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_priorityQueue.cpp
+ *
+ * Test the template cPriorityQueue class and the order of cOrderedList.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/priorityQueue.h"
+#include "xStl/data/orderedList.h"
+#include "xStl/data/string.h"
+#include "xStl/os/osrand.h"
+#include "../../xStl/tests/tests.h"
+
+class cTestPriorityQueue : public cTestObject
+{
+public:
+    typedef cPriorityQueue<uint> Queue;
+
+    // Reverse order, the greatest element is poped first
+    class cGreaterThan
+    {
+    public:
+        bool operator () (uint a, uint b) const { return a > b; }
+    };
+
+    // An item of an ordered-list which is ordered only by its key
+    class cItem
+    {
+    public:
+        cItem(uint key = 0, uint order = 0) : m_key(key), m_order(order) {}
+        bool operator < (const cItem& other) const { return m_key < other.m_key; }
+        bool operator == (const cItem& other) const { return m_key == other.m_key; }
+
+        uint m_key;
+        uint m_order;
+    };
+
+    // Check that the top of the queue is the lowest valid element of the
+    // reference.
+    void compare(const Queue& queue, const cArray<uint>& values,
+                 const cArray<bool>& valid)
+    {
+        uint count = 0;
+        uint lowest = 0;
+        for (uint i = 0; i < values.getSize(); i++)
+        {
+            TESTS_ASSERT_EQUAL(queue.isValid(i), valid[i]);
+            if (!valid[i])
+                continue;
+            TESTS_ASSERT_EQUAL(queue.get(i), values[i]);
+            if ((count == 0) || (values[i] < lowest))
+                lowest = values[i];
+            count++;
+        }
+        TESTS_ASSERT_EQUAL(queue.length(), count);
+        TESTS_ASSERT_EQUAL(queue.isEmpty(), count == 0);
+        if (count > 0)
+        {
+            TESTS_ASSERT_EQUAL(queue.top(), lowest);
+            TESTS_ASSERT_EQUAL(values[queue.topHandle()], lowest);
+        }
+    }
+
+    // Random operations, compared with an array which is indexed by handles
+    void test_random()
+    {
+        Queue queue;
+        cArray<uint> values;
+        cArray<bool> valid;
+        for (uint i = 0; i < 20000; i++)
+        {
+            uint value = cOSRand::rand() % 1000;
+            uint handle = (values.getSize() > 0) ?
+                          (cOSRand::rand() % values.getSize()) : 0;
+            bool isValid = (values.getSize() > 0) && valid[handle];
+            switch (cOSRand::rand() % 8)
+            {
+            case 0:
+            case 1:
+            case 2:
+                handle = queue.push(value);
+                if (handle == values.getSize())
+                {
+                    values.append(value);
+                    valid.append(true);
+                } else
+                {
+                    // Reused handle
+                    TESTS_ASSERT(!valid[handle]);
+                    values[handle] = value;
+                    valid[handle] = true;
+                }
+                break;
+            case 3:
+                if (queue.isEmpty())
+                {
+                    TESTS_EXCEPTION(queue.pop());
+                    break;
+                }
+                handle = queue.topHandle();
+                queue.pop();
+                valid[handle] = false;
+                break;
+            case 4:
+                if (!isValid)
+                {
+                    TESTS_EXCEPTION(queue.decreaseKey(handle, value));
+                    break;
+                }
+                value = values[handle] - (values[handle] > 0 ? 1 : 0);
+                queue.decreaseKey(handle, value / 2);
+                values[handle] = value / 2;
+                break;
+            case 5:
+                if (!isValid)
+                {
+                    TESTS_EXCEPTION(queue.update(handle, value));
+                    break;
+                }
+                queue.update(handle, value);
+                values[handle] = value;
+                break;
+            case 6:
+                if (!isValid)
+                {
+                    TESTS_EXCEPTION(queue.remove(handle));
+                    break;
+                }
+                queue.remove(handle);
+                valid[handle] = false;
+                break;
+            case 7:
+                if (cOSRand::rand() % 100 == 0)
+                {
+                    queue.removeAll();
+                    values.changeSize(0);
+                    valid.changeSize(0);
+                }
+                break;
+            }
+            compare(queue, values, valid);
+        }
+
+        // Empty the queue in order
+        uint last = 0;
+        while (!queue.isEmpty())
+        {
+            TESTS_ASSERT(queue.top() >= last);
+            last = queue.top();
+            queue.pop();
+        }
+        TESTS_EXCEPTION(queue.top());
+        TESTS_EXCEPTION(queue.topHandle());
+    }
+
+    // Bulk build of the heap and other orders
+    void test_heapify()
+    {
+        uint i;
+        cArray<uint> values;
+        for (i = 0; i < 5000; i++)
+            values.append(cOSRand::rand() % 10000);
+
+        Queue queue;
+        queue.push(1);
+        queue.heapify(values);
+        TESTS_ASSERT_EQUAL(queue.length(), values.getSize());
+        for (i = 0; i < values.getSize(); i++)
+            TESTS_ASSERT_EQUAL(queue.get(i), values[i]);
+        TESTS_ASSERT(!queue.isValid(values.getSize()));
+
+        // A decreased key must not come after the current value
+        uint handle = queue.topHandle();
+        TESTS_EXCEPTION(queue.decreaseKey(handle, queue.top() + 1));
+        queue.decreaseKey(handle, queue.top());
+
+        Queue copy(queue);
+        uint last = 0;
+        for (i = 0; i < values.getSize(); i++)
+        {
+            TESTS_ASSERT(queue.top() >= last);
+            last = queue.top();
+            queue.pop();
+        }
+        TESTS_ASSERT(queue.isEmpty());
+
+        queue.swap(copy);
+        TESTS_ASSERT(copy.isEmpty());
+        TESTS_ASSERT_EQUAL(queue.length(), values.getSize());
+
+        // Max-heap, binary
+        cPriorityQueue<uint, cGreaterThan, 2> reverse;
+        reverse.heapify(values);
+        for (i = 0; i < 100; i++)
+            reverse.push(i);
+        last = reverse.top();
+        while (!reverse.isEmpty())
+        {
+            TESTS_ASSERT(reverse.top() <= last);
+            last = reverse.top();
+            reverse.pop();
+        }
+
+        // Empty array
+        queue.heapify(cArray<uint>());
+        TESTS_ASSERT(queue.isEmpty());
+        TESTS_ASSERT_EQUAL(queue.push(5), 0);
+
+        cPriorityQueue<cString> strings;
+        strings.push(XSTL_STRING("b"));
+        strings.push(XSTL_STRING("c"));
+        strings.push(XSTL_STRING("a"));
+        TESTS_ASSERT_EQUAL(strings.top(), XSTL_STRING("a"));
+        strings.pop();
+        TESTS_ASSERT_EQUAL(strings.top(), XSTL_STRING("b"));
+    }
+
+    // Test that add() keeps the ordered-list sorted and stable
+    void test_orderedList()
+    {
+        uint i;
+        cOrderedList<cItem> list;
+        for (i = 0; i < 2000; i++)
+            list.add(cItem(cOSRand::rand() % 50, i));
+        // Ascending items are appended
+        for (i = 0; i < 100; i++)
+            list.add(cItem(50 + i, 2000 + i));
+
+        TESTS_ASSERT_EQUAL(list.length(), 2100);
+        cItem previous = list.first();
+        i = 0;
+        for (cList<cItem>::iterator j = list.begin(); j != list.end(); ++j, i++)
+        {
+            if (i == 0)
+                continue;
+            TESTS_ASSERT(!((*j) < previous));
+            if ((*j).m_key == previous.m_key)
+                TESTS_ASSERT((*j).m_order > previous.m_order);
+            previous = *j;
+        }
+        TESTS_ASSERT_EQUAL(previous.m_key, 149);
+
+        list.add(cItem(0, 5000));
+        list.pop2null();
+        TESTS_ASSERT_EQUAL(list.length(), 2100);
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_random();
+        test_heapify();
+        test_orderedList();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestPriorityQueue g_globalTestPriorityQueue;
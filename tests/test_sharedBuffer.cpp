@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_sharedBuffer.cpp
+ *
+ * Test the copy-on-write buffer.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/sarray.h"
+#include "xStl/data/list.h"
+#include "xStl/data/sharedBuffer.h"
+#include "tests.h"
+
+class cTestSharedBuffer : public cTestObject
+{
+public:
+    // Perform the test
+    virtual void test()
+    {
+        static const uint8 data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+        cSharedBuffer buffer(data, sizeof(data));
+        TESTS_ASSERT_EQUAL(buffer.getSize(), sizeof(data));
+        TESTS_ASSERT(!buffer.isShared());
+        TESTS_ASSERT_EQUAL(buffer[3], 4);
+
+        // Copies reference the same memory
+        cSharedBuffer copy(buffer);
+        cList<cSharedBuffer> list;
+        list.append(buffer);
+        list.append(copy);
+        TESTS_ASSERT(buffer.isShared());
+        TESTS_ASSERT(copy.getBuffer() == buffer.getBuffer());
+        TESTS_ASSERT((*list.begin()).getBuffer() == buffer.getBuffer());
+        TESTS_ASSERT(copy == buffer);
+
+        // Changing a copy detaches it
+        copy[0] = 100;
+        TESTS_ASSERT(copy.getBuffer() != buffer.getBuffer());
+        TESTS_ASSERT_EQUAL(copy[0], 100);
+        TESTS_ASSERT_EQUAL(buffer[0], 1);
+        TESTS_ASSERT(copy != buffer);
+        TESTS_ASSERT(!copy.isShared());
+
+        copy.getWritableData().append(9);
+        TESTS_ASSERT_EQUAL(copy.getSize(), sizeof(data) + 1);
+        TESTS_ASSERT_EQUAL(buffer.getSize(), sizeof(data));
+
+        // The last reference changes the memory without copying
+        list.removeAll();
+        TESTS_ASSERT(!buffer.isShared());
+        const uint8* memory = buffer.getBuffer();
+        buffer.getWritableData()[1] = 200;
+        TESTS_ASSERT(buffer.getBuffer() == memory);
+        TESTS_ASSERT_EQUAL(buffer.getData()[1], 200);
+
+        // Assignment
+        copy = buffer;
+        TESTS_ASSERT(copy.getBuffer() == memory);
+        TESTS_ASSERT(copy == buffer);
+        cSharedBuffer empty;
+        TESTS_ASSERT_EQUAL(empty.getSize(), 0);
+        copy = empty;
+        TESTS_ASSERT_EQUAL(copy.getSize(), 0);
+        TESTS_ASSERT(!buffer.isShared());
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestSharedBuffer g_globalTestSharedBuffer;
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_smallMemory.cpp
+ *
+ * Test the size classes, the thread caches and the statistics of the UNIX
+ * small-memory allocator.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/os/os.h"
+#include "xStl/os/threadedClass.h"
+#include "xStl/except/trace.h"
+#include "tests.h"
+
+#ifdef XSTL_LINUX
+
+#include "xStl/os/unixOS/smallMemory.h"
+
+class cTestSmallMemory : public cTestObject
+{
+public:
+    enum { Blocks = 10000 };
+
+    static bool isAligned(void* block)
+    {
+        return ((addressNumericValue)block % cSmallMemory::Alignment) == 0;
+    }
+
+    void testSizeClasses()
+    {
+        TESTS_ASSERT_EQUAL(cSmallMemory::getSizeClass(0), 0);
+        TESTS_ASSERT_EQUAL(cSmallMemory::getSizeClass(1), 0);
+        TESTS_ASSERT_EQUAL(cSmallMemory::getSizeClass(16), 0);
+        TESTS_ASSERT_EQUAL(cSmallMemory::getSizeClass(17), 1);
+        TESTS_ASSERT_EQUAL(cSmallMemory::getSizeClassSize(63), 1024);
+        TESTS_ASSERT_EQUAL(cSmallMemory::getSizeClassSize(64), 1280);
+        TESTS_ASSERT_EQUAL(
+            cSmallMemory::getSizeClass(cSmallMemory::MaxSmallSize),
+            cSmallMemory::SizeClassesCount - 1);
+        TESTS_ASSERT_EQUAL(
+            cSmallMemory::getSizeClassSize(cSmallMemory::SizeClassesCount - 1),
+            cSmallMemory::MaxSmallSize);
+
+        // Every size gets the smallest class which holds it
+        for (uint size = 1; size <= cSmallMemory::MaxSmallSize; size++)
+        {
+            uint sizeClass = cSmallMemory::getSizeClass(size);
+            TESTS_ASSERT(cSmallMemory::getSizeClassSize(sizeClass) >= size);
+            TESTS_ASSERT((cSmallMemory::getSizeClassSize(sizeClass) %
+                          cSmallMemory::Alignment) == 0);
+            if (sizeClass > 0)
+            {
+                TESTS_ASSERT(cSmallMemory::getSizeClassSize(sizeClass - 1) <
+                             size);
+            }
+        }
+    }
+
+    void testAllocations()
+    {
+        // Blocks of all the classes and large blocks
+        uint8* blocks[64];
+        uint i;
+        for (i = 0; i < 64; i++)
+        {
+            uint size = (i * 997) + 1;
+            blocks[i] = (uint8*)cOS::smallMemoryAllocation(size);
+            TESTS_ASSERT(isAligned(blocks[i]));
+            blocks[i][0] = (uint8)i;
+            blocks[i][size - 1] = (uint8)i;
+        }
+        for (i = 0; i < 64; i++)
+        {
+            uint size = (i * 997) + 1;
+            TESTS_ASSERT_EQUAL(blocks[i][0], (uint8)i);
+            TESTS_ASSERT_EQUAL(blocks[i][size - 1], (uint8)i);
+            cOS::smallMemoryFree(blocks[i]);
+        }
+        cOS::smallMemoryFree(NULL);
+
+        // Freed blocks are recycled by the same thread
+        void* block = cOS::smallMemoryAllocation(40);
+        cOS::smallMemoryFree(block);
+        TESTS_ASSERT(cOS::smallMemoryAllocation(48) == block);
+        cOS::smallMemoryFree(block);
+    }
+
+    void testReallocate()
+    {
+        uint8* block = (uint8*)cOS::smallMemoryRealloc(NULL, 20);
+        for (uint i = 0; i < 20; i++)
+            block[i] = (uint8)i;
+
+        // The same size class keeps the block
+        TESTS_ASSERT(cOS::smallMemoryRealloc(block, 32) == block);
+
+        // Grow into a small block and into a large block
+        block = (uint8*)cOS::smallMemoryRealloc(block, 1000);
+        TESTS_ASSERT_EQUAL(block[19], 19);
+        block = (uint8*)cOS::smallMemoryRealloc(block, 100000);
+        TESTS_ASSERT_EQUAL(block[19], 19);
+        TESTS_ASSERT(isAligned(block));
+        block[99999] = 1;
+        block = (uint8*)cOS::smallMemoryRealloc(block, 200000);
+        TESTS_ASSERT_EQUAL(block[99999], 1);
+
+        // And shrink back
+        block = (uint8*)cOS::smallMemoryRealloc(block, 10);
+        TESTS_ASSERT_EQUAL(block[9], 9);
+        TESTS_ASSERT(cOS::smallMemoryRealloc(block, 0) == NULL);
+    }
+
+    void testStatistics()
+    {
+        uint size = 20000;
+        uint sizeClass = cSmallMemory::getSizeClass(size);
+        uint classSize = cSmallMemory::getSizeClassSize(sizeClass);
+        void* blocks[100];
+        uint i;
+
+        cSmallMemory::Statistics before;
+        cSmallMemory::getStatistics(before);
+        for (i = 0; i < 100; i++)
+            blocks[i] = cOS::smallMemoryAllocation(size);
+        void* large = cOS::smallMemoryAllocation(1000000);
+
+        cSmallMemory::Statistics after;
+        cSmallMemory::getStatistics(after);
+        TESTS_ASSERT_EQUAL(after.m_bytesInUse[sizeClass] -
+                           before.m_bytesInUse[sizeClass],
+                           100 * classSize);
+        TESTS_ASSERT_EQUAL(after.m_largeBytesInUse - before.m_largeBytesInUse,
+                           1000000);
+        TESTS_ASSERT(after.m_reservedBytes >= 100 * classSize);
+        TESTS_ASSERT(after.m_cacheHits + after.m_cacheMisses >=
+                     before.m_cacheHits + before.m_cacheMisses + 100);
+
+        // Large blocks are resized by the system heap
+        large = cOS::smallMemoryRealloc(large, 2000000);
+        cSmallMemory::getStatistics(after);
+        TESTS_ASSERT_EQUAL(after.m_largeBytesInUse - before.m_largeBytesInUse,
+                           2000000);
+
+        for (i = 0; i < 100; i++)
+            cOS::smallMemoryFree(blocks[i]);
+        cOS::smallMemoryFree(large);
+        cSmallMemory::getStatistics(after);
+        TESTS_ASSERT_EQUAL(after.m_bytesInUse[sizeClass],
+                           before.m_bytesInUse[sizeClass]);
+        TESTS_ASSERT_EQUAL(after.m_largeBytesInUse, before.m_largeBytesInUse);
+
+        // Most of the allocations are served by the cache
+        for (i = 0; i < Blocks; i++)
+            cOS::smallMemoryFree(cOS::smallMemoryAllocation(64));
+        cSmallMemory::getStatistics(after);
+        TESTS_ASSERT(after.getCacheHitRatio() > 0.5);
+        TESTS_ASSERT(after.getCacheHitRatio() <= 1.0);
+    }
+
+    // Allocate blocks which are freed by another thread
+    class cAllocateThread : public cThreadedClass
+    {
+    public:
+        cAllocateThread(void** blocks) : m_blocks(blocks) {}
+
+        virtual void run()
+        {
+            for (uint i = 0; i < Blocks; i++)
+            {
+                m_blocks[i] = cOS::smallMemoryAllocation((i % 256) + 1);
+                *(uint*)m_blocks[i] = i;
+            }
+        }
+
+    private:
+        void** m_blocks;
+    };
+
+    void testThreads()
+    {
+        cSmallMemory::Statistics before;
+        cSmallMemory::getStatistics(before);
+
+        void** blocks = (void**)cOS::smallMemoryAllocation(
+                                    Blocks * sizeof(void*));
+        cAllocateThread thread(blocks);
+        thread.start();
+        thread.wait();
+
+        // Free the blocks of the exited thread
+        uint i;
+        for (i = 0; i < Blocks; i++)
+        {
+            TESTS_ASSERT_EQUAL(*(uint*)blocks[i], i);
+            cOS::smallMemoryFree(blocks[i]);
+        }
+        cSmallMemory::flushThreadCache();
+
+        // The blocks of the exited thread are no longer in use
+        cSmallMemory::Statistics after;
+        cSmallMemory::getStatistics(after);
+        uint64 beforeBytes = 0;
+        uint64 afterBytes = 0;
+        for (i = 0; i < cSmallMemory::SizeClassesCount; i++)
+        {
+            beforeBytes+= before.m_bytesInUse[i];
+            afterBytes+= after.m_bytesInUse[i];
+        }
+        TESTS_ASSERT(afterBytes < beforeBytes + (Blocks * 16));
+
+        // The depot returns the freed blocks to other threads
+        cAllocateThread secondThread(blocks);
+        secondThread.start();
+        secondThread.wait();
+        for (i = 0; i < Blocks; i++)
+            cOS::smallMemoryFree(blocks[i]);
+        cOS::smallMemoryFree(blocks);
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        testSizeClasses();
+        testAllocations();
+        testReallocate();
+        testStatistics();
+        testThreads();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestSmallMemory g_globalTestSmallMemory;
+
+#endif // XSTL_LINUX
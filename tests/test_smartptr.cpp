@@ -41,6 +41,8 @@
 #include "xStl/os/osrand.h"
 #include "xStl/data/smartptr.h"
 #include "xStl/data/list.h"
+#include "xStl/os/interlocked.h"
+#include "xStl/os/threadedClass.h"
 #include "xStl/except/trace.h"
 #include "../../xStl/tests/tests.h"
 
@@ -59,14 +61,19 @@ public:
     ~A()
     {
         //TRACE(TRACE_LOW, "Object destruct");
+        cInterlocked::increment(&g_destructed);
     }
 
+    // The number of destructed objects
+    static volatile counter_t g_destructed;
+
     int& getMember() { return m_member; }
 
 private:
     int m_member;
 };
 
+volatile counter_t A::g_destructed = 0;
 
 
 class cTestSmartPtr : public cTestObject
@@ -88,6 +95,87 @@ public:
         TESTS_ASSERT_EQUAL(obj1, obj2);
     };
 
+    // Objects which are allocated together with their counter
+    void test_make()
+    {
+        counter_t destructed = A::g_destructed;
+        {
+            cSmartPtr<A> object1 = makeSmartPtr<A>();
+            TESTS_ASSERT(!object1.isEmpty());
+            TESTS_ASSERT_EQUAL(object1.getDestructMethod(),
+                               SMARTPTR_DESTRUCT_EMBEDDED);
+            TESTS_ASSERT_EQUAL(object1.getCounter().getValue(), 1);
+
+            cSmartPtr<A> object2(object1);
+            TESTS_ASSERT_EQUAL(object1.getCounter().getValue(), 2);
+            TESTS_ASSERT(object1 == object2);
+
+            object2 = cSmartPtr<A>(new A());
+            TESTS_ASSERT(object1 != object2);
+            TESTS_ASSERT_EQUAL(object1.getCounter().getValue(), 1);
+            TESTS_ASSERT_EQUAL(A::g_destructed, destructed);
+
+            object1 = object2;
+            TESTS_ASSERT_EQUAL(A::g_destructed, destructed + 1);
+        }
+        TESTS_ASSERT_EQUAL(A::g_destructed, destructed + 2);
+
+        // Constructor arguments
+        cSmartPtr<cString> string = makeSmartPtr<cString>(XSTL_STRING("abc"));
+        TESTS_ASSERT_EQUAL(*string, XSTL_STRING("abc"));
+        cSmartPtr<cList<int> > list = makeSmartPtr<cList<int> >();
+        list->append(5);
+        TESTS_ASSERT_EQUAL(list->length(), 1);
+    }
+
+    // Copy and release a shared object from a thread
+    class cCopyThread : public cThreadedClass
+    {
+    public:
+        enum { COPIES = 20000 };
+
+        cCopyThread(const cSmartPtr<A>& object) : m_object(object) {}
+
+        virtual void run()
+        {
+            cList<cSmartPtr<A> > copies;
+            for (uint i = 0; i < COPIES; i++)
+            {
+                cSmartPtr<A> copy(m_object);
+                cSmartPtr<A> other(m_object);
+                other = copy;
+                if ((i % 16) == 0)
+                    copies.append(other);
+            }
+        }
+
+    private:
+        cSmartPtr<A> m_object;
+    };
+
+    void test_threads()
+    {
+        enum { THREADS = 8 };
+        counter_t destructed = A::g_destructed;
+        {
+            cSmartPtr<A> object(new A());
+            cCopyThread* threads[THREADS];
+            uint i;
+            for (i = 0; i < THREADS; i++)
+            {
+                threads[i] = new cCopyThread(object);
+                threads[i]->start();
+            }
+            for (i = 0; i < THREADS; i++)
+            {
+                threads[i]->wait();
+                delete threads[i];
+            }
+            TESTS_ASSERT_EQUAL(A::g_destructed, destructed);
+        }
+        TESTS_ASSERT_EQUAL(A::g_destructed, destructed + 1);
+    }
+
 
     // Perform the test
     virtual void test()
@@ -95,6 +183,8 @@ public:
         // Init random generator.
         for (uint i = 0; i < 100; i++) cOSRand::rand();
         test_normal();
+        test_make();
+        test_threads();
     };
 
     // Return the name of the module
@@ -197,6 +197,77 @@ public:
         }
     }
 
+    void test_replace()
+    {
+        cString a(XSTL_STRING("a-b-c"));
+        a.replace(XSTL_STRING("-"), XSTL_STRING("::"));
+        TESTS_ASSERT_EQUAL(a, XSTL_STRING("a::b::c"));
+        a.replace(XSTL_STRING("::"), XSTL_STRING(""));
+        TESTS_ASSERT_EQUAL(a, XSTL_STRING("abc"));
+
+        // The substituted strings are not scanned again
+        a.replace(XSTL_STRING("b"), XSTL_STRING("bb"));
+        TESTS_ASSERT_EQUAL(a, XSTL_STRING("abbc"));
+        cString b(XSTL_STRING("aaab"));
+        b.replace(XSTL_STRING("ab"), XSTL_STRING("b"));
+        TESTS_ASSERT_EQUAL(b, XSTL_STRING("aab"));
+
+        // No match and empty strings
+        b.replace(XSTL_STRING("x"), XSTL_STRING("y"));
+        TESTS_ASSERT_EQUAL(b, XSTL_STRING("aab"));
+        b.replace(XSTL_STRING(""), XSTL_STRING("y"));
+        TESTS_ASSERT_EQUAL(b, XSTL_STRING("aab"));
+        cString empty;
+        empty.replace(XSTL_STRING("a"), XSTL_STRING("b"));
+        TESTS_ASSERT_EQUAL(empty.length(), 0);
+
+        // Long and shared strings
+        cString longString(cString::dup(XSTL_STRING("ab"), 50));
+        cString copy(longString);
+        longString.share();
+        cString sharedCopy(longString);
+        longString.replace(cStringView(XSTL_STRING("b")),
+                           cStringView(XSTL_STRING("")));
+        TESTS_ASSERT_EQUAL(longString, cString::dup(XSTL_STRING("a"), 50));
+        TESTS_ASSERT_EQUAL(sharedCopy, copy);
+    }
+
+    void test_splitInto()
+    {
+        // Dividers at the edges
+        cList<cString> d = cString(XSTL_STRING(";x;")).split(XSTL_STRING(";"));
+        TESTS_ASSERT_EQUAL(d.length(), 3);
+        TESTS_ASSERT_EQUAL(*d.begin(), XSTL_STRING(""));
+        TESTS_ASSERT_EQUAL(cString(XSTL_STRING("x")).split(XSTL_STRING("")).length(), 1);
+        TESTS_ASSERT_EQUAL(cString().split(XSTL_STRING(";")).length(), 1);
+
+        // Split into a list reuses the strings memory
+        cString lines(cString::dup(XSTL_STRING("0123456789"), 5));
+        lines+= XSTL_STRING("\n");
+        lines+= cString::dup(XSTL_STRING("abcdefghij"), 5);
+        cList<cString> tokens;
+        lines.split(cStringView(XSTL_STRING("\n")), tokens);
+        TESTS_ASSERT_EQUAL(tokens.length(), 2);
+        const character* first = (*tokens.begin()).getBuffer();
+        lines.split(cStringView(XSTL_STRING("\n")), tokens);
+        TESTS_ASSERT_EQUAL(tokens.length(), 2);
+        TESTS_ASSERT((*tokens.begin()).getBuffer() == first);
+        TESTS_ASSERT_EQUAL(*tokens.begin(), cString::dup(XSTL_STRING("0123456789"), 5));
+
+        // Unused strings are removed
+        cString(XSTL_STRING("single")).split(cStringView(XSTL_STRING(",")), tokens);
+        TESTS_ASSERT_EQUAL(tokens.length(), 1);
+        TESTS_ASSERT_EQUAL(*tokens.begin(), XSTL_STRING("single"));
+        cString(XSTL_STRING("a,b,c")).split(cStringView(XSTL_STRING(",")), tokens);
+        TESTS_ASSERT_EQUAL(tokens.length(), 3);
+
+        // Views
+        cList<cStringView> views = lines.splitView(cStringView(XSTL_STRING("\n")));
+        TESTS_ASSERT_EQUAL(views.length(), 2);
+        TESTS_ASSERT((*views.begin()).getBuffer() == lines.getBuffer());
+        TESTS_ASSERT_EQUAL(lines.splitView(cStringView()).length(), 1);
+    }
+
     void test_operator_LZ()
     {
         cString temp = XSTL_STRING("TEMP");
@@ -208,6 +279,13 @@ public:
         uint32 position = 4;
         character nil = temp[position];
         TESTS_ASSERT_EQUAL(nil, cChar::getNullCharacter());
+
+        // Out of range indexes throw
+        const cString& constTemp = temp;
+        TESTS_ASSERT_EQUAL(constTemp[4], cChar::getNullCharacter());
+        TESTS_EXCEPTION(temp[5]);
+        TESTS_EXCEPTION(temp[-1]);
+        TESTS_EXCEPTION(constTemp[5]);
     }
 
     void test_right()
@@ -309,18 +387,203 @@ public:
         TESTS_ASSERT_EQUAL(temp, "bla bla bla blab");
     }
 
+    void test_move()
+    {
+        cString a(ABC);
+        cString b(XSTL_STRING("xyz"));
+        a.swap(b);
+        TESTS_ASSERT_EQUAL(a, XSTL_STRING("xyz"));
+        TESTS_ASSERT_EQUAL(b, cString(ABC));
+        TESTS_ASSERT_EQUAL(a.length(), 3);
+        t_swap(a, b);
+        TESTS_ASSERT_EQUAL(a, cString(ABC));
+        TESTS_ASSERT_EQUAL(b.length(), 3);
+
+        // Concatenation chains
+        cString c = a + XSTL_STRING("-") + b + XSTL_CHAR('!') + a.left(3);
+        TESTS_ASSERT_EQUAL(c, cString(ABC) + XSTL_STRING("-xyz!abc"));
+        TESTS_ASSERT_EQUAL(c.length(), 26 + 8);
+
+        #ifdef XSTL_CPP11
+        const character* buffer = c.getBuffer();
+        cString moved(t_move(c));
+        TESTS_ASSERT(moved.getBuffer() == buffer);
+        TESTS_ASSERT_EQUAL(moved.length(), 26 + 8);
+
+        // A moved string can be assigned again
+        c = XSTL_STRING("again");
+        TESTS_ASSERT_EQUAL(c, XSTL_STRING("again"));
+        cString other(t_move(c));
+        c = other;
+        TESTS_ASSERT_EQUAL(c, other);
+
+        buffer = moved.getBuffer();
+        a = t_move(moved);
+        TESTS_ASSERT(a.getBuffer() == buffer);
+        TESTS_ASSERT_EQUAL(a.length(), 26 + 8);
+
+        // Appending into a temporary keeps its memory
+        cString left = a.left(10);
+        buffer = left.getBuffer(64);
+        cString appended = t_move(left) + XSTL_STRING("...");
+        TESTS_ASSERT(appended.getBuffer() == buffer);
+        TESTS_ASSERT_EQUAL(appended, XSTL_STRING("abcdefghij..."));
+        #endif
+    }
+
+    void test_sso()
+    {
+        // Short strings are stored inside the object
+        cString empty;
+        TESTS_ASSERT(empty.isInline());
+        TESTS_ASSERT_EQUAL(empty.length(), 0);
+        TESTS_ASSERT_EQUAL(empty[0], cChar::getNullCharacter());
+
+        cString inlined;
+        for (uint i = 0; i < cString::InlineStringLength; i++)
+            inlined+= (character)(XSTL_CHAR('0') + (i % 10));
+        TESTS_ASSERT_EQUAL(inlined.length(), cString::InlineStringLength);
+        TESTS_ASSERT(inlined.isInline());
+
+        // One more character moves the string into the heap
+        cString copy(inlined);
+        TESTS_ASSERT(copy.isInline());
+        copy+= XSTL_CHAR('x');
+        TESTS_ASSERT(!copy.isInline());
+        TESTS_ASSERT_EQUAL(copy, inlined + XSTL_CHAR('x'));
+        TESTS_ASSERT_EQUAL(copy.left(cString::InlineStringLength), inlined);
+        TESTS_ASSERT(copy.left(cString::InlineStringLength).isInline());
+
+        // Copy assignment reuses the heap memory
+        const cString shortString(XSTL_STRING("short"));
+        const character* heap = copy.getBuffer();
+        copy = shortString;
+        TESTS_ASSERT(copy.getBuffer() == heap);
+        TESTS_ASSERT_EQUAL(copy, XSTL_STRING("short"));
+
+        // Self concatenation across the inline limit
+        cString twice(XSTL_STRING("0123456789ab"));
+        twice.concat(twice);
+        TESTS_ASSERT(!twice.isInline());
+        TESTS_ASSERT_EQUAL(twice, XSTL_STRING("0123456789ab0123456789ab"));
+
+        // Swap between inline and heap strings
+        cString a(XSTL_STRING("abc"));
+        cString b(cString(ABC) + ABC);
+        heap = b.getBuffer();
+        a.swap(b);
+        TESTS_ASSERT(a.getBuffer() == heap);
+        TESTS_ASSERT(b.isInline());
+        TESTS_ASSERT_EQUAL(b, XSTL_STRING("abc"));
+        TESTS_ASSERT_EQUAL(a, cString(ABC) + ABC);
+
+        // getBuffer() can expand an inline string
+        cString buffer;
+        character* data = buffer.getBuffer(100);
+        TESTS_ASSERT(!buffer.isInline());
+        for (uint i = 0; i < 99; i++)
+            data[i] = XSTL_CHAR('a');
+        data[99] = cChar::getNullCharacter();
+        buffer.rearrangeStringVector();
+        TESTS_ASSERT_EQUAL(buffer.length(), 99);
+        TESTS_ASSERT_EQUAL(buffer.right(2), XSTL_STRING("aa"));
+    }
+
+    // Return the string memory without detaching shared strings
+    static const character* getData(const cString& string)
+    {
+        return string.getBuffer();
+    }
+
+    void test_shared()
+    {
+        cString original(cString(ABC) + ABC);
+        TESTS_ASSERT(!original.isShared());
+
+        // Copies of a non-shared string have their own memory
+        cString copy(original);
+        TESTS_ASSERT(getData(copy) != getData(original));
+
+        // Copies of a shared string reference the same memory
+        original.share();
+        TESTS_ASSERT(original.isShared());
+        const character* memory = getData(original);
+        cString first(original);
+        cString second;
+        second = first;
+        cList<cString> list;
+        list.append(second);
+        TESTS_ASSERT(first.isShared());
+        TESTS_ASSERT(getData(first) == memory);
+        TESTS_ASSERT(getData(second) == memory);
+        TESTS_ASSERT(getData((*list.begin())) == memory);
+        TESTS_ASSERT_EQUAL(second, original);
+
+        // Every change detaches the changed string
+        first+= XSTL_CHAR('!');
+        TESTS_ASSERT(!first.isShared());
+        TESTS_ASSERT(getData(first) != memory);
+        TESTS_ASSERT_EQUAL(first, cString(ABC) + ABC + XSTL_STRING("!"));
+        TESTS_ASSERT_EQUAL(original.length(), 52);
+
+        second[0] = XSTL_CHAR('A');
+        TESTS_ASSERT(getData(second) != memory);
+        TESTS_ASSERT_EQUAL(second.left(3), XSTL_STRING("Abc"));
+        TESTS_ASSERT_EQUAL(original.left(3), XSTL_STRING("abc"));
+
+        cString upper((*list.begin()));
+        upper.makeUpper();
+        TESTS_ASSERT(getData(upper) != memory);
+        TESTS_ASSERT_EQUAL((*list.begin()), original);
+
+        character* buffer = copy.getBuffer(10);
+        TESTS_ASSERT(buffer != memory);
+        copy = original;
+        TESTS_ASSERT(getData(copy) == memory);
+        buffer = copy.getBuffer(10);
+        TESTS_ASSERT(buffer != memory);
+        buffer[0] = XSTL_CHAR('x');
+        TESTS_ASSERT_EQUAL(getData(original)[0], XSTL_CHAR('a'));
+
+        // Moving keeps the reference
+        #ifdef XSTL_CPP11
+        cString moved(t_move(original));
+        TESTS_ASSERT(moved.isShared());
+        TESTS_ASSERT(getData(moved) == memory);
+        TESTS_ASSERT_EQUAL(original.length(), 0);
+        original = t_move(moved);
+        #endif
+
+        // The last reference takes the memory
+        list.removeAll();
+        TESTS_ASSERT(original.isShared());
+        original+= XSTL_CHAR('?');
+        TESTS_ASSERT(!original.isShared());
+        TESTS_ASSERT_EQUAL(original.right(2), XSTL_STRING("z?"));
+
+        // Short strings are never shared
+        cString shortString(XSTL_STRING("abc"));
+        shortString.share();
+        TESTS_ASSERT(!shortString.isShared());
+    }
+
     // Perform the test
     virtual void test()
     {
         test_wildcard();
+        test_shared();
+        test_sso();
         test_right();
         test_mid();
         test_constructor();
         test_operator_LZ();
         test_find();
         test_split();
+        test_splitInto();
+        test_replace();
         test_left();
         test_trim();
+        test_move();
     };
 
     // Return the name of the module
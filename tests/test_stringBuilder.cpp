@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_stringBuilder.cpp
+ *
+ * Test the string builder against a cString which is built by concatenation,
+ * and the users of the builder: cStringBuilderStream, hexDumpObject,
+ * cString::dup() and cString::pad().
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringBuilder.h"
+#include "xStl/data/datastream.h"
+#include "xStl/stream/stringerStream.h"
+#include "xStl/os/osrand.h"
+#include "tests.h"
+
+class cTestStringBuilder : public cTestObject
+{
+public:
+    // Append random pieces using small blocks, so the pieces cross blocks.
+    void test_random()
+    {
+        for (uint blockLength = 1; blockLength < 20; blockLength+= 3)
+        {
+            cStringBuilder builder(blockLength);
+            cString expected;
+
+            for (uint i = 0; i < 500; i++)
+            {
+                switch (cOSRand::rand() % 5)
+                {
+                case 0:
+                    {
+                        character ch = (character)('a' + (cOSRand::rand() % 26));
+                        builder << ch;
+                        expected+= ch;
+                    }
+                    break;
+                case 1:
+                    {
+                        cString piece = cString::dup("xyz",
+                                                     cOSRand::rand() % 10);
+                        builder << piece;
+                        expected+= piece;
+                    }
+                    break;
+                case 2:
+                    builder << "ascii";
+                    expected+= XSTL_STRING("ascii");
+                    break;
+                case 3:
+                    {
+                        int32 number = (int32)cOSRand::rand();
+                        builder << number;
+                        expected+= cString(number);
+                    }
+                    break;
+                case 4:
+                    {
+                        uint count = cOSRand::rand() % 30;
+                        builder.appendRepeated(XSTL_CHAR('-'), count);
+                        expected+= cString::dup("-", count);
+                    }
+                    break;
+                }
+                TESTS_ASSERT_EQUAL(builder.length(), expected.length());
+            }
+
+            TESTS_ASSERT_EQUAL(builder.toString(), expected);
+
+            // Append to an existing string
+            cString prefix("prefix:");
+            builder.appendTo(prefix);
+            TESTS_ASSERT_EQUAL(prefix, cString("prefix:") + expected);
+
+            // Clear and reuse the builder
+            builder.clear();
+            TESTS_ASSERT_EQUAL(builder.length(), 0);
+            TESTS_ASSERT_EQUAL(builder.toString(), cString());
+            builder << XSTL_STRING("again") << (uint64)18;
+            TESTS_ASSERT_EQUAL(builder.toString(), cString("again18"));
+        }
+
+        // An empty builder
+        cStringBuilder empty;
+        TESTS_ASSERT_EQUAL(empty.length(), 0);
+        TESTS_ASSERT_EQUAL(empty.toString(), cString());
+        empty.clear();
+        TESTS_ASSERT_EQUAL(empty.toString(), cString());
+
+        // Numbers
+        cStringBuilder numbers;
+        numbers << (int32)-5 << XSTL_CHAR(' ') << -((int64)1234567 * 1000000 + 890123);
+        numbers.appendUnsignedNumber(0xFF, 16);
+        numbers.appendRepeated(cString("ab").getView(), 3);
+        TESTS_ASSERT_EQUAL(numbers.toString(),
+                           cString("-5 -1234567890123FFababab"));
+    }
+
+    // Test cString::dup() and cString::pad()
+    void test_dupAndPad()
+    {
+        TESTS_ASSERT_EQUAL(cString::dup("ab", 3), cString("ababab"));
+        TESTS_ASSERT_EQUAL(cString::dup("ab", 0), cString());
+        TESTS_ASSERT_EQUAL(cString::dup("", 10), cString());
+        cString longString = cString::dup("0123456789", 100);
+        TESTS_ASSERT_EQUAL(longString.length(), 1000);
+        TESTS_ASSERT_EQUAL(longString.right(10), cString("0123456789"));
+
+        TESTS_ASSERT_EQUAL(cString::pad("ab", 5), cString("ab   "));
+        TESTS_ASSERT_EQUAL(cString::pad("ab", 5, XSTL_CHAR('.')),
+                           cString("ab..."));
+        TESTS_ASSERT_EQUAL(cString::pad("abcdef", 5), cString("abcdef"));
+        TESTS_ASSERT_EQUAL(cString::pad("", 3, XSTL_CHAR('0')),
+                           cString("000"));
+    }
+
+    // Test the builder stream and the hex dump, which write into builders
+    void test_streams()
+    {
+        cStringBuilder output(16);
+        cStringBuilderStream stream(output);
+        cString expected;
+        for (uint i = 0; i < 1000; i++)
+        {
+            stream << "line " << i << endl;
+            expected+= cString("line ") + cString(i) + endl;
+            TESTS_ASSERT_EQUAL(output.length(), expected.length());
+        }
+        TESTS_ASSERT_EQUAL(output.toString(), expected);
+
+        // The blocks are the builder text
+        cString blocks;
+        for (uint j = 0; j < output.getBlocksCount(); j++)
+            blocks+= cString(output.getBlock(j));
+        TESTS_ASSERT_EQUAL(blocks, expected);
+
+        // The hex dump into a builder and into a stream gives the same text
+        uint8 buffer[] = {0xDE, 0xAD, 0xFA, 0xCE, 0x41, 0x42, 0xBE, 0xEF,
+                          0xFA, 0xCE, 0x00, 0x01, 0x30, 0x31, 0x32, 0x33,
+                          0x7F, 0x80, 0x20};
+        DATA8 dump(buffer, buffer + sizeof(buffer));
+        cStringBuilder builder;
+        hexDumpObject(builder, dump);
+        cStringStream stringStream;
+        stringStream << dump;
+        cString text = builder.toString();
+        TESTS_ASSERT_EQUAL(stringStream.getData(), text);
+        TESTS_ASSERT(text.find(cString("DEAD FACE")) != text.length());
+
+        // The hex conversions
+        TESTS_ASSERT_EQUAL(HEXBYTE(0x0A), cString("0A"));
+        TESTS_ASSERT_EQUAL(HEXWORD(0xBEEF), cString("BEEF"));
+        TESTS_ASSERT_EQUAL(HEXDWORD(0x0012ABCD), cString("0012ABCD"));
+        TESTS_ASSERT_EQUAL(HEXQWORD(((uint64)0x01234567 << 32) | 0x89ABCDEF),
+                           cString("0123456789ABCDEF"));
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_random();
+        test_dupAndPad();
+        test_streams();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestStringBuilder g_globalTestStringBuilder;
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_stringCase.cpp
+ *
+ * Test the vectorized case conversion and the case insensitive comparison
+ * against the character by character implementation.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/char.h"
+#include "xStl/data/string.h"
+#include "xStl/data/hash.h"
+#include "xStl/data/stringCase.h"
+#include "xStl/data/caseInsensitiveString.h"
+#include "xStl/data/wildcardMatcher.h"
+#include "xStl/os/osrand.h"
+#include "tests.h"
+
+class cTestStringCase : public cTestObject
+{
+public:
+    enum { MaxLength = 80 };
+
+    // The reference implementation
+    template <class T>
+    static T simpleFold(T ch)
+    {
+        return ((ch >= 'A') && (ch <= 'Z')) ? (T)(ch + ('a' - 'A')) : ch;
+    }
+
+    template <class T>
+    static int simpleCompare(const T* a, uint aLength,
+                             const T* b, uint bLength)
+    {
+        for (uint i = 0; (i < aLength) && (i < bLength); i++)
+        {
+            uint32 x = (uint32)simpleFold(a[i]);
+            uint32 y = (uint32)simpleFold(b[i]);
+            if (sizeof(T) == 1)
+            {
+                x&= 0xFF;
+                y&= 0xFF;
+            }
+            if (x != y)
+                return (x < y) ? -1 : 1;
+        }
+        if (aLength == bLength)
+            return 0;
+        return (aLength < bLength) ? -1 : 1;
+    }
+
+    // Random letters around the ASCII case ranges, and non-ASCII characters
+    template <class T>
+    static T randomCharacter()
+    {
+        static const uint32 characters[] = {
+            'a', 'A', 'z', 'Z', '@', '[', '`', '{', '_', '0', 0x80, 0xC1, 0xE1,
+            0xFF };
+        uint32 ch = characters[cOSRand::rand() % arraysize(characters)];
+        if ((sizeof(T) > 1) && ((cOSRand::rand() % 8) == 0))
+            ch = 0x400 + (cOSRand::rand() % 0x40);
+        return (T)ch;
+    }
+
+    template <class T>
+    void testRandom()
+    {
+        T a[MaxLength];
+        T b[MaxLength];
+        T converted[MaxLength];
+        for (uint round = 0; round < 1000; round++)
+        {
+            uint aLength = cOSRand::rand() % MaxLength;
+            uint bLength = aLength;
+            if ((round % 4) == 0)
+                bLength = cOSRand::rand() % MaxLength;
+            for (uint i = 0; i < MaxLength; i++)
+                a[i] = randomCharacter<T>();
+
+            // 'b' is the same as 'a' with random case changes and a few
+            // different characters
+            for (uint i = 0; i < MaxLength; i++)
+            {
+                b[i] = a[i];
+                if (((b[i] | 0x20) >= 'a') && ((b[i] | 0x20) <= 'z') &&
+                    (cOSRand::rand() % 2))
+                {
+                    b[i] = (T)(b[i] ^ 0x20);
+                }
+                if ((cOSRand::rand() % 64) == 0)
+                    b[i] = randomCharacter<T>();
+            }
+
+            int expected = simpleCompare(a, aLength, b, bLength);
+            int result = cStringCase::icompare(a, aLength, b, bLength);
+            TESTS_ASSERT_EQUAL((result < 0), (expected < 0));
+            TESTS_ASSERT_EQUAL((result > 0), (expected > 0));
+            TESTS_ASSERT_EQUAL(cStringCase::iequals(a, aLength, b, bLength),
+                               (expected == 0));
+
+            // Case conversion
+            cStringCase::foldCase(a, aLength, converted);
+            for (uint i = 0; i < aLength; i++)
+                TESTS_ASSERT_EQUAL(converted[i], simpleFold(a[i]));
+
+            for (uint i = 0; i < aLength; i++)
+                converted[i] = a[i];
+            cStringCase::makeUpper(converted, aLength);
+            for (uint i = 0; i < aLength; i++)
+            {
+                T expectedCharacter = a[i];
+                if ((a[i] >= 'a') && (a[i] <= 'z'))
+                    expectedCharacter = (T)(a[i] - ('a' - 'A'));
+                TESTS_ASSERT_EQUAL(converted[i], expectedCharacter);
+            }
+            cStringCase::makeLower(converted, aLength);
+            for (uint i = 0; i < aLength; i++)
+                TESTS_ASSERT_EQUAL(converted[i], simpleFold(a[i]));
+        }
+    }
+
+    void test_string()
+    {
+        cString a(XSTL_STRING("The Quick Brown Fox Jumps Over The Lazy Dog [_]"));
+        cString b(a);
+        b.makeUpper();
+        TESTS_ASSERT_EQUAL(b, XSTL_STRING("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG [_]"));
+        TESTS_ASSERT_EQUAL(a.icompare(b), cString::EqualTo);
+        b.makeLower();
+        TESTS_ASSERT_EQUAL(b, XSTL_STRING("the quick brown fox jumps over the lazy dog [_]"));
+        TESTS_ASSERT_EQUAL(b.icompare(a), cString::EqualTo);
+
+        // The order of the lower-case form, the same as strcasecmp
+        TESTS_ASSERT_EQUAL(cString(XSTL_STRING("_")).icompare(XSTL_STRING("a")),
+                           cString::LowerThan);
+        TESTS_ASSERT_EQUAL(cString(XSTL_STRING("abc")).icompare(XSTL_STRING("ABCD")),
+                           cString::LowerThan);
+        TESTS_ASSERT_EQUAL(cString(XSTL_STRING("abd")).icompare(XSTL_STRING("ABC")),
+                           cString::GreaterThan);
+        TESTS_ASSERT(cStringView(XSTL_STRING("_")) < cStringView(XSTL_STRING("A")));
+
+        // Wildcards
+        TESTS_ASSERT(cWildcardMatcher::match(a,
+            XSTL_STRING("the QUICK*fox*?AZY dog*"), false));
+        TESTS_ASSERT(!cWildcardMatcher::match(a,
+            XSTL_STRING("the QUICK*fox*?AZY dog*"), true));
+        TESTS_ASSERT(!cWildcardMatcher::match(a,
+            XSTL_STRING("the QUICK*cat*"), false));
+    }
+
+    void test_hash()
+    {
+        cString a(XSTL_STRING("Content-Length"));
+        cString b(XSTL_STRING("CONTENT-length"));
+        TESTS_ASSERT(cCaseInsensitiveString(a) == cCaseInsensitiveString(b));
+        TESTS_ASSERT(cCaseInsensitiveString(a) != cCaseInsensitiveString(XSTL_STRING("Content")));
+        TESTS_ASSERT_EQUAL(cHashCodeNoCase(a.getView(), 0),
+                           cHashCodeNoCase(b.getView(), 0));
+        TESTS_ASSERT(cHashCodeNoCase(a.getView(), 0) !=
+                     cHashCodeNoCase(cStringView(XSTL_STRING("Content-Type")), 0));
+
+        // Strings longer than a single hash block
+        cString longString(cString::dup(XSTL_STRING("Header-Name-"), 20));
+        cString upperString(longString);
+        upperString.makeUpper();
+        TESTS_ASSERT_EQUAL(cHashCodeNoCase(longString.getView(), 7),
+                           cHashCodeNoCase(upperString.getView(), 7));
+
+        cHash<cCaseInsensitiveString, int> headers;
+        headers.append(a, 10);
+        headers.append(longString, 20);
+        TESTS_ASSERT(headers.hasKey(b));
+        TESTS_ASSERT_EQUAL(headers[b], 10);
+        TESTS_ASSERT_EQUAL(headers[upperString], 20);
+        TESTS_ASSERT(!headers.hasKey(cString(XSTL_STRING("Content-Type"))));
+        TESTS_EXCEPTION(headers.append(cString(XSTL_STRING("content-length")), 5));
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        testRandom<char>();
+        testRandom<character>();
+        test_string();
+        test_hash();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestStringCase g_globalTestStringCase;
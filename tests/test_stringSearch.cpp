@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_stringSearch.cpp
+ *
+ * Test the vectorized search engines against a simple search.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/array.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringSearch.h"
+#include "xStl/os/osrand.h"
+#include "tests.h"
+
+class cTestStringSearch : public cTestObject
+{
+public:
+    enum { HaystackLength = 300 };
+
+    // The reference implementation
+    template <class T>
+    static uint simpleFind(const T* haystack, uint length,
+                           const T* needle, uint needleLength,
+                           uint startIndex, bool isReverse)
+    {
+        if (needleLength == 0)
+            return startIndex;
+        if (needleLength > length)
+            return length;
+        uint last = length - needleLength;
+        for (uint i = 0; i <= last; i++)
+        {
+            uint position = isReverse ? (last - i) : i;
+            if (isReverse ? (position > startIndex) : (position < startIndex))
+                continue;
+            uint j = 0;
+            while ((j < needleLength) && (haystack[position + j] == needle[j]))
+                j++;
+            if (j == needleLength)
+                return position;
+        }
+        return length;
+    }
+
+    // Test random haystacks with a small alphabet (many partial matches)
+    template <class T>
+    void testRandom()
+    {
+        T haystack[HaystackLength];
+        T needle[40];
+        for (uint round = 0; round < 300; round++)
+        {
+            uint length = cOSRand::rand() % HaystackLength;
+            for (uint i = 0; i < length; i++)
+                haystack[i] = (T)('a' + (cOSRand::rand() % 3));
+
+            uint needleLength = 1 + (cOSRand::rand() % 39);
+            if ((length > 0) && ((round % 2) == 0))
+            {
+                // Take the needle from the haystack
+                needleLength = t_min(needleLength, length);
+                uint position = cOSRand::rand() % (length - needleLength + 1);
+                for (uint i = 0; i < needleLength; i++)
+                    needle[i] = haystack[position + i];
+            } else
+            {
+                needleLength = 1 + (needleLength % 6);
+                for (uint i = 0; i < needleLength; i++)
+                    needle[i] = (T)('a' + (cOSRand::rand() % 3));
+            }
+
+            uint start = cOSRand::rand() % (length + 2);
+            TESTS_ASSERT_EQUAL(
+                cStringSearch::find(haystack, length, needle, needleLength, start),
+                simpleFind(haystack, length, needle, needleLength, start, false));
+            TESTS_ASSERT_EQUAL(
+                cStringSearch::find(haystack, length, needle, needleLength),
+                simpleFind(haystack, length, needle, needleLength, 0, false));
+            TESTS_ASSERT_EQUAL(
+                cStringSearch::rfind(haystack, length, needle, needleLength, start),
+                simpleFind(haystack, length, needle, needleLength, start, true));
+            TESTS_ASSERT_EQUAL(
+                cStringSearch::rfind(haystack, length, needle, needleLength),
+                simpleFind(haystack, length, needle, needleLength, MAX_UINT, true));
+        }
+    }
+
+    void test_engines()
+    {
+        cStringSearch::Engine original = cStringSearch::getEngine();
+        TESTS_ASSERT(cStringSearch::isEngineSupported(cStringSearch::ScalarEngine));
+
+        for (int engine = cStringSearch::ScalarEngine;
+             engine <= cStringSearch::AVX2Engine;
+             engine++)
+        {
+            if (!cStringSearch::isEngineSupported((cStringSearch::Engine)engine))
+            {
+                TESTS_EXCEPTION(cStringSearch::setEngine(
+                    (cStringSearch::Engine)engine));
+                continue;
+            }
+
+            cStringSearch::setEngine((cStringSearch::Engine)engine);
+            TESTS_ASSERT_EQUAL(cStringSearch::getEngine(), engine);
+            testRandom<char>();
+            testRandom<character>();
+
+            // Needles at the edges of long haystacks
+            cString haystack(cString::dup(XSTL_STRING("x"), 100));
+            haystack+= XSTL_STRING("needle");
+            TESTS_ASSERT_EQUAL(haystack.find(XSTL_STRING("needle")), 100);
+            TESTS_ASSERT_EQUAL(haystack.rfind(XSTL_STRING("x")), 99);
+            TESTS_ASSERT_EQUAL(haystack.rfind(XSTL_STRING("xn"), 98),
+                               haystack.length());
+            cString head(XSTL_STRING("needle"));
+            head+= cString::dup(XSTL_STRING("x"), 100);
+            TESTS_ASSERT_EQUAL(head.rfind(XSTL_STRING("needle")), 0);
+            TESTS_ASSERT_EQUAL(head.find(XSTL_STRING("needle"), 1),
+                               head.length());
+        }
+
+        cStringSearch::setEngine(original);
+    }
+
+    void test_findAll()
+    {
+        cString string(XSTL_STRING("aaa-aa-a"));
+        cArray<uint> positions = string.findAll(cStringView(XSTL_STRING("aa")));
+        TESTS_ASSERT_EQUAL(positions.getSize(), 2);
+        TESTS_ASSERT_EQUAL(positions[0], 0);
+        TESTS_ASSERT_EQUAL(positions[1], 4);
+
+        positions = string.findAll(cStringView(XSTL_STRING("aa")), true);
+        TESTS_ASSERT_EQUAL(positions.getSize(), 3);
+        TESTS_ASSERT_EQUAL(positions[0], 0);
+        TESTS_ASSERT_EQUAL(positions[1], 1);
+        TESTS_ASSERT_EQUAL(positions[2], 4);
+
+        TESTS_ASSERT_EQUAL(string.findAll(cStringView(XSTL_STRING("b"))).getSize(), 0);
+        TESTS_ASSERT_EQUAL(string.findAll(cStringView()).getSize(), 0);
+        TESTS_ASSERT_EQUAL(string.findAll(cStringView(XSTL_STRING("-"))).getSize(), 2);
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_engines();
+        test_findAll();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestStringSearch g_globalTestStringSearch;
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2008-2016, Integrity Project Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the Integrity Project nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * test_stringView.cpp
+ *
+ * Test the non-owning string view.
+ *
+ * Author: Elad Raz <e@eladraz.com>
+ */
+#include "xStl/types.h"
+#include "xStl/data/list.h"
+#include "xStl/data/string.h"
+#include "xStl/data/stringView.h"
+#include "xStl/data/wildcardMatcher.h"
+#include "xStl/parser/parser.h"
+#include "tests.h"
+
+class cTestStringView : public cTestObject
+{
+public:
+    void test_view()
+    {
+        cString string(XSTL_STRING("key=value;other=1"));
+        cStringView view = string.getView();
+        TESTS_ASSERT(view.getBuffer() == string.getBuffer());
+        TESTS_ASSERT_EQUAL(view.length(), string.length());
+
+        // Sub-views reference the same memory
+        TESTS_ASSERT(view.left(3).getBuffer() == string.getBuffer());
+        TESTS_ASSERT(view.left(3) == cStringView(XSTL_STRING("key")));
+        TESTS_ASSERT(view.right(1) == cStringView(XSTL_STRING("1")));
+        TESTS_ASSERT(view.mid(4, 5) == cStringView(XSTL_STRING("value")));
+        TESTS_ASSERT(view.part(4, 9) == view.mid(4, 5));
+        TESTS_ASSERT_EQUAL(view.left(100).length(), view.length());
+        TESTS_ASSERT(view.mid(100, 2).isEmpty());
+        TESTS_ASSERT(view.part(5, 2).isEmpty());
+        TESTS_ASSERT_EQUAL(view[3], XSTL_CHAR('='));
+        TESTS_EXCEPTION(view[view.length()]);
+
+        // Searches
+        TESTS_ASSERT_EQUAL(view.find(cStringView(XSTL_STRING("other"))), 10);
+        TESTS_ASSERT_EQUAL(view.find(XSTL_CHAR('='), 4), 15);
+        TESTS_ASSERT_EQUAL(view.find(cStringView(XSTL_STRING("none"))),
+                           view.length());
+        TESTS_ASSERT_EQUAL(view.find(cStringView(), 3), 3);
+        TESTS_ASSERT_EQUAL(string.find(cStringView(XSTL_STRING(";"))), 9);
+        TESTS_ASSERT(view.startsWith(cStringView(XSTL_STRING("key="))));
+        TESTS_ASSERT(!view.startsWith(cStringView(XSTL_STRING("value"))));
+
+        // Comparison
+        cStringView abc(XSTL_STRING("abc"));
+        TESTS_ASSERT_EQUAL(abc.compare(cStringView(XSTL_STRING("abc"))), 0);
+        TESTS_ASSERT(abc.compare(cStringView(XSTL_STRING("abd"))) < 0);
+        TESTS_ASSERT(abc.compare(cStringView(XSTL_STRING("ab"))) > 0);
+        TESTS_ASSERT_EQUAL(abc.icompare(cStringView(XSTL_STRING("ABC"))), 0);
+        TESTS_ASSERT(abc != cStringView(XSTL_STRING("ABC")));
+        TESTS_ASSERT(abc < cStringView(XSTL_STRING("ABD")));
+        TESTS_ASSERT_EQUAL(cString(XSTL_STRING("abc")).compare(abc),
+                           cString::EqualTo);
+        TESTS_ASSERT_EQUAL(cString(XSTL_STRING("abb")).compare(abc),
+                           cString::LowerThan);
+
+        // Materialize
+        cString value(view.mid(4, 5));
+        TESTS_ASSERT_EQUAL(value, XSTL_STRING("value"));
+        TESTS_ASSERT(cString(cStringView()).length() == 0);
+    }
+
+    void test_tokens()
+    {
+        cStringView view(XSTL_STRING("a=1;bb=22;;c"));
+        cStringView divider(XSTL_STRING(";"));
+
+        uint position = 0;
+        cStringView token;
+        TESTS_ASSERT(view.getNextToken(divider, position, token));
+        TESTS_ASSERT(token == cStringView(XSTL_STRING("a=1")));
+        TESTS_ASSERT(token.getBuffer() == view.getBuffer());
+        TESTS_ASSERT(view.getNextToken(divider, position, token));
+        TESTS_ASSERT(token == cStringView(XSTL_STRING("bb=22")));
+        TESTS_ASSERT(view.getNextToken(divider, position, token));
+        TESTS_ASSERT(token.isEmpty());
+        TESTS_ASSERT(view.getNextToken(divider, position, token));
+        TESTS_ASSERT(token == cStringView(XSTL_STRING("c")));
+        TESTS_ASSERT(!view.getNextToken(divider, position, token));
+
+        cList<cStringView> tokens =
+            cStringView(XSTL_STRING(";x;")).split(divider);
+        TESTS_ASSERT_EQUAL(tokens.length(), 3);
+        cList<cStringView>::iterator i = tokens.begin();
+        TESTS_ASSERT((*i).isEmpty()); ++i;
+        TESTS_ASSERT(*i == cStringView(XSTL_STRING("x"))); ++i;
+        TESTS_ASSERT((*i).isEmpty());
+
+        TESTS_ASSERT_EQUAL(cStringView().split(divider).length(), 1);
+
+        // cString::split accepts a view
+        cString string(XSTL_STRING("a=13&b=5&c=2"));
+        cList<cString> parts = string.split(cStringView(XSTL_STRING("&")));
+        TESTS_ASSERT_EQUAL(parts.length(), 3);
+        TESTS_ASSERT_EQUAL(*parts.begin(), XSTL_STRING("a=13"));
+    }
+
+    void test_wildcard()
+    {
+        cString string(XSTL_STRING("blaABCDblaABCD1.txt"));
+        cStringView view = string.getView();
+        TESTS_ASSERT(cWildcardMatcher::match(view.left(15),
+                     cStringView(XSTL_STRING("bla*bla*1"))));
+        TESTS_ASSERT(cWildcardMatcher::match(view,
+                     cStringView(XSTL_STRING("*.TXT")), false));
+        TESTS_ASSERT(!cWildcardMatcher::match(view,
+                     cStringView(XSTL_STRING("*.TXT"))));
+        TESTS_ASSERT(!cWildcardMatcher::match(view.left(4),
+                     cStringView(XSTL_STRING("bla*bla*1"))));
+    }
+
+    void test_parser()
+    {
+        char text[] = "first second\nthird";
+        Parser parser(text, text, sizeof(text) - 1, 1);
+
+        cAsciiStringView word = parser.readWordView();
+        TESTS_ASSERT(word.getBuffer() == text);
+        TESTS_ASSERT(word == cAsciiStringView("first"));
+        parser.readBlanks();
+        TESTS_ASSERT(parser.readWordView() == cAsciiStringView("second"));
+        parser.readBlanks();
+        TESTS_ASSERT_EQUAL(parser.getLinenumber(), 2);
+        TESTS_ASSERT_EQUAL(parser.readWord(), XSTL_STRING("third"));
+        TESTS_ASSERT(parser.isEOS());
+        TESTS_ASSERT(parser.readWordView().isEmpty());
+    }
+
+    // Perform the test
+    virtual void test()
+    {
+        test_view();
+        test_tokens();
+        test_wildcard();
+        test_parser();
+    }
+
+    // Return the name of the module
+    virtual cString getName() { return __FILE__; }
+};
+
+// Instance test object
+cTestStringView g_globalTestStringView;